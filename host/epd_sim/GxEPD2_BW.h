@@ -0,0 +1,169 @@
+// CryptoBar V0.99s (Host e-paper simulator)
+// GxEPD2_BW.h - Host stand-in for GxEPD2_BW + GxEPD2_290_BS backed by EpdSimPanel
+#pragma once
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#include "epd_sim_panel.h"
+
+#define GxEPD_BLACK 0x0000
+#define GxEPD_WHITE 0xFFFF
+
+// Same geometry as GxEPD2_290_BS. Refresh times are the driver's nominal
+// values; they feed the simulated panel time and, with setBusyTimeScale(),
+// how long a refresh holds BUSY.
+class GxEPD2_290_BS : public EpdSimPanel {
+ public:
+  static const uint16_t WIDTH = 128;
+  static const uint16_t WIDTH_VISIBLE = WIDTH;
+  static const uint16_t HEIGHT = 296;
+  static const bool hasPartialUpdate = true;
+  static const bool hasFastPartialUpdate = true;
+  static const uint16_t full_refresh_time = 4000;
+  static const uint16_t partial_refresh_time = 700;
+
+  GxEPD2_290_BS(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+    : EpdSimPanel(WIDTH, HEIGHT, full_refresh_time, partial_refresh_time) {
+    (void)cs; (void)dc; (void)rst; (void)busy;
+  }
+};
+
+// Paged 1-bpp frame buffer with the same window, page and rotation handling
+// as GxEPD2_BW, so CryptoBar's drawing code runs unchanged on the host.
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+ public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance)
+    : Adafruit_GFX(GxEPD2_Type::WIDTH_VISIBLE, GxEPD2_Type::HEIGHT), epd2(epd2_instance) {
+    _page_height = page_height;
+    _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  uint16_t pages() { return _pages; }
+  uint16_t pageHeight() { return _page_height; }
+
+  void init(uint32_t serial_diag_bitrate = 0) { epd2.init(serial_diag_bitrate); }
+  void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 10, bool pulldown_rst_mode = false) {
+    (void)initial; (void)reset_duration; (void)pulldown_rst_mode;
+    epd2.init(serial_diag_bitrate);
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
+    switch (getRotation()) {
+      case 1: std::swap(x, y); x = WIDTH - x - 1; break;
+      case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+      case 3: std::swap(x, y); y = HEIGHT - y - 1; break;
+    }
+    // transpose partial window to 0,0
+    x -= _pw_x;
+    y -= _pw_y;
+    if ((x < 0) || (x >= _pw_w) || (y < 0) || (y >= _pw_h)) return;
+    // adjust for current page
+    y -= _current_page * _page_height;
+    if ((y < 0) || (y >= _page_height)) return;
+    uint32_t i = x / 8 + y * (_pw_w / 8);
+    if (color) _buffer[i] = (uint8_t)(_buffer[i] | (1 << (7 - x % 8)));
+    else       _buffer[i] = (uint8_t)(_buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
+  }
+
+  void fillScreen(uint16_t color) override {
+    uint8_t data = (color == GxEPD_BLACK) ? 0x00 : 0xFF;
+    memset(_buffer, data, sizeof(_buffer));
+  }
+
+  void setFullWindow() {
+    _using_partial_mode = false;
+    _pw_x = 0;
+    _pw_y = 0;
+    _pw_w = WIDTH;
+    _pw_h = HEIGHT;
+    _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+  }
+
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    _rotate(x, y, w, h);
+    _pw_x = gx_min(x, (uint16_t)WIDTH);
+    _pw_y = gx_min(y, (uint16_t)HEIGHT);
+    _pw_w = gx_min(w, (uint16_t)(WIDTH - _pw_x));
+    _pw_h = gx_min(h, (uint16_t)(HEIGHT - _pw_y));
+    _using_partial_mode = true;
+    // make _pw_x, _pw_w multiple of 8
+    _pw_w += _pw_x % 8;
+    if (_pw_w % 8 > 0) _pw_w += 8 - _pw_w % 8;
+    _pw_x -= _pw_x % 8;
+    _pages = 1 + ((_pw_h - 1) / _page_height);
+  }
+
+  void firstPage() {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+  }
+
+  bool nextPage() {
+    uint16_t page_ys = _current_page * _page_height;
+    if (_using_partial_mode) {
+      uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : _pw_h;
+      uint16_t dest_ys = _pw_y + page_ys;
+      uint16_t dest_ye = gx_min((uint16_t)(_pw_y + _pw_h), (uint16_t)(_pw_y + page_ye));
+      if (dest_ye > dest_ys) epd2.writeImage(_buffer, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+      if (++_current_page < _pages) {
+        fillScreen(GxEPD_WHITE);
+        return true;
+      }
+      _current_page = 0;
+      epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+      return false;
+    }
+    epd2.writeImage(_buffer, 0, page_ys, WIDTH, gx_min(_page_height, (uint16_t)(HEIGHT - page_ys)));
+    if (++_current_page < _pages) {
+      fillScreen(GxEPD_WHITE);
+      return true;
+    }
+    _current_page = 0;
+    epd2.refresh(false);
+    return false;
+  }
+
+  void display(bool partial_update_mode = false) {
+    epd2.writeImage(_buffer, 0, 0, WIDTH, _page_height);
+    epd2.refresh(partial_update_mode);
+  }
+
+  void powerOff() { epd2.powerOff(); }
+  void hibernate() { epd2.hibernate(); }
+
+ private:
+  template <typename T>
+  static T gx_min(T a, T b) { return a < b ? a : b; }
+
+  void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h) {
+    switch (getRotation()) {
+      case 1:
+        std::swap(x, y);
+        std::swap(w, h);
+        x = WIDTH - x - w;
+        break;
+      case 2:
+        x = WIDTH - x - w;
+        y = HEIGHT - y - h;
+        break;
+      case 3:
+        std::swap(x, y);
+        std::swap(w, h);
+        y = HEIGHT - y - h;
+        break;
+    }
+  }
+
+  uint8_t  _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  bool     _using_partial_mode;
+  uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+  uint16_t _pages, _page_height, _current_page;
+};
@@ -0,0 +1,273 @@
+// CryptoBar V0.99s (Host e-paper simulator)
+// epd_bench.cpp - Renders every screen on the simulated panel and reports the cost per frame
+//
+// Usage: epd_bench [--iter N] [--pbm DIR] [--csv FILE] [--busy-scale F]
+//   --iter N        frames per scenario (default 20)
+//   --pbm DIR       save the last frame of each scenario as DIR/<scenario>.pbm
+//   --csv FILE      append one row per scenario (for tracking across releases)
+//   --busy-scale F  hold BUSY for F x the nominal refresh time (default 0: no wait),
+//                   so the loop stall table shows what a refresh costs the caller
+//
+// Built with RENDER_TASK_ENABLE=1 ([env:epd_sim_task]) frames are drawn by the
+// render task on a host thread, as on the device; the loop stall table then
+// shows the submit cost and how many requests latest-wins merging dropped.
+#include <Arduino.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "epd_display.h"
+#include "app_state.h"
+#include "app_time.h"
+#include "coins.h"
+#include "day_avg.h"
+#include "ui.h"
+#include "render_task.h"
+#include "refresh_scheduler.h"
+
+EpdDisplay display(
+  GxEPD2_290_BS(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY)
+);
+
+// ==================== Firmware hooks =====================
+// On the device these live in main.cpp / app_time.cpp.
+
+static time_t s_simUtc = 1767225600;  // 2026-01-01 00:00:00 UTC
+
+const CoinInfo& currentCoin() {
+  int n = coinCount();
+  if (g_currentCoinIndex < 0) g_currentCoinIndex = 0;
+  if (g_currentCoinIndex >= n) g_currentCoinIndex = n - 1;
+  return coinAt(g_currentCoinIndex);
+}
+
+bool getLocalTimeLocal(struct tm* out) {
+  time_t localSec = s_simUtc + g_localUtcOffsetSec;
+  return gmtime_r(&localSec, out) != nullptr;
+}
+
+// ==================== Fixture state =====================
+
+static double benchPrice(int i) {
+  return 2.3456 + 0.0125 * sin(i * 0.7) + 0.0001 * i;
+}
+
+static void setupFixture() {
+  g_currentCoinIndex = coinIndexFromTicker("XRP");
+  g_currentPriceApi   = "Paprika";
+  g_currentHistoryApi = "CoinGecko";
+  g_timeValid = true;
+  g_localUtcOffsetSec = -5 * 3600;
+
+  g_cycleInit     = true;
+  g_cycleStartUtc = s_simUtc - 5 * 3600;
+  g_cycleEndUtc   = g_cycleStartUtc + 24 * 3600;
+
+  // A realistic day: 5-minute samples for most of the cycle.
+  g_chartSampleCount = 0;
+  for (int i = 0; i < 240 && i < MAX_CHART_SAMPLES; ++i) {
+    g_chartSamples[i].pos   = (float)i / 288.0f;
+    g_chartSamples[i].price = 2.30 + 0.05 * sin(i * 0.05) + 0.01 * sin(i * 0.9);
+    g_chartSampleCount++;
+  }
+  g_chartDirtyFrom  = 0;
+  g_prevDayRefPrice = 2.31;
+  g_prevDayRefValid = true;
+  g_dayAvgMode      = DAYAVG_ROLLING;
+
+  g_lastPriceUsd  = benchPrice(0);
+  g_lastChange24h = 1.84;
+}
+
+// ==================== Scenarios =====================
+
+typedef void (*BenchStepFn)(int i);
+
+struct BenchScenario {
+  const char* name;
+  BenchStepFn step;
+  uint16_t    gapMs;  // pause between steps (encoder pace), only with --busy-scale
+};
+
+static void stepMainFull(int i)    { drawMainScreen(benchPrice(i), 1.84, true); }
+static void stepMainPartial(int i) { drawMainScreen(benchPrice(i), 1.84, false); }
+static void stepTimeOnly(int i)    { (void)i; s_simUtc += 60; drawMainScreenTimeOnly(false); }
+
+static void stepMenuFull(int i)    { (void)i; drawMenuScreen(true); }
+static void stepMenuCursor(int i)  { (void)i; g_menuIndex = (g_menuIndex + 1) % MENU_COUNT; drawMenuScreen(false); }
+static void stepTzCursor(int i)    { (void)i; g_tzMenuIndex = (g_tzMenuIndex + 1) % TIMEZONE_COUNT; drawTimezoneMenu(false); }
+static void stepCoinCursor(int i)  { (void)i; g_coinMenuIndex = (g_coinMenuIndex + 1) % coinCount(); drawCoinMenu(false); }
+static void stepCurrCursor(int i)  { (void)i; g_currencyMenuIndex = (g_currencyMenuIndex + 1) % CURR_COUNT; drawCurrencyMenu(false); }
+static void stepUpdCursor(int i)   { (void)i; g_updateMenuIndex = (g_updateMenuIndex + 1) % UPDATE_PRESETS_COUNT; drawUpdateMenu(false); }
+
+// One encoder detent in the settings menu, submitted the way loop() does.
+static void stepMenuEncoder(int i) {
+  (void)i;
+  g_menuIndex = (g_menuIndex + 1) % MENU_COUNT;
+  renderTaskSubmitInput(UI_MODE_MENU, false);
+}
+
+// A fast spin: one detent every 30 ms.
+static const uint16_t kEncoderGapMs = 30;
+
+static const BenchScenario kScenarios[] = {
+  { "main_full",       stepMainFull,    0 },
+  { "main_partial",    stepMainPartial, 0 },
+  { "main_time_only",  stepTimeOnly,    0 },
+  { "menu_full",       stepMenuFull,    0 },
+  { "menu_cursor",     stepMenuCursor,  0 },
+  { "menu_encoder",    stepMenuEncoder, kEncoderGapMs },
+  { "tz_cursor",       stepTzCursor,    0 },
+  { "coin_cursor",     stepCoinCursor,  0 },
+  { "currency_cursor", stepCurrCursor,  0 },
+  { "update_cursor",   stepUpdCursor,   0 },
+};
+static const int kScenarioCount = sizeof(kScenarios) / sizeof(kScenarios[0]);
+
+struct BenchResult {
+  uint32_t    frames;
+  double      cpuUs;      // host time per frame until the queue is idle (pauses excluded)
+  EpdSimStats panel;      // totals over the run
+  double      loopMaxUs;  // longest step on the calling ("loop") task
+  double      loopP99Us;
+  uint32_t    dropped;    // render task: requests superseded before drawing
+  uint32_t    preempted;  // render task: frames abandoned for newer input
+};
+
+static float s_busyScale = 0.0f;
+
+static BenchResult runScenario(const BenchScenario& s, int iterations) {
+  BenchResult r;
+  memset(&r, 0, sizeof(r));
+
+  display.epd2.resetStats();
+  RenderTaskStats rs0;
+  renderTaskGetStats(rs0);
+  uint32_t frames0 = display.shadow().frameCount();
+  std::vector<double> stepUs;
+  stepUs.reserve(iterations);
+  double pausedUs = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    renderTaskFlush();  // start of a loop() pass
+    s.step(i);
+    auto t1 = std::chrono::steady_clock::now();
+    stepUs.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    if (s.gapMs && s_busyScale > 0.0f) {
+      delay(s.gapMs);
+      pausedUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t1).count();
+    }
+  }
+  renderTaskWaitIdle(600000);
+  double totalUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() - pausedUs;
+
+  RenderTaskStats rs1;
+  renderTaskGetStats(rs1);
+  r.frames    = display.shadow().frameCount() - frames0;
+  r.cpuUs     = r.frames ? totalUs / r.frames : 0;
+  r.panel     = display.epd2.stats();
+  r.dropped   = rs1.framesDropped - rs0.framesDropped;
+  r.preempted = rs1.framesPreempted - rs0.framesPreempted;
+  std::sort(stepUs.begin(), stepUs.end());
+  r.loopMaxUs = stepUs.back();
+  r.loopP99Us = stepUs[(stepUs.size() * 99 + 99) / 100 - 1];
+  return r;
+}
+
+// ==================== Report =====================
+
+static double perFrame(uint64_t v, uint32_t frames) {
+  return frames ? (double)v / frames : 0.0;
+}
+
+static void printReport(const BenchResult* results, int iterations) {
+  printf("\n## CryptoBar %s render benchmark (host)\n\n", CRYPTOBAR_VERSION);
+  printf("page divisor %d: %u page(s), frame buffer %lu B, shadow %lu B, %d frames/scenario\n\n",
+         EPD_PAGE_DIVISOR, (unsigned)EpdDisplay::kPages,
+         (unsigned long)EpdDisplay::kBufferBytes, (unsigned long)EpdDisplay::kShadowBytes, iterations);
+  printf("| scenario | frames | cpu us/frame | full | partial | window px/frame | changed px/frame | bytes/frame | panel ms/frame |\n");
+  printf("|---|---:|---:|---:|---:|---:|---:|---:|---:|\n");
+  for (int i = 0; i < kScenarioCount; ++i) {
+    const BenchResult& r = results[i];
+    printf("| %s | %lu | %.1f | %lu | %lu | %.0f | %.0f | %.0f | %.0f |\n",
+           kScenarios[i].name, (unsigned long)r.frames, r.cpuUs,
+           (unsigned long)r.panel.fullRefreshes, (unsigned long)r.panel.partialRefreshes,
+           perFrame(r.panel.windowArea, r.frames), perFrame(r.panel.changedPixels, r.frames),
+           perFrame(r.panel.bytesWritten, r.frames), perFrame(r.panel.refreshMs, r.frames));
+  }
+
+  printf("\n### Loop stall per step (%s, busy scale %.2f)\n\n",
+         RENDER_TASK_ENABLE ? "render task" : "synchronous", (double)s_busyScale);
+  printf("| scenario | steps | frames | dropped | preempted | loop max ms | loop p99 ms |\n");
+  printf("|---|---:|---:|---:|---:|---:|---:|\n");
+  for (int i = 0; i < kScenarioCount; ++i) {
+    const BenchResult& r = results[i];
+    printf("| %s | %d | %lu | %lu | %lu | %.2f | %.2f |\n",
+           kScenarios[i].name, iterations, (unsigned long)r.frames,
+           (unsigned long)r.dropped, (unsigned long)r.preempted,
+           r.loopMaxUs / 1000.0, r.loopP99Us / 1000.0);
+  }
+}
+
+static bool appendCsv(const char* path, const BenchResult* results) {
+  FILE* f = fopen(path, "a+");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  if (ftell(f) == 0) {
+    fprintf(f, "version,page_divisor,scenario,frames,cpu_us,full,partial,window_px,changed_px,bytes,panel_ms\n");
+  }
+  for (int i = 0; i < kScenarioCount; ++i) {
+    const BenchResult& r = results[i];
+    fprintf(f, "%s,%d,%s,%lu,%.1f,%lu,%lu,%.0f,%.0f,%.0f,%.0f\n",
+            CRYPTOBAR_VERSION, EPD_PAGE_DIVISOR, kScenarios[i].name, (unsigned long)r.frames, r.cpuUs,
+            (unsigned long)r.panel.fullRefreshes, (unsigned long)r.panel.partialRefreshes,
+            perFrame(r.panel.windowArea, r.frames), perFrame(r.panel.changedPixels, r.frames),
+            perFrame(r.panel.bytesWritten, r.frames), perFrame(r.panel.refreshMs, r.frames));
+  }
+  fclose(f);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int iterations = 20;
+  const char* pbmDir = nullptr;
+  const char* csvPath = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--iter") && i + 1 < argc)      iterations = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--pbm") && i + 1 < argc)  pbmDir = argv[++i];
+    else if (!strcmp(argv[i], "--csv") && i + 1 < argc)  csvPath = argv[++i];
+    else if (!strcmp(argv[i], "--busy-scale") && i + 1 < argc) s_busyScale = (float)atof(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [--iter N] [--pbm DIR] [--csv FILE] [--busy-scale F]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (iterations < 1) iterations = 1;
+
+  display.init(115200);
+  display.setRotation(1);
+  display.epd2.setBusyTimeScale(s_busyScale);
+  renderTaskBegin(0);
+  refreshSchedulerBegin();
+  setupFixture();
+
+  BenchResult results[kScenarioCount];
+  for (int i = 0; i < kScenarioCount; ++i) {
+    results[i] = runScenario(kScenarios[i], iterations);
+    if (pbmDir) {
+      char path[256];
+      snprintf(path, sizeof(path), "%s/%s.pbm", pbmDir, kScenarios[i].name);
+      if (!display.epd2.savePbm(path, display.getRotation())) {
+        fprintf(stderr, "[Sim] Cannot write %s\n", path);
+      }
+    }
+  }
+
+  printReport(results, iterations);
+  if (csvPath && !appendCsv(csvPath, results)) {
+    fprintf(stderr, "[Sim] Cannot write %s\n", csvPath);
+    return 1;
+  }
+  return 0;
+}
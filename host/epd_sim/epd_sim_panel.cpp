@@ -0,0 +1,110 @@
+// CryptoBar V0.99s (Host e-paper simulator)
+// epd_sim_panel.cpp - Simulated e-paper controller
+#include "epd_sim_panel.h"
+
+EpdSimPanel::EpdSimPanel(uint16_t w, uint16_t h, uint16_t fullMs, uint16_t partialMs)
+  : m_w(w), m_h(h), m_stride((uint16_t)((w + 7) / 8)),
+    m_fullMs(fullMs), m_partialMs(partialMs),
+    m_ram((size_t)((w + 7) / 8) * h, 0xFF),
+    m_panel((size_t)((w + 7) / 8) * h, 0xFF) {
+  resetStats();
+}
+
+void EpdSimPanel::resetStats() {
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+// Same contract as GxEPD2_EPD::writeImage(): x and w are multiples of 8,
+// bitmap rows are w/8 bytes.
+void EpdSimPanel::writeImage(const uint8_t* bitmap, int16_t x, int16_t y, int16_t w, int16_t h) {
+  const int16_t wb = (int16_t)((w + 7) / 8);
+  for (int16_t row = 0; row < h; ++row) {
+    int16_t py = y + row;
+    if (py < 0 || py >= (int16_t)m_h) continue;
+    for (int16_t b = 0; b < wb; ++b) {
+      int16_t px = x + b * 8;
+      if (px < 0 || px >= (int16_t)m_w) continue;
+      m_ram[(size_t)py * m_stride + px / 8] = bitmap[(size_t)row * wb + b];
+    }
+  }
+  m_stats.bytesWritten += (uint64_t)wb * (h > 0 ? h : 0);
+}
+
+void EpdSimPanel::refresh(bool partialUpdateMode) {
+  refreshWindow(0, 0, m_w, m_h, !partialUpdateMode);
+}
+
+void EpdSimPanel::refresh(int16_t x, int16_t y, int16_t w, int16_t h) {
+  refreshWindow(x, y, w, h, false);
+}
+
+void EpdSimPanel::refreshWindow(int16_t x, int16_t y, int16_t w, int16_t h, bool full) {
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > (int16_t)m_w) w = m_w - x;
+  if (y + h > (int16_t)m_h) h = m_h - y;
+  if (w <= 0 || h <= 0) return;
+
+  const int b0 = x / 8;
+  const int b1 = (x + w - 1) / 8;
+  for (int16_t py = y; py < y + h; ++py) {
+    uint8_t* dst = &m_panel[(size_t)py * m_stride];
+    const uint8_t* src = &m_ram[(size_t)py * m_stride];
+    for (int b = b0; b <= b1; ++b) {
+      m_stats.changedPixels += (uint64_t)__builtin_popcount((unsigned)(dst[b] ^ src[b]));
+      dst[b] = src[b];
+    }
+  }
+
+  m_stats.windowArea += (uint64_t)w * h;
+  if (full) {
+    m_stats.fullRefreshes++;
+    m_stats.refreshMs += m_fullMs;
+  } else {
+    m_stats.partialRefreshes++;
+    m_stats.refreshMs += m_partialMs;
+  }
+
+  if (m_busyScale > 0.0f) {
+    const uint32_t busyUs = (uint32_t)((full ? m_fullMs : m_partialMs) * 1000.0f * m_busyScale);
+    const uint32_t t0 = micros();
+    while (micros() - t0 < busyUs) {
+      if (m_busyCb) m_busyCb(m_busyParam);
+      else          delay(1);
+    }
+  }
+}
+
+bool EpdSimPanel::pixelBlack(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= (int16_t)m_w || y >= (int16_t)m_h) return false;
+  return (m_panel[(size_t)y * m_stride + x / 8] & (0x80 >> (x & 7))) == 0;
+}
+
+bool EpdSimPanel::savePbm(const char* path, uint8_t rotation) const {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+
+  const bool swap = (rotation & 1) != 0;
+  const int sw = swap ? m_h : m_w;
+  const int sh = swap ? m_w : m_h;
+  fprintf(f, "P4\n%d %d\n", sw, sh);
+
+  std::vector<uint8_t> row((size_t)(sw + 7) / 8);
+  for (int sy = 0; sy < sh; ++sy) {
+    std::fill(row.begin(), row.end(), 0);
+    for (int sx = 0; sx < sw; ++sx) {
+      // Screen -> controller, same mapping as GxEPD2_BW::drawPixel()
+      int16_t x = sx, y = sy;
+      switch (rotation & 3) {
+        case 1: x = m_w - sy - 1; y = sx; break;
+        case 2: x = m_w - sx - 1; y = m_h - sy - 1; break;
+        case 3: x = sy; y = m_h - sx - 1; break;
+        default: break;
+      }
+      if (pixelBlack(x, y)) row[sx / 8] |= (uint8_t)(0x80 >> (sx & 7));  // PBM: 1 = black
+    }
+    fwrite(row.data(), 1, row.size(), f);
+  }
+  fclose(f);
+  return true;
+}
@@ -0,0 +1,59 @@
+// CryptoBar V0.99s (Host e-paper simulator)
+// epd_sim_panel.h - Simulated e-paper controller: RAM, visible image, refresh statistics
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+struct EpdSimStats {
+  uint32_t fullRefreshes;
+  uint32_t partialRefreshes;
+  uint64_t windowArea;     // pixels inside refreshed windows
+  uint64_t changedPixels;  // pixels that changed colour on the panel
+  uint64_t bytesWritten;   // image bytes sent to the controller
+  uint64_t refreshMs;      // simulated panel time (nominal refresh durations)
+};
+
+// Stands in for a GxEPD2_EPD driver. Bit set = white, like GxEPD2 buffers.
+class EpdSimPanel {
+ public:
+  EpdSimPanel(uint16_t w, uint16_t h, uint16_t fullMs, uint16_t partialMs);
+
+  // ---- GxEPD2_EPD surface used by GxEPD2_BW and CryptoBar ----
+  void init(uint32_t serialDiagBitrate = 0) { (void)serialDiagBitrate; }
+  void writeImage(const uint8_t* bitmap, int16_t x, int16_t y, int16_t w, int16_t h);
+  void refresh(bool partialUpdateMode = false);
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h);
+  void setBusyCallback(void (*cb)(const void*), const void* param = 0) {
+    m_busyCb = cb;
+    m_busyParam = param;
+  }
+  void powerOff() {}
+  void hibernate() {}
+
+  // ---- Simulator API ----
+  const EpdSimStats& stats() const { return m_stats; }
+  void resetStats();
+
+  // Hold BUSY for the nominal refresh time times 'scale' after each refresh,
+  // calling the busy callback like GxEPD2's _waitWhileBusy(). 0 (default):
+  // refreshes return at once and only count simulated panel time.
+  void setBusyTimeScale(float scale) { m_busyScale = scale; }
+
+  bool pixelBlack(int16_t x, int16_t y) const;  // controller coordinates
+
+  // Save the visible image as a binary PBM, rotated like Adafruit_GFX::setRotation().
+  bool savePbm(const char* path, uint8_t rotation) const;
+
+ private:
+  void refreshWindow(int16_t x, int16_t y, int16_t w, int16_t h, bool full);
+
+  uint16_t m_w, m_h, m_stride;
+  uint16_t m_fullMs, m_partialMs;
+  float m_busyScale = 0.0f;
+  void (*m_busyCb)(const void*) = nullptr;
+  const void* m_busyParam = nullptr;
+  std::vector<uint8_t> m_ram;    // controller RAM (next image)
+  std::vector<uint8_t> m_panel;  // what the panel shows
+  EpdSimStats m_stats;
+};
@@ -0,0 +1,565 @@
+// CryptoBar V0.99s (Host native build)
+// native_bench.cpp - Microbenchmarks for the firmware's core logic on the host HAL shim
+//
+// Usage: native_bench [--iter N] [--filter TEXT] [--fixtures DIR] [--csv FILE] [--trace FILE] [--soak TICKS]
+//                     [--soak-history API] [--http URL] [--verbose]
+//   --iter N        timed runs per case (default 200)
+//   --filter TEXT   only run cases whose name contains TEXT
+//   --fixtures DIR  API response fixtures (default host/native/fixtures)
+//   --csv FILE      append one row per case (for tracking across releases)
+//   --trace FILE    write the event ring (fetch / parse / history, last 256 events) as
+//                   Chrome Trace Event JSON, the same format as the device's /trace.json
+//   --soak TICKS    instead of the cases, run TICKS 30 s price ticks (hourly FX, daily
+//                   history) and count heap allocations per tick; fails if any
+//                   JsonDocument memory came from the heap instead of the JSON arena
+//   --soak-history API  history provider the soak bootstraps from: coingecko (default),
+//                   binance or kraken (the providers ahead of it are refused); the
+//                   JSON arena high water then covers the largest documents
+//   --http URL      instead of the cases, GET URL --iter times with lite_http (identity and
+//                   gzip / deflate) and with the HTTPClient shim (e.g. against the replay
+//                   server, --gzip --kbps); reports time, bytes on the wire and heap
+//                   allocations per request
+//   --verbose       keep firmware Serial output (muted while timing by default)
+//
+// Built with CRYPTOBAR_API_BASE ([env:native_replay]) the fixtures are not
+// loaded: requests go to the replay server (host/replay), so run times include
+// the socket round trip and any latency or faults the server injects.
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <chrono>
+#include <new>
+
+#include "host_hal.h"
+#include "app_state.h"
+#include "app_scheduler.h"
+#include "coins.h"
+#include "day_avg.h"
+#include "heap_monitor.h"
+#include "json_arena.h"
+#include "lite_http.h"
+#include "network.h"
+#include "settings_store.h"
+#include "trace.h"
+
+// ==================== Firmware hooks =====================
+// On the device this lives in main.cpp.
+
+const CoinInfo& currentCoin() {
+  int n = coinCount();
+  if (g_currentCoinIndex < 0) g_currentCoinIndex = 0;
+  if (g_currentCoinIndex >= n) g_currentCoinIndex = n - 1;
+  return coinAt(g_currentCoinIndex);
+}
+
+// ==================== Allocation counter =====================
+// Global operator new covers String (std::string in the shim) and the HTTP
+// shim; JsonDocument memory is counted by the arena (JsonArenaStats).
+
+static uint64_t s_newCount = 0;
+
+void* operator new(size_t size) {
+  s_newCount++;
+  if (void* p = malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// ==================== Fixture state =====================
+// The fixtures were captured for XRP at this instant: 12:00 ET, 17 h into the
+// 7pm ET cycle that started at 2026-01-15 00:00 UTC.
+
+static const time_t kBenchNowUtc        = 1768496400;  // 2026-01-15 17:00:00 UTC
+static const time_t kBenchCycleStartUtc = 1768435200;  // 2026-01-15 00:00:00 UTC
+static const double kFixturePriceUsd    = 2.3583;
+static const int    kFixtureCycleBars   = 205;         // 5-min bars from 00:00 to 17:00 UTC
+
+static const char* s_fixtureDir = "host/native/fixtures";
+
+#ifdef CRYPTOBAR_API_BASE
+static const bool kLive = true;
+#else
+static const bool kLive = false;
+#endif
+
+// Answer requests for pattern from a fixture (live: leave them to the server).
+static bool serve(const char* pattern, const char* file) {
+  if (kLive) return true;
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", s_fixtureDir, file);
+  return hostHttpAddRoute(pattern, path);
+}
+
+// Refuse requests for pattern, as if that provider were down.
+static void refuse(const char* pattern) {
+  hostHttpAddRouteBody(pattern, "", HTTPC_ERROR_CONNECTION_REFUSED);
+}
+
+static void resetAppState() {
+  hostClockSetUtc(kBenchNowUtc);
+  g_currentCoinIndex = coinIndexFromTicker("XRP");
+  g_currentPriceApi   = "";
+  g_currentHistoryApi = "";
+  g_cycleInit = false;
+  g_chartSampleCount = 0;
+  dayAvgRollingReset();
+  heapMonitorForceDegrade(false);
+}
+
+// ==================== Cases =====================
+
+typedef bool (*BenchSetupFn)();
+typedef bool (*BenchRunFn)();  // one run; returns the sanity check
+
+struct BenchCase {
+  const char*  name;
+  BenchSetupFn setup;
+  BenchRunFn   run;
+  uint32_t     opsPerRun;
+};
+
+static bool fetchPriceIs(const char* api) {
+  double price = 0, change = 0;
+  g_currentPriceApi = "";
+  if (!fetchPrice(price, change)) return false;
+  return fabs(price - kFixturePriceUsd) < 1e-6 && strcmp(g_currentPriceApi, api) == 0;
+}
+
+static bool historyIs(const char* api) {
+  g_currentHistoryApi = "";
+  g_chartSampleCount = 0;
+  bootstrapHistoryFromKrakenOHLC();
+  return g_chartSampleCount == kFixtureCycleBars && strcmp(g_currentHistoryApi, api) == 0;
+}
+
+// Price: the providers ahead of the measured one in the fallback chain
+// (CoinGecko -> CoinPaprika -> Kraken -> Binance) are refused, so they fail
+// fast and the measured provider's fetch and parse dominate.
+static bool setupPriceCoingecko() {
+  return serve("/simple/price", "coingecko_simple_price.json");
+}
+static bool setupPricePaprika() {
+  refuse("/simple/price");
+  return serve("api.coinpaprika.com", "coinpaprika_ticker.json");
+}
+static bool setupPriceKraken() {
+  refuse("/simple/price");
+  refuse("api.coinpaprika.com");
+  return serve("/public/Ticker", "kraken_ticker.json");
+}
+static bool setupPriceBinance() {
+  refuse("/simple/price");
+  refuse("api.coinpaprika.com");
+  refuse("/public/Ticker");
+  return serve("/ticker/24hr", "binance_ticker_24hr.json");
+}
+static bool runPriceCoingecko() { return fetchPriceIs("CoinGecko"); }
+static bool runPricePaprika()   { return fetchPriceIs("Paprika"); }
+static bool runPriceKraken()    { return fetchPriceIs("Kraken"); }
+static bool runPriceBinance()   { return fetchPriceIs("Binance"); }
+
+// History bootstrap: full cycle parse into the chart and rolling-mean buffers
+// (CoinGecko -> Binance -> Kraken).
+static bool setupHistoryCoingecko() {
+  return serve("/market_chart", "coingecko_market_chart.json");
+}
+static bool setupHistoryBinance() {
+  refuse("/market_chart");
+  return serve("/klines", "binance_klines.json");
+}
+static bool setupHistoryKraken() {
+  refuse("/market_chart");
+  refuse("/klines");
+  return serve("/public/OHLC", "kraken_ohlc.json");
+}
+// Low-memory mode: the in-place scan instead of the filtered 16 KB document.
+static bool setupHistoryCoingeckoLowmem() {
+  heapMonitorForceDegrade(true);
+  return serve("/market_chart", "coingecko_market_chart.json");
+}
+static bool runHistoryCoingecko() { return historyIs("CoinGecko"); }
+static bool runHistoryBinance()   { return historyIs("Binance"); }
+static bool runHistoryKraken()    { return historyIs("Kraken"); }
+
+static bool setupFx() { return serve("open.er-api.com", "open_er_api_usd.json"); }
+static bool runFx() {
+  for (int c = 0; c < (int)CURR_COUNT; ++c) g_usdToRate[c] = 0;
+  return fetchExchangeRates() && fabs(g_usdToRate[CURR_TWD] - 31.512) < 1e-9;
+}
+
+// A whole cycle of 30 s price updates on the virtual clock: 2880 calls that
+// collapse into 288 five-minute buckets.
+static const uint32_t kDayUpdates = 24 * 3600 / 30;
+
+static bool setupNoop() { return true; }
+static bool runChartBucketDay() {
+  hostClockSetUtc(kBenchCycleStartUtc);
+  g_chartSampleCount = 0;
+  for (uint32_t i = 0; i < kDayUpdates; ++i) {
+    addChartSampleForNow(kFixturePriceUsd + 0.0001 * (i % 17));
+    hostClockAdvanceMs(30 * 1000);
+  }
+  return g_chartSampleCount == 288;
+}
+
+static bool runDayAvgRolling() {
+  dayAvgRollingReset();
+  time_t t = kBenchCycleStartUtc;
+  for (uint32_t i = 0; i < kDayUpdates; ++i, t += 30) {
+    dayAvgRollingAdd(t, kFixturePriceUsd + 0.0001 * (i % 17));
+  }
+  double mean = 0;
+  return dayAvgRollingGet(t, mean) && dayAvgRollingCount() == 288 && mean > 0;
+}
+
+static bool setupDayAvgCycle() {
+  hostClockSetUtc(kBenchCycleStartUtc);
+  return runChartBucketDay();
+}
+static bool runDayAvgCycle() {
+  double mean = 0;
+  return dayAvgCycleMean(mean) && mean > 0;
+}
+
+// Tick scheduler: reschedule at every second of an hour for the current
+// preset, as after wake-ups, menu exits and NTP syncs.
+static bool runTickScheduler() {
+  bool ok = true;
+  time_t t0 = kBenchNowUtc;
+  for (uint32_t s = 0; s < 3600; ++s) {
+    hostClockSetUtc(t0 + (time_t)s);
+    tickSchedulerReset("bench");
+    ok &= g_nextUpdateUtc > t0 + (time_t)s && (g_nextUpdateUtc % (time_t)updateIntervalSec()) == 0;
+  }
+  return ok;
+}
+
+static bool runSettingsRoundTrip() {
+  StoredSettings in;
+  in.updPreset  = 3;
+  in.briPreset  = 2;
+  in.coinTicker = "XRP";
+  in.timeFmt    = 0;
+  in.tzIndex    = 5;
+  in.dispCur    = (int)CURR_TWD;
+  if (!settingsStoreSave(in)) return false;
+
+  StoredSettings out;
+  if (!settingsStoreLoad(out)) return false;
+  return out.updPreset == in.updPreset && out.briPreset == in.briPreset &&
+         out.coinTicker == in.coinTicker && out.timeFmt == in.timeFmt &&
+         out.tzIndex == in.tzIndex && out.dispCur == in.dispCur;
+}
+
+static const BenchCase kCases[] = {
+  { "price_coingecko",    setupPriceCoingecko,   runPriceCoingecko,    1 },
+  { "price_paprika",      setupPricePaprika,     runPricePaprika,      1 },
+  { "price_kraken",       setupPriceKraken,      runPriceKraken,       1 },
+  { "price_binance",      setupPriceBinance,     runPriceBinance,      1 },
+  { "history_coingecko",  setupHistoryCoingecko, runHistoryCoingecko,  1 },
+  { "history_cg_lowmem",  setupHistoryCoingeckoLowmem, runHistoryCoingecko, 1 },
+  { "history_binance",    setupHistoryBinance,   runHistoryBinance,    1 },
+  { "history_kraken",     setupHistoryKraken,    runHistoryKraken,     1 },
+  { "fx_rates",           setupFx,               runFx,                1 },
+  { "chart_bucket_day",   setupNoop,             runChartBucketDay,    kDayUpdates },
+  { "day_avg_rolling",    setupNoop,             runDayAvgRolling,     kDayUpdates },
+  { "day_avg_cycle",      setupDayAvgCycle,      runDayAvgCycle,       1 },
+  { "tick_scheduler",     setupNoop,             runTickScheduler,     3600 },
+  { "settings_roundtrip", setupNoop,             runSettingsRoundTrip, 1 },
+};
+static const int kCaseCount = sizeof(kCases) / sizeof(kCases[0]);
+
+struct BenchResult {
+  bool     ran;
+  bool     ok;        // every run passed its sanity check
+  uint32_t runs;
+  double   meanUs;    // host time per run
+  double   minUs;
+  double   httpBytes; // response bytes parsed per run
+};
+
+static BenchResult runCase(const BenchCase& c, int iterations, bool verbose) {
+  BenchResult r;
+  memset(&r, 0, sizeof(r));
+  r.ran = true;
+
+  hostHttpClearRoutes();
+  hostPrefsClear();
+  resetAppState();
+  hostSerialSetMuted(!verbose);
+  r.ok = c.setup();
+  r.ok &= c.run();  // warm-up (also the verbose run)
+  hostSerialSetMuted(true);
+
+  hostHttpResetStats();
+  double total = 0;
+  r.minUs = 1e30;
+  for (int i = 0; i < iterations; ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    bool ok = c.run();
+    auto t1 = std::chrono::steady_clock::now();
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    total += us;
+    if (us < r.minUs) r.minUs = us;
+    r.ok &= ok;
+  }
+  hostSerialSetMuted(false);
+
+  r.runs      = (uint32_t)iterations;
+  r.meanUs    = total / iterations;
+  r.httpBytes = (double)hostHttpStats().bytes / iterations;
+  return r;
+}
+
+// ==================== Soak =====================
+// Steady-state firmware traffic on the virtual clock: a CoinGecko price every
+// 30 s tick, FX every hour, the history bootstrap once a day.
+
+static const uint32_t kSoakTickSec      = 30;
+static const uint32_t kSoakFxTicks      = 3600 / kSoakTickSec;
+static const uint32_t kSoakHistoryTicks = 24 * 3600 / kSoakTickSec;
+
+static bool runSoak(uint32_t ticks, const char* historyApi, bool verbose) {
+  hostHttpClearRoutes();
+  resetAppState();
+  serve("/simple/price", "coingecko_simple_price.json");
+  serve("open.er-api.com", "open_er_api_usd.json");
+  bool routed;
+  if (!strcmp(historyApi, "binance"))     routed = setupHistoryBinance();
+  else if (!strcmp(historyApi, "kraken")) routed = setupHistoryKraken();
+  else                                    routed = setupHistoryCoingecko();
+  if (!routed) {
+    fprintf(stderr, "[Native] No history fixture for %s\n", historyApi);
+    return false;
+  }
+  hostSerialSetMuted(!verbose);
+
+  JsonArenaStats before;
+  jsonArenaGetStats(before);
+  const uint64_t newBefore = s_newCount;
+  uint32_t failures = 0;
+  uint32_t historyRuns = 0, historyOk = 0;  // the fixtures only chart the first cycle
+  for (uint32_t t = 0; t < ticks; ++t) {
+    double price = 0, change = 0;
+    if (!fetchPrice(price, change)) failures++;
+    if (t % kSoakFxTicks == 0 && !fetchExchangeRates()) failures++;
+    if (t % kSoakHistoryTicks == 0) {
+      g_currentHistoryApi = "";
+      bootstrapHistoryFromKrakenOHLC();
+      historyRuns++;
+      if (g_currentHistoryApi[0]) historyOk++;
+    }
+    hostClockAdvanceMs(kSoakTickSec * 1000);
+  }
+  JsonArenaStats after;
+  jsonArenaGetStats(after);
+  hostSerialSetMuted(false);
+
+  const uint32_t jsonHeap = after.heapFallbacks - before.heapFallbacks;
+  printf("## Soak: %lu ticks of %lu s (FX every %lu, history every %lu from %s)\n\n",
+         (unsigned long)ticks, (unsigned long)kSoakTickSec,
+         (unsigned long)kSoakFxTicks, (unsigned long)kSoakHistoryTicks, historyApi);
+  printf("| metric | value |\n|---|---:|\n");
+  printf("| heap allocations / tick (operator new) | %.1f |\n", (double)(s_newCount - newBefore) / ticks);
+  printf("| JSON arena blocks / tick | %.1f |\n", (double)(after.allocations - before.allocations) / ticks);
+  printf("| JSON heap fallbacks | %lu |\n", (unsigned long)jsonHeap);
+  printf("| JSON arena high water | %lu / %lu B |\n", (unsigned long)after.highWater, (unsigned long)after.capacity);
+  printf("| history bootstraps charted | %lu / %lu |\n", (unsigned long)historyOk, (unsigned long)historyRuns);
+  printf("| failed fetches | %lu |\n", (unsigned long)failures);
+  return jsonHeap == 0 && failures == 0 && historyOk > 0;
+}
+
+// ==================== HTTP client =====================
+// One URL fetched through LiteHttp (fixed buffers, body drained in 1 KB reads,
+// as the parsers consume it), once offering compression through a NetInflate
+// with the firmware's window, and through the HTTPClient shim (GET +
+// getString()). Wall clock; allocations counted by the global operator new.
+
+struct HttpRun {
+  const char* client;
+  uint32_t    failures;
+  uint64_t    bodyBytes;
+  uint64_t    wireBytes;  // body bytes received (compressed size when inflating)
+  uint64_t    allocations;
+  double      seconds;
+};
+
+static HttpRun runHttpLite(const char* url, int iterations, NetInflate* inflate) {
+  static char buf[1024];
+  static char sink[1024];
+  static const LiteHttpTimeouts kTimeouts = { 5000, 8000, 8000 };
+  LiteHttp http(netSocketDefault(), buf, sizeof(buf));
+
+  HttpRun r = { inflate ? "lite_http+inflate" : "lite_http", 0, 0, 0, 0, 0 };
+  const uint64_t newBefore = s_newCount;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    int code = http.get(url, kTimeouts, inflate);
+    size_t n;
+    while ((n = http.readBytes(sink, sizeof(sink))) > 0) r.bodyBytes += n;
+    r.wireBytes += http.wireBytes();
+    if (code != 200 || http.bodyError() != 0) r.failures++;
+    http.end();
+  }
+  r.seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  r.allocations = s_newCount - newBefore;
+  return r;
+}
+
+static HttpRun runHttpClient(const char* url, int iterations) {
+  HttpRun r = { "HTTPClient", 0, 0, 0, 0, 0 };
+  const uint64_t newBefore = s_newCount;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    HTTPClient http;
+    http.begin(url);
+    http.setTimeout(8000);
+    int code = http.GET();
+    if (code == 200) {
+      const size_t len = http.getString().length();
+      r.bodyBytes += len;
+      r.wireBytes += len;  // no Accept-Encoding: identity
+    } else {
+      r.failures++;
+    }
+    http.end();
+  }
+  r.seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  r.allocations = s_newCount - newBefore;
+  return r;
+}
+
+static bool runHttp(const char* url, int iterations) {
+  static uint8_t window[NET_INFLATE_WINDOW_BYTES];
+  static NetInflate inflate(window, sizeof(window));
+  const HttpRun runs[3] = { runHttpLite(url, iterations, nullptr), runHttpLite(url, iterations, &inflate),
+                            runHttpClient(url, iterations) };
+  printf("## HTTP GET %s, %d requests/client\n\n", url, iterations);
+  printf("| client | MB/s | ms/request | body B/request | wire B/request | allocations/request | failures |\n");
+  printf("|---|---:|---:|---:|---:|---:|---:|\n");
+  bool ok = true;
+  for (const HttpRun& r : runs) {
+    printf("| %s | %.1f | %.3f | %.0f | %.0f | %.1f | %lu |\n", r.client,
+           r.seconds > 0 ? (double)r.bodyBytes / r.seconds / 1e6 : 0.0,
+           r.seconds * 1000.0 / iterations, (double)r.bodyBytes / iterations,
+           (double)r.wireBytes / iterations, (double)r.allocations / iterations, (unsigned long)r.failures);
+    ok &= r.failures == 0;
+  }
+  return ok;
+}
+
+// ==================== Report =====================
+
+static void printReport(const BenchResult* results, int iterations) {
+  printf("\n## CryptoBar %s core logic benchmark (host)\n\n", CRYPTOBAR_VERSION);
+#ifdef CRYPTOBAR_API_BASE
+  printf("%d runs/case, virtual clock at %ld, live: %s\n\n", iterations, (long)kBenchNowUtc, CRYPTOBAR_API_BASE);
+#else
+  printf("%d runs/case, virtual clock at %ld, fixtures: %s\n\n", iterations, (long)kBenchNowUtc, s_fixtureDir);
+#endif
+  printf("| case | ops/run | mean us/run | min us/run | ns/op | http B/run | check |\n");
+  printf("|---|---:|---:|---:|---:|---:|---|\n");
+  for (int i = 0; i < kCaseCount; ++i) {
+    const BenchResult& r = results[i];
+    if (!r.ran) continue;
+    printf("| %s | %lu | %.2f | %.2f | %.1f | %.0f | %s |\n",
+           kCases[i].name, (unsigned long)kCases[i].opsPerRun, r.meanUs, r.minUs,
+           r.meanUs * 1000.0 / kCases[i].opsPerRun, r.httpBytes, r.ok ? "ok" : "FAIL");
+  }
+}
+
+static bool appendCsv(const char* path, const BenchResult* results) {
+  FILE* f = fopen(path, "a+");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  if (ftell(f) == 0) {
+    fprintf(f, "version,case,runs,ops_per_run,mean_us,min_us,ns_per_op,http_bytes,ok\n");
+  }
+  for (int i = 0; i < kCaseCount; ++i) {
+    const BenchResult& r = results[i];
+    if (!r.ran) continue;
+    fprintf(f, "%s,%s,%lu,%lu,%.2f,%.2f,%.1f,%.0f,%d\n",
+            CRYPTOBAR_VERSION, kCases[i].name, (unsigned long)r.runs, (unsigned long)kCases[i].opsPerRun,
+            r.meanUs, r.minUs, r.meanUs * 1000.0 / kCases[i].opsPerRun, r.httpBytes, r.ok ? 1 : 0);
+  }
+  fclose(f);
+  return true;
+}
+
+// The fixtures run on the virtual clock; trace in wall time instead.
+static uint32_t wallMicros() {
+  static const auto s_t0 = std::chrono::steady_clock::now();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_t0).count();
+}
+
+static bool fileSink(const uint8_t* data, size_t len, void* ctx) {
+  return fwrite(data, 1, len, (FILE*)ctx) == len;
+}
+
+static bool writeTrace(const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  size_t n = traceExport(fileSink, f);
+  bool ok = fclose(f) == 0 && n > 0;
+  if (ok) printf("[Native] Trace: %zu bytes -> %s\n", n, path);
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  int iterations = 200;
+  const char* filter = nullptr;
+  const char* csvPath = nullptr;
+  const char* tracePath = nullptr;
+  const char* httpUrl = nullptr;
+  uint32_t soakTicks = 0;
+  const char* soakHistory = "coingecko";
+  bool verbose = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--iter") && i + 1 < argc)           iterations = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--filter") && i + 1 < argc)    filter = argv[++i];
+    else if (!strcmp(argv[i], "--fixtures") && i + 1 < argc)  s_fixtureDir = argv[++i];
+    else if (!strcmp(argv[i], "--csv") && i + 1 < argc)       csvPath = argv[++i];
+    else if (!strcmp(argv[i], "--trace") && i + 1 < argc)     tracePath = argv[++i];
+    else if (!strcmp(argv[i], "--soak") && i + 1 < argc)      soakTicks = (uint32_t)atol(argv[++i]);
+    else if (!strcmp(argv[i], "--soak-history") && i + 1 < argc) soakHistory = argv[++i];
+    else if (!strcmp(argv[i], "--http") && i + 1 < argc)      httpUrl = argv[++i];
+    else if (!strcmp(argv[i], "--verbose"))                   verbose = true;
+    else {
+      fprintf(stderr, "usage: %s [--iter N] [--filter TEXT] [--fixtures DIR] [--csv FILE] [--trace FILE] [--soak TICKS]\n"
+                      "          [--soak-history API] [--http URL] [--verbose]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (iterations < 1) iterations = 1;
+
+  hostWiFiSetConnected(true);
+  jsonArenaBegin();
+  if (tracePath) {
+    traceSetClock(wallMicros);
+    traceBegin();
+  }
+  if (soakTicks > 0) return runSoak(soakTicks, soakHistory, verbose) ? 0 : 1;
+  if (httpUrl) return runHttp(httpUrl, iterations) ? 0 : 1;
+
+  BenchResult results[kCaseCount];
+  memset(results, 0, sizeof(results));
+  bool allOk = true;
+  for (int i = 0; i < kCaseCount; ++i) {
+    if (filter && !strstr(kCases[i].name, filter)) continue;
+    results[i] = runCase(kCases[i], iterations, verbose);
+    allOk &= results[i].ok;
+  }
+
+  printReport(results, iterations);
+  if (csvPath && !appendCsv(csvPath, results)) {
+    fprintf(stderr, "[Native] Cannot write %s\n", csvPath);
+    return 1;
+  }
+  if (tracePath && !writeTrace(tracePath)) {
+    fprintf(stderr, "[Native] Cannot write %s\n", tracePath);
+    return 1;
+  }
+  return allOk ? 0 : 1;
+}
@@ -0,0 +1,688 @@
+// CryptoBar V0.99s (Host replay server)
+// replay_server.cpp - Serves recorded API responses to CRYPTOBAR_API_BASE builds, with fault injection
+//
+// Usage: replay_server [--port N] [--routes FILE] [--latency MS] [--jitter MS]
+//                      [--p429 P] [--ptruncate P] [--ptimeout P] [--hold MS]
+//                      [--fault-only TEXT] [--seed N] [--quiet]
+//                      [--capture FILE [--capture-timing]] [--trace FILE] [--chunked BYTES]
+//                      [--gzip] [--kbps N] [--etag] [--max-age S]
+//   --port N          listen port (default 8787, all interfaces so a device can reach it)
+//   --routes FILE     route manifest (default host/replay/routes.txt; with --capture,
+//                     only loaded when given explicitly, as a fallback)
+//   --capture FILE    serve a device capture (.cbcap from the maintenance page); a URL
+//                     captured several times is served in capture order, then wraps
+//   --capture-timing  replay each captured response's own GET + body time as latency
+//   --latency MS      delay before every response (default 0)
+//   --jitter MS       add a uniform 0..MS to the delay (default 0)
+//   --p429 P          probability of "429 Too Many Requests" instead of the recording
+//   --ptruncate P     probability of sending half the body, then closing
+//   --ptimeout P      probability of accepting the request and never answering
+//   --hold MS         how long a timed-out request is held open (default 30000)
+//   --fault-only TEXT inject faults only into URLs containing TEXT
+//   --seed N          fault RNG seed (default 1; same seed = same fault sequence)
+//   --quiet           no per-request log
+//   --trace FILE      on exit, write every request as a Chrome Trace Event JSON span
+//                     (same format as the device's /trace.json)
+//   --chunked BYTES   send bodies with Transfer-Encoding: chunked in BYTES-sized chunks
+//                     (as CoinGecko / Binance do) instead of Content-Length
+//   --gzip            compress bodies (gzip, else deflate) for requests that accept it
+//   --kbps N          limit each response to N kbit/s (a weak 2.4 GHz link: ~500-2000)
+//   --etag            send an ETag per recording; answer 304 to a matching If-None-Match
+//   --max-age S       send Cache-Control: max-age=S
+//
+// Plain HTTP/1.1, one thread per connection, Connection: close. POSIX only.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <zlib.h>
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // macOS: SIGPIPE is ignored in main() instead
+#endif
+
+// ==================== Routes =====================
+
+struct ReplayRoute {
+  std::string pattern;
+  std::string body;
+  int         status;
+  int         latencyMs;  // added to the global latency
+  size_t      group = 1;  // captures: this + the next group-1 routes share the pattern
+  mutable size_t cursor = 0;
+};
+
+struct ReplayConfig {
+  int         port = 8787;
+  const char* routesPath = "host/replay/routes.txt";
+  bool        routesGiven = false;
+  const char* capturePath = nullptr;
+  bool        captureTiming = false;
+  int         latencyMs = 0;
+  int         jitterMs = 0;
+  double      p429 = 0;
+  double      pTruncate = 0;
+  double      pTimeout = 0;
+  int         holdMs = 30000;
+  const char* faultOnly = nullptr;
+  unsigned    seed = 1;
+  bool        quiet = false;
+  const char* tracePath = nullptr;
+  size_t      chunkBytes = 0;  // 0: Content-Length framing
+  bool        gzip = false;
+  int         kbps = 0;        // 0: unlimited
+  bool        etag = false;
+  int         maxAgeS = -1;    // -1: no Cache-Control
+};
+
+static ReplayConfig s_cfg;
+static std::vector<ReplayRoute> s_routes;
+
+// '*' matches any run of characters; everything else is literal.
+static bool globMatch(const char* pat, const char* s) {
+  if (*pat == '\0') return *s == '\0';
+  if (*pat == '*') {
+    for (;; ++s) {
+      if (globMatch(pat + 1, s)) return true;
+      if (*s == '\0') return false;
+    }
+  }
+  return *s == *pat && globMatch(pat + 1, s + 1);
+}
+
+static bool readFile(const std::string& path, std::string& out) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  out.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+static bool loadRoutes(const char* path) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "[Replay] Cannot open %s\n", path);
+    return false;
+  }
+  std::string dir(path);
+  size_t slash = dir.find_last_of('/');
+  dir = (slash == std::string::npos) ? std::string() : dir.substr(0, slash + 1);
+
+  char line[1024];
+  int lineNo = 0;
+  bool ok = true;
+  while (fgets(line, sizeof(line), f)) {
+    ++lineNo;
+    char* tok[6];
+    int n = 0;
+    for (char* t = strtok(line, " \t\r\n"); t && n < 6; t = strtok(nullptr, " \t\r\n")) tok[n++] = t;
+    if (n == 0 || tok[0][0] == '#') continue;
+    if (n < 2) {
+      fprintf(stderr, "[Replay] %s:%d: expected <pattern> <file>\n", path, lineNo);
+      ok = false;
+      continue;
+    }
+
+    ReplayRoute r;
+    r.pattern = tok[0];
+    r.status = 200;
+    r.latencyMs = 0;
+    for (int i = 2; i < n; ++i) {
+      if (!strncmp(tok[i], "status=", 7))       r.status = atoi(tok[i] + 7);
+      else if (!strncmp(tok[i], "latency=", 8)) r.latencyMs = atoi(tok[i] + 8);
+      else fprintf(stderr, "[Replay] %s:%d: unknown option %s\n", path, lineNo, tok[i]);
+    }
+    std::string file = (tok[1][0] == '/') ? std::string(tok[1]) : dir + tok[1];
+    if (!readFile(file, r.body)) {
+      fprintf(stderr, "[Replay] %s:%d: cannot read %s\n", path, lineNo, file.c_str());
+      ok = false;
+      continue;
+    }
+    s_routes.push_back(r);
+  }
+  fclose(f);
+  return ok && !s_routes.empty();
+}
+
+static std::mutex s_cursorMutex;
+
+static const ReplayRoute* findRoute(const std::string& target) {
+  for (size_t i = 0; i < s_routes.size(); i += s_routes[i].group) {
+    const ReplayRoute& r = s_routes[i];
+    if (!globMatch(r.pattern.c_str(), target.c_str())) continue;
+    if (r.group == 1) return &r;
+    std::lock_guard<std::mutex> lock(s_cursorMutex);
+    return &s_routes[i + (r.cursor++ % r.group)];
+  }
+  return nullptr;
+}
+
+// ==================== Device captures =====================
+
+// Mirrors NetCaptureHeader in include/net_capture.h (44 bytes, little-endian).
+struct CaptureHeader {
+  uint32_t magic;
+  uint32_t seq;
+  uint32_t utc;
+  uint32_t uptimeMs;
+  int32_t  httpCode;
+  uint16_t flags;
+  uint16_t urlLen;
+  uint32_t bodyLen;
+  uint32_t fullLen;
+  uint32_t headMs;
+  uint32_t bodyMs;
+  uint32_t crc;
+};
+static_assert(sizeof(CaptureHeader) == 44, "capture header layout");
+
+static const uint32_t kCaptureMagic = 0x31434243UL;  // "CBC1"
+static const uint16_t kCaptureTruncated = 0x0001;
+
+// CRC-32 (IEEE), same as the ESP32 ROM crc32_le(0, ...) used on the device.
+static uint32_t crc32Update(uint32_t crc, const uint8_t* p, size_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320UL & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+// The firmware's URL minus the scheme is the path a CRYPTOBAR_API_BASE build requests.
+static std::string capturePathFor(const std::string& url) {
+  size_t p = url.find("://");
+  return "/" + (p == std::string::npos ? url : url.substr(p + 3));
+}
+
+static bool loadCapture(const char* path) {
+  std::string data;
+  if (!readFile(path, data)) {
+    fprintf(stderr, "[Replay] Cannot open %s\n", path);
+    return false;
+  }
+
+  std::vector<ReplayRoute> recs;
+  size_t off = 0, bad = 0, truncated = 0;
+  while (off + sizeof(CaptureHeader) <= data.size()) {
+    CaptureHeader h;
+    memcpy(&h, data.data() + off, sizeof(h));
+    if (h.magic != kCaptureMagic) {
+      fprintf(stderr, "[Replay] %s: bad record magic at offset %zu, stopping\n", path, off);
+      break;
+    }
+    size_t len = sizeof(h) + h.urlLen + (size_t)h.bodyLen;
+    if (off + len > data.size()) {
+      fprintf(stderr, "[Replay] %s: record at offset %zu runs past the end\n", path, off);
+      break;
+    }
+    const uint8_t* payload = (const uint8_t*)data.data() + off + sizeof(h);
+    if (crc32Update(0, payload, h.urlLen + (size_t)h.bodyLen) != h.crc) {
+      ++bad;
+    } else {
+      ReplayRoute r;
+      r.pattern   = capturePathFor(std::string((const char*)payload, h.urlLen));
+      r.body.assign((const char*)payload + h.urlLen, h.bodyLen);
+      r.status    = h.httpCode;  // <= 0: transport error, the connection is dropped
+      r.latencyMs = s_cfg.captureTiming ? (int)(h.headMs + h.bodyMs) : 0;
+      if (h.flags & kCaptureTruncated) ++truncated;
+      recs.push_back(r);
+    }
+    off += len;
+  }
+
+ // Group repeats of a URL (capture order kept) ahead of any manifest routes.
+  std::vector<ReplayRoute> grouped;
+  std::vector<bool> used(recs.size(), false);
+  for (size_t i = 0; i < recs.size(); ++i) {
+    if (used[i]) continue;
+    size_t first = grouped.size();
+    for (size_t j = i; j < recs.size(); ++j) {
+      if (used[j] || recs[j].pattern != recs[i].pattern) continue;
+      used[j] = true;
+      grouped.push_back(recs[j]);
+    }
+    grouped[first].group = grouped.size() - first;
+  }
+  s_routes.insert(s_routes.begin(), grouped.begin(), grouped.end());
+
+  printf("[Replay] %zu capture record(s) from %s (%zu CRC errors skipped, %zu truncated bodies)\n",
+         recs.size(), path, bad, truncated);
+  return !recs.empty();
+}
+
+// ==================== Faults =====================
+
+enum ReplayOutcome {
+  OUT_OK,
+  OUT_NOT_FOUND,
+  OUT_429,
+  OUT_TRUNCATED,
+  OUT_TIMEOUT,
+  OUT_BAD_REQUEST,
+  OUT_DROPPED,
+  OUT_NOT_MODIFIED,
+  OUT_COUNT
+};
+
+static const char* kOutcomeNames[OUT_COUNT] = { "ok", "404", "429", "truncated", "timeout", "bad-request", "dropped",
+                                                "304" };
+
+static std::atomic<uint32_t> s_outcomes[OUT_COUNT];
+static std::atomic<bool> s_stop(false);
+
+static std::mutex   s_rngMutex;
+static std::mt19937 s_rng;
+
+// One draw per request in arrival order, so a seed reproduces a fault sequence.
+static void drawFaults(const std::string& target, int& delayMs, ReplayOutcome& fault) {
+  std::lock_guard<std::mutex> lock(s_rngMutex);
+  std::uniform_real_distribution<double> u(0.0, 1.0);
+  double roll = u(s_rng);
+  delayMs = s_cfg.latencyMs + (s_cfg.jitterMs > 0 ? (int)(u(s_rng) * (s_cfg.jitterMs + 1)) : 0);
+
+  fault = OUT_OK;
+  if (s_cfg.faultOnly && target.find(s_cfg.faultOnly) == std::string::npos) return;
+  if (roll < s_cfg.pTimeout) fault = OUT_TIMEOUT;
+  else if (roll < s_cfg.pTimeout + s_cfg.p429) fault = OUT_429;
+  else if (roll < s_cfg.pTimeout + s_cfg.p429 + s_cfg.pTruncate) fault = OUT_TRUNCATED;
+}
+
+// ==================== Trace =====================
+// One complete ("X") event per request. Concurrent requests get separate lanes
+// (tids) so spans on one lane never overlap.
+
+struct TraceSpan {
+  uint64_t    startUs;
+  uint64_t    durUs;
+  int         lane;
+  std::string target;
+  const char* outcome;
+  size_t      bytes;
+};
+
+static const auto s_traceT0 = std::chrono::steady_clock::now();
+static std::mutex             s_traceMutex;
+static std::vector<TraceSpan> s_traceSpans;
+static std::vector<bool>      s_traceLanes;  // busy flags
+
+static uint64_t traceNowUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_traceT0).count();
+}
+
+static int traceLaneAcquire() {
+  std::lock_guard<std::mutex> lock(s_traceMutex);
+  for (size_t i = 0; i < s_traceLanes.size(); ++i) {
+    if (!s_traceLanes[i]) {
+      s_traceLanes[i] = true;
+      return (int)i;
+    }
+  }
+  s_traceLanes.push_back(true);
+  return (int)s_traceLanes.size() - 1;
+}
+
+static void traceLaneRelease(TraceSpan&& span) {
+  std::lock_guard<std::mutex> lock(s_traceMutex);
+  s_traceLanes[span.lane] = false;
+  s_traceSpans.push_back(std::move(span));
+}
+
+static std::string jsonEscape(const std::string& in) {
+  std::string out;
+  for (char c : in) {
+    if (c == '"' || c == '\\') out += '\\';
+    if ((unsigned char)c >= 0x20) out += c;
+  }
+  return out;
+}
+
+static bool writeTrace(const char* path) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  std::lock_guard<std::mutex> lock(s_traceMutex);
+  fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  fprintf(f, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"replay_server\"}}");
+  for (size_t i = 0; i < s_traceLanes.size(); ++i) {
+    fprintf(f, ",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%zu,\"args\":{\"name\":\"conn %zu\"}}", i, i);
+  }
+  for (const TraceSpan& sp : s_traceSpans) {
+    std::string path = sp.target.substr(0, sp.target.find('?'));
+    fprintf(f, ",{\"name\":\"%s\",\"cat\":\"replay\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":0,\"tid\":%d,"
+               "\"args\":{\"outcome\":\"%s\",\"bytes\":%zu,\"url\":\"%s\"}}",
+            jsonEscape(path.empty() ? "-" : path).c_str(), (unsigned long long)sp.startUs, (unsigned long long)sp.durUs,
+            sp.lane, sp.outcome, sp.bytes, jsonEscape(sp.target).c_str());
+  }
+  fprintf(f, "]}\n");
+  bool ok = !ferror(f);
+  ok &= fclose(f) == 0;
+  if (ok) printf("[Replay] Trace: %zu request(s) -> %s\n", s_traceSpans.size(), path);
+  return ok;
+}
+
+// ==================== HTTP =====================
+
+// With --kbps, sends in 1 KB slices paced to the link rate.
+static bool sendAll(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    const size_t slice = (s_cfg.kbps > 0) ? std::min(len, (size_t)1024) : len;
+    ssize_t n = send(fd, data, slice, MSG_NOSIGNAL);
+    if (n <= 0) return false;
+    if (s_cfg.kbps > 0) std::this_thread::sleep_for(std::chrono::microseconds((int64_t)n * 8000 / s_cfg.kbps));
+    data += n;
+    len -= (size_t)n;
+  }
+  return true;
+}
+
+enum ReplayEncoding { ENC_IDENTITY, ENC_GZIP, ENC_DEFLATE };
+
+static const char* kEncodingHeaders[] = { nullptr, "Content-Encoding: gzip\r\n", "Content-Encoding: deflate\r\n" };
+
+// Value of a request header (name in lower case), trimmed; "" if absent.
+static std::string requestHeader(const std::string& head, const char* name) {
+  std::string lower(head);
+  for (char& c : lower) c = (char)tolower((unsigned char)c);
+  size_t at = lower.find(std::string("\r\n") + name + ":");
+  if (at == std::string::npos) return "";
+  at += 3 + strlen(name);
+  while (at < head.size() && (head[at] == ' ' || head[at] == '\t')) at++;
+  return head.substr(at, head.find("\r\n", at) - at);
+}
+
+// With --gzip: the best encoding the request's Accept-Encoding offers.
+static ReplayEncoding pickEncoding(const std::string& head) {
+  if (!s_cfg.gzip) return ENC_IDENTITY;
+  std::string value = requestHeader(head, "accept-encoding");
+  for (char& c : value) c = (char)tolower((unsigned char)c);
+  if (value.find("gzip") != std::string::npos) return ENC_GZIP;
+  if (value.find("deflate") != std::string::npos) return ENC_DEFLATE;
+  return ENC_IDENTITY;
+}
+
+// With --etag: a strong validator derived from the recording (FNV-1a).
+static std::string etagFor(const std::string& body) {
+  uint32_t h = 2166136261u;
+  for (unsigned char c : body) h = (h ^ c) * 16777619u;
+  char tag[16];
+  snprintf(tag, sizeof(tag), "\"%08x\"", h);
+  return tag;
+}
+
+// zlib level 6 with a 32 KB window, as web servers compress by default.
+static std::string compressBody(const std::string& in, ReplayEncoding enc) {
+  z_stream z;
+  memset(&z, 0, sizeof(z));
+  if (deflateInit2(&z, 6, Z_DEFLATED, enc == ENC_GZIP ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK) return in;
+  std::string out(deflateBound(&z, in.size()), '\0');
+  z.next_in   = (Bytef*)in.data();
+  z.avail_in  = (uInt)in.size();
+  z.next_out  = (Bytef*)&out[0];
+  z.avail_out = (uInt)out.size();
+  deflate(&z, Z_FINISH);
+  out.resize(z.total_out);
+  deflateEnd(&z);
+  return out;
+}
+
+static const char* reasonPhrase(int status) {
+  switch (status) {
+    case 200: return "OK";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 503: return "Service Unavailable";
+    default:  return "Status";
+  }
+}
+
+static void sendResponse(int fd, int status, const std::string& body, size_t bodyBytesToSend, const char* extraHeaders) {
+  if (bodyBytesToSend > body.size()) bodyBytesToSend = body.size();
+  const bool chunked = s_cfg.chunkBytes > 0;
+  char head[256];
+  char framing[64];
+  if (chunked) snprintf(framing, sizeof(framing), "Transfer-Encoding: chunked\r\n");
+  else         snprintf(framing, sizeof(framing), "Content-Length: %zu\r\n", body.size());
+  int n = snprintf(head, sizeof(head),
+                   "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n%s%sConnection: close\r\n\r\n",
+                   status, reasonPhrase(status), framing, extraHeaders ? extraHeaders : "");
+  if (!sendAll(fd, head, (size_t)n)) return;
+  if (!chunked) {
+    sendAll(fd, body.data(), bodyBytesToSend);
+    return;
+  }
+  // A truncated body stops mid-chunk, without the terminating 0-size chunk.
+  for (size_t off = 0; off < body.size(); off += s_cfg.chunkBytes) {
+    const size_t len = std::min(s_cfg.chunkBytes, body.size() - off);
+    n = snprintf(head, sizeof(head), "%zx\r\n", len);
+    if (!sendAll(fd, head, (size_t)n)) return;
+    if (off + len > bodyBytesToSend) {
+      sendAll(fd, body.data() + off, bodyBytesToSend - off);
+      return;
+    }
+    if (!sendAll(fd, body.data() + off, len) || !sendAll(fd, "\r\n", 2)) return;
+  }
+  sendAll(fd, "0\r\n\r\n", 5);
+}
+
+// Reads the request head; returns false on EOF, overflow or a 10 s stall.
+static bool readRequestHead(int fd, std::string& head) {
+  char buf[1024];
+  head.clear();
+  while (head.find("\r\n\r\n") == std::string::npos) {
+    pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, 10000) <= 0) return false;
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) return false;
+    head.append(buf, (size_t)n);
+    if (head.size() > 8192) return false;
+  }
+  return true;
+}
+
+// Waits until the client gives up (closes) or the hold time ends.
+static void holdOpen(int fd) {
+  char buf[256];
+  auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(s_cfg.holdMs);
+  while (!s_stop && std::chrono::steady_clock::now() < until) {
+    pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, 200) > 0 && recv(fd, buf, sizeof(buf), 0) <= 0) return;
+  }
+}
+
+static void handleConnection(int fd) {
+  auto t0 = std::chrono::steady_clock::now();
+  const uint64_t traceStartUs = traceNowUs();
+  const int      lane = s_cfg.tracePath ? traceLaneAcquire() : -1;
+  std::string head;
+  ReplayOutcome outcome = OUT_BAD_REQUEST;
+  std::string target;
+  size_t sent = 0;
+
+  if (readRequestHead(fd, head)) {
+    char method[16] = {0};
+    char path[2048] = {0};
+    if (sscanf(head.c_str(), "%15s %2047s", method, path) == 2 && !strcmp(method, "GET")) {
+      target = path;
+      int delayMs = 0;
+      ReplayOutcome fault = OUT_OK;
+      drawFaults(target, delayMs, fault);
+      if (delayMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+
+      const ReplayRoute* r = findRoute(target);
+      if (!r) {
+        outcome = OUT_NOT_FOUND;
+        sendResponse(fd, 404, "{\"error\":\"no recording\"}", SIZE_MAX, nullptr);
+      } else {
+        if (r->latencyMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(r->latencyMs));
+        if (r->status <= 0 && (fault == OUT_OK || fault == OUT_TRUNCATED)) fault = OUT_DROPPED;
+        outcome = fault;
+        switch (fault) {
+          case OUT_DROPPED:
+            break;  // captured transport error: close without answering
+          case OUT_TIMEOUT:
+            holdOpen(fd);
+            break;
+          case OUT_429:
+            sendResponse(fd, 429, "{\"status\":{\"error_code\":429,\"error_message\":\"rate limited (replay)\"}}",
+                         SIZE_MAX, "Retry-After: 60\r\n");
+            break;
+          default: {
+            std::string extra;
+            if (s_cfg.maxAgeS >= 0) extra += "Cache-Control: max-age=" + std::to_string(s_cfg.maxAgeS) + "\r\n";
+            if (s_cfg.etag && r->status == 200) {
+              const std::string tag = etagFor(r->body);
+              extra += "ETag: " + tag + "\r\n";
+              if (fault == OUT_OK && requestHeader(head, "if-none-match") == tag) {
+                outcome = OUT_NOT_MODIFIED;
+                const std::string reply = "HTTP/1.1 304 Not Modified\r\n" + extra + "Connection: close\r\n\r\n";
+                sendAll(fd, reply.data(), reply.size());
+                break;
+              }
+            }
+            const ReplayEncoding enc = pickEncoding(head);
+            if (kEncodingHeaders[enc]) extra += kEncodingHeaders[enc];
+            const std::string body = (enc == ENC_IDENTITY) ? r->body : compressBody(r->body, enc);
+            sent = (fault == OUT_TRUNCATED) ? body.size() / 2 : body.size();
+            sendResponse(fd, r->status, body, sent, extra.empty() ? nullptr : extra.c_str());
+            break;
+          }
+        }
+      }
+    } else {
+      sendResponse(fd, 400, "{\"error\":\"bad request\"}", SIZE_MAX, nullptr);
+    }
+  }
+  close(fd);
+
+  s_outcomes[outcome]++;
+  if (lane >= 0) {
+    traceLaneRelease(TraceSpan{ traceStartUs, traceNowUs() - traceStartUs, lane, target, kOutcomeNames[outcome], sent });
+  }
+  if (!s_cfg.quiet) {
+    long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - t0).count();
+    printf("[Replay] %-9s %6zu B %5ld ms %s\n", kOutcomeNames[outcome], sent, ms,
+           target.empty() ? "-" : target.c_str());
+    fflush(stdout);
+  }
+}
+
+// ==================== Main =====================
+
+static void onSignal(int) {
+  s_stop = true;
+}
+
+static void printSummary() {
+  printf("\n[Replay] Summary:");
+  for (int i = 0; i < OUT_COUNT; ++i) printf(" %s=%u", kOutcomeNames[i], (unsigned)s_outcomes[i]);
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    const char* a = argv[i];
+    bool hasVal = i + 1 < argc;
+    if (!strcmp(a, "--port") && hasVal)            s_cfg.port = atoi(argv[++i]);
+    else if (!strcmp(a, "--routes") && hasVal)     { s_cfg.routesPath = argv[++i]; s_cfg.routesGiven = true; }
+    else if (!strcmp(a, "--capture") && hasVal)    s_cfg.capturePath = argv[++i];
+    else if (!strcmp(a, "--capture-timing"))       s_cfg.captureTiming = true;
+    else if (!strcmp(a, "--latency") && hasVal)    s_cfg.latencyMs = atoi(argv[++i]);
+    else if (!strcmp(a, "--jitter") && hasVal)     s_cfg.jitterMs = atoi(argv[++i]);
+    else if (!strcmp(a, "--p429") && hasVal)       s_cfg.p429 = atof(argv[++i]);
+    else if (!strcmp(a, "--ptruncate") && hasVal)  s_cfg.pTruncate = atof(argv[++i]);
+    else if (!strcmp(a, "--ptimeout") && hasVal)   s_cfg.pTimeout = atof(argv[++i]);
+    else if (!strcmp(a, "--hold") && hasVal)       s_cfg.holdMs = atoi(argv[++i]);
+    else if (!strcmp(a, "--fault-only") && hasVal) s_cfg.faultOnly = argv[++i];
+    else if (!strcmp(a, "--seed") && hasVal)       s_cfg.seed = (unsigned)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(a, "--quiet"))                s_cfg.quiet = true;
+    else if (!strcmp(a, "--trace") && hasVal)      s_cfg.tracePath = argv[++i];
+    else if (!strcmp(a, "--chunked") && hasVal)    s_cfg.chunkBytes = (size_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(a, "--gzip"))                 s_cfg.gzip = true;
+    else if (!strcmp(a, "--kbps") && hasVal)       s_cfg.kbps = atoi(argv[++i]);
+    else if (!strcmp(a, "--etag"))                 s_cfg.etag = true;
+    else if (!strcmp(a, "--max-age") && hasVal)    s_cfg.maxAgeS = atoi(argv[++i]);
+    else {
+      fprintf(stderr,
+              "usage: %s [--port N] [--routes FILE] [--latency MS] [--jitter MS] [--p429 P]\n"
+              "          [--ptruncate P] [--ptimeout P] [--hold MS] [--fault-only TEXT] [--seed N] [--quiet]\n"
+              "          [--capture FILE [--capture-timing]] [--trace FILE] [--chunked BYTES]\n"
+              "          [--gzip] [--kbps N] [--etag] [--max-age S]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+  if (s_cfg.p429 + s_cfg.pTruncate + s_cfg.pTimeout > 1.0) {
+    fprintf(stderr, "[Replay] Fault probabilities add up to more than 1\n");
+    return 2;
+  }
+  if (s_cfg.capturePath) {
+    if (!loadCapture(s_cfg.capturePath)) return 1;
+    if (s_cfg.routesGiven && !loadRoutes(s_cfg.routesPath)) return 1;
+  } else if (!loadRoutes(s_cfg.routesPath)) {
+    return 1;
+  }
+  s_rng.seed(s_cfg.seed);
+
+  int lfd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons((uint16_t)s_cfg.port);
+  if (lfd < 0 || bind(lfd, (sockaddr*)&addr, sizeof(addr)) != 0 || listen(lfd, 16) != 0) {
+    fprintf(stderr, "[Replay] Cannot listen on port %d: %s\n", s_cfg.port, strerror(errno));
+    return 1;
+  }
+
+  signal(SIGINT, onSignal);
+  signal(SIGTERM, onSignal);
+  signal(SIGPIPE, SIG_IGN);
+  printf("[Replay] %zu route(s) from %s, listening on :%d (latency %d+%d ms, 429 %.2f, truncate %.2f, timeout %.2f%s%s)\n",
+         s_routes.size(), s_cfg.capturePath ? s_cfg.capturePath : s_cfg.routesPath, s_cfg.port, s_cfg.latencyMs, s_cfg.jitterMs,
+         s_cfg.p429, s_cfg.pTruncate, s_cfg.pTimeout,
+         s_cfg.faultOnly ? ", only " : "", s_cfg.faultOnly ? s_cfg.faultOnly : "");
+  fflush(stdout);
+
+  while (!s_stop) {
+    pollfd p = { lfd, POLLIN, 0 };
+    if (poll(&p, 1, 200) <= 0) continue;
+    int fd = accept(lfd, nullptr, nullptr);
+    if (fd < 0) continue;
+    std::thread(handleConnection, fd).detach();
+  }
+  close(lfd);
+  printSummary();
+  if (s_cfg.tracePath && !writeTrace(s_cfg.tracePath)) {
+    fprintf(stderr, "[Replay] Cannot write %s\n", s_cfg.tracePath);
+    return 1;
+  }
+  return 0;
+}
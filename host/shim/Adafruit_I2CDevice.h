@@ -0,0 +1,6 @@
+// CryptoBar V0.99s (Host build)
+// Adafruit_I2CDevice.h - Placeholder for Adafruit BusIO (not used on the host)
+#pragma once
+
+// Adafruit_GFX.h includes the BusIO headers for its OLED/TFT drivers. Host
+// builds ignore BusIO and compile those drivers out (see [env:epd_sim]).
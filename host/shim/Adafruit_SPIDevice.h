@@ -0,0 +1,5 @@
+// CryptoBar V0.99s (Host build)
+// Adafruit_SPIDevice.h - Placeholder for Adafruit BusIO (not used on the host)
+#pragma once
+
+// See Adafruit_I2CDevice.h.
@@ -0,0 +1,99 @@
+// CryptoBar V0.99s (Host build)
+// Arduino.h - Minimal Arduino-ESP32 core for host builds (simulator, benchmarks)
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "freertos/FreeRTOS.h"  // portMUX_TYPE, like the ESP32 core
+
+// ==================== Attributes / flash access =====================
+#define PROGMEM
+#define PGM_P const char*
+#define IRAM_ATTR
+#define RTC_NOINIT_ATTR
+#define __NOINIT_ATTR
+#define pgm_read_byte(addr)    (*(const uint8_t*)(addr))
+#define pgm_read_word(addr)    (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)   (*(const uint32_t*)(addr))
+#define pgm_read_pointer(addr) (*(void* const*)(addr))
+
+// ==================== GPIO =====================
+#define LOW          0x0
+#define HIGH         0x1
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define RISING       0x01
+#define FALLING      0x02
+#define CHANGE       0x03
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+// Arduino-ESP32 also maps these to the std versions
+using std::min;
+using std::max;
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int  digitalRead(uint8_t pin);
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+// ==================== Time =====================
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// ==================== Serial (stdout) =====================
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end() {}
+  int  available() override { return 0; }
+  int  read() override { return -1; }
+  int  peek() override { return -1; }
+  void flush() override;
+  operator bool() const { return true; }
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buf, size_t n) override;
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+// ==================== ESP =====================
+class EspClass {
+ public:
+  uint32_t getHeapSize()     { return 320u * 1024u; }
+  uint32_t getFreeHeap()     { return 256u * 1024u; }
+  uint32_t getMinFreeHeap()  { return 256u * 1024u; }
+  uint32_t getMaxAllocHeap() { return 128u * 1024u; }
+  uint32_t getCpuFreqMHz()   { return 240; }
+  uint32_t getCycleCount()   { return (uint32_t)micros() * 240u; }
+  uint64_t getEfuseMac()     { return 0x0000A1B2C3D4E5F6ULL; }
+  void     restart();
+};
+
+extern EspClass ESP;
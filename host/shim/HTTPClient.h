@@ -0,0 +1,52 @@
+// CryptoBar V0.99s (Host build)
+// HTTPClient.h - ESP32 HTTPClient shim: host routes (see host_hal.h), else plain HTTP over sockets
+#pragma once
+
+#include <Arduino.h>
+
+// Subset of the ESP32 core's error codes and status codes
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_NOT_CONNECTED      (-4)
+#define HTTPC_ERROR_CONNECTION_LOST    (-5)
+#define HTTPC_ERROR_READ_TIMEOUT       (-11)
+
+#define HTTP_CODE_OK                   200
+#define HTTP_CODE_NOT_MODIFIED         304
+#define HTTP_CODE_NOT_FOUND            404
+#define HTTP_CODE_TOO_MANY_REQUESTS    429
+#define HTTP_CODE_INTERNAL_SERVER_ERROR 500
+
+typedef enum {
+  HTTPC_DISABLE_FOLLOW_REDIRECTS,
+  HTTPC_STRICT_FOLLOW_REDIRECTS,
+  HTTPC_FORCE_FOLLOW_REDIRECTS
+} followRedirects_t;
+
+class HTTPClient {
+ public:
+  bool begin(const String& url) { m_url = url; m_code = 0; m_body = String(); return true; }
+  bool begin(const char* url) { return begin(String(url)); }
+  void end() { m_url = String(); m_body = String(); }
+
+  void setTimeout(uint16_t ms) { m_timeoutMs = ms; }
+  void setConnectTimeout(int32_t ms) { m_connectTimeoutMs = ms; }
+  void setFollowRedirects(followRedirects_t follow) { (void)follow; }
+  void setReuse(bool reuse) { (void)reuse; }
+  void setUserAgent(const String& ua) { (void)ua; }
+  void addHeader(const String& name, const String& value) { (void)name; (void)value; }
+
+  int    GET();
+  String getString() { return m_body; }
+  int    getSize() { return m_code > 0 ? (int)m_body.length() : -1; }
+  static String errorToString(int code);
+
+ private:
+  String m_url;
+  String m_body;
+  int    m_code = 0;
+  uint32_t m_timeoutMs = 5000;  // HTTPCLIENT_DEFAULT_TCP_TIMEOUT
+  int32_t  m_connectTimeoutMs = 5000;
+
+  int getOverSocket();
+};
@@ -0,0 +1,53 @@
+// CryptoBar V0.99s (Host build)
+// Print.h - Arduino Print base class (text formatting on top of write())
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class Print {
+ public:
+  virtual ~Print() {}
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t r = 0;
+    while (n--) r += write(*buf++);
+    return r;
+  }
+  size_t write(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+  size_t write(const char* buf, size_t n) { return write((const uint8_t*)buf, n); }
+  virtual void flush() {}
+
+  size_t print(const char* s)    { return write(s); }
+  size_t print(const String& s)  { return write(s.c_str(), s.length()); }
+  size_t print(char c)           { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return printUnsigned(v, base); }
+  size_t print(int v, int base = DEC)           { return printSigned(v, base); }
+  size_t print(unsigned int v, int base = DEC)  { return printUnsigned(v, base); }
+  size_t print(long v, int base = DEC)          { return printSigned(v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printUnsigned(v, base); }
+  size_t print(long long v, int base = DEC)     { return printSigned(v, base); }
+  size_t print(unsigned long long v, int base = DEC) { return printUnsigned(v, base); }
+  size_t print(double v, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& v) { size_t n = print(v); return n + println(); }
+  template <typename T>
+  size_t println(const T& v, int fmt) { size_t n = print(v, fmt); return n + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+ private:
+  size_t printSigned(long long v, int base);
+  size_t printUnsigned(unsigned long long v, int base);
+};
@@ -0,0 +1,29 @@
+// CryptoBar V0.99s (Host build)
+// Stream.h - Arduino Stream (byte source on top of Print)
+#pragma once
+
+#include "Print.h"
+
+class Stream : public Print {
+ public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long ms) { m_timeout = ms; }
+  unsigned long getTimeout() const { return m_timeout; }
+
+  size_t readBytes(char* buf, size_t n) {
+    size_t r = 0;
+    while (r < n) {
+      int c = read();
+      if (c < 0) break;
+      buf[r++] = (char)c;
+    }
+    return r;
+  }
+  size_t readBytes(uint8_t* buf, size_t n) { return readBytes((char*)buf, n); }
+
+ protected:
+  unsigned long m_timeout = 1000;
+};
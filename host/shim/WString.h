@@ -0,0 +1,84 @@
+// CryptoBar V0.99s (Host build)
+// WString.h - Arduino String on top of std::string (the subset CryptoBar uses)
+#pragma once
+
+#include <stdlib.h>
+#include <string>
+
+class String {
+ public:
+  String(const char* s = "") : m_s(s ? s : "") {}
+  String(const std::string& s) : m_s(s) {}
+  explicit String(char c) : m_s(1, c) {}
+  explicit String(int v, unsigned char base = 10);
+  explicit String(unsigned int v, unsigned char base = 10);
+  explicit String(long v, unsigned char base = 10);
+  explicit String(unsigned long v, unsigned char base = 10);
+  explicit String(float v, unsigned int decimals = 2);
+  explicit String(double v, unsigned int decimals = 2);
+
+  const char*  c_str() const { return m_s.c_str(); }
+  unsigned int length() const { return (unsigned int)m_s.size(); }
+  bool         isEmpty() const { return m_s.empty(); }
+  bool         reserve(unsigned int size) { m_s.reserve(size); return true; }
+
+  char  charAt(unsigned int i) const { return i < m_s.size() ? m_s[i] : 0; }
+  char  operator[](unsigned int i) const { return charAt(i); }
+  char& operator[](unsigned int i) { return m_s[i]; }
+
+  String& operator=(const char* s) { m_s = s ? s : ""; return *this; }
+  String& operator+=(const String& s) { m_s += s.m_s; return *this; }
+  String& operator+=(const char* s) { if (s) m_s += s; return *this; }
+  String& operator+=(char c) { m_s += c; return *this; }
+  String& operator+=(int v) { return *this += String(v); }
+  String& operator+=(unsigned int v) { return *this += String(v); }
+  String& operator+=(long v) { return *this += String(v); }
+  String& operator+=(unsigned long v) { return *this += String(v); }
+  String& operator+=(double v) { return *this += String(v); }
+  bool concat(const String& s) { *this += s; return true; }
+  bool concat(const char* s) { *this += s; return true; }
+  bool concat(char c) { *this += c; return true; }
+
+  bool equals(const String& s) const { return m_s == s.m_s; }
+  bool equalsIgnoreCase(const String& s) const;
+  bool operator==(const String& s) const { return m_s == s.m_s; }
+  bool operator==(const char* s) const { return m_s == (s ? s : ""); }
+  bool operator!=(const String& s) const { return !(*this == s); }
+  bool operator!=(const char* s) const { return !(*this == s); }
+  bool operator<(const String& s) const { return m_s < s.m_s; }
+
+  bool startsWith(const String& s) const { return m_s.compare(0, s.m_s.size(), s.m_s) == 0; }
+  bool endsWith(const String& s) const {
+    return m_s.size() >= s.m_s.size() &&
+           m_s.compare(m_s.size() - s.m_s.size(), s.m_s.size(), s.m_s) == 0;
+  }
+
+  int indexOf(char c, unsigned int from = 0) const { return pos(m_s.find(c, from)); }
+  int indexOf(const String& s, unsigned int from = 0) const { return pos(m_s.find(s.m_s, from)); }
+  int lastIndexOf(char c) const { return pos(m_s.rfind(c)); }
+  int lastIndexOf(const String& s) const { return pos(m_s.rfind(s.m_s)); }
+
+  String substring(unsigned int from) const { return from < m_s.size() ? String(m_s.substr(from)) : String(); }
+  String substring(unsigned int from, unsigned int to) const;
+
+  void replace(const String& from, const String& to);
+  void remove(unsigned int index) { if (index < m_s.size()) m_s.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < m_s.size()) m_s.erase(index, count); }
+  void trim();
+  void toLowerCase();
+  void toUpperCase();
+
+  long   toInt() const { return strtol(m_s.c_str(), nullptr, 10); }
+  float  toFloat() const { return strtof(m_s.c_str(), nullptr); }
+  double toDouble() const { return strtod(m_s.c_str(), nullptr); }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+  friend String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, char c) { String r(a); r += c; return r; }
+
+ private:
+  static int pos(std::string::size_type p) { return p == std::string::npos ? -1 : (int)p; }
+
+  std::string m_s;
+};
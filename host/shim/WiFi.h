@@ -0,0 +1,27 @@
+// CryptoBar V0.99s (Host build)
+// WiFi.h - WiFi status shim (always "connected" unless a host program says otherwise)
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum {
+  WL_NO_SHIELD       = 255,
+  WL_IDLE_STATUS     = 0,
+  WL_NO_SSID_AVAIL   = 1,
+  WL_SCAN_COMPLETED  = 2,
+  WL_CONNECTED       = 3,
+  WL_CONNECT_FAILED  = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED    = 6
+} wl_status_t;
+
+class WiFiClass {
+ public:
+  wl_status_t status();
+  bool    isConnected() { return status() == WL_CONNECTED; }
+  int8_t  RSSI() { return isConnected() ? -55 : 0; }
+  String  SSID() { return isConnected() ? String("host") : String(); }
+  String  localIP() { return isConnected() ? String("127.0.0.1") : String("0.0.0.0"); }
+};
+
+extern WiFiClass WiFi;
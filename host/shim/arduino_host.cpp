@@ -0,0 +1,231 @@
+// CryptoBar V0.99s (Host build)
+// arduino_host.cpp - Host implementation of the Arduino core shim
+#include <Arduino.h>
+#include "host_hal.h"
+#include "freertos/task.h"
+
+#include <ctype.h>
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+
+// ==================== Time =====================
+// Real steady clock by default; virtual once hostClockSetUtc() is called.
+
+static const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+
+static bool     s_clockVirtual = false;
+static uint64_t s_virtualUs    = 0;  // virtual micros()
+static time_t   s_virtualUtc0  = 0;  // UTC at s_virtualUs == 0
+
+void hostClockSetUtc(time_t utc) {
+  s_clockVirtual = true;
+  s_virtualUtc0 = utc - (time_t)(s_virtualUs / 1000000ULL);  // micros() stays monotonic
+}
+
+void hostClockAdvanceMs(uint32_t ms) {
+  s_virtualUs += (uint64_t)ms * 1000ULL;
+}
+
+bool hostClockIsVirtual() {
+  return s_clockVirtual;
+}
+
+uint64_t hostClockMicros() {
+  if (s_clockVirtual) return s_virtualUs;
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - s_start).count();
+}
+
+time_t hostClockUtc() {
+  if (s_clockVirtual) return s_virtualUtc0 + (time_t)(s_virtualUs / 1000000ULL);
+  return (time_t)std::chrono::duration_cast<std::chrono::seconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// time() itself is replaced in host_time.c (C linkage, see there).
+extern "C" time_t hostClockUtcC(void) {
+  return hostClockUtc();
+}
+
+unsigned long micros() {
+  return (unsigned long)hostClockMicros();
+}
+
+unsigned long millis() {
+  return (unsigned long)(hostClockMicros() / 1000ULL);
+}
+
+TickType_t xTaskGetTickCount() {
+  return (TickType_t)(hostClockMicros() / 1000ULL);
+}
+
+void delay(unsigned long ms) {
+  if (s_clockVirtual) {
+    s_virtualUs += (uint64_t)ms * 1000ULL;
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+  if (s_clockVirtual) {
+    s_virtualUs += us;
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {}
+
+// ==================== GPIO =====================
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+void digitalWrite(uint8_t pin, uint8_t val) { (void)pin; (void)val; }
+int  digitalRead(uint8_t pin) { (void)pin; return HIGH; }
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) { (void)pin; (void)isr; (void)mode; }
+void detachInterrupt(uint8_t pin) { (void)pin; }
+
+// ==================== Serial =====================
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static bool s_serialMuted = false;
+
+void hostSerialSetMuted(bool muted) {
+  s_serialMuted = muted;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (s_serialMuted) return 1;
+  return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t n) {
+  if (s_serialMuted) return n;
+  return fwrite(buf, 1, n, stdout);
+}
+
+void HardwareSerial::flush() {
+  fflush(stdout);
+}
+
+void EspClass::restart() {
+  fflush(stdout);
+  exit(0);
+}
+
+// ==================== Print =====================
+
+size_t Print::printf(const char* format, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, format);
+  int n = vsnprintf(buf, sizeof(buf), format, ap);
+  va_end(ap);
+  if (n < 0) return 0;
+  if ((size_t)n < sizeof(buf)) return write((const uint8_t*)buf, (size_t)n);
+
+  std::string big((size_t)n + 1, '\0');
+  va_start(ap, format);
+  vsnprintf(&big[0], big.size(), format, ap);
+  va_end(ap);
+  return write((const uint8_t*)big.data(), (size_t)n);
+}
+
+size_t Print::print(double v, int digits) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", digits, v);
+  return write(buf);
+}
+
+size_t Print::printUnsigned(unsigned long long v, int base) {
+  if (base < 2) base = 10;
+  char buf[66];
+  char* p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  do {
+    int d = (int)(v % (unsigned)base);
+    *--p = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+    v /= (unsigned)base;
+  } while (v);
+  return write(p);
+}
+
+size_t Print::printSigned(long long v, int base) {
+  if (v < 0 && base == 10) {
+    size_t n = print('-');
+    return n + printUnsigned((unsigned long long)(-(v + 1)) + 1, base);
+  }
+  return printUnsigned((unsigned long long)v, base);
+}
+
+// ==================== String =====================
+
+static std::string fmtInteger(unsigned long long v, bool neg, unsigned char base) {
+  if (base < 2) base = 10;
+  std::string s;
+  do {
+    int d = (int)(v % base);
+    s.insert(s.begin(), (char)(d < 10 ? '0' + d : 'a' + d - 10));
+    v /= base;
+  } while (v);
+  if (neg) s.insert(s.begin(), '-');
+  return s;
+}
+
+String::String(int v, unsigned char base)
+  : m_s(base == 10 ? fmtInteger(v < 0 ? -(long long)v : v, v < 0, 10) : fmtInteger((unsigned int)v, false, base)) {}
+String::String(unsigned int v, unsigned char base) : m_s(fmtInteger(v, false, base)) {}
+String::String(long v, unsigned char base)
+  : m_s(base == 10 ? fmtInteger(v < 0 ? -(long long)v : v, v < 0, 10) : fmtInteger((unsigned long)v, false, base)) {}
+String::String(unsigned long v, unsigned char base) : m_s(fmtInteger(v, false, base)) {}
+
+String::String(float v, unsigned int decimals) : String((double)v, decimals) {}
+
+String::String(double v, unsigned int decimals) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", (int)decimals, v);
+  m_s = buf;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+  if (m_s.size() != s.m_s.size()) return false;
+  for (size_t i = 0; i < m_s.size(); ++i) {
+    if (tolower((unsigned char)m_s[i]) != tolower((unsigned char)s.m_s[i])) return false;
+  }
+  return true;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+  if (from > to) std::swap(from, to);
+  if (from >= m_s.size()) return String();
+  if (to > m_s.size()) to = (unsigned int)m_s.size();
+  return String(m_s.substr(from, to - from));
+}
+
+void String::replace(const String& from, const String& to) {
+  if (from.m_s.empty()) return;
+  std::string::size_type p = 0;
+  while ((p = m_s.find(from.m_s, p)) != std::string::npos) {
+    m_s.replace(p, from.m_s.size(), to.m_s);
+    p += to.m_s.size();
+  }
+}
+
+void String::trim() {
+  std::string::size_type b = 0;
+  std::string::size_type e = m_s.size();
+  while (b < e && isspace((unsigned char)m_s[b])) ++b;
+  while (e > b && isspace((unsigned char)m_s[e - 1])) --e;
+  m_s = m_s.substr(b, e - b);
+}
+
+void String::toLowerCase() {
+  for (char& c : m_s) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char& c : m_s) c = (char)toupper((unsigned char)c);
+}
@@ -0,0 +1,37 @@
+// CryptoBar V0.99s (Host build)
+// freertos/FreeRTOS.h - Base types and critical sections for host builds
+#pragma once
+
+#include <stdint.h>
+
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdFAIL  0
+#define pdPASS  1
+
+// 1 tick = 1 ms of the host clock.
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY      ((TickType_t)0xFFFFFFFFu)
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(ms))
+
+#define portYIELD_FROM_ISR(woken) ((void)(woken))
+
+// ESP32 spinlock critical sections. Host builds with tasks (epd_sim_task) run
+// them on threads, so every critical section takes one process-wide recursive
+// lock; single-threaded builds pay an uncontended lock.
+typedef struct {
+  int owner;
+} portMUX_TYPE;
+
+void hostCriticalEnter();
+void hostCriticalExit();
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(mux)     ((void)(mux), hostCriticalEnter())
+#define portEXIT_CRITICAL(mux)      ((void)(mux), hostCriticalExit())
+#define portENTER_CRITICAL_ISR(mux) ((void)(mux), hostCriticalEnter())
+#define portEXIT_CRITICAL_ISR(mux)  ((void)(mux), hostCriticalExit())
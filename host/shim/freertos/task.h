@@ -0,0 +1,23 @@
+// CryptoBar V0.99s (Host build)
+// freertos/task.h - Tasks as host threads, with task notifications (1 tick = 1 ms of the host clock)
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void* TaskHandle_t;
+typedef void (*TaskFunction_t)(void*);
+
+TickType_t xTaskGetTickCount();
+
+// The thread that calls setup()/main() is the task named "main".
+TaskHandle_t xTaskGetCurrentTaskHandle();
+char*        pcTaskGetName(TaskHandle_t task);
+
+// Starts a detached thread; priority, stack size and core are ignored.
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* out,
+                                   BaseType_t core);
+
+void     vTaskDelay(TickType_t ticks);
+void     xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout);
@@ -0,0 +1,172 @@
+// CryptoBar V0.99s (Host build)
+// freertos_host.cpp - FreeRTOS tasks, notifications and semaphores on std::thread
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Objects are never freed: a detached task may still wait on them at exit.
+
+// ==================== Critical sections =====================
+
+static std::recursive_mutex& criticalLock() {
+  static std::recursive_mutex* s_lock = new std::recursive_mutex();
+  return *s_lock;
+}
+
+void hostCriticalEnter() { criticalLock().lock(); }
+void hostCriticalExit()  { criticalLock().unlock(); }
+
+// ==================== Waiting =====================
+
+// Waits on cv until pred() holds or 'timeout' ticks pass. Returns pred().
+template <typename Pred>
+static bool waitTicks(std::condition_variable& cv, std::unique_lock<std::mutex>& lk,
+                      TickType_t timeout, Pred pred) {
+  if (timeout == portMAX_DELAY) {
+    cv.wait(lk, pred);
+    return true;
+  }
+  return cv.wait_for(lk, std::chrono::milliseconds(timeout), pred);
+}
+
+// ==================== Tasks =====================
+
+struct HostTask {
+  char                    name[16];
+  std::mutex              lock;
+  std::condition_variable cv;
+  uint32_t                notify;
+};
+
+static HostTask* mainTask() {
+  static HostTask* s_main = [] {
+    HostTask* t = new HostTask();
+    snprintf(t->name, sizeof(t->name), "main");
+    t->notify = 0;
+    return t;
+  }();
+  return s_main;
+}
+
+static thread_local HostTask* t_current = nullptr;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  return t_current ? t_current : mainTask();
+}
+
+char* pcTaskGetName(TaskHandle_t task) {
+  return static_cast<HostTask*>(task ? task : xTaskGetCurrentTaskHandle())->name;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackBytes,
+                                   void* arg, UBaseType_t priority, TaskHandle_t* out,
+                                   BaseType_t core) {
+  (void)stackBytes;
+  (void)priority;
+  (void)core;
+  HostTask* t = new HostTask();
+  snprintf(t->name, sizeof(t->name), "%s", name ? name : "");
+  t->notify = 0;
+  if (out) *out = t;
+  std::thread([t, fn, arg] {
+    t_current = t;
+    fn(arg);
+  }).detach();
+  return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+void xTaskNotifyGive(TaskHandle_t task) {
+  HostTask* t = static_cast<HostTask*>(task);
+  {
+    std::lock_guard<std::mutex> lk(t->lock);
+    t->notify++;
+  }
+  t->cv.notify_one();
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t timeout) {
+  HostTask* t = static_cast<HostTask*>(xTaskGetCurrentTaskHandle());
+  std::unique_lock<std::mutex> lk(t->lock);
+  waitTicks(t->cv, lk, timeout, [t] { return t->notify > 0; });
+  uint32_t value = t->notify;
+  if (value) t->notify = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+// ==================== Semaphores =====================
+// One type for all three kinds: a counting semaphore (mutex: starts at 1,
+// binary: at 0, capped at 1) plus an owner and depth for recursive takes.
+
+struct HostSemaphore {
+  std::mutex              lock;
+  std::condition_variable cv;
+  int                     count;
+  std::thread::id         owner;
+  int                     depth;
+};
+
+static SemaphoreHandle_t createSemaphore(int initial) {
+  HostSemaphore* s = new HostSemaphore();
+  s->count = initial;
+  s->depth = 0;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()          { return createSemaphore(1); }
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex() { return createSemaphore(1); }
+SemaphoreHandle_t xSemaphoreCreateBinary()         { return createSemaphore(0); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t timeout) {
+  std::unique_lock<std::mutex> lk(sem->lock);
+  if (!waitTicks(sem->cv, lk, timeout, [sem] { return sem->count > 0; })) return pdFALSE;
+  sem->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+  {
+    std::lock_guard<std::mutex> lk(sem->lock);
+    if (sem->count > 0) return pdFALSE;  // already given
+    sem->count = 1;
+  }
+  sem->cv.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t timeout) {
+  const std::thread::id self = std::this_thread::get_id();
+  std::unique_lock<std::mutex> lk(sem->lock);
+  if (sem->depth > 0 && sem->owner == self) {
+    sem->depth++;
+    return pdTRUE;
+  }
+  if (!waitTicks(sem->cv, lk, timeout, [sem] { return sem->depth == 0; })) return pdFALSE;
+  sem->owner = self;
+  sem->depth = 1;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+  {
+    std::lock_guard<std::mutex> lk(sem->lock);
+    if (sem->depth == 0 || sem->owner != std::this_thread::get_id()) return pdFALSE;
+    if (--sem->depth > 0) return pdTRUE;
+  }
+  sem->cv.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t* woken) {
+  if (woken) *woken = pdFALSE;
+  return xSemaphoreGive(sem);
+}
@@ -0,0 +1,524 @@
+// CryptoBar V0.99s (Host build)
+// hal_host.cpp - Host WiFi, HTTPClient and Preferences shims
+#include <Arduino.h>
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include <Preferences.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "host_hal.h"
+#include "net_socket.h"
+
+// ==================== WiFi =====================
+
+WiFiClass WiFi;
+
+static bool s_wifiConnected = true;
+
+void hostWiFiSetConnected(bool connected) {
+  s_wifiConnected = connected;
+}
+
+wl_status_t WiFiClass::status() {
+  return s_wifiConnected ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+// ==================== HTTP routes =====================
+
+struct HostHttpRoute {
+  std::string pattern;
+  String      body;
+  int         code;
+};
+
+static std::vector<HostHttpRoute> s_routes;
+static HostHttpStats s_httpStats;
+
+static bool readFile(const char* path, std::string& out) {
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  char buf[4096];
+  size_t n;
+  out.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+bool hostHttpAddRoute(const char* pattern, const char* fixturePath, int code) {
+  std::string body;
+  if (!readFile(fixturePath, body)) {
+    Serial.printf("[HostHttp] Cannot read fixture %s\n", fixturePath);
+    return false;
+  }
+  s_routes.push_back({ pattern, String(body), code });
+  return true;
+}
+
+void hostHttpAddRouteBody(const char* pattern, const char* body, int code) {
+  s_routes.push_back({ pattern, String(body ? body : ""), code });
+}
+
+void hostHttpClearRoutes() {
+  s_routes.clear();
+}
+
+const HostHttpStats& hostHttpStats() {
+  return s_httpStats;
+}
+
+void hostHttpResetStats() {
+  memset(&s_httpStats, 0, sizeof(s_httpStats));
+}
+
+int HTTPClient::GET() {
+  s_httpStats.requests++;
+  if (!s_wifiConnected) {
+    m_code = HTTPC_ERROR_NOT_CONNECTED;
+    return m_code;
+  }
+
+  for (const HostHttpRoute& r : s_routes) {
+    if (strstr(m_url.c_str(), r.pattern.c_str()) == nullptr) continue;
+    s_httpStats.served++;
+    m_code = r.code;
+    if (m_code > 0) {
+      m_body = r.body;
+      s_httpStats.bytes += m_body.length();
+    }
+    return m_code;
+  }
+
+  if (m_url.startsWith("http://")) {
+    s_httpStats.network++;
+    m_code = getOverSocket();
+    if (m_code > 0) s_httpStats.bytes += m_body.length();
+    return m_code;
+  }
+
+  s_httpStats.unmatched++;
+  m_code = HTTPC_ERROR_CONNECTION_REFUSED;
+  return m_code;
+}
+
+#if !defined(_WIN32)
+
+static bool waitFd(int fd, short events, uint32_t timeoutMs) {
+  pollfd p = { fd, events, 0 };
+  return poll(&p, 1, (int)timeoutMs) > 0;
+}
+
+// Non-blocking connect bounded by timeoutMs; returns the fd or -1. Numeric
+// hosts skip getaddrinfo() (which allocates) so benchmarks count only the client.
+static int tcpConnect(const char* host, uint16_t port, uint32_t timeoutMs) {
+  sockaddr_in sa;
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &sa.sin_addr) != 1) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* ai = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &ai) != 0 || !ai) return -1;
+    sa.sin_addr = ((sockaddr_in*)ai->ai_addr)->sin_addr;
+    freeaddrinfo(ai);
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  if (connect(fd, (sockaddr*)&sa, sizeof(sa)) != 0) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    if (errno != EINPROGRESS || !waitFd(fd, POLLOUT, timeoutMs) ||
+        getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+      close(fd);
+      return -1;
+    }
+  }
+  return fd;
+}
+
+// Plain HTTP/1.1 GET with Connection: close. Like the ESP32 core, a body that
+// ends early (Content-Length not reached) is returned as received.
+int HTTPClient::getOverSocket() {
+  std::string url(m_url.c_str() + 7);  // after "http://"
+  size_t slash = url.find('/');
+  std::string hostPort = url.substr(0, slash);
+  std::string path = (slash == std::string::npos) ? std::string("/") : url.substr(slash);
+  std::string host = hostPort;
+  std::string port = "80";
+  size_t colon = hostPort.find(':');
+  if (colon != std::string::npos) {
+    host = hostPort.substr(0, colon);
+    port = hostPort.substr(colon + 1);
+  }
+
+  int fd = tcpConnect(host.c_str(), (uint16_t)atoi(port.c_str()), (uint32_t)m_connectTimeoutMs);
+  if (fd < 0) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+  std::string req = "GET " + path + " HTTP/1.1\r\nHost: " + hostPort +
+                    "\r\nUser-Agent: ESP32HTTPClient\r\nConnection: close\r\n\r\n";
+  size_t off = 0;
+  while (off < req.size()) {
+    if (!waitFd(fd, POLLOUT, m_timeoutMs)) break;
+    ssize_t n = send(fd, req.data() + off, req.size() - off, 0);
+    if (n <= 0) break;
+    off += (size_t)n;
+  }
+  if (off < req.size()) {
+    close(fd);
+    return HTTPC_ERROR_SEND_HEADER_FAILED;
+  }
+
+  // Read until close; each wait is bounded by the read timeout, as on the device.
+  std::string resp;
+  bool timedOut = false;
+  char buf[4096];
+  for (;;) {
+    if (!waitFd(fd, POLLIN, m_timeoutMs)) {
+      timedOut = true;
+      break;
+    }
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n <= 0) break;
+    resp.append(buf, (size_t)n);
+  }
+  close(fd);
+
+  size_t headEnd = resp.find("\r\n\r\n");
+  if (headEnd == std::string::npos) {
+    return timedOut ? HTTPC_ERROR_READ_TIMEOUT : HTTPC_ERROR_CONNECTION_LOST;
+  }
+  int code = 0;
+  if (sscanf(resp.c_str(), "HTTP/%*s %d", &code) != 1 || code <= 0) {
+    return HTTPC_ERROR_CONNECTION_LOST;
+  }
+  std::string head = resp.substr(0, headEnd);
+  for (char& c : head) c = (char)tolower((unsigned char)c);
+  if (head.find("transfer-encoding: chunked") == std::string::npos) {
+    m_body = String(resp.substr(headEnd + 4));
+    return code;
+  }
+  // Chunked (as getString() on the device decodes it); stops at a cut-off chunk.
+  std::string body;
+  size_t pos = headEnd + 4;
+  for (;;) {
+    size_t eol = resp.find("\r\n", pos);
+    if (eol == std::string::npos) break;
+    size_t len = strtoul(resp.c_str() + pos, nullptr, 16);
+    if (len == 0) break;
+    body.append(resp, eol + 2, std::min(len, resp.size() - (eol + 2)));
+    pos = eol + 2 + len + 2;
+    if (pos > resp.size()) break;
+  }
+  m_body = String(body);
+  return code;
+}
+
+#else
+
+int HTTPClient::getOverSocket() {
+  return HTTPC_ERROR_CONNECTION_REFUSED;
+}
+
+#endif
+
+String HTTPClient::errorToString(int code) {
+  switch (code) {
+    case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+    case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+    case HTTPC_ERROR_NOT_CONNECTED:      return "not connected";
+    case HTTPC_ERROR_CONNECTION_LOST:    return "connection lost";
+    case HTTPC_ERROR_READ_TIMEOUT:       return "read Timeout";
+    default:                             return String();
+  }
+}
+
+// ==================== NetSocket =====================
+// lite_http's socket. The request line decides between a route and the
+// network, so the connection is made by the first write(): routes answer from
+// memory with Content-Length framing, other plain http:// requests go out over
+// a real socket, and unmatched https:// requests are refused. No heap use.
+
+namespace {
+
+class HostSocket : public NetSocket {
+ public:
+  bool connect(const char* host, uint16_t port, bool tls, uint32_t timeoutMs) override {
+    close();
+    s_httpStats.requests++;
+    if (!s_wifiConnected) return false;
+    snprintf(m_host, sizeof(m_host), "%s", host);
+    m_port      = port;
+    m_tls       = tls;
+    m_connectMs = timeoutMs;
+    m_pending   = true;
+    return true;
+  }
+
+  int write(const uint8_t* data, size_t len, uint32_t timeoutMs) override {
+    if (m_pending) {
+      m_pending = false;
+      int rc = open((const char*)data, len);
+      if (rc < 0) return rc;
+    }
+    if (m_route) return (int)len;  // the route does not need the request
+#if !defined(_WIN32)
+    size_t off = 0;
+    while (m_fd >= 0 && off < len) {
+      if (!waitFd(m_fd, POLLOUT, timeoutMs)) break;
+      ssize_t n = send(m_fd, data + off, len - off, 0);
+      if (n <= 0) break;
+      off += (size_t)n;
+    }
+    if (off == len) return (int)len;
+#endif
+    (void)timeoutMs;
+    return NET_ERR_SEND;
+  }
+
+  int read(uint8_t* buf, size_t len, uint32_t timeoutMs) override {
+    if (m_route) {
+      // One TCP segment at most per read, as lwIP hands them over.
+      size_t n = 0;
+      while (n < len && n < 1460) {
+        if (m_off < (size_t)m_headLen) {
+          buf[n++] = (uint8_t)m_head[m_off++];
+        } else {
+          const size_t bodyOff = m_off - (size_t)m_headLen;
+          if (bodyOff >= m_route->body.length()) break;
+          size_t take = std::min(std::min(len - n, (size_t)1460 - n), m_route->body.length() - bodyOff);
+          memcpy(buf + n, m_route->body.c_str() + bodyOff, take);
+          n += take;
+          m_off += take;
+        }
+      }
+      return (int)n;
+    }
+#if !defined(_WIN32)
+    if (m_fd >= 0) {
+      if (!waitFd(m_fd, POLLIN, timeoutMs)) return NET_ERR_TIMEOUT;
+      ssize_t n = recv(m_fd, buf, len, 0);
+      if (n < 0) return NET_ERR_LOST;
+      for (ssize_t i = 0; i < n; ++i) {  // count what follows the header block
+        if (m_headMatch == 4) {
+          s_httpStats.bytes += (uint64_t)(n - i);
+          break;
+        }
+        m_headMatch = (buf[i] == "\r\n\r\n"[m_headMatch]) ? m_headMatch + 1 : (buf[i] == '\r') ? 1 : 0;
+      }
+      return (int)n;
+    }
+#endif
+    (void)buf;
+    (void)len;
+    (void)timeoutMs;
+    return NET_ERR_LOST;
+  }
+
+  void close() override {
+#if !defined(_WIN32)
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+    m_fd      = -1;
+    m_route   = nullptr;
+    m_pending = false;
+  }
+
+ private:
+  // Match "GET <path> ..." against the routes (as HTTPClient::GET()) or connect.
+  int open(const char* req, size_t len) {
+    char url[512];
+    const char* path = (len > 4 && strncmp(req, "GET ", 4) == 0) ? req + 4 : "/";
+    const char* pathEnd = (const char*)memchr(path, ' ', len - (size_t)(path - req));
+    const int   pathLen = pathEnd ? (int)(pathEnd - path) : 1;
+    char portSuffix[8] = "";
+    if (m_port != (m_tls ? 443 : 80)) snprintf(portSuffix, sizeof(portSuffix), ":%u", (unsigned)m_port);
+    snprintf(url, sizeof(url), "%s://%s%s%.*s", m_tls ? "https" : "http", m_host, portSuffix, pathLen, path);
+
+    for (const HostHttpRoute& r : s_routes) {
+      if (strstr(url, r.pattern.c_str()) == nullptr) continue;
+      s_httpStats.served++;
+      if (r.code < 0) return r.code;
+      m_route   = &r;
+      m_off     = 0;
+      m_headLen = snprintf(m_head, sizeof(m_head), "HTTP/1.1 %d Route\r\nContent-Length: %u\r\n\r\n",
+                           r.code, (unsigned)r.body.length());
+      s_httpStats.bytes += r.body.length();
+      return 0;
+    }
+
+#if !defined(_WIN32)
+    if (!m_tls) {
+      s_httpStats.network++;
+      m_fd = tcpConnect(m_host, m_port, m_connectMs);
+      m_headMatch = 0;
+      return (m_fd >= 0) ? 0 : NET_ERR_CONNECT;
+    }
+#endif
+    s_httpStats.unmatched++;
+    return NET_ERR_CONNECT;
+  }
+
+  char     m_host[96] = "";
+  uint16_t m_port = 0;
+  bool     m_tls = false;
+  bool     m_pending = false;
+  uint32_t m_connectMs = 0;
+  int      m_fd = -1;
+  uint8_t  m_headMatch = 0;  // network: bytes of "\r\n\r\n" seen so far
+
+  const HostHttpRoute* m_route = nullptr;
+  char   m_head[96];
+  int    m_headLen = 0;
+  size_t m_off = 0;
+};
+
+}  // namespace
+
+NetSocket& netSocketDefault() {
+  static HostSocket s_socket;
+  return s_socket;
+}
+
+// ==================== Preferences =====================
+// namespace -> key -> (type tag, raw bytes)
+
+struct HostNvsValue {
+  char        type;
+  std::string data;
+};
+
+typedef std::map<std::string, HostNvsValue> HostNvsNamespace;
+static std::map<std::string, HostNvsNamespace> s_nvs;
+
+void hostPrefsClear() {
+  s_nvs.clear();
+}
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+  (void)partitionLabel;
+  if (m_started || !name || !name[0] || strlen(name) > 15) return false;
+  m_ns = name;
+  m_readOnly = readOnly;
+  m_started = true;
+  return true;
+}
+
+void Preferences::end() {
+  m_started = false;
+}
+
+bool Preferences::clear() {
+  if (!m_started || m_readOnly) return false;
+  s_nvs[m_ns].clear();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!m_started || m_readOnly || !key) return false;
+  return s_nvs[m_ns].erase(key) > 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  if (!m_started || !key) return false;
+  const HostNvsNamespace& ns = s_nvs[m_ns];
+  return ns.find(key) != ns.end();
+}
+
+size_t Preferences::putRaw(const char* key, char type, const void* data, size_t len) {
+  if (!m_started || m_readOnly || !key || strlen(key) > 15) return 0;
+  HostNvsValue& v = s_nvs[m_ns][key];
+  v.type = type;
+  v.data.assign((const char*)data, len);
+  return len;
+}
+
+bool Preferences::getRaw(const char* key, char type, void* out, size_t len) {
+  if (!m_started || !key) return false;
+  const HostNvsNamespace& ns = s_nvs[m_ns];
+  HostNvsNamespace::const_iterator it = ns.find(key);
+  if (it == ns.end() || it->second.type != type || it->second.data.size() != len) return false;
+  memcpy(out, it->second.data.data(), len);
+  return true;
+}
+
+#define HOST_PREFS_SCALAR(Suffix, T, tag)                               \
+  size_t Preferences::put##Suffix(const char* key, T value) {           \
+    return putRaw(key, tag, &value, sizeof(value));                     \
+  }                                                                     \
+  T Preferences::get##Suffix(const char* key, T defaultValue) {         \
+    T v;                                                                \
+    return getRaw(key, tag, &v, sizeof(v)) ? v : defaultValue;          \
+  }
+
+HOST_PREFS_SCALAR(Char,     int8_t,   'c')
+HOST_PREFS_SCALAR(UChar,    uint8_t,  'C')
+HOST_PREFS_SCALAR(Short,    int16_t,  's')
+HOST_PREFS_SCALAR(UShort,   uint16_t, 'S')
+HOST_PREFS_SCALAR(Int,      int32_t,  'i')
+HOST_PREFS_SCALAR(UInt,     uint32_t, 'I')
+HOST_PREFS_SCALAR(Long64,   int64_t,  'l')
+HOST_PREFS_SCALAR(ULong64,  uint64_t, 'L')
+
+#undef HOST_PREFS_SCALAR
+
+size_t Preferences::putString(const char* key, const char* value) {
+  if (!value) return 0;
+  size_t len = strlen(value);
+  // Like the ESP32 core: returns strlen(value), so an empty string reports 0.
+  return putRaw(key, 'z', value, len) == len ? len : 0;
+}
+
+String Preferences::getString(const char* key, const String& defaultValue) {
+  if (!m_started || !key) return defaultValue;
+  const HostNvsNamespace& ns = s_nvs[m_ns];
+  HostNvsNamespace::const_iterator it = ns.find(key);
+  if (it == ns.end() || it->second.type != 'z') return defaultValue;
+  return String(it->second.data);
+}
+
+size_t Preferences::getString(const char* key, char* value, size_t maxLen) {
+  String s = getString(key, String());
+  if (!value || maxLen == 0 || s.length() + 1 > maxLen) return 0;
+  memcpy(value, s.c_str(), s.length() + 1);
+  return s.length() + 1;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!value || len == 0) return 0;
+  return putRaw(key, 'b', value, len);
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!m_started || !key) return 0;
+  const HostNvsNamespace& ns = s_nvs[m_ns];
+  HostNvsNamespace::const_iterator it = ns.find(key);
+  if (it == ns.end() || it->second.type != 'b') return 0;
+  return it->second.data.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  size_t len = getBytesLength(key);
+  if (len == 0 || !buf || len > maxLen) return 0;
+  memcpy(buf, s_nvs[m_ns][key].data.data(), len);
+  return len;
+}
@@ -0,0 +1,51 @@
+// CryptoBar V0.99s (Host build)
+// host_hal.h - Controls for the host HAL shims (virtual clock, WiFi, HTTP fixtures, NVS)
+//
+// Firmware code never includes this header. Host programs (benchmarks, tools)
+// use it to set up the environment the firmware modules run in.
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+// ==================== Clock =====================
+// Real clock by default. Once hostClockSetUtc() is called, millis()/micros()/
+// time() follow a virtual clock that only moves through hostClockAdvanceMs()
+// and delay(), so time-dependent code runs deterministically and instantly.
+void     hostClockSetUtc(time_t utc);
+void     hostClockAdvanceMs(uint32_t ms);
+bool     hostClockIsVirtual();
+time_t   hostClockUtc();
+uint64_t hostClockMicros();
+
+// ==================== Serial =====================
+// Muting drops Serial output (keeps firmware logging out of timed loops).
+void hostSerialSetMuted(bool muted);
+
+// ==================== WiFi =====================
+// WiFi.status() returns WL_CONNECTED unless set otherwise.
+void hostWiFiSetConnected(bool connected);
+
+// ==================== HTTP =====================
+// HTTPClient::GET() and lite_http (netSocketDefault()) serve the first route
+// whose pattern is a substring of the requested URL. A route with a negative
+// code fails with that code instead. Unmatched http:// URLs go out over a real
+// socket (e.g. to the replay server of a CRYPTOBAR_API_BASE build); anything
+// else fails with HTTPC_ERROR_CONNECTION_REFUSED / NET_ERR_CONNECT.
+struct HostHttpStats {
+  uint32_t requests;
+  uint32_t served;     // answered from a route
+  uint32_t unmatched;  // no route, not http:// (connection refused)
+  uint32_t network;    // sent over a socket
+  uint64_t bytes;      // response body bytes (lite_http over a socket: incl. chunk framing)
+};
+
+bool hostHttpAddRoute(const char* pattern, const char* fixturePath, int code = 200);
+void hostHttpAddRouteBody(const char* pattern, const char* body, int code = 200);
+void hostHttpClearRoutes();
+const HostHttpStats& hostHttpStats();
+void hostHttpResetStats();
+
+// ==================== Preferences (NVS) =====================
+// In-memory store shared by every Preferences instance; lives for the process.
+void hostPrefsClear();
@@ -0,0 +1,16 @@
+/* CryptoBar V0.99s (Host build)
+ * host_time.c - time() follows the host clock shim (real or virtual)
+ *
+ * Defined in C so the signature matches libc's declaration on every host
+ * (C++ headers differ in their exception specifications). The executable's
+ * definition takes precedence over libc's for firmware code.
+ */
+#include <time.h>
+
+time_t hostClockUtcC(void);
+
+time_t time(time_t* out) {
+  time_t now = hostClockUtcC();
+  if (out) *out = now;
+  return now;
+}
@@ -0,0 +1,15 @@
+// CryptoBar V0.99s (Host build)
+// rom/crc.h - ESP32 ROM CRC32 for host builds (bitwise, same results as the ROM table)
+#pragma once
+
+#include <stdint.h>
+
+// IEEE CRC32, reflected; crc32_le(0, buf, len) matches zlib's crc32().
+static inline uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (uint8_t k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
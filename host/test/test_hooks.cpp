@@ -0,0 +1,24 @@
+// CryptoBar V0.99s (Host unit tests)
+// test_hooks.cpp - Firmware globals the tested modules expect from main.cpp
+//
+// Linked into every [env:native_test] program (test/test_*/), so each test
+// directory gets the same display and coin selection the device has.
+#include <Arduino.h>
+
+#include "app_state.h"
+#include "coins.h"
+#include "epd_display.h"
+
+// ==================== Firmware hooks =====================
+// On the device these live in main.cpp.
+
+const CoinInfo& currentCoin() {
+  int n = coinCount();
+  if (g_currentCoinIndex < 0) g_currentCoinIndex = 0;
+  if (g_currentCoinIndex >= n) g_currentCoinIndex = n - 1;
+  return coinAt(g_currentCoinIndex);
+}
+
+EpdDisplay display(
+  GxEPD2_290_BS(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY)
+);
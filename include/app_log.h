@@ -0,0 +1,80 @@
+// CryptoBar V0.99s (Async logging)
+// app_log.h - Compile-time log levels per module + lock-free ring drained by a low-priority task
+#pragma once
+
+#include <Arduino.h>
+
+// Set to 0 to print synchronously from the caller (pre-V0.99s behaviour).
+#ifndef LOG_ASYNC_ENABLE
+#define LOG_ASYNC_ENABLE 1
+#endif
+
+// Levels
+#define LOG_LEVEL_NONE    0
+#define LOG_LEVEL_ERROR   1
+#define LOG_LEVEL_WARN    2
+#define LOG_LEVEL_INFO    3
+#define LOG_LEVEL_DEBUG   4  // per-fetch URLs, raw fields, parsed values
+#define LOG_LEVEL_VERBOSE 5  // full payload dumps
+
+#ifndef LOG_LEVEL_DEFAULT
+#define LOG_LEVEL_DEFAULT LOG_LEVEL_INFO
+#endif
+
+// Per-module levels (override with e.g. -DLOG_LEVEL_NET=LOG_LEVEL_DEBUG).
+// A call above its module's level is an `if (0)` and compiles to nothing.
+#ifndef LOG_LEVEL_NET
+#define LOG_LEVEL_NET LOG_LEVEL_DEFAULT     // network.cpp (price / history / FX)
+#endif
+#ifndef LOG_LEVEL_TIME
+#define LOG_LEVEL_TIME LOG_LEVEL_DEFAULT    // app_time.cpp (NTP, timezone)
+#endif
+#ifndef LOG_LEVEL_SCHED
+#define LOG_LEVEL_SCHED LOG_LEVEL_DEFAULT   // app_scheduler.cpp
+#endif
+#ifndef LOG_LEVEL_RENDER
+#define LOG_LEVEL_RENDER LOG_LEVEL_DEFAULT  // render_task.cpp, refresh_scheduler.cpp, ui.cpp
+#endif
+#ifndef LOG_LEVEL_MAIN
+#define LOG_LEVEL_MAIN LOG_LEVEL_DEFAULT    // main.cpp loop
+#endif
+#ifndef LOG_LEVEL_HEAP
+#define LOG_LEVEL_HEAP LOG_LEVEL_DEFAULT    // heap_monitor.cpp
+#endif
+
+// Ring size: LOG_RING_SLOTS lines of up to LOG_LINE_MAX chars (power of two slots).
+// Longer lines are cut; a full ring drops the line and counts it.
+#ifndef LOG_RING_SLOTS
+#define LOG_RING_SLOTS 64
+#endif
+#ifndef LOG_LINE_MAX
+#define LOG_LINE_MAX 160
+#endif
+
+#define LOG_ENABLED(mod, lvl) (LOG_LEVEL_##mod >= LOG_LEVEL_##lvl)
+
+// One line per call; the newline is added.
+#define LOG_AT(mod, lvl, ...) \
+  do { if (LOG_ENABLED(mod, lvl)) appLogPrintf(__VA_ARGS__); } while (0)
+
+#define LOGE(mod, ...) LOG_AT(mod, ERROR, __VA_ARGS__)
+#define LOGW(mod, ...) LOG_AT(mod, WARN, __VA_ARGS__)
+#define LOGI(mod, ...) LOG_AT(mod, INFO, __VA_ARGS__)
+#define LOGD(mod, ...) LOG_AT(mod, DEBUG, __VA_ARGS__)
+#define LOGV(mod, ...) LOG_AT(mod, VERBOSE, __VA_ARGS__)
+
+// Start the drain task (priority 1). Until then, and with
+// LOG_ASYNC_ENABLE=0, lines are printed synchronously.
+void appLogBegin(uint8_t core);
+
+// Format one line into the ring (never blocks; safe from any task, not from ISRs).
+void appLogPrintf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+
+// Log a long text as several lines of LOG_LINE_MAX chars, each prefixed with tag.
+void appLogDump(const char* tag, const char* text, size_t len);
+
+// Wait until the ring is drained (or timeout), e.g. before ESP.restart().
+void appLogFlush(uint32_t timeoutMs);
+
+// Lines dropped because the ring was full (since boot).
+uint32_t appLogDropped();
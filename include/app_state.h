@@ -3,7 +3,7 @@
 #pragma once
 
 #include <Arduino.h>
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 #include "config.h"
 #include "ui.h"
 #include "chart.h"
@@ -70,8 +70,15 @@ extern const char* REFRESH_MODE_LABELS[];
 extern int    g_displayCurrency;
 extern double g_usdToRate[CURR_COUNT];  // Exchange rates: USD -> other currencies (double for precision)
 extern bool   g_fxValid;
+extern time_t g_fxUpdatedUtc;     // V0.99s: when g_usdToRate[] was last fetched / confirmed (0 = defaults)
 extern time_t g_nextFxUpdateUtc;
 
+// V0.99s: Quote source for non-USD display
+// 0 = USD price x FX table, 1 = native (display currency in the price request, FX as fallback)
+enum QuoteMode { QUOTE_USD_FX = 0, QUOTE_NATIVE = 1 };
+extern int g_quoteMode;
+extern const char* QUOTE_MODE_LABELS[];
+
 // Backward compatibility: g_usdToTwd is a reference to g_usdToRate[CURR_TWD]
 extern double& g_usdToTwd;
 
@@ -83,7 +90,7 @@ extern const char* g_currentHistoryApi;  // Current historical data API (e.g., "
 
 extern uint32_t g_updateIntervalMs;
 
-// Refresh statistics
+// Refresh statistics (partials since last full refresh, maintained by refresh_scheduler)
 extern uint16_t g_partialRefreshCount;
 
 // LED / update / coin settings index
@@ -143,14 +150,6 @@ extern unsigned long g_encPressStart;
 extern volatile int g_encStepAccum;
 extern portMUX_TYPE g_encMux;
 
-// UI redraw throttling
-extern bool g_menuDirty;
-extern bool g_tzDirty;
-extern bool g_coinDirty;
-extern bool g_currencyDirty;  // V0.99f
-extern bool g_updateDirty;    // V0.99r
-extern uint32_t g_lastUiDrawMs;
-extern const uint32_t UI_DRAW_MIN_MS;
 
 // Time / price state
 extern unsigned long lastUpdate;
@@ -173,6 +172,7 @@ extern double g_prefetchChange;
 extern double g_lastPriceUsd;
 extern double g_lastChange24h;
 extern bool   g_lastPriceOk;
+extern bool   g_priceStale;     // V0.99s: g_lastPriceUsd came from the boot cache (fast boot)
 
 // Previous day average reference price
 extern double g_prevDayRefPrice;
@@ -190,8 +190,7 @@ extern int32_t g_localUtcOffsetSec;
 extern ChartSample g_chartSamples[MAX_CHART_SAMPLES];
 extern int         g_chartSampleCount;
 
-// e-paper display
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+// e-paper display: see epd_display.h (EpdDisplay display)
 
 // ==================== WiFi credentials (stored in NVS) =====================
 extern String g_wifiSsid;
@@ -217,7 +216,8 @@ extern AppState g_appState;
 extern uint32_t g_staConnectStartMs;
 extern const uint32_t STA_CONNECT_TIMEOUT_MS;
 
-// Partial refresh limit
+// Safety cap: max partial refreshes between two full refreshes
+// V0.99s: full refreshes are normally scheduled by the ghosting budget (refresh_scheduler.h)
 extern const uint16_t PARTIAL_REFRESH_LIMIT;
 
 // ==================== Periodic NTP resync =====================
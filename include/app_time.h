@@ -5,8 +5,12 @@
 #include <Arduino.h>
 #include <time.h>
 
-// Setup NTP time synchronization
-void setupTime();
+// Start NTP time synchronization (V0.99s: returns immediately; SNTP syncs on the lwIP task)
+void setupTimeBegin();
+
+// Poll the sync started by setupTimeBegin() (loop task). True once finished:
+// clock valid and tick scheduler armed, or 20 s without a sync (NTP FAILED).
+bool setupTimePoll();
 
 // Apply timezone offset to g_localUtcOffsetSec
 void applyTimezone();
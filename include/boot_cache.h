@@ -0,0 +1,34 @@
+// CryptoBar V0.99s (Fast boot)
+// boot_cache.h - Last price, chart and day-average line in NVS, drawn (marked stale) at the next boot
+#pragma once
+
+#include <Arduino.h>
+
+// Set to 0 to compile the fast-boot path out (every boot shows the splash).
+#ifndef BOOT_CACHE_ENABLE
+#define BOOT_CACHE_ENABLE 1
+#endif
+
+// Unforced saves (price ticks) are written at most this often.
+#ifndef BOOT_CACHE_SAVE_INTERVAL_MS
+#define BOOT_CACHE_SAVE_INTERVAL_MS (30UL * 60UL * 1000UL)
+#endif
+
+// One blob in NVS namespace "bootcache": coin ticker, last USD price and 24h
+// change, the ET cycle, the day-average reference and the chart samples
+// (Q16 position + float price, 6 bytes each: <= 1.8 KB for a full day).
+//
+// Saved once the startup history has landed, on price ticks at most every
+// BOOT_CACHE_SAVE_INTERVAL_MS, and before intentional restarts, so a power
+// loss costs at most that much chart. Loop task only.
+
+// Save the current price / chart. force=false is rate-limited. True if written.
+bool bootCacheSave(bool force);
+
+// Load the cache into g_lastPriceUsd / g_lastChange24h, g_chartSamples, the
+// ET cycle, the day-average reference and g_currentHistoryApi. False if there
+// is none or it belongs to another coin (globals untouched).
+bool bootCacheRestore();
+
+// Forget the cache (factory reset).
+void bootCacheClear();
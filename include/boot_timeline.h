@@ -0,0 +1,38 @@
+// CryptoBar V0.99s (Boot timeline)
+// boot_timeline.h - Timestamp of every boot phase, printed on serial and kept across soft resets
+#pragma once
+
+#include <Arduino.h>
+
+#define BOOT_TIMELINE_MAX   24  // marks per boot (later marks are dropped)
+#define BOOT_PHASE_NAME_LEN 12  // including '\0'
+
+// Usage:
+//   bootMark("wifi.up");   // phase reached now
+//
+// Each mark stores millis() since this boot and is printed at once as
+// "[Boot] +812 ms wifi.up (+640)". bootTimelineDump() prints the whole table
+// (at the end of the startup pipeline, serial 'b' / 'B').
+//
+// The table is written through to RTC no-init memory with a CRC (like the
+// profile checkpoint), so after a software reset (maintenance mode, OTA,
+// crash) bootTimelineBegin() restores it as "previous boot" for the
+// maintenance page. bootMark() may be called from any task (the render task
+// marks "first.frame" once that refresh is done), not from ISRs.
+
+struct BootPhaseMark {
+  char     name[BOOT_PHASE_NAME_LEN];
+  uint32_t ms;  // millis() when the phase was reached
+};
+
+// Restore the previous boot's timeline and start this one (first thing in setup()).
+void bootTimelineBegin();
+
+// Record that a phase was reached now.
+void bootMark(const char* phase);
+
+// Copy this boot's / the previous boot's marks. Returns the mark count.
+uint8_t bootTimelineGet(BootPhaseMark* out, uint8_t maxMarks, bool previous);
+
+// Print the table (previous=true: restored timeline), through the log ring.
+void bootTimelineDump(bool previous);
@@ -16,6 +16,10 @@ constexpr int MAX_CHART_SAMPLES = 300;
 extern ChartSample g_chartSamples[MAX_CHART_SAMPLES];
 extern int         g_chartSampleCount;
 
+// V0.99s: First sample index written since the UI last converted the series to
+// the display currency (MAX_CHART_SAMPLES = nothing new). Samples stay in USD.
+extern int         g_chartDirtyFrom;
+
 // 7pm ET cycle state (also defined in main.cpp)
 extern bool   g_cycleInit;
 extern time_t g_cycleStartUtc;
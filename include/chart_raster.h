@@ -0,0 +1,33 @@
+// CryptoBar V0.99s (Chart rasterizer)
+// chart_raster.h - Span-based 1-bpp chart rasterizer with cached geometry
+#pragma once
+
+#include <Arduino.h>
+#include "chart.h"
+
+// Chart rectangle in screen coordinates (all edges inclusive).
+struct ChartRect {
+  int16_t left;
+  int16_t top;
+  int16_t right;
+  int16_t bottom;
+};
+
+// Rasterize the price polyline (and optional dashed reference line) into a
+// private 1-bpp plane and composite the set pixels into the global 'display'.
+//
+// - Prices are mapped to pixels once per geometry change using Q16 fixed point.
+// - Segments use integer Bresenham emitted as per-column vertical spans; when
+// several samples land in the same column, only their min/max envelope is drawn.
+// - The plane is cached: as long as count, generation, reference line and
+// rect are unchanged (e.g. the per-minute time-only refresh), only the
+// composite runs. The caller bumps 'generation' whenever a sample changes
+// (see g_chartDirtyFrom); the samples themselves are not re-read to decide.
+//
+// Safe to call inside every firstPage()/nextPage() pass.
+void chartRasterDraw(const ChartSample* samples, int count, uint32_t generation,
+                     bool refShown, double refPrice,
+                     const ChartRect& rect);
+
+// Drop cached geometry (next draw rebuilds the plane).
+void chartRasterInvalidate();
@@ -7,6 +7,19 @@
 // CoinPaprika (aggregated market data) updates every 30 seconds
 static const uint32_t UPDATE_INTERVAL_MS = 30UL * 1000UL;  // 30 seconds
 
+// ----------------- API endpoints -----------------
+// V0.99s: Build-time base URL override for the replay server (host/replay).
+//   -DCRYPTOBAR_API_BASE=\"http://192.168.1.20:8787\"
+// turns every API URL into <base>/<original host><path> over plain HTTP,
+// e.g. http://192.168.1.20:8787/api.kraken.com/0/public/Ticker?pair=XXRPZUSD
+#ifdef CRYPTOBAR_API_BASE
+#define API_ORIGIN(host)      CRYPTOBAR_API_BASE "/" host
+#define API_ORIGIN_HTTP(host) CRYPTOBAR_API_BASE "/" host
+#else
+#define API_ORIGIN(host)      "https://" host
+#define API_ORIGIN_HTTP(host) "http://" host
+#endif
+
 // ----------------- Timezone Configuration -----------------
 struct TimezoneInfo {
   const char* label;           // Display string in settings menu
@@ -15,10 +15,16 @@ enum DayAvgMode : uint8_t {
 };
 
 // Rolling 24h mean state (5-min buckets)
+constexpr int DAYAVG_ROLLING_MAX = 320;  // > 288 (24h @ 5-min)
+
 void dayAvgRollingReset();
 void dayAvgRollingAdd(time_t sampleUtc, double price);
 bool dayAvgRollingGet(time_t nowUtc, double& outMean);
 int  dayAvgRollingCount();
 
+// V0.99s: Bucket i (0 = oldest) of the rolling buffer, for the warm restart
+// snapshot. Restore by replaying the buckets through dayAvgRollingAdd().
+bool dayAvgRollingAt(int i, time_t& outBucketUtc, double& outPrice);
+
 // Cycle mean computed from current chart buffer (7pm ET cycle)
 bool dayAvgCycleMean(double& outMean);
@@ -0,0 +1,217 @@
+// CryptoBar V0.99s (Shadow-frame e-paper display)
+// epd_display.h - GxEPD2_BW wrapper that diffs every refreshed frame per panel region
+#pragma once
+
+#include <Arduino.h>
+#include <GxEPD2_BW.h>
+
+// ==================== Page height (build flag) =====================
+// GxEPD2 renders a frame in EPD_PAGE_DIVISOR bands of controller rows:
+//   1 = full frame buffer (4736 B, one drawing pass per frame)
+//   2 = half height       (2368 B, two passes)
+//   4 = quarter height    (1184 B, four passes)
+// Every pass re-runs the screen's drawing code, so fewer bytes cost CPU time.
+#ifndef EPD_PAGE_DIVISOR
+#define EPD_PAGE_DIVISOR 1
+#endif
+
+#if EPD_PAGE_DIVISOR != 1 && EPD_PAGE_DIVISOR != 2 && EPD_PAGE_DIVISOR != 4
+#error "EPD_PAGE_DIVISOR must be 1, 2 or 4"
+#endif
+
+// ==================== Frame diff =====================
+// The panel is split into a fixed grid of regions (tiles) in controller
+// coordinates (128x296). With rotation 1 these are the 37x32 px tiles of an
+// 8x4 grid on the 296x128 screen.
+#define EPD_DIFF_TILE_COLS 4
+#define EPD_DIFF_TILE_ROWS 8
+#define EPD_DIFF_TILES     (EPD_DIFF_TILE_COLS * EPD_DIFF_TILE_ROWS)
+
+struct EpdFrameDiff {
+  bool     fullRefresh;                  // frame was sent with a full (flashing) refresh
+  uint32_t changedPixels;                // total pixel transitions in this frame
+  uint16_t tileWidth;
+  uint16_t tileHeight;
+  uint16_t tileChanged[EPD_DIFF_TILES];  // transitions per tile (row-major)
+};
+
+// Called after every completed frame (from whichever task owns the display).
+typedef void (*EpdFrameObserver)(const EpdFrameDiff& diff);
+
+// ==================== Shadow frames =====================
+// 1-bpp copy of what the panel shows ("front", whole panel) and of the page
+// being drawn ("back", one page band), in controller coordinates. Windows,
+// 8-px alignment and page bands follow GxEPD2_BW, so only pixels GxEPD2 really
+// sends are recorded. Each band is diffed into front just before it is sent.
+class EpdFrameShadow {
+ public:
+  EpdFrameShadow();
+
+  // Buffers are owned by the display wrapper (sized at compile time).
+  void attach(uint8_t* front, uint8_t* back, uint16_t w, uint16_t h, uint16_t pageH);
+
+  void setObserver(EpdFrameObserver cb) { m_observer = cb; }
+
+  // Window in controller coordinates (already clipped/aligned like GxEPD2).
+  void setWindow(bool full, int16_t x, int16_t y, int16_t w, int16_t h);
+
+  void beginFrame();
+  void commitPage();  // diff the current band against front, then copy it in
+  void nextPage();    // move to the next band
+  void endFrame();
+  void pauseRecording() { m_recording = false; }
+
+  inline void setPixel(int16_t x, int16_t y, bool black) {
+    if (!m_recording) return;
+    if (x < m_winX || x >= m_winX + m_winW || y < m_bandY || y >= m_bandY + m_bandH) return;
+    uint8_t* p = &m_back[(y - m_bandY) * m_stride + (x >> 3)];
+    uint8_t mask = (uint8_t)(0x80 >> (x & 7));
+    if (black) *p |= mask;
+    else       *p &= (uint8_t)~mask;
+  }
+
+  void fillWindow(bool black);
+
+  const EpdFrameDiff& lastDiff() const { return m_diff; }
+
+  // Number of completed frames (lets a screen tell whether someone else drew since).
+  uint32_t frameCount() const { return m_frames; }
+
+ private:
+  void loadBand();
+
+  uint8_t* m_front;
+  uint8_t* m_back;
+  int16_t  m_w, m_h, m_stride, m_pageH;
+  bool     m_full;
+  int16_t  m_winX, m_winY, m_winW, m_winH;
+  int16_t  m_bandY, m_bandH;
+  bool     m_recording;
+  bool     m_frontValid;  // false until the first full-window frame
+  uint32_t m_frames;
+  EpdFrameObserver m_observer;
+  EpdFrameDiff     m_diff;
+};
+
+// ==================== Display wrapper =====================
+// Drop-in replacement for GxEPD2_BW: draws exactly as before and additionally
+// records each frame into the shadow so callers can see what changed.
+// setFullWindow/setPartialWindow/firstPage/nextPage shadow (not override) the
+// base versions; always call them through the EpdShadowDisplay type.
+template <typename Driver, const uint16_t PageHeight>
+class EpdShadowDisplay : public GxEPD2_BW<Driver, PageHeight> {
+  typedef GxEPD2_BW<Driver, PageHeight> Base;
+
+ public:
+  static const uint16_t kPages       = (Driver::HEIGHT + PageHeight - 1) / PageHeight;
+  static const uint32_t kBufferBytes = (uint32_t)(Driver::WIDTH / 8) * PageHeight;
+  static const uint32_t kShadowBytes = (uint32_t)(Driver::WIDTH / 8) * (Driver::HEIGHT + PageHeight);
+
+  explicit EpdShadowDisplay(Driver drv) : Base(drv) {
+    m_shadow.attach(m_front, m_back, Driver::WIDTH, Driver::HEIGHT, PageHeight);
+  }
+
+  EpdFrameShadow& shadow() { return m_shadow; }
+
+  void setFullWindow() {
+    Base::setFullWindow();
+    m_shadow.setWindow(true, 0, 0, Driver::WIDTH, Driver::HEIGHT);
+  }
+
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    Base::setPartialWindow(x, y, w, h);
+    int16_t px = x, py = y, pw = w, ph = h;
+    toControllerWindow(px, py, pw, ph);
+    m_shadow.setWindow(false, px, py, pw, ph);
+  }
+
+  void firstPage() {
+    m_shadow.beginFrame();
+    Base::firstPage();  // clears via fillScreen(), recorded into the shadow
+  }
+
+  bool nextPage() {
+    m_shadow.commitPage();
+    bool more = Base::nextPage();
+    if (more) {
+      // GxEPD2 cleared its buffer for the next band; do the same in the shadow.
+      m_shadow.nextPage();
+      m_shadow.fillWindow(false);
+    } else {
+      m_shadow.endFrame();
+    }
+    return more;
+  }
+
+  // Abandon the current frame before it is sent (the panel keeps its content).
+  // Only valid before the first nextPage().
+  void cancelFrame() {
+    m_shadow.pauseRecording();
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    Base::drawPixel(x, y, color);
+    if (x < 0 || y < 0 || x >= this->width() || y >= this->height()) return;
+    toController(x, y);
+    m_shadow.setPixel(x, y, color != GxEPD_WHITE);
+  }
+
+  void fillScreen(uint16_t color) override {
+    Base::fillScreen(color);
+    m_shadow.fillWindow(color != GxEPD_WHITE);
+  }
+
+ private:
+  // Same mapping as GxEPD2_BW::drawPixel().
+  void toController(int16_t& x, int16_t& y) const {
+    int16_t t;
+    switch (this->getRotation() & 3) {
+      case 1: t = x; x = y; y = t; x = Driver::WIDTH - x - 1; break;
+      case 2: x = Driver::WIDTH - x - 1; y = Driver::HEIGHT - y - 1; break;
+      case 3: t = x; x = y; y = t; y = Driver::HEIGHT - y - 1; break;
+      default: break;
+    }
+  }
+
+  // Same rotation, clipping and 8-px alignment as GxEPD2_BW::setPartialWindow().
+  void toControllerWindow(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+    int16_t t;
+    switch (this->getRotation() & 3) {
+      case 1:
+        t = x; x = y; y = t;
+        t = w; w = h; h = t;
+        x = Driver::WIDTH - x - w;
+        break;
+      case 2:
+        x = Driver::WIDTH - x - w;
+        y = Driver::HEIGHT - y - h;
+        break;
+      case 3:
+        t = x; x = y; y = t;
+        t = w; w = h; h = t;
+        y = Driver::HEIGHT - y - h;
+        break;
+      default: break;
+    }
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > (int16_t)Driver::WIDTH)  w = Driver::WIDTH - x;
+    if (y + h > (int16_t)Driver::HEIGHT) h = Driver::HEIGHT - y;
+    if (w <= 0 || h <= 0) { w = 0; h = 0; return; }
+    w += x % 8;
+    if (w % 8 > 0) w += 8 - w % 8;
+    x -= x % 8;
+    if (x + w > (int16_t)Driver::WIDTH) w = Driver::WIDTH - x;
+  }
+
+  uint8_t m_front[(Driver::WIDTH / 8) * Driver::HEIGHT];
+  uint8_t m_back[(Driver::WIDTH / 8) * PageHeight];
+  EpdFrameShadow m_shadow;
+};
+
+#define EPD_PAGE_HEIGHT (GxEPD2_290_BS::HEIGHT / EPD_PAGE_DIVISOR)
+
+typedef EpdShadowDisplay<GxEPD2_290_BS, EPD_PAGE_HEIGHT> EpdDisplay;
+
+// e-paper display (defined in main.cpp)
+extern EpdDisplay display;
@@ -0,0 +1,84 @@
+// CryptoBar V0.99s (Heap monitor)
+// heap_monitor.h - Free heap / largest block / stack high-water tracking and low-memory degrade mode
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Set to 0 to drop sampling (host builds); heapMonitorForceDegrade() still works.
+#ifndef HEAP_MONITOR_ENABLE
+#define HEAP_MONITOR_ENABLE 1
+#endif
+
+// Degrade mode is entered as soon as the largest free block drops below
+// ENTER, and left after HEAP_DEGRADE_EXIT_SAMPLES consecutive samples above EXIT.
+// A TLS session alone takes ~40 KB; provider bodies stream through a 1 KB buffer.
+#ifndef HEAP_DEGRADE_ENTER_BYTES
+#define HEAP_DEGRADE_ENTER_BYTES (40 * 1024)
+#endif
+#ifndef HEAP_DEGRADE_EXIT_BYTES
+#define HEAP_DEGRADE_EXIT_BYTES (56 * 1024)
+#endif
+#define HEAP_DEGRADE_EXIT_SAMPLES 3
+
+#define HEAP_SAMPLE_MS      10000
+#define HEAP_TREND_MINUTES  60  // one point per minute, kept across soft resets
+#define HEAP_MAX_TASKS      6
+#define HEAP_TASK_NAME      12  // including '\0'
+
+// In degrade mode network.cpp:
+//   - scans CoinGecko market_chart as it streams in instead of a 16 KB JsonDocument,
+//   - skips the Binance klines history fallback while capture is on (it then
+//     arrives as one ~36 KB String).
+
+struct HeapSample {
+  uint32_t freeBytes;     // heap_caps_get_free_size(MALLOC_CAP_8BIT)
+  uint32_t largestBlock;  // heap_caps_get_largest_free_block(MALLOC_CAP_8BIT)
+  uint32_t minEverFree;   // heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT)
+  uint8_t  fragPct;       // 100 - largest * 100 / free
+};
+
+// One minute of samples: minima over the minute, degraded if it was at any point.
+struct HeapTrendPoint {
+  uint16_t freeKb;
+  uint16_t largestKb;
+  uint16_t minEverKb;
+  uint8_t  degraded;
+  uint8_t  reserved;
+};
+
+struct HeapTaskStack {
+  char     name[HEAP_TASK_NAME];
+  uint32_t stackBytes;    // as passed to xTaskCreate
+  uint32_t minFreeBytes;  // uxTaskGetStackHighWaterMark() (bytes on ESP-IDF)
+};
+
+// Restore the previous boot's trend and take the first sample (call early in setup()).
+void heapMonitorBegin();
+
+// Track a task's stack high-water mark (call after creating it).
+void heapMonitorWatchTask(TaskHandle_t task, uint32_t stackBytes);
+
+// Sample every HEAP_SAMPLE_MS from loop(); force=true samples now (e.g. before a large parse).
+void heapMonitorPoll(bool force = false);
+
+// True while the largest free block is low (or degrade is forced).
+bool heapMonitorDegraded();
+
+// Serial 'd' / host benchmark: hold degrade mode on regardless of the heap.
+void heapMonitorForceDegrade(bool on);
+bool heapMonitorForced();
+
+HeapSample heapMonitorLast();
+uint32_t   heapMonitorDegradeEntries();  // since boot
+
+// Copy the stack table / trend (oldest first). Return the entry count.
+uint8_t heapMonitorTasks(HeapTaskStack* out, uint8_t maxTasks);
+uint8_t heapMonitorTrend(HeapTrendPoint* out, uint8_t maxPoints, bool previous);
+
+// [Heap] / [Stack] lines for the loop's minute report.
+void heapMonitorLogStats();
+
+// Print the stack table and trend to Serial (previous=true: restored trend).
+void heapMonitorDump(bool previous);
@@ -0,0 +1,42 @@
+// CryptoBar V0.99s (HTTP response cache)
+// http_cache.h - Per-URL validators and parsed results, persisted in NVS, for conditional requests
+#pragma once
+
+#include <Arduino.h>
+#include "lite_http.h"
+
+// Set to 0 to compile the cache out (every request is unconditional).
+#ifndef HTTP_CACHE_ENABLE
+#define HTTP_CACHE_ENABLE 1
+#endif
+
+#define HTTP_CACHE_ENTRIES    4   // URLs kept (least recently stored is replaced)
+#define HTTP_CACHE_RESULT_MAX 96  // parsed result bytes per URL (FX: 9 doubles)
+
+// The cache does not keep response bodies: each caller stores its own parsed
+// result (e.g. the FX rate table) next to the URL's ETag / Last-Modified /
+// max-age. A later fetch either skips the request while max-age lasts, or
+// sends the validators and reuses the stored result on 304 Not Modified.
+//
+// Entries live in RAM and are written to NVS (namespace "httpcache", one blob
+// per slot) only when a 200 brings new validators or a new result, so a 304
+// costs no flash write. Loaded lazily on the first lookup; loop task only.
+
+struct HttpCacheEntry {
+  uint32_t           urlHash;    // FNV-1a of the URL; 0 = empty slot
+  uint32_t           storedUtc;  // response time (200, or the last 304)
+  LiteHttpValidators validators;
+  uint16_t           resultLen;
+  uint8_t            result[HTTP_CACHE_RESULT_MAX];
+};
+
+// Copy of the URL's entry. False if the URL has none.
+bool httpCacheLookup(const char* url, HttpCacheEntry& out);
+
+// True while the entry's max-age lasts (needs a valid clock).
+bool httpCacheFresh(const HttpCacheEntry& e, time_t nowUtc);
+
+// After a 200 (result = the parsed data) or a 304 (result = nullptr: keep the
+// stored one). Responses without any validator or max-age are not stored.
+void httpCacheStore(const char* url, const LiteHttpValidators& v, const void* result, size_t resultLen,
+                    time_t nowUtc);
@@ -0,0 +1,52 @@
+// CryptoBar V0.99s (JSON arena)
+// json_arena.h - One long-lived buffer behind every provider JsonDocument
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Arena size: ESTIMATED, not yet measured against the real library. The
+// figures come from the host build's ArduinoJson stand-in, which replays
+// v7.4's 32-bit allocation pattern (native --soak-history binance|kraken):
+// Binance klines (288 rows of 12 fields) ~60.5 KB of pools, strings and block
+// headers; Kraken OHLC ~34 KB for 205 rows (~48 KB for a full cycle); the
+// filtered CoinGecko chart ~13.6 KB. 72 KB leaves ~11 KB for the model's
+// error. Re-measure on the device (maintenance page "JSON arena" peak) or in
+// `pio run -e native` with the real library, and after a parser or library
+// change; a document that outgrows the arena falls back to the heap and is
+// counted, it does not fail.
+#ifndef JSON_ARENA_BYTES
+#define JSON_ARENA_BYTES (72 * 1024)
+#endif
+
+// jsonArenaBegin() allocates the arena once at boot. jsonArenaAllocator then
+// hands out its memory with a bump pointer instead of malloc(); the
+// pointer goes back to zero when the last block of a request is released,
+// so steady-state fetches allocate nothing from the heap and leave no holes.
+//
+// Requests that do not fit (or run before jsonArenaBegin()) fall back to the
+// heap and are counted in heapFallbacks.
+
+struct JsonArenaStats {
+  uint32_t capacity;       // 0 if jsonArenaBegin() failed / was not called
+  uint32_t highWater;      // most bytes in use at once
+  uint32_t allocations;    // blocks served from the arena
+  uint32_t heapFallbacks;  // blocks that went to the heap instead
+};
+
+// Allocate the arena (call early in setup(), before the first fetch).
+bool jsonArenaBegin();
+
+void jsonArenaGetStats(JsonArenaStats& out);
+
+// ArduinoJson allocator. Every provider document, filters included, takes
+// its memory from the arena:
+//   JsonDocument doc(&jsonArenaAllocator);
+class JsonArenaAllocator : public ArduinoJson::Allocator {
+ public:
+  void* allocate(size_t size) override;
+  void  deallocate(void* ptr) override;
+  void* reallocate(void* ptr, size_t newSize) override;
+};
+
+extern JsonArenaAllocator jsonArenaAllocator;
@@ -0,0 +1,112 @@
+// CryptoBar V0.99s (Fixed-buffer HTTP client)
+// lite_http.h - HTTP/1.1 GET over a NetSocket with caller buffers, chunked decoding and redirects
+#pragma once
+
+#include <Arduino.h>
+#include "net_socket.h"
+#include "net_inflate.h"
+
+#define LITE_HTTP_MAX_REDIRECTS 3
+#define LITE_HTTP_URL_MAX       256  // redirect target (Location) kept in the client
+#define LITE_HTTP_ETAG_MAX      64   // longer ETags are not kept (no conditional request)
+
+struct LiteHttpTimeouts {
+  uint32_t connectMs;   // TCP connect + TLS handshake
+  uint32_t headerMs;    // request sent -> end of response headers
+  uint32_t bodyIdleMs;  // longest gap between body reads
+};
+
+// Cache validators of one URL. Sent as If-None-Match / If-Modified-Since when
+// set; replaced from a 200 response's headers, refreshed by a 304's.
+struct LiteHttpValidators {
+  char    etag[LITE_HTTP_ETAG_MAX];  // "" = none
+  char    lastModified[32];          // HTTP-date, "" = none
+  int32_t maxAgeS;                   // Cache-Control max-age minus Age; -1 = none, 0 = no-cache / no-store
+};
+
+// Usage:
+//   static char buf[1024];
+//   LiteHttp http(netSocketDefault(), buf, sizeof(buf));
+//   int code = http.get(url, timeouts);
+//   if (code == 200) deserializeJson(doc, http);  // ArduinoJson custom reader
+//   http.end();
+//
+// With an inflater passed to get() the request offers gzip / deflate and an
+// encoded body is decompressed as it is read; bodyBytes() then counts the
+// decompressed bytes and wireBytes() what arrived.
+//
+// With validators passed to get() the request is conditional: a 304 status
+// means the caller's cached result is still current (no body).
+//
+// No heap: the request line, header lines and body bytes all pass through the
+// caller's buffer (>= 256 bytes; 1 KB keeps socket reads efficient). Header
+// lines longer than the buffer are skipped; only Content-Length,
+// Transfer-Encoding, Content-Encoding, Location, ETag, Last-Modified,
+// Cache-Control and Age are interpreted.
+// Connection: close per request.
+//
+// Redirects (301/302/303/307/308) are followed up to LITE_HTTP_MAX_REDIRECTS,
+// including relative Locations and http <-> https switches.
+class LiteHttp {
+ public:
+  LiteHttp(NetSocket& socket, char* buf, size_t bufLen);
+  ~LiteHttp() { end(); }
+
+  // GET url (http:// or https://). Returns the final HTTP status, or a
+  // NET_ERR_* code. On any status the body can be read until end().
+  int get(const char* url, const LiteHttpTimeouts& timeouts, NetInflate* inflate = nullptr,
+          LiteHttpValidators* validators = nullptr);
+
+  // Body stream (after get()). read(): next byte or -1 at the end / on error.
+  int    read();
+  size_t readBytes(char* out, size_t len);
+
+  // Read the rest of the body into out (NUL-terminated, cut at cap - 1).
+  // Returns the body bytes seen (including any cut off).
+  size_t readAll(char* out, size_t cap);
+
+  int32_t  contentLength() const { return m_contentLength; }  // -1: chunked / until close
+  size_t   bodyBytes() const { return m_bodyRead; }            // decoded body bytes handed out
+  size_t   wireBytes() const { return m_rawRead; }             // body bytes received (before inflate)
+  bool     compressed() const { return m_active != nullptr; }  // body is being inflated
+  int      bodyError() const { return m_bodyError; }           // NET_ERR_* if the body ended early
+  uint32_t headMs() const { return m_headMs; }                 // connect .. headers (all redirects)
+
+  void end();
+
+ private:
+  enum BodyMode : uint8_t { BODY_NONE, BODY_LENGTH, BODY_CHUNKED, BODY_CLOSE };
+
+  int    request(const char* url);
+  int    fill(uint32_t timeoutMs);
+  int    readLine(uint32_t deadlineMs, bool& overflow);
+  bool   nextChunk();
+  size_t readRaw(char* out, size_t len);  // body after transfer decoding, before inflate
+
+  static size_t inflateSource(void* ctx, uint8_t* buf, size_t len);
+
+  NetSocket&       m_sock;
+  char*            m_buf;
+  size_t           m_bufLen;
+  size_t           m_pos;  // read cursor in m_buf
+  size_t           m_len;  // valid bytes in m_buf
+  bool             m_open;
+  LiteHttpTimeouts m_to;
+
+  BodyMode m_mode;
+  int32_t  m_contentLength;
+  uint32_t m_remaining;  // BODY_LENGTH / current chunk
+  size_t   m_bodyRead;
+  size_t   m_rawRead;
+  int      m_bodyError;
+  uint32_t m_headMs;
+
+  NetInflate* m_inflate;   // offered by get()
+  NetInflate* m_active;    // decoding this body
+  uint8_t     m_encoding;  // Content-Encoding: 0 none, else NetInflateFormat + 1
+
+  LiteHttpValidators* m_validators;  // sent by get()
+  LiteHttpValidators  m_seen;        // from the current response's headers
+
+  char m_location[LITE_HTTP_URL_MAX];
+};
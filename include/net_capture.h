@@ -0,0 +1,69 @@
+// CryptoBar V0.99s (Provider response capture)
+// net_capture.h - Opt-in capture of raw API responses to a flash ring on the spiffs partition
+#pragma once
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+// Set to 0 to compile capture out (netCaptureHttpGet() then only does GET + getString()).
+#ifndef NET_CAPTURE_ENABLE
+#define NET_CAPTURE_ENABLE 1
+#endif
+
+// The unused "spiffs" data partition is used raw (no filesystem) as a ring of
+// fixed 64 KB slots, one response per slot, oldest overwritten first. Only the
+// sectors a record needs are erased, and the header is written last, so a
+// power cut mid-write leaves no valid record behind.
+//
+// Capture is off by default; the maintenance page turns it on/off (persisted
+// in NVS), clears the ring and downloads it. The download is the records
+// oldest first in the on-flash format below; host/replay/replay_server
+// serves it back with --capture FILE.
+
+#define NET_CAPTURE_MAGIC     0x31434243UL  // "CBC1" little-endian
+#define NET_CAPTURE_SLOT_SIZE 0x10000UL     // 64 KB
+
+// Flags
+#define NET_CAPTURE_F_TRUNCATED 0x0001  // body cut to fit the slot (fullLen has the real size)
+
+// On-flash / download record header, followed by url[urlLen] and body[bodyLen].
+// Little-endian, no padding.
+struct NetCaptureHeader {
+  uint32_t magic;
+  uint32_t seq;       // increases across reboots
+  uint32_t utc;       // time(nullptr) when the response was read
+  uint32_t uptimeMs;
+  int32_t  httpCode;  // HTTP status or HTTPClient error (< 0)
+  uint16_t flags;
+  uint16_t urlLen;
+  uint32_t bodyLen;   // bytes stored
+  uint32_t fullLen;   // bytes received
+  uint32_t headMs;    // GET(): connect + request + status/headers
+  uint32_t bodyMs;    // getString(): body transfer
+  uint32_t crc;       // CRC-32 (IEEE) of url + body
+};
+
+struct NetCaptureInfo {
+  bool     enabled;    // capturing (persisted setting)
+  bool     available;  // spiffs partition found
+  uint16_t slots;
+  uint16_t records;    // valid records in the ring
+  uint32_t exportBytes;
+  uint32_t oldestUtc;
+  uint32_t newestUtc;
+  uint32_t writeErrors;  // since boot (records dropped on flash errors)
+};
+
+// GET url on an already begun HTTPClient and read the body on 200, recording
+// the response and its timings when capture is on. Returns the HTTP code.
+int netCaptureHttpGet(HTTPClient& http, const char* url, String& payload);
+
+void netCaptureSetEnabled(bool enabled);
+bool netCaptureEnabled();
+bool netCaptureInfo(NetCaptureInfo& out);
+bool netCaptureClear();
+
+// Stream every valid record, oldest first. The sink returns false to abort.
+// Returns the bytes delivered (netCaptureInfo().exportBytes when complete).
+typedef bool (*NetCaptureSink)(const uint8_t* data, size_t len, void* ctx);
+size_t netCaptureExport(NetCaptureSink sink, void* ctx);
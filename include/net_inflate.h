@@ -0,0 +1,105 @@
+// CryptoBar V0.99s (Streaming inflate)
+// net_inflate.h - Pull-based gzip / zlib / raw deflate decoder over a caller-provided window
+#pragma once
+
+#include <Arduino.h>
+
+// Set to 0 to request identity bodies only (no inflate window in network.cpp).
+#ifndef NET_INFLATE_ENABLE
+#define NET_INFLATE_ENABLE 1
+#endif
+
+// Deflate back-references reach up to 32 KB (gzip / zlib default). A smaller
+// window only works for servers known to compress with one: a zlib header
+// asking for more is refused up front, a gzip stream fails at the first
+// reference past the window.
+#ifndef NET_INFLATE_WINDOW_BITS
+#define NET_INFLATE_WINDOW_BITS 15
+#endif
+#define NET_INFLATE_WINDOW_BYTES (1u << NET_INFLATE_WINDOW_BITS)
+
+enum NetInflateFormat : uint8_t {
+  NET_INFLATE_GZIP,     // Content-Encoding: gzip
+  NET_INFLATE_DEFLATE,  // Content-Encoding: deflate (zlib-wrapped, or raw as some servers send it)
+};
+
+enum NetInflateError : int8_t {
+  NET_INFLATE_OK = 0,
+  NET_INFLATE_ERR_INPUT,   // compressed stream ended early
+  NET_INFLATE_ERR_DATA,    // corrupt header / block / code
+  NET_INFLATE_ERR_WINDOW,  // back-reference beyond the window
+};
+
+// Compressed bytes come from a source callback (returns 0 at the end or on an
+// error); decompressed bytes are pulled with read()/readBytes(), so they can
+// feed ArduinoJson directly. Besides the window the decoder holds ~1.4 KB of
+// Huffman tables and a 64-byte input buffer; it never allocates.
+// The gzip trailer's length is checked, the CRC is not.
+class NetInflate {
+ public:
+  typedef size_t (*Source)(void* ctx, uint8_t* buf, size_t len);
+
+  // window: power-of-two size, kept across begin() calls (contents are per stream).
+  NetInflate(uint8_t* window = nullptr, size_t windowLen = 0);
+
+  // Attach (or detach with nullptr) the window, e.g. one borrowed per fetch.
+  // begin() without a window fails with NET_INFLATE_ERR_WINDOW.
+  void setWindow(uint8_t* window, size_t windowLen);
+
+  void begin(Source src, void* ctx, NetInflateFormat format);
+
+  int    read();  // next byte, -1 at the end / on an error
+  size_t readBytes(char* out, size_t len);
+
+  bool            finished() const { return m_state == ST_DONE; }
+  NetInflateError error() const { return m_err; }
+  size_t          inBytes() const { return m_inTotal; }
+  size_t          outBytes() const { return m_outTotal; }
+
+ private:
+  enum State : uint8_t { ST_HEADER, ST_BLOCK, ST_STORED, ST_HUFFMAN, ST_DONE, ST_ERROR };
+
+  struct Huffman {
+    uint16_t counts[16];    // codes per bit length
+    uint16_t symbols[288];  // symbols ordered by code
+  };
+
+  int      getByte();
+  int      peekByte(size_t ahead);
+  uint32_t bits(uint8_t n);
+  void     fail(NetInflateError err);
+
+  bool streamHeader();
+  bool streamTrailer();
+  bool blockHeader();
+  bool dynamicTables();
+  void buildTable(Huffman& h, const uint8_t* lengths, uint16_t n);
+  int  decodeSymbol(const Huffman& h);
+
+  Source m_src;
+  void*  m_ctx;
+  NetInflateFormat m_format;
+  bool   m_zlib;  // deflate: zlib wrapper seen (else raw)
+
+  uint8_t  m_in[64];
+  uint8_t  m_inPos;
+  uint8_t  m_inLen;
+  bool     m_inEnd;
+  uint32_t m_bitBuf;
+  uint8_t  m_bitCnt;
+
+  State           m_state;
+  NetInflateError m_err;
+  bool            m_lastBlock;
+  uint16_t        m_storedLeft;
+  uint16_t        m_copyLen;
+  uint16_t        m_copyDist;
+
+  uint8_t* m_window;
+  size_t   m_windowMask;
+  size_t   m_inTotal;
+  size_t   m_outTotal;
+
+  Huffman m_lit;
+  Huffman m_dist;
+};
@@ -0,0 +1,36 @@
+// CryptoBar V0.99s (Socket abstraction)
+// net_socket.h - Minimal blocking TCP/TLS socket interface under lite_http
+#pragma once
+
+#include <Arduino.h>
+
+// Result codes (negative; same values as the ESP32 HTTPClient's HTTPC_ERROR_*
+// so provider logs read the same whichever client produced them).
+#define NET_ERR_CONNECT    (-1)   // refused / DNS / TLS handshake failed
+#define NET_ERR_SEND       (-2)
+#define NET_ERR_LOST       (-5)   // closed mid-response / malformed response
+#define NET_ERR_ENCODING   (-9)   // corrupt compressed body
+#define NET_ERR_TIMEOUT    (-11)
+
+// One connection at a time. Implementations:
+//   src/net_socket.cpp             device (WiFiClient / WiFiClientSecure)
+//   host/shim/hal_host.cpp         host (HTTP fixture routes, else POSIX TCP)
+class NetSocket {
+ public:
+  virtual ~NetSocket() {}
+
+  // tls: HTTPS (the device does not verify certificates, as HTTPClient without a CA).
+  virtual bool connect(const char* host, uint16_t port, bool tls, uint32_t timeoutMs) = 0;
+
+  // Returns bytes written (all of len) or a NET_ERR_* code.
+  virtual int write(const uint8_t* data, size_t len, uint32_t timeoutMs) = 0;
+
+  // Waits up to timeoutMs for data. Returns bytes read (> 0), 0 when the peer
+  // closed, or a NET_ERR_* code.
+  virtual int read(uint8_t* buf, size_t len, uint32_t timeoutMs) = 0;
+
+  virtual void close() = 0;
+};
+
+// The platform's socket (a static instance; loop task only).
+NetSocket& netSocketDefault();
@@ -19,6 +19,20 @@ void bootstrapHistoryFromKrakenOHLC();
 // Returns: true = success (at least 50% of rates fetched)
 bool fetchExchangeRates();
 
+// V0.99s: Load the last good FX table from NVS into g_usdToRate[] (saved by
+// fetchExchangeRates() whenever the table changes).
+// Returns: true = restored, g_fxUpdatedUtc holds its fetch time
+bool restoreExchangeRates();
+
+// V0.99s: True if the last price (less than an hour ago) came with a native
+// quote in the display currency, so the FX table is not needed for it.
+bool fxQuotedNatively(time_t nowUtc);
+
+// V0.99s: Native quote state (currency of the last native quote, -1 = none,
+// and its time), carried across restarts by the warm restart snapshot.
+void fxNativeQuoteGet(int& cur, time_t& quoteUtc);
+void fxNativeQuoteSet(int cur, time_t quoteUtc);
+
 // USD -> TWD exchange rate (backward compatibility wrapper)
 // Returns: true = success, outRate is populated
 bool fetchUsdToTwdRate(float& outRate);
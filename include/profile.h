@@ -0,0 +1,93 @@
+// CryptoBar V0.99s (Profiling zones)
+// profile.h - Cycle-counter scoped zones with log2 latency histograms, kept across soft resets
+#pragma once
+
+#include <Arduino.h>
+#include "freertos/task.h"
+
+// Set to 0 to compile every PROFILE_ZONE() out.
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE 1
+#endif
+
+#define PROFILE_MAX_ZONES 16
+#define PROFILE_NAME_LEN  16  // including '\0'
+#define PROFILE_BUCKETS   24  // bucket b: < 2^(b+1) us (b=0: < 2 us); the last one is open-ended (>= 8.4 s)
+
+// Usage (one per scope):
+//   bool fetchFoo() {
+//     PROFILE_ZONE("fetch.foo");
+//     ...
+//   }
+// The first pass through a call site registers the zone; after that a zone
+// costs two cycle-counter reads, two tick reads and a short critical section.
+//
+// Durations come from the CPU cycle counter (CCOUNT), which wraps every ~17.9 s
+// at 240 MHz, so zones longer than 10 s fall back to the FreeRTOS tick count.
+//
+// profileCheckpoint() copies the stats into RTC no-init memory with a CRC;
+// after a software reset (e.g. into maintenance mode) profileBegin() restores
+// them as "previous boot" (maint page, serial 'P').
+
+struct ProfileZoneStats {
+  char     name[PROFILE_NAME_LEN];
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t buckets[PROFILE_BUCKETS];
+};
+
+// Restore the previous boot's checkpoint (call early in setup()).
+void profileBegin();
+
+// Find or register a zone (nullptr when the table is full).
+ProfileZoneStats* profileZone(const char* name);
+
+// Add one sample measured elsewhere (e.g. loop() interval).
+void profileRecordUs(ProfileZoneStats* zone, uint32_t us);
+
+// Internal: used by ProfileScope.
+void profileRecordCycles(ProfileZoneStats* zone, uint32_t cycles, uint32_t ticks);
+
+// Snapshot this boot's stats into RTC memory (periodically and before ESP.restart()).
+void profileCheckpoint();
+
+// Copy this boot's / the previous boot's zones. Returns the zone count.
+uint8_t profileSnapshot(ProfileZoneStats* out, uint8_t maxZones);
+uint8_t profilePrevious(ProfileZoneStats* out, uint8_t maxZones, uint32_t* uptimeMs);
+
+// Upper bound of the bucket holding the pct-th percentile sample (0 if empty).
+uint32_t profilePercentileUs(const ProfileZoneStats& zone, uint8_t pct);
+
+// Print a table to Serial (previous=true: restored checkpoint; serial 'p' / 'P').
+void profileDump(bool previous);
+
+#if PROFILE_ENABLE
+
+class ProfileScope {
+ public:
+  explicit ProfileScope(ProfileZoneStats* zone)
+      : m_zone(zone), m_cycles(ESP.getCycleCount()), m_ticks(xTaskGetTickCount()) {}
+  ~ProfileScope() {
+    if (m_zone) profileRecordCycles(m_zone, ESP.getCycleCount() - m_cycles, xTaskGetTickCount() - m_ticks);
+  }
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+ private:
+  ProfileZoneStats* m_zone;
+  uint32_t          m_cycles;
+  TickType_t        m_ticks;
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT2(a, b)
+#define PROFILE_ZONE(name)                                                              \
+  static ProfileZoneStats* PROFILE_CONCAT(s_profZone_, __LINE__) = profileZone(name);   \
+  ProfileScope PROFILE_CONCAT(profScope_, __LINE__)(PROFILE_CONCAT(s_profZone_, __LINE__))
+
+#else
+
+#define PROFILE_ZONE(name) do { } while (0)
+
+#endif  // PROFILE_ENABLE
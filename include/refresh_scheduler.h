@@ -0,0 +1,45 @@
+// CryptoBar V0.99s (Adaptive full-refresh scheduler)
+// refresh_scheduler.h - Ghosting budget from per-region frame diffs + daily refresh metrics
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+// Every completed frame reports how many pixels changed in each panel region
+// (see epd_display.h). Partial refreshes add to a per-region "ghost load";
+// a full refresh clears it. The next main-screen frame is promoted to a full
+// refresh only when:
+// - the worst region exceeds the ghosting budget (stricter in Full mode), or
+// - the ET cycle just rolled over (quiet time) and some ghosting has built up, or
+// - PARTIAL_REFRESH_LIMIT partials have passed since the last full refresh (safety cap).
+
+enum RefreshFullReason : uint8_t {
+  REFRESH_FULL_FORCED = 0,  // caller asked for it (startup, leaving a menu, ...)
+  REFRESH_FULL_BUDGET = 1,
+  REFRESH_FULL_QUIET  = 2,
+  REFRESH_FULL_CAP    = 3
+};
+
+// Refresh counts for one ET cycle (7pm-7pm)
+struct RefreshDayStats {
+  uint32_t fullCount;
+  uint32_t partialCount;
+  uint32_t fullByReason[4];  // indexed by RefreshFullReason
+  uint32_t changedPixels;    // pixel transitions over all frames
+};
+
+// Attach to the display's frame diffs (call after display.init()).
+void refreshSchedulerBegin();
+
+// Decide the refresh type of the next main-screen frame.
+// Must be called by the display owner right before drawing it.
+bool refreshSchedulerWantFull(bool requestedFull, time_t cycleStartUtc);
+
+// Worst-region ghost load relative to the active budget (0-100+ %).
+uint16_t refreshSchedulerGhostPercent();
+
+// Copy current and previous cycle metrics.
+void refreshSchedulerGetStats(RefreshDayStats& today, RefreshDayStats& yesterday);
+
+// Print today's metrics to Serial.
+void refreshSchedulerLogStats();
@@ -0,0 +1,90 @@
+// CryptoBar V0.99s (Async e-paper render task)
+// render_task.h - Prioritized, latest-state-wins render queue for the e-paper panel
+#pragma once
+
+#include <Arduino.h>
+
+// Set to 0 to render synchronously on the loop task (pre-V0.99s behaviour,
+// useful for comparing the "[Loop]" stall statistics).
+#ifndef RENDER_TASK_ENABLE
+#define RENDER_TASK_ENABLE 1
+#endif
+
+// Redraw requests are queued and rendered by a dedicated task, so GxEPD2's
+// BUSY wait no longer stalls loop() / encoder / prefetch.
+//
+// Two request classes, each holding at most one pending request (a newer
+// request supersedes the pending one, keeping its stronger refresh needs):
+// - Input feedback (menu cursor moves): captured into a UiMenuModel snapshot,
+// rendered first, no throttling.
+// - Main screen (price tick, FX update, clock): captured into a UiMainModel
+// snapshot. Requests made during one loop() pass are held and released
+// together by renderTaskFlush(), so a price / FX / clock refresh due in the
+// same second become one panel update (price beats clock: the merged frame
+// is time-only only if every merged request was).
+//
+// A frame that is still drawing when a newer input request arrives is
+// abandoned before it is sent to the panel (see renderTaskPreempted()).
+//
+// Every other screen still draws synchronously, wrapped in DisplayLock, which
+// drops pending requests and preempts / waits for an in-flight frame.
+
+// Start the render task and hook the EPD BUSY interrupt (call after display.init()).
+void renderTaskBegin(uint8_t core);
+
+// Snapshot current UI state and queue a main-screen render.
+// timeOnly=true marks a clock refresh (may be merged into a pending price frame).
+void renderTaskSubmitMain(double priceUsd, double change24h, bool fullRefresh, bool timeOnly);
+
+// Queue a redraw of a list menu (uiMode: UI_MODE_MENU / _TZ_SUB / _COIN_SUB /
+// _CURRENCY_SUB / _UPDATE_SUB). The page is captured into a UiMenuModel here,
+// on the calling (loop) task. Supersedes any pending input redraw.
+void renderTaskSubmitInput(uint8_t uiMode, bool fullRefresh);
+
+// Record boot phase 'phase' (bootMark) once the main-screen frame just
+// submitted is on the panel, i.e. from the render task after its refresh.
+// Carried over if the request is merged; lost if the frame is cancelled or
+// preempted. Synchronous rendering marks it at once. phase must be a literal.
+void renderTaskMarkBootPhase(const char* phase);
+
+// Release main-screen requests held during the current loop() pass.
+void renderTaskFlush();
+
+// Drop all queued (not yet started) requests.
+void renderTaskCancelPending();
+
+// Block until nothing is pending or rendering (or timeout). Returns true when idle.
+bool renderTaskWaitIdle(uint32_t timeoutMs);
+
+// For drawing code: true on the render task when a newer input request (or a
+// synchronous screen) is waiting and the current frame should be abandoned.
+// Only check before the first page is sent to the panel.
+bool renderTaskPreempted();
+
+// Print render statistics to Serial.
+void renderTaskLogStats();
+
+struct RenderTaskStats {
+  uint32_t framesRendered;
+  uint32_t inputFrames;
+  uint32_t framesDropped;    // superseded before rendering started
+  uint32_t framesMerged;     // main requests folded into a held one (same pass)
+  uint32_t framesCancelled;  // cancelled by a synchronous screen
+  uint32_t framesPreempted;  // abandoned mid-draw for newer input
+  uint32_t maxRenderMs;      // whole frame (CPU + BUSY)
+};
+
+// Counters since boot (read without locking; for reports and benchmarks).
+void renderTaskGetStats(RenderTaskStats& out);
+
+// RAII guard for synchronous drawing to 'display'.
+class DisplayLock {
+ public:
+  DisplayLock();
+  ~DisplayLock();
+  DisplayLock(const DisplayLock&) = delete;
+  DisplayLock& operator=(const DisplayLock&) = delete;
+
+ private:
+  bool m_held;
+};
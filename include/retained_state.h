@@ -0,0 +1,24 @@
+// CryptoBar V0.99s (Retained state)
+// retained_state.h - Shared integrity check for state kept across software resets
+#pragma once
+
+#include <Arduino.h>
+#include <rom/crc.h>
+
+// The profile checkpoint, heap trend ring and boot timeline live in RTC slow
+// memory (RTC_NOINIT_ATTR, 8 KB, shared with the trace ring); the ~5 KB
+// warm-restart snapshot does not fit beside them and lives in .noinit
+// internal RAM (__NOINIT_ATTR). Both
+// keep their contents across software resets (ESP.restart(), panic,
+// watchdog) but hold garbage after power-on, so each block starts with a
+// magic and a layout version and ends with a CRC over everything before it:
+//
+//   s.magic = kMagic;  // last field written before the CRC
+//   s.crc   = retainedCrc(&s, offsetof(Saved, crc));
+//
+// A block is trusted only if magic, version and CRC all match.
+
+// CRC32 (IEEE, as zlib) of the first len bytes, via the ROM routine.
+static inline uint32_t retainedCrc(const void* data, size_t len) {
+  return crc32_le(0, (const uint8_t*)data, (uint32_t)len);
+}
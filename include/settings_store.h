@@ -28,6 +28,8 @@ struct StoredSettings {
   int rfMode    = 1;
  // Display currency: CURR_USD or CURR_NTD
   int dispCur   = (int)CURR_USD;
+ // V0.99s: Quote source (0 = USD+FX, 1 = native display currency)
+  int quoteMd   = 1;
 };
 
 // Returns true if read succeeded (even if keys missing; defaults will apply).
@@ -36,6 +38,12 @@ bool settingsStoreLoad(StoredSettings& out);
 // Returns true if write succeeded.
 bool settingsStoreSave(const StoredSettings& in);
 
+// V0.99s: Last good FX table (USD -> CURRENCY_INFO order, count entries) and
+// the UTC time it was fetched. Load fails if nothing (or a table of another
+// size) is stored.
+bool settingsStoreLoadFx(double* rates, size_t count, uint32_t& outUtc);
+bool settingsStoreSaveFx(const double* rates, size_t count, uint32_t utc);
+
 // Returns true if tzIndex key exists in NVS.
 // Used to decide whether we should auto-detect timezone on first setup.
 bool settingsStoreHasTzIndex();
@@ -0,0 +1,81 @@
+// CryptoBar V0.99s (Event trace)
+// trace.h - Fixed-size binary event ring, exported as Chrome Trace Event JSON
+#pragma once
+
+#include <Arduino.h>
+
+// Set to 0 to compile every trace point out (traceExport() then returns an empty trace).
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1
+#endif
+
+// Ring size in events (12 bytes each, power of two).
+#ifndef TRACE_RING_EVENTS
+#define TRACE_RING_EVENTS 256
+#endif
+
+// Events are 12-byte records in RTC no-init memory, oldest overwritten first,
+// so the ring survives the software reset into maintenance mode: each boot is
+// one "process" (pid = boot number) in the exported trace, each FreeRTOS task
+// one thread. Timestamps are micros() since that boot.
+//
+// Load /trace.json (maintenance page) or the host tools' --trace output in
+// chrome://tracing or https://ui.perfetto.dev.
+
+enum TraceEventId : uint8_t {
+  TRACE_BOOT = 0,        // instant, first event of a boot
+  TRACE_PREFETCH,        // prefetch-to-tick price fetch (main.cpp)
+  TRACE_FETCH_CG,        // fetchPriceFromCoingecko
+  TRACE_FETCH_CP,        // fetchPriceFromPaprika
+  TRACE_FETCH_KRAKEN,    // fetchPriceFromKraken
+  TRACE_FETCH_BINANCE,   // fetchPriceFromBinance
+  TRACE_FETCH_FX,        // fetchExchangeRates
+  TRACE_HISTORY,         // bootstrapHistoryFromKrakenOHLC (all providers)
+  TRACE_PARSE,           // deserializeJson (arg: payload bytes)
+  TRACE_RENDER,          // one render_task frame
+  TRACE_PANEL_BUSY,      // EPD BUSY wait (complete event)
+  TRACE_NTP_SYNC,        // setupTimeBegin() .. first sync (background)
+  TRACE_NTP_UPDATE,      // instant: SNTP applied a time update
+  TRACE_WIFI_CONNECT,    // connectWiFiSta (arg: 1 = connected)
+  TRACE_EVENT_COUNT
+};
+
+void traceBegin();  // call once early in setup()
+
+// Trace clock (micros() unless replaced). Host tools running on the virtual
+// clock of host/shim point it at wall time.
+uint32_t traceNowUs();
+void     traceSetClock(uint32_t (*nowUs)());
+
+void traceBeginEvent(TraceEventId id);
+void traceEndEvent(TraceEventId id, uint32_t arg = 0);
+void traceInstant(TraceEventId id, uint32_t arg = 0);
+void traceComplete(TraceEventId id, uint32_t startUs, uint32_t durUs);  // startUs from traceNowUs()
+
+// Stream the ring as Chrome Trace Event JSON. The sink returns false to abort.
+// Returns the bytes delivered.
+typedef bool (*TraceSink)(const uint8_t* data, size_t len, void* ctx);
+size_t traceExport(TraceSink sink, void* ctx);
+
+#if TRACE_ENABLE
+
+class TraceScope {
+ public:
+  explicit TraceScope(TraceEventId id) : m_id(id) { traceBeginEvent(id); }
+  ~TraceScope() { traceEndEvent(m_id); }
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  TraceEventId m_id;
+};
+
+#define TRACE_CONCAT2(a, b) a##b
+#define TRACE_CONCAT(a, b)  TRACE_CONCAT2(a, b)
+#define TRACE_SCOPE(id)     TraceScope TRACE_CONCAT(traceScope_, __LINE__)(id)
+
+#else
+
+#define TRACE_SCOPE(id) do { } while (0)
+
+#endif  // TRACE_ENABLE
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <Arduino.h>
+#include <time.h>
 #include "config.h"
+#include "chart.h"
 
 // ===== Date/Time Formats =====
 
@@ -28,6 +30,7 @@ enum MenuItem {
   MENU_DATE_FORMAT,
   MENU_DATETIME_SIZE,
   MENU_CURRENCY,
+  MENU_QUOTE,
   MENU_TIMEZONE,
   MENU_DAYAVG_LINE,
   MENU_FIRMWARE_UPDATE,
@@ -52,13 +55,76 @@ void drawWifiInfoScreen(const char* version, const char* mac, const char* staIp,
 void drawFirmwareUpdateConfirmScreen(const char* version);
 void drawFirmwareUpdateApScreen(const char* version, const char* apSsid, const char* apIp, bool fullRefresh = true);
 
+// V0.99s: Everything the main screen needs, captured at submit time so the
+// render task never reads globals that loop() is modifying.
+struct UiMainModel {
+  double priceUsd;
+  double change24h;
+  char   ticker[12];
+  char   priceApi[16];
+  char   historyApi[16];
+  int    displayCurrency;
+  double fxRate;           // USD -> display currency (1.0 for USD)
+  int    dtSize;           // 0=Small, 1=Large
+  int    dateFormat;
+  int    timeFormat;
+  bool   timeOk;
+  struct tm local;         // local time at capture
+  time_t cycleStartUtc;    // ET cycle the frame belongs to (refresh scheduler rollover)
+  bool   refShown;         // day-average line visible
+  double refPrice;         // display currency
+  int    chartCount;
+  uint32_t chartGen;       // bumped whenever chart[] changes (raster cache key)
+  ChartSample chart[MAX_CHART_SAMPLES];  // display currency
+};
+
+// Capture current global state into a model (call from the loop task).
+void uiCaptureMainModel(UiMainModel& m, double priceUsd, double change24h);
+
+// Render a captured model (used by render_task; does not take DisplayLock).
+// Returns false when the frame was abandoned for newer input (renderTaskPreempted()).
+bool uiRenderMainScreen(const UiMainModel& m, bool fullRefresh, bool timeOnly);
+
 // Main price display screen: coin symbol from currentCoin()
+// V0.99s: Queued to the render task (see render_task.h); returns immediately.
 void drawMainScreen(double priceUsd, double change24h, bool fullRefresh);
 
 // V0.99q: Time-only refresh (updates only date/time area, not price/chart)
 // This allows the clock to stay current even with long price update intervals
 void drawMainScreenTimeOnly(bool fullRefresh = false);
 
+// V0.99s: One page of a list menu, captured on the loop task like UiMainModel
+// (cursor, scroll position and the printed labels), so the render task never
+// reads the menu indices or settings while loop() changes them.
+#define UI_MENU_VISIBLE_LINES 5
+#define UI_MENU_LABEL_LEN     32
+
+struct UiMenuModel {
+  uint8_t mode;      // UI_MODE_MENU / _TZ_SUB / _COIN_SUB / _CURRENCY_SUB / _UPDATE_SUB
+  int     total;
+  int     first;     // top row
+  int     selected;
+  char    labels[UI_MENU_VISIBLE_LINES][UI_MENU_LABEL_LEN];  // rows first .. first + visible - 1
+};
+
+// Scroll the active list so its cursor is visible and capture the page
+// (call from the loop task). False for a mode that is not a list menu.
+bool uiCaptureMenuModel(UiMenuModel& m, uint8_t uiMode);
+
+// Render a captured page (used by render_task; does not take DisplayLock).
+void uiRenderMenu(const UiMenuModel& m, bool fullRefresh);
+
+// Per-list capture (page fields only; mode is set by uiCaptureMenuModel).
+// Each one fills the page with uiMenuFillPage() and its own label formatter.
+typedef void (*UiMenuFormatFn)(int index, char* out, size_t len);
+void uiMenuFillPage(UiMenuModel& m, int total, int first, int selected, UiMenuFormatFn format);
+
+void captureMainMenu(UiMenuModel& m);
+void captureTimezoneMenu(UiMenuModel& m);
+void captureCoinMenu(UiMenuModel& m);
+void captureCurrencyMenu(UiMenuModel& m);
+void captureUpdateMenu(UiMenuModel& m);
+
 // Main settings menu
 void drawMenuScreen(bool fullRefresh);
 void ensureMainMenuVisible();
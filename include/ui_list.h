@@ -4,6 +4,12 @@
 
 // Simple list-page renderer for e-paper UI (used by settings subpages).
 // Rendering is done directly to the global 'display' object.
+//
+// V0.99s: uiDrawListPage() owns the whole frame (window + page loop). It remembers
+// the page it drew last; when only the cursor moved inside the same visible page
+// (and nothing else was drawn in between), it refreshes a partial window covering
+// just the old and new cursor rows (full width, so the scrollbar track is included).
+// Scrolling, label changes on the same row and fullRefresh redraw the whole page.
 
 struct UiListLayout {
   int x;           // left margin
@@ -25,4 +31,5 @@ void uiDrawListPage(const char* title,
                     int firstIndex,
                     int visibleLines,
                     int selectedIndex,
-                    UiListPrintItemFn printItem);
+                    UiListPrintItemFn printItem,
+                    bool fullRefresh);
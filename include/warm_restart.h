@@ -0,0 +1,65 @@
+// CryptoBar V0.99s (Warm restart)
+// warm_restart.h - Runtime state snapshot across intentional software restarts
+#pragma once
+
+#include <Arduino.h>
+#include <time.h>
+
+// Set to 0 to compile the snapshot out (every restart rebuilds over the network).
+#ifndef WARM_RESTART_ENABLE
+#define WARM_RESTART_ENABLE 1
+#endif
+
+// A restored chart older than this is re-bootstrapped from the history APIs
+// (the samples missed while the device was restarting would leave a gap).
+#ifndef WARM_RESTART_HISTORY_MAX_AGE_SEC
+#define WARM_RESTART_HISTORY_MAX_AGE_SEC (15 * 60)
+#endif
+
+// A whole snapshot older than this (e.g. after a long maintenance session) is
+// ignored: price, FX and prefetch would be restored stale.
+#ifndef WARM_RESTART_MAX_AGE_SEC
+#define WARM_RESTART_MAX_AGE_SEC (30 * 60)
+#endif
+
+// Usage:
+//   warmRestartSave();  ESP.restart();     // maintenance / firmware update request
+//   ...
+//   warmRestartRestore();                  // next normal boot, after loadSettings()
+//
+// The snapshot holds the chart samples and ET cycle, the rolling 24h mean
+// buckets, the last price / 24h change / day-average reference, the FX table
+// and native quote state, a pending prefetch and the active provider labels.
+// It lives in no-init RAM (kept across software resets, not power-on) with
+// magic, layout version, size and CRC, and records CRYPTOBAR_VERSION and the
+// save time. A snapshot from another firmware build or older than
+// WARM_RESTART_MAX_AGE_SEC is ignored, so the device boots as before.
+//
+// The maintenance-mode boot does not restore it, so it can carry over to the
+// boot after maintenance mode if nothing changed. A successful firmware upload
+// discards it (warmRestartDiscard()). Restoring consumes it. Setup / loop task
+// only.
+
+// Snapshot the runtime state (right before an intentional ESP.restart()).
+void warmRestartSave();
+
+// Validate, consume and apply the snapshot. False if there is none, it does
+// not match this firmware (layout or version), is too old, or belongs to
+// another coin.
+bool warmRestartRestore();
+
+// Drop the snapshot without applying it (e.g. a new image was flashed).
+void warmRestartDiscard();
+
+// True if this boot's state came from a snapshot.
+bool warmRestartRestored();
+
+// True if the restored chart is recent enough to skip the history bootstrap
+// (nowUtc must be a valid clock).
+bool warmRestartChartFresh(time_t nowUtc);
+
+#ifdef PIO_UNIT_TESTING
+// Raw snapshot for test/test_warm_restart (corrupt or re-version it). The CRC
+// at crcOffset covers the bytes before it (retainedCrc()).
+uint8_t* warmRestartSnapshotRaw(size_t& crcOffset);
+#endif
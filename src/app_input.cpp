@@ -15,6 +15,10 @@
 #include "maint_boot.h"
 #include "wifi_portal.h"
 #include "ui.h"
+#include "app_log.h"
+#include "profile.h"
+#include "boot_cache.h"
+#include "warm_restart.h"
 
 // Forward declarations for UI functions that remain in main.cpp
 extern void showWifiSetupRequired(unsigned long splashStartMs, bool enforceSplashDelay);
@@ -67,7 +71,11 @@ void handleLongPress() {
  // (Avoids switching WiFi modes while other work may be in progress.)
     drawFirmwareUpdateApScreen(CRYPTOBAR_VERSION, "Rebooting to Update AP...", "");
     Serial.println("[MAINT] Request (reboot into update AP)");
+    bootCacheSave(true);  // V0.99s: the boot after the update starts from this screen
+    warmRestartSave();    // V0.99s: ...with chart, mean, FX and prefetch intact
     maintBootRequest();
+    profileCheckpoint();
+    appLogFlush(500);
     delay(80);
     ESP.restart();
   }
@@ -114,11 +122,14 @@ void handleFactoryReset() {
 
  // Also clear saved WiFi creds so the device truly returns to "provisioning required"
   clearWifiCreds();
+  bootCacheClear();  // V0.99s: next boot shows the splash, not the last coin
 
  // Stop any WiFi/AP activity and reboot cleanly
   wifiPortalStop();
   WiFi.disconnect(true);
   WiFi.mode(WIFI_OFF);
+  profileCheckpoint();
+  appLogFlush(500);
   delay(200);
 
   ESP.restart();
@@ -0,0 +1,184 @@
+// CryptoBar V0.99s (Async logging)
+// app_log.cpp - Lock-free log ring (multi-producer, single consumer) + drain task
+#include "app_log.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#if LOG_ASYNC_ENABLE
+#include <atomic>
+#include "heap_monitor.h"
+#endif
+
+static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS must be a power of two");
+
+// Synchronous path: before appLogBegin() and with LOG_ASYNC_ENABLE=0.
+static void writeLineSync(const char* fmt, va_list ap) {
+  char line[LOG_LINE_MAX + 2];
+  int n = vsnprintf(line, sizeof(line) - 1, fmt, ap);
+  if (n < 0) return;
+  if (n > LOG_LINE_MAX) n = LOG_LINE_MAX;
+  line[n++] = '\n';
+  Serial.write((const uint8_t*)line, (size_t)n);
+}
+
+#if LOG_ASYNC_ENABLE
+
+// ==================== Ring =====================
+//
+// Bounded MPSC queue with per-slot sequence numbers (Vyukov). A producer claims
+// a position with one CAS on s_head, formats straight into the slot and
+// publishes it by bumping the slot's sequence; the drain task consumes slots in
+// order. Nothing blocks: a full ring drops the line.
+//
+// Slot i stores (sequence - i) so the zero-initialized ring is already valid
+// before appLogBegin() runs.
+
+struct LogSlot {
+  std::atomic<uint32_t> seq;
+  uint16_t len;
+  char     text[LOG_LINE_MAX + 2];  // + '\n' + '\0'
+};
+
+static const uint32_t kMask = LOG_RING_SLOTS - 1;
+
+static LogSlot               s_ring[LOG_RING_SLOTS];
+static std::atomic<uint32_t> s_head(0);
+static std::atomic<uint32_t> s_tail(0);
+static std::atomic<uint32_t> s_dropped(0);
+static TaskHandle_t          s_task = nullptr;
+static const uint32_t        kDrainStackBytes = 3072;
+
+static inline uint32_t slotSeq(const LogSlot& s, uint32_t idx) {
+  return s.seq.load(std::memory_order_acquire) + idx;
+}
+
+static void ringPush(const char* fmt, va_list ap) {
+  uint32_t pos = s_head.load(std::memory_order_relaxed);
+  LogSlot* slot;
+  for (;;) {
+    slot = &s_ring[pos & kMask];
+    int32_t diff = (int32_t)(slotSeq(*slot, pos & kMask) - pos);
+    if (diff == 0) {
+      if (s_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      s_dropped.fetch_add(1, std::memory_order_relaxed);  // full
+      return;
+    } else {
+      pos = s_head.load(std::memory_order_relaxed);
+    }
+  }
+
+  int n = vsnprintf(slot->text, LOG_LINE_MAX + 1, fmt, ap);
+  if (n < 0) n = 0;
+  if (n > LOG_LINE_MAX) {
+    n = LOG_LINE_MAX;
+    memcpy(slot->text + n - 3, "...", 3);  // mark cut lines
+  }
+  slot->text[n++] = '\n';
+  slot->len = (uint16_t)n;
+  slot->seq.store(pos + 1 - (pos & kMask), std::memory_order_release);
+}
+
+// Single consumer. Returns the number of lines written.
+static uint32_t ringDrain() {
+  uint32_t tail  = s_tail.load(std::memory_order_relaxed);
+  uint32_t lines = 0;
+  for (;;) {
+    const uint32_t idx = tail & kMask;
+    LogSlot& slot = s_ring[idx];
+    if (slotSeq(slot, idx) != tail + 1) break;  // empty, or producer still formatting
+
+    Serial.write((const uint8_t*)slot.text, slot.len);
+    slot.seq.store(tail + LOG_RING_SLOTS - idx, std::memory_order_release);
+    tail++;
+    s_tail.store(tail, std::memory_order_release);
+    lines++;
+  }
+  return lines;
+}
+
+// ==================== Drain task =====================
+
+static void logDrainTask(void*) {
+  uint32_t reportedDrops = 0;
+  for (;;) {
+    ringDrain();
+
+    uint32_t drops = s_dropped.load(std::memory_order_relaxed);
+    if (drops != reportedDrops) {
+      Serial.printf("[Log] %lu line(s) dropped (ring full)\n", (unsigned long)(drops - reportedDrops));
+      reportedDrops = drops;
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+
+#endif  // LOG_ASYNC_ENABLE
+
+// ==================== Public API =====================
+
+void appLogBegin(uint8_t core) {
+#if LOG_ASYNC_ENABLE
+  if (s_task) return;
+  if (core > 1) core = 0;
+ // Priority 1 (same as loop / render): it time-slices with them, so a busy core
+ // can't starve it and fill the ring. It sleeps 10 ms between drains, so idle still runs.
+  xTaskCreatePinnedToCore(logDrainTask, "logDrain", kDrainStackBytes, nullptr, tskIDLE_PRIORITY + 1, &s_task, core);
+  if (s_task) {
+    heapMonitorWatchTask(s_task, kDrainStackBytes);
+    appLogPrintf("[Log] Async logging: %u x %u B ring, drain on core %u",
+                 (unsigned)LOG_RING_SLOTS, (unsigned)LOG_LINE_MAX, (unsigned)core);
+  } else {
+    Serial.println("[Log] Failed to start drain task, logging synchronously");
+  }
+#else
+  (void)core;
+#endif
+}
+
+void appLogPrintf(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+#if LOG_ASYNC_ENABLE
+  if (s_task) ringPush(fmt, ap);
+  else        writeLineSync(fmt, ap);
+#else
+  writeLineSync(fmt, ap);
+#endif
+  va_end(ap);
+}
+
+void appLogDump(const char* tag, const char* text, size_t len) {
+  const int room = LOG_LINE_MAX - (int)strlen(tag) - 1;
+  if (room <= 0) return;
+  while (len > 0) {
+    int n = (len > (size_t)room) ? room : (int)len;
+    appLogPrintf("%s %.*s", tag, n, text);
+    text += n;
+    len  -= (size_t)n;
+  }
+}
+
+void appLogFlush(uint32_t timeoutMs) {
+#if LOG_ASYNC_ENABLE
+  if (!s_task) return;
+  uint32_t start = millis();
+  while (s_tail.load(std::memory_order_acquire) != s_head.load(std::memory_order_relaxed) &&
+         millis() - start < timeoutMs) {
+    delay(5);
+  }
+  Serial.flush();
+#else
+  (void)timeoutMs;
+#endif
+}
+
+uint32_t appLogDropped() {
+#if LOG_ASYNC_ENABLE
+  return s_dropped.load(std::memory_order_relaxed);
+#else
+  return 0;
+#endif
+}
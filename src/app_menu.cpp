@@ -14,6 +14,7 @@
 #include "day_avg.h"
 #include "network.h"
 #include "ui.h"
+#include "app_log.h"
 
 // Forward declarations for functions that remain in main.cpp
 extern const CoinInfo& currentCoin();
@@ -75,9 +76,10 @@ void loadSettings() {
 
   g_displayCurrency = st.dispCur;
   if (g_displayCurrency < 0 || g_displayCurrency >= (int)CURR_COUNT) g_displayCurrency = (int)CURR_USD;
+  g_quoteMode = (st.quoteMd == QUOTE_USD_FX) ? QUOTE_USD_FX : QUOTE_NATIVE;
   applyTimezone();
 
-  Serial.printf("[Settings] Loaded: coin=%s, upd=%s, LED=%s, timeFmt=%s, date=%s, dtSize=%s, tz=%s, dayAvg=%s, refresh=%s, cur=%s\n",
+  Serial.printf("[Settings] Loaded: coin=%s, upd=%s, LED=%s, timeFmt=%s, date=%s, dtSize=%s, tz=%s, dayAvg=%s, refresh=%s, cur=%s, quote=%s\n",
                 currentCoin().ticker,
                 UPDATE_PRESET_LABELS[g_updatePresetIndex],
                 BRIGHTNESS_LABELS[g_brightnessPresetIndex],
@@ -87,7 +89,8 @@ void loadSettings() {
                 TIMEZONES[g_timezoneIndex].label,
                 dayAvgModeLabel(g_dayAvgMode),
                 REFRESH_MODE_LABELS[g_refreshMode],
-                CURRENCY_INFO[g_displayCurrency].code);
+                CURRENCY_INFO[g_displayCurrency].code,
+                QUOTE_MODE_LABELS[g_quoteMode]);
 }
 
 void saveSettings() {
@@ -102,10 +105,11 @@ void saveSettings() {
   st.dayAvg    = (int)g_dayAvgMode;
   st.rfMode    = g_refreshMode;
   st.dispCur   = g_displayCurrency;
+  st.quoteMd   = g_quoteMode;
 
   settingsStoreSave(st);
 
-  Serial.printf("[Settings] Saved: coin=%s, upd=%s, LED=%s, timeFmt=%s, date=%s, dtSize=%s, tz=%s, dayAvg=%s, refresh=%s, cur=%s\n",
+  Serial.printf("[Settings] Saved: coin=%s, upd=%s, LED=%s, timeFmt=%s, date=%s, dtSize=%s, tz=%s, dayAvg=%s, refresh=%s, cur=%s, quote=%s\n",
                 currentCoin().ticker,
                 UPDATE_PRESET_LABELS[g_updatePresetIndex],
                 BRIGHTNESS_LABELS[g_brightnessPresetIndex],
@@ -115,7 +119,8 @@ void saveSettings() {
                 TIMEZONES[g_timezoneIndex].label,
                 dayAvgModeLabel(g_dayAvgMode),
                 REFRESH_MODE_LABELS[g_refreshMode],
-                CURRENCY_INFO[g_displayCurrency].code);
+                CURRENCY_INFO[g_displayCurrency].code,
+                QUOTE_MODE_LABELS[g_quoteMode]);
 }
 
 // ==================== Menu Navigation =====================
@@ -124,7 +129,6 @@ void leaveMenu() {
   g_uiMode = UI_MODE_NORMAL;
   Serial.println("[Menu] Exit to main");
   drawMainScreen(g_lastPriceUsd, g_lastChange24h, true);
-  g_partialRefreshCount = 0;
   lastUpdate = millis();
 }
 
@@ -242,7 +246,6 @@ void handleMenuSelect() {
       g_uiMode           = UI_MODE_COIN_SUB;
       g_coinMenuIndex    = g_currentCoinIndex;
       g_coinMenuTopIndex = 0;
-      g_coinDirty        = true;
       Serial.println("[Menu] Enter COIN submenu");
       drawCoinMenu(false);  // Partial refresh
       break;
@@ -253,7 +256,6 @@ void handleMenuSelect() {
       g_uiMode = UI_MODE_UPDATE_SUB;
       g_updateMenuIndex = g_updatePresetIndex;  // Start at current setting
       g_updateMenuTopIndex = 0;
-      g_updateDirty = true;
       Serial.println("[Menu] Enter UPDATE submenu");
       drawUpdateMenu(false);  // Partial refresh
       break;
@@ -322,6 +324,18 @@ void handleMenuSelect() {
       break;
     }
 
+    case MENU_QUOTE: {
+      // V0.99s: Native quotes fetch the display currency with the price; the next tick uses it
+      g_quoteMode = (g_quoteMode == QUOTE_NATIVE) ? QUOTE_USD_FX : QUOTE_NATIVE;
+      LOGI(MAIN, "[Menu] Quote -> %s", QUOTE_MODE_LABELS[g_quoteMode]);
+      if (g_quoteMode == QUOTE_USD_FX && g_displayCurrency != (int)CURR_USD) {
+        g_nextFxUpdateUtc = 0;  // the FX table is the only rate source again
+      }
+      saveSettings();
+      drawMenuScreen(false);
+      break;
+    }
+
     case MENU_DAYAVG_LINE: {
       g_dayAvgMode = (uint8_t)((g_dayAvgMode + 1) % 3);
       Serial.printf("[Menu] Day avg -> %s\n", dayAvgModeLabel(g_dayAvgMode));
@@ -2,6 +2,7 @@
 // app_scheduler.cpp - Tick-aligned update scheduler
 #include "app_scheduler.h"
 #include "app_state.h"
+#include "app_log.h"
 
 uint32_t updateIntervalSec() {
   uint32_t sec = (uint32_t)(g_updateIntervalMs / 1000UL);
@@ -28,7 +29,7 @@ void tickSchedulerReset(const char* reason) {
     g_prefetchValid = false;
     g_prefetchForUtc = 0;
     g_nextFxUpdateUtc = 0;
-    Serial.printf("[Sched] Reset(%s): time not valid\n", reason ? reason : "");
+    LOGI(SCHED, "[Sched] Reset(%s): time not valid", reason ? reason : "");
     return;
   }
 
@@ -43,11 +44,14 @@ void tickSchedulerReset(const char* reason) {
   g_nextFxUpdateUtc = alignNextTickUtc(nowUtc, 300);
 
   // New schedule → discard any pending prefetch
-  g_prefetchValid = false;
-  g_prefetchForUtc = 0;
+  // (V0.99s: unless it is for this very tick, e.g. restored by a warm restart)
+  if (!g_prefetchValid || g_prefetchForUtc != g_nextUpdateUtc) {
+    g_prefetchValid = false;
+    g_prefetchForUtc = 0;
+  }
 
-  Serial.printf("[Sched] Reset(%s): int=%lus nextUtc=%ld (minute-aligned)\n",
-                reason ? reason : "", (unsigned long)sec, (long)g_nextUpdateUtc);
+  LOGI(SCHED, "[Sched] Reset(%s): int=%lus nextUtc=%ld (minute-aligned)",
+              reason ? reason : "", (unsigned long)sec, (long)g_nextUpdateUtc);
 }
 
 void logTickInfo(const char* tag, uint32_t intervalSec) {
@@ -55,7 +59,7 @@ void logTickInfo(const char* tag, uint32_t intervalSec) {
   if (intervalSec < 1) intervalSec = 1;
   time_t tickUtc = nowUtc - (nowUtc % (time_t)intervalSec);
   time_t nextUtc = tickUtc + (time_t)intervalSec;
-  Serial.printf("[Tick][%s] nowUtc=%ld tickUtc=%ld delta=%ld int=%lus next=%ld\n",
-                tag, (long)nowUtc, (long)tickUtc, (long)(nowUtc - tickUtc),
-                (unsigned long)intervalSec, (long)nextUtc);
+  LOGI(SCHED, "[Tick][%s] nowUtc=%ld tickUtc=%ld delta=%ld int=%lus next=%ld",
+              tag, (long)nowUtc, (long)tickUtc, (long)(nowUtc - tickUtc),
+              (unsigned long)intervalSec, (long)nextUtc);
 }
@@ -63,8 +63,12 @@ double g_usdToRate[CURR_COUNT] = {
 };
 
 bool  g_fxValid         = false;
+time_t g_fxUpdatedUtc    = 0;
 time_t g_nextFxUpdateUtc = 0;
 
+int g_quoteMode = QUOTE_NATIVE;
+const char* QUOTE_MODE_LABELS[] = { "USD+FX", "Native" };
+
 // Backward compatibility: g_usdToTwd points to TWD rate
 double& g_usdToTwd = g_usdToRate[CURR_TWD];
 
@@ -125,15 +129,6 @@ unsigned long g_encPressStart   = 0;
 volatile int g_encStepAccum = 0;
 portMUX_TYPE g_encMux = portMUX_INITIALIZER_UNLOCKED;
 
-// UI redraw throttling
-bool g_menuDirty = false;
-bool g_tzDirty   = false;
-bool g_coinDirty = false;
-bool g_currencyDirty = false;  // V0.99f
-bool g_updateDirty   = false;  // V0.99r
-uint32_t g_lastUiDrawMs = 0;
-const uint32_t UI_DRAW_MIN_MS = 120;
-
 // Time / price state
 unsigned long lastUpdate = 0;
 
@@ -156,6 +151,7 @@ double g_prefetchChange = 0.0;
 double g_lastPriceUsd   = 0.0;
 double g_lastChange24h  = 0.0;
 bool   g_lastPriceOk    = false;
+bool   g_priceStale     = false;
 
 // Previous day average reference price
 double g_prevDayRefPrice   = 0.0;
@@ -172,6 +168,7 @@ int32_t g_localUtcOffsetSec = 0;
 // Chart samples
 ChartSample g_chartSamples[MAX_CHART_SAMPLES];
 int         g_chartSampleCount = 0;
+int         g_chartDirtyFrom   = 0;
 
 // e-paper display (defined in main.cpp)
 
@@ -193,8 +190,11 @@ AppState g_appState = APP_STATE_RUNNING;
 uint32_t g_staConnectStartMs = 0;
 const uint32_t STA_CONNECT_TIMEOUT_MS = 30000;
 
-// Partial refresh limit
-const uint16_t PARTIAL_REFRESH_LIMIT = 20;
+// Safety cap: max partial refreshes between two full refreshes
+// V0.99s: was a fixed 20. The ghosting budget (refresh_scheduler.cpp) is now the
+// main control and normally fires long before this; the cap only bounds the case
+// where the diffs under-count ghosting. 240 = 4 h of minute-by-minute clock updates.
+const uint16_t PARTIAL_REFRESH_LIMIT = 240;
 
 // ==================== Periodic NTP resync =====================
 const uint32_t NTP_RESYNC_INTERVAL_SEC = 10UL * 60UL;
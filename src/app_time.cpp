@@ -4,6 +4,10 @@
 #include "app_state.h"
 #include "app_scheduler.h"
 #include "config.h"
+#include "net_capture.h"
+#include "app_log.h"
+#include "trace.h"
+#include "json_arena.h"
 #include <WiFi.h>
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
@@ -48,8 +52,8 @@ static bool fetchUtcOffsetHoursFromWorldTimeApi(int8_t& outOffsetHours) {
   if (WiFi.status() != WL_CONNECTED) return false;
 
   const char* urls[] = {
-    "http://worldtimeapi.org/api/ip",
-    "https://worldtimeapi.org/api/ip"
+    API_ORIGIN_HTTP("worldtimeapi.org") "/api/ip",
+    API_ORIGIN("worldtimeapi.org") "/api/ip"
   };
 
   for (size_t u = 0; u < sizeof(urls) / sizeof(urls[0]); ++u) {
@@ -58,33 +62,34 @@ static bool fetchUtcOffsetHoursFromWorldTimeApi(int8_t& outOffsetHours) {
     http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
     http.setTimeout(8000);
 
-    Serial.print("[TZ][Auto] GET ");
-    Serial.println(urls[u]);
+    LOGD(TIME, "[TZ][Auto] GET %s", urls[u]);
 
-    int code = http.GET();
+    String payload;
+    int code = netCaptureHttpGet(http, urls[u], payload);
     if (code != 200) {
-      Serial.printf("[TZ][Auto] HTTP error: %d\n", code);
+      LOGW(TIME, "[TZ][Auto] HTTP error: %d", code);
       http.end();
       continue;
     }
 
-    String payload = http.getString();
     http.end();
 
     // Parse only the utc_offset field to keep memory low
-    StaticJsonDocument<96> filter;
+    JsonDocument filter(&jsonArenaAllocator);
     filter["utc_offset"] = true;
 
-    DynamicJsonDocument doc(512);
+    JsonDocument doc(&jsonArenaAllocator);
+    traceBeginEvent(TRACE_PARSE);
     DeserializationError err = deserializeJson(doc, payload, DeserializationOption::Filter(filter));
+    traceEndEvent(TRACE_PARSE, payload.length());
     if (err) {
-      Serial.printf("[TZ][Auto] JSON parse error: %s\n", err.c_str());
+      LOGW(TIME, "[TZ][Auto] JSON parse error: %s", err.c_str());
       continue;
     }
 
     const char* off = doc["utc_offset"] | "";
     if (!off || off[0] == '\0') {
-      Serial.println("[TZ][Auto] utc_offset missing");
+      LOGW(TIME, "[TZ][Auto] utc_offset missing");
       continue;
     }
 
@@ -99,13 +104,13 @@ static bool fetchUtcOffsetHoursFromWorldTimeApi(int8_t& outOffsetHours) {
 
     // V0.97 integer-only timezone support
     if (mm != 0) {
-      Serial.printf("[TZ][Auto] Non-integer offset not supported: %s\n", off);
+      LOGI(TIME, "[TZ][Auto] Non-integer offset not supported: %s", off);
       return false;
     }
 
     if (sign == '-') hh = -hh;
     if (hh < -12 || hh > 14) {
-      Serial.printf("[TZ][Auto] Offset out of range: %d (raw=%s)\n", hh, off);
+      LOGI(TIME, "[TZ][Auto] Offset out of range: %d (raw=%s)", hh, off);
       return false;
     }
 
@@ -121,26 +126,26 @@ void autoDetectTimezoneIfNeeded() {
   g_tzAutoAttempted = true;
 
   if (g_tzIndexKeyPresent) {
-    Serial.println("[TZ][Auto] tzIndex already set in NVS; skip");
+    LOGI(TIME, "[TZ][Auto] tzIndex already set in NVS; skip");
     return;
   }
 
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[TZ][Auto] WiFi not connected; skip");
+    LOGW(TIME, "[TZ][Auto] WiFi not connected; skip");
     return;
   }
 
-  Serial.println("[TZ][Auto] Detecting timezone offset (best-effort)...");
+  LOGI(TIME, "[TZ][Auto] Detecting timezone offset (best-effort)...");
 
   int8_t offHours = 0;
   if (!fetchUtcOffsetHoursFromWorldTimeApi(offHours)) {
-    Serial.println("[TZ][Auto] Detect failed; keep default");
+    LOGW(TIME, "[TZ][Auto] Detect failed; keep default");
     return;
   }
 
   int tzIdx = findTzIndexByOffsetHours(offHours);
   if (tzIdx < 0) {
-    Serial.printf("[TZ][Auto] No matching tzIndex for UTC%+d; keep default\n", (int)offHours);
+    LOGI(TIME, "[TZ][Auto] No matching tzIndex for UTC%+d; keep default", (int)offHours);
     return;
   }
 
@@ -150,9 +155,9 @@ void autoDetectTimezoneIfNeeded() {
   g_tzIndexKeyPresent = true;
   g_tzIndexKeyPresentAtBoot = true;
 
-  Serial.printf("[TZ][Auto] Applied: %s (UTC%+d)\n",
-                TIMEZONES[g_timezoneIndex].label,
-                (int)TIMEZONES[g_timezoneIndex].utcOffsetHours);
+  LOGI(TIME, "[TZ][Auto] Applied: %s (UTC%+d)",
+             TIMEZONES[g_timezoneIndex].label,
+             (int)TIMEZONES[g_timezoneIndex].utcOffsetHours);
 }
 
 // ==================== NTP Time Synchronization =====================
@@ -162,6 +167,8 @@ void ntpTimeSyncCb(struct timeval* tv) {
   if (tv) utc = (int64_t)tv->tv_sec;
   else    utc = (int64_t)time(nullptr);
 
+  traceInstant(TRACE_NTP_UPDATE);  // lwIP task
+
   portENTER_CRITICAL(&g_ntpMux);
   g_ntpEventUtc = utc;
   g_ntpEventPending = true;
@@ -174,8 +181,8 @@ void applyPeriodicNtpConfig(bool logLine) {
   sntp_set_sync_interval((uint32_t)NTP_RESYNC_INTERVAL_SEC * 1000UL);
 
   if (logLine) {
-    Serial.printf("[Time] SNTP periodic enabled: interval=%lus mode=SMOOTH\n",
-                  (unsigned long)NTP_RESYNC_INTERVAL_SEC);
+    LOGI(TIME, "[Time] SNTP periodic enabled: interval=%lus mode=SMOOTH",
+               (unsigned long)NTP_RESYNC_INTERVAL_SEC);
   }
 }
 
@@ -186,42 +193,55 @@ void ntpResyncReset(const char* reason) {
     return;
   }
   g_nextNtpResyncUtc = alignNextTickUtc(nowUtc, (uint32_t)NTP_RESYNC_INTERVAL_SEC);
-  Serial.printf("[Time][SNTP] Next resync: %ld (in %ld s) reason=%s\n",
-                (long)g_nextNtpResyncUtc,
-                (long)(g_nextNtpResyncUtc - nowUtc),
-                reason ? reason : "?");
+  LOGI(TIME, "[Time][SNTP] Next resync: %ld (in %ld s) reason=%s",
+             (long)g_nextNtpResyncUtc,
+             (long)(g_nextNtpResyncUtc - nowUtc),
+             reason ? reason : "?");
 }
 
 void requestNtpResync(const char* reason) {
-  Serial.printf("[Time][SNTP] Resync requested (%s)\n", reason ? reason : "?");
+  LOGI(TIME, "[Time][SNTP] Resync requested (%s)", reason ? reason : "?");
   // Restart SNTP via configTime (Arduino core stops/starts SNTP inside)
   configTime(0, 0, NTP_SERVER_1, NTP_SERVER_2);
   // Re-apply interval/callback/mode in case configTime() reset them
   applyPeriodicNtpConfig(false);
 }
 
-void setupTime() {
+// V0.99s: The first sync no longer blocks setup (it was 40 x 500 ms polling):
+// SNTP runs on the lwIP task while the first price is fetched, and loop()
+// polls for the result.
+static const uint32_t NTP_FIRST_SYNC_TIMEOUT_MS = 20000;
+
+static bool     s_ntpSyncPending = false;
+static uint32_t s_ntpSyncStartMs = 0;
+
+void setupTimeBegin() {
+  traceBeginEvent(TRACE_NTP_SYNC);  // ended by setupTimePoll(), also on the loop task
   configTime(0, 0, NTP_SERVER_1, NTP_SERVER_2);
+  s_ntpSyncPending = true;
+  s_ntpSyncStartMs = millis();
+  LOGI(TIME, "[Time] Syncing NTP (background)...");
+}
 
-  Serial.println("[Time] Syncing NTP...");
-  time_t nowUtc = 0;
-  int retry = 0;
-  while (nowUtc < TIME_VALID_MIN_UTC && retry < 40) {
-    nowUtc = time(nullptr);
-    Serial.print(".");
-    delay(500);
-    retry++;
-  }
-  Serial.println();
+bool setupTimePoll() {
+  if (!s_ntpSyncPending) return true;
+
+  time_t   nowUtc    = time(nullptr);
+  uint32_t elapsedMs = millis() - s_ntpSyncStartMs;
+  if (nowUtc < TIME_VALID_MIN_UTC && elapsedMs < NTP_FIRST_SYNC_TIMEOUT_MS) return false;
+
+  s_ntpSyncPending = false;
+  traceEndEvent(TRACE_NTP_SYNC, nowUtc >= TIME_VALID_MIN_UTC ? 1 : 0);
 
   if (nowUtc >= TIME_VALID_MIN_UTC) {
     struct tm local;
     if (getLocalTimeLocal(&local)) {
-      Serial.printf("[Time] NTP OK: %02d:%02d  %02d/%02d/%04d\n",
-                    local.tm_hour, local.tm_min,
-                    local.tm_mon + 1, local.tm_mday, local.tm_year + 1900);
+      LOGI(TIME, "[Time] NTP OK: %02d:%02d  %02d/%02d/%04d (%lu ms)",
+                 local.tm_hour, local.tm_min,
+                 local.tm_mon + 1, local.tm_mday, local.tm_year + 1900,
+                 (unsigned long)elapsedMs);
     } else {
-      Serial.println("[Time] local conversion failed.");
+      LOGW(TIME, "[Time] local conversion failed.");
     }
 
     // Enable tick-aligned scheduler as soon as time is valid
@@ -230,7 +250,8 @@ void setupTime() {
     tickSchedulerReset("NTP");
     logTickInfo("NTP", updateIntervalSec());
   } else {
-    Serial.println("[Time] NTP FAILED");
+    LOGW(TIME, "[Time] NTP FAILED (%lu ms)", (unsigned long)elapsedMs);
     tickSchedulerReset("NTP FAIL");
   }
+  return true;
 }
@@ -5,6 +5,7 @@
 #include "settings_store.h"
 #include "led_status.h"
 #include "ui.h"
+#include "trace.h"
 #include <WiFi.h>
 
 // ==================== WiFi Credentials Management =====================
@@ -79,6 +80,7 @@ bool connectWiFiSta(const char* ssid, const char* pass, uint32_t timeoutMs) {
   delay(100);
 
   Serial.printf("[WiFi] Connecting to %s\n", ssid);
+  traceBeginEvent(TRACE_WIFI_CONNECT);
   WiFi.begin(ssid, (pass ? pass : ""));
   setLedBlue();
 
@@ -91,6 +93,7 @@ bool connectWiFiSta(const char* ssid, const char* pass, uint32_t timeoutMs) {
     if (dots % 40 == 0) Serial.println();
   }
   Serial.println();
+  traceEndEvent(TRACE_WIFI_CONNECT, WiFi.status() == WL_CONNECTED ? 1 : 0);
 
   if (WiFi.status() == WL_CONNECTED) {
     Serial.print("[WiFi] Connected, IP: ");
@@ -0,0 +1,168 @@
+// CryptoBar V0.99s (Fast boot)
+// boot_cache.cpp - Last screen data in NVS: saved rate-limited, restored before the splash
+#include "boot_cache.h"
+
+#include <Preferences.h>
+#include <string.h>
+
+#include "app_log.h"
+#include "app_state.h"
+#include "chart.h"
+#include "coins.h"
+#include "profile.h"
+
+// Helper provided by main.cpp (declaration only; definition in main.cpp)
+const CoinInfo& currentCoin();
+
+static const char*   kNs      = "bootcache";
+static const char*   kKey     = "snap";
+static const uint8_t kVersion = 1;  // bump when the blob layout changes
+
+struct BootCacheHeader {
+  uint8_t  version;
+  uint8_t  refValid;
+  uint16_t count;          // chart samples following the header
+  char     ticker[12];
+  char     historyApi[16];
+  uint32_t cycleStartUtc;  // 0 = no cycle
+  uint32_t cycleEndUtc;
+  double   priceUsd;
+  double   change24h;
+  double   refPrice;
+};
+
+// Blob: header, uint16_t pos[count] (Q16), float price[count]
+static const size_t kBlobMax =
+    sizeof(BootCacheHeader) + MAX_CHART_SAMPLES * (sizeof(uint16_t) + sizeof(float));
+
+static uint8_t  s_blob[kBlobMax];  // loop task only
+static uint32_t s_lastSaveMs = 0;
+static bool     s_saved      = false;
+
+// Restored label (g_currentHistoryApi points at string storage)
+static char s_historyApi[16];
+
+bool bootCacheSave(bool force) {
+#if BOOT_CACHE_ENABLE
+  if (g_lastPriceUsd <= 0.0) return false;
+  const uint32_t nowMs = millis();
+  if (!force && s_saved && nowMs - s_lastSaveMs < BOOT_CACHE_SAVE_INTERVAL_MS) return false;
+  PROFILE_ZONE("nvs.save");
+
+  int n = g_chartSampleCount;
+  if (n < 0) n = 0;
+  if (n > MAX_CHART_SAMPLES) n = MAX_CHART_SAMPLES;
+
+  BootCacheHeader h;
+  memset(&h, 0, sizeof(h));
+  h.version  = kVersion;
+  h.refValid = g_prevDayRefValid ? 1 : 0;
+  h.count    = (uint16_t)n;
+  strncpy(h.ticker, currentCoin().ticker, sizeof(h.ticker) - 1);
+  strncpy(h.historyApi, g_currentHistoryApi ? g_currentHistoryApi : "", sizeof(h.historyApi) - 1);
+  h.cycleStartUtc = g_cycleInit ? (uint32_t)g_cycleStartUtc : 0;
+  h.cycleEndUtc   = g_cycleInit ? (uint32_t)g_cycleEndUtc : 0;
+  h.priceUsd  = g_lastPriceUsd;
+  h.change24h = g_lastChange24h;
+  h.refPrice  = g_prevDayRefPrice;
+
+  memcpy(s_blob, &h, sizeof(h));
+  uint16_t* pos   = (uint16_t*)(s_blob + sizeof(h));
+  float*    price = (float*)(s_blob + sizeof(h) + n * sizeof(uint16_t));
+  for (int i = 0; i < n; i++) {
+    float p = g_chartSamples[i].pos;
+    if (p < 0.0f) p = 0.0f;
+    if (p > 1.0f) p = 1.0f;
+    const uint16_t q = (uint16_t)(p * 65535.0f + 0.5f);
+    const float    v = (float)g_chartSamples[i].price;
+    memcpy(&pos[i], &q, sizeof(q));
+    memcpy(&price[i], &v, sizeof(v));
+  }
+  const size_t bytes = sizeof(h) + n * (sizeof(uint16_t) + sizeof(float));
+
+  Preferences pref;
+  if (!pref.begin(kNs, false)) {
+    LOGW(MAIN, "[BootCache] NVS open failed");
+    return false;
+  }
+  const bool ok = pref.putBytes(kKey, s_blob, bytes) == bytes;
+  pref.end();
+  if (!ok) {
+    LOGW(MAIN, "[BootCache] NVS write failed");
+    return false;
+  }
+  s_saved      = true;
+  s_lastSaveMs = nowMs;
+  LOGD(MAIN, "[BootCache] Saved %s %.6f, %d samples (%u B)", h.ticker, h.priceUsd, n, (unsigned)bytes);
+  return true;
+#else
+  (void)force;
+  return false;
+#endif
+}
+
+bool bootCacheRestore() {
+#if BOOT_CACHE_ENABLE
+  Preferences pref;
+  if (!pref.begin(kNs, true)) return false;  // nothing stored yet
+  const size_t bytes = pref.getBytesLength(kKey);
+  const bool read = bytes >= sizeof(BootCacheHeader) && bytes <= kBlobMax &&
+                    pref.getBytes(kKey, s_blob, bytes) == bytes;
+  pref.end();
+  if (!read) return false;
+
+  BootCacheHeader h;
+  memcpy(&h, s_blob, sizeof(h));
+  h.ticker[sizeof(h.ticker) - 1] = '\0';
+  h.historyApi[sizeof(h.historyApi) - 1] = '\0';
+  if (h.version != kVersion || h.count > MAX_CHART_SAMPLES ||
+      bytes != sizeof(h) + h.count * (sizeof(uint16_t) + sizeof(float))) {
+    LOGW(MAIN, "[BootCache] Layout mismatch; ignored");
+    return false;
+  }
+  if (strcmp(h.ticker, currentCoin().ticker) != 0 || !(h.priceUsd > 0.0)) {
+    LOGI(MAIN, "[BootCache] Cached %s does not match %s; ignored", h.ticker, currentCoin().ticker);
+    return false;
+  }
+
+  const uint16_t* pos   = (const uint16_t*)(s_blob + sizeof(h));
+  const float*    price = (const float*)(s_blob + sizeof(h) + h.count * sizeof(uint16_t));
+  for (int i = 0; i < h.count; i++) {
+    uint16_t q;
+    float    v;
+    memcpy(&q, &pos[i], sizeof(q));
+    memcpy(&v, &price[i], sizeof(v));
+    g_chartSamples[i].pos   = (float)q / 65535.0f;
+    g_chartSamples[i].price = (double)v;
+  }
+  g_chartSampleCount = h.count;
+  g_chartDirtyFrom   = 0;
+
+  // The cycle is only trusted as a hint: updateEtCycle() resets the chart
+  // once the real clock shows a different ET day.
+  g_cycleInit     = h.cycleStartUtc != 0;
+  g_cycleStartUtc = (time_t)h.cycleStartUtc;
+  g_cycleEndUtc   = (time_t)h.cycleEndUtc;
+
+  g_prevDayRefPrice = h.refPrice;
+  g_prevDayRefValid = h.refValid != 0;
+  g_lastPriceUsd    = h.priceUsd;
+  g_lastChange24h   = h.change24h;
+
+  strncpy(s_historyApi, h.historyApi, sizeof(s_historyApi) - 1);
+  if (s_historyApi[0]) g_currentHistoryApi = s_historyApi;
+
+  LOGI(MAIN, "[BootCache] Restored %s %.6f, %d samples", h.ticker, h.priceUsd, (int)h.count);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void bootCacheClear() {
+  Preferences pref;
+  if (!pref.begin(kNs, false)) return;
+  pref.clear();
+  pref.end();
+  s_saved = false;
+}
@@ -0,0 +1,106 @@
+// CryptoBar V0.99s (Boot timeline)
+// boot_timeline.cpp - Boot phase marks, written through to RTC no-init memory
+#include "boot_timeline.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "app_log.h"
+#include "retained_state.h"
+#include "freertos/FreeRTOS.h"
+
+// ==================== RTC copy =====================
+// RTC no-init memory; validated as described in retained_state.h.
+
+static const uint32_t kSavedMagic   = 0x31544250;  // "PBT1"
+static const uint16_t kSavedVersion = 1;
+
+struct BootTimelineSaved {
+  uint32_t      magic;
+  uint16_t      version;
+  uint8_t       count;
+  uint8_t       reserved;
+  BootPhaseMark marks[BOOT_TIMELINE_MAX];
+  uint32_t      crc;
+};
+
+RTC_NOINIT_ATTR static BootTimelineSaved s_saved;
+
+static BootPhaseMark s_marks[BOOT_TIMELINE_MAX];
+static uint8_t       s_count = 0;
+static portMUX_TYPE  s_mux   = portMUX_INITIALIZER_UNLOCKED;  // render task marks too
+
+static BootPhaseMark s_prev[BOOT_TIMELINE_MAX];
+static uint8_t       s_prevCount = 0;
+
+static uint32_t savedCrc(const BootTimelineSaved& s) {
+  return retainedCrc(&s, offsetof(BootTimelineSaved, crc));
+}
+
+static void writeThrough() {
+  s_saved.magic    = 0;
+  s_saved.version  = kSavedVersion;
+  s_saved.count    = s_count;
+  s_saved.reserved = 0;
+  memcpy(s_saved.marks, s_marks, sizeof(s_marks));
+  s_saved.magic = kSavedMagic;
+  s_saved.crc   = savedCrc(s_saved);
+}
+
+// ==================== Public API =====================
+
+void bootTimelineBegin() {
+  if (s_saved.magic == kSavedMagic && s_saved.version == kSavedVersion &&
+      s_saved.count <= BOOT_TIMELINE_MAX && s_saved.crc == savedCrc(s_saved)) {
+    s_prevCount = s_saved.count;
+    memcpy(s_prev, s_saved.marks, s_prevCount * sizeof(BootPhaseMark));
+  }
+  memset(s_marks, 0, sizeof(s_marks));
+  s_count = 0;
+  bootMark("setup");
+}
+
+void bootMark(const char* phase) {
+  BootPhaseMark m;
+  strncpy(m.name, phase, BOOT_PHASE_NAME_LEN - 1);
+  m.name[BOOT_PHASE_NAME_LEN - 1] = '\0';
+
+  portENTER_CRITICAL(&s_mux);
+  if (s_count >= BOOT_TIMELINE_MAX) {
+    portEXIT_CRITICAL(&s_mux);
+    return;
+  }
+  m.ms = millis();
+  const uint32_t stepMs = s_count ? m.ms - s_marks[s_count - 1].ms : m.ms;
+  s_marks[s_count++] = m;
+  writeThrough();
+  portEXIT_CRITICAL(&s_mux);
+
+  LOGI(MAIN, "[Boot] +%lu ms %s (+%lu)", (unsigned long)m.ms, m.name, (unsigned long)stepMs);
+}
+
+uint8_t bootTimelineGet(BootPhaseMark* out, uint8_t maxMarks, bool previous) {
+  const BootPhaseMark* src = previous ? s_prev : s_marks;
+  portENTER_CRITICAL(&s_mux);
+  const uint8_t count = previous ? s_prevCount : s_count;
+  const uint8_t n = (count < maxMarks) ? count : maxMarks;
+  memcpy(out, src, n * sizeof(BootPhaseMark));
+  portEXIT_CRITICAL(&s_mux);
+  return n;
+}
+
+// ==================== Serial =====================
+
+void bootTimelineDump(bool previous) {
+  BootPhaseMark marks[BOOT_TIMELINE_MAX];
+  const uint8_t n = bootTimelineGet(marks, BOOT_TIMELINE_MAX, previous);
+
+  // Through the log ring, so the table stays in order with the stage logs.
+  appLogPrintf("[Boot] %s boot timeline, %u phase(s) (ms since reset)",
+               previous ? "Previous" : "This", (unsigned)n);
+  appLogPrintf("[Boot] phase             at     step");
+  for (uint8_t i = 0; i < n; i++) {
+    const uint32_t step = i ? marks[i].ms - marks[i - 1].ms : marks[i].ms;
+    appLogPrintf("[Boot] %-11s %8lu %8lu", marks[i].name, (unsigned long)marks[i].ms, (unsigned long)step);
+  }
+}
@@ -0,0 +1,260 @@
+// CryptoBar V0.99s (Chart rasterizer)
+// chart_raster.cpp - Span-based 1-bpp chart rasterizer with cached geometry
+#include "chart_raster.h"
+
+#include <string.h>
+
+#include "app_state.h"
+
+// ==================== Plane / cache state =====================
+// The chart area is ~203x53 px on the 2.9" panel; the plane is sized with headroom.
+static constexpr int kPlaneMaxW = 256;
+static constexpr int kPlaneMaxH = 64;
+static constexpr int kStride    = kPlaneMaxW / 8;
+
+// Dashed reference line: 5 px on, 3 px off (same look as the old drawLine dashes)
+static constexpr int kDashOn     = 5;
+static constexpr int kDashPeriod = 8;
+
+static uint8_t s_plane[kStride * kPlaneMaxH];
+static int     s_planeW = 0;
+static int     s_planeH = 0;
+
+// Cached polyline geometry (plane coordinates)
+static int16_t s_px[MAX_CHART_SAMPLES];
+static int16_t s_py[MAX_CHART_SAMPLES];
+static int     s_pointCount = 0;
+static int16_t s_refY       = -1;
+
+static bool     s_cacheValid = false;
+static uint32_t s_cacheKey   = 0;
+
+// ==================== Cache key =====================
+
+static inline uint32_t fnvMix(uint32_t h, uint32_t v) {
+  return (h ^ v) * 16777619u;
+}
+
+static inline uint32_t fnvMixDouble(uint32_t h, double d) {
+  uint32_t w[2];
+  memcpy(w, &d, sizeof(w));
+  return fnvMix(fnvMix(h, w[0]), w[1]);
+}
+
+// Integer-only hash over everything that affects the plane. The samples are
+// represented by their count and the caller's generation, so the key costs
+// the same for 3 or 288 points.
+static uint32_t computeKey(int count, uint32_t generation,
+                           bool refShown, double refPrice,
+                           const ChartRect& rect) {
+  uint32_t h = 2166136261u;
+  h = fnvMix(h, (uint32_t)count);
+  h = fnvMix(h, generation);
+  h = fnvMix(h, ((uint32_t)(uint16_t)rect.left << 16) | (uint16_t)rect.right);
+  h = fnvMix(h, ((uint32_t)(uint16_t)rect.top << 16) | (uint16_t)rect.bottom);
+  h = fnvMix(h, refShown ? 1u : 0u);
+  if (refShown) h = fnvMixDouble(h, refPrice);
+  return h;
+}
+
+// ==================== Span primitives =====================
+
+static void planeVSpan(int x, int y0, int y1) {
+  if (x < 0 || x >= s_planeW) return;
+  if (y0 > y1) { int t = y0; y0 = y1; y1 = t; }
+  if (y0 < 0) y0 = 0;
+  if (y1 >= s_planeH) y1 = s_planeH - 1;
+  if (y0 > y1) return;
+
+  const uint8_t mask = (uint8_t)(0x80 >> (x & 7));
+  uint8_t* p = &s_plane[y0 * kStride + (x >> 3)];
+  for (int y = y0; y <= y1; ++y) {
+    *p |= mask;
+    p += kStride;
+  }
+}
+
+static void planeHSpan(int y, int x0, int x1) {
+  if (y < 0 || y >= s_planeH) return;
+  if (x0 < 0) x0 = 0;
+  if (x1 >= s_planeW) x1 = s_planeW - 1;
+  if (x0 > x1) return;
+
+  uint8_t* row = &s_plane[y * kStride];
+  int b0 = x0 >> 3;
+  int b1 = x1 >> 3;
+  uint8_t m0 = (uint8_t)(0xFF >> (x0 & 7));
+  uint8_t m1 = (uint8_t)(0xFF << (7 - (x1 & 7)));
+  if (b0 == b1) {
+    row[b0] |= (uint8_t)(m0 & m1);
+    return;
+  }
+  row[b0] |= m0;
+  for (int b = b0 + 1; b < b1; ++b) row[b] = 0xFF;
+  row[b1] |= m1;
+}
+
+// Integer Bresenham; consecutive pixels in one column are merged into one span.
+static void planeSegment(int x0, int y0, int x1, int y1) {
+  const int dx = abs(x1 - x0);
+  const int sx = (x0 < x1) ? 1 : -1;
+  const int dy = -abs(y1 - y0);
+  const int sy = (y0 < y1) ? 1 : -1;
+  int err = dx + dy;
+
+  int runX  = x0;
+  int runY0 = y0;
+  int runY1 = y0;
+  while (x0 != x1 || y0 != y1) {
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+    if (x0 != runX) {
+      planeVSpan(runX, runY0, runY1);
+      runX  = x0;
+      runY0 = y0;
+    }
+    runY1 = y0;
+  }
+  planeVSpan(runX, runY0, runY1);
+}
+
+// ==================== Geometry build =====================
+
+static void buildGeometry(const ChartSample* samples, int count,
+                          bool refShown, double refPrice,
+                          const ChartRect& rect) {
+  s_planeW = rect.right - rect.left + 1;
+  s_planeH = rect.bottom - rect.top + 1;
+  if (s_planeW > kPlaneMaxW) s_planeW = kPlaneMaxW;
+  if (s_planeH > kPlaneMaxH) s_planeH = kPlaneMaxH;
+  if (s_planeW < 1) s_planeW = 1;
+  if (s_planeH < 1) s_planeH = 1;
+
+  memset(s_plane, 0, sizeof(s_plane));
+
+  double minP = samples[0].price;
+  double maxP = samples[0].price;
+  for (int i = 1; i < count; ++i) {
+    double p = samples[i].price;
+    if (p < minP) minP = p;
+    if (p > maxP) maxP = p;
+  }
+  if (refShown) {
+    if (refPrice < minP) minP = refPrice;
+    if (refPrice > maxP) maxP = refPrice;
+  }
+  if (minP == maxP) {
+    maxP = minP + 1.0;
+  }
+
+  const int chartHeight = rect.bottom - rect.top;
+  const int chartWidth  = rect.right - rect.left;
+  const double range    = maxP - minP;
+
+  // Q16 pixels per price unit: one multiply per sample, everything after is integer.
+  const double   yScaleQ16 = (double)chartHeight * 65536.0 / range;
+  const int32_t  yMaxQ16   = (int32_t)chartHeight << 16;
+  const uint32_t xSpan     = (chartWidth > 0) ? (uint32_t)(chartWidth - 1) : 0;
+
+  auto priceToRow = [&](double p) -> int16_t {
+    double d = p - minP;
+    if (d < 0.0) d = 0.0;
+    if (d > range) d = range;
+    int32_t yq = (int32_t)(d * yScaleQ16);
+    if (yq > yMaxQ16) yq = yMaxQ16;
+    return (int16_t)(chartHeight - (yq >> 16));
+  };
+
+  s_pointCount = count;
+  for (int i = 0; i < count; ++i) {
+    float pos = samples[i].pos;
+    if (pos < 0.0f) pos = 0.0f;
+    if (pos > 1.0f) pos = 1.0f;
+    uint32_t posQ16 = (uint32_t)(pos * 65536.0f);
+    int x = (int)((posQ16 * xSpan) >> 16);
+    if (x >= s_planeW) x = s_planeW - 1;
+    s_px[i] = (int16_t)x;
+    s_py[i] = priceToRow(samples[i].price);
+  }
+
+  s_refY = refShown ? priceToRow(refPrice) : (int16_t)-1;
+
+  // Dashed reference line
+  if (s_refY >= 0) {
+    for (int x = 0; x < s_planeW; x += kDashPeriod) {
+      planeHSpan(s_refY, x, x + kDashOn - 1);
+    }
+  }
+
+  // Polyline: samples sharing a column collapse to their min/max envelope,
+  // and columns are joined by Bresenham spans (exit point -> next entry point).
+  int i = 0;
+  int prevX = -1;
+  int prevY = 0;
+  while (i < s_pointCount) {
+    const int x = s_px[i];
+    const int yFirst = s_py[i];
+    int yMin = yFirst;
+    int yMax = yFirst;
+    int yLast = yFirst;
+    int j = i + 1;
+    while (j < s_pointCount && s_px[j] == x) {
+      int y = s_py[j];
+      if (y < yMin) yMin = y;
+      if (y > yMax) yMax = y;
+      yLast = y;
+      ++j;
+    }
+    if (prevX >= 0) {
+      planeSegment(prevX, prevY, x, yFirst);
+    }
+    planeVSpan(x, yMin, yMax);
+    prevX = x;
+    prevY = yLast;
+    i = j;
+  }
+}
+
+// ==================== Composite =====================
+
+// Horizontal runs of set pixels go to the display as one drawFastHLine()
+// each; empty bytes (the vast majority) are skipped.
+static void compositePlane(const ChartRect& rect) {
+  const int w = s_planeW;
+  for (int row = 0; row < s_planeH; ++row) {
+    const uint8_t* p = &s_plane[row * kStride];
+    const int16_t y = rect.top + row;
+    int x = 0;
+    while (x < w) {
+      uint8_t v = p[x >> 3];
+      if (!v && (x & 7) == 0) { x += 8; continue; }
+      if (!(v & (0x80 >> (x & 7)))) { ++x; continue; }
+      int runStart = x;
+      while (x < w && (p[x >> 3] & (0x80 >> (x & 7)))) ++x;
+      display.drawFastHLine(rect.left + runStart, y, x - runStart, GxEPD_BLACK);
+    }
+  }
+}
+
+// ==================== Public API =====================
+
+void chartRasterDraw(const ChartSample* samples, int count, uint32_t generation,
+                     bool refShown, double refPrice,
+                     const ChartRect& rect) {
+  if (!samples || count <= 0) return;
+  if (count > MAX_CHART_SAMPLES) count = MAX_CHART_SAMPLES;
+
+  uint32_t key = computeKey(count, generation, refShown, refPrice, rect);
+  if (!s_cacheValid || key != s_cacheKey) {
+    buildGeometry(samples, count, refShown, refPrice, rect);
+    s_cacheKey   = key;
+    s_cacheValid = true;
+  }
+
+  compositePlane(rect);
+}
+
+void chartRasterInvalidate() {
+  s_cacheValid = false;
+}
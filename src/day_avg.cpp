@@ -1,7 +1,7 @@
 #include "day_avg.h"
 #include "chart.h"
 
-static constexpr int   kMaxSamples   = 320;   // > 288 (24h @ 5-min)
+static constexpr int   kMaxSamples   = DAYAVG_ROLLING_MAX;
 static constexpr int   kBucketSec    = 300;   // 5 minutes
 static constexpr time_t kWindowSec   = 24 * 3600;
 
@@ -97,6 +97,14 @@ int dayAvgRollingCount() {
   return s_count;
 }
 
+bool dayAvgRollingAt(int i, time_t& outBucketUtc, double& outPrice) {
+  if (i < 0 || i >= s_count) return false;
+  const MeanSample& s = s_buf[idxAt(i)];
+  outBucketUtc = s.tUtc;
+  outPrice     = s.price;
+  return true;
+}
+
 bool dayAvgCycleMean(double& outMean) {
   if (g_chartSampleCount <= 0) return false;
   double acc = 0.0;
@@ -0,0 +1,123 @@
+// CryptoBar V0.99s (Shadow-frame e-paper display)
+// epd_display.cpp - Shadow frames and per-region frame diffs
+#include "epd_display.h"
+
+#include <string.h>
+
+EpdFrameShadow::EpdFrameShadow()
+  : m_front(nullptr), m_back(nullptr),
+    m_w(0), m_h(0), m_stride(0), m_pageH(0),
+    m_full(true),
+    m_winX(0), m_winY(0), m_winW(0), m_winH(0),
+    m_bandY(0), m_bandH(0),
+    m_recording(false),
+    m_frontValid(false),
+    m_frames(0),
+    m_observer(nullptr) {
+  memset(&m_diff, 0, sizeof(m_diff));
+}
+
+void EpdFrameShadow::attach(uint8_t* front, uint8_t* back, uint16_t w, uint16_t h, uint16_t pageH) {
+  m_front  = front;
+  m_back   = back;
+  m_w      = (int16_t)w;
+  m_h      = (int16_t)h;
+  m_stride = (int16_t)((w + 7) / 8);
+  m_pageH  = (int16_t)pageH;
+  m_winW   = m_w;
+  m_winH   = m_h;
+  memset(m_front, 0, (size_t)m_stride * m_h);
+  memset(m_back, 0, (size_t)m_stride * m_pageH);
+}
+
+void EpdFrameShadow::setWindow(bool full, int16_t x, int16_t y, int16_t w, int16_t h) {
+  m_full = full;
+  m_winX = x;
+  m_winY = y;
+  m_winW = w;
+  m_winH = h;
+}
+
+// Back band starts as the panel's current content (pixels outside the window stay).
+void EpdFrameShadow::loadBand() {
+  int16_t end = m_winY + m_winH;
+  m_bandH = end - m_bandY;
+  if (m_bandH > m_pageH) m_bandH = m_pageH;
+  if (m_bandH < 0) m_bandH = 0;
+  memcpy(m_back, &m_front[m_bandY * m_stride], (size_t)m_stride * m_bandH);
+  m_recording = (m_bandH > 0 && m_winW > 0);
+}
+
+void EpdFrameShadow::beginFrame() {
+  if (!m_front) return;
+  memset(&m_diff, 0, sizeof(m_diff));
+  m_diff.fullRefresh = m_full;
+  m_diff.tileWidth   = (uint16_t)((m_w + EPD_DIFF_TILE_COLS - 1) / EPD_DIFF_TILE_COLS);
+  m_diff.tileHeight  = (uint16_t)((m_h + EPD_DIFF_TILE_ROWS - 1) / EPD_DIFF_TILE_ROWS);
+  m_bandY = m_winY;
+  loadBand();
+}
+
+void EpdFrameShadow::fillWindow(bool black) {
+  if (!m_recording) return;
+  const int b0 = m_winX >> 3;
+  const int b1 = (m_winX + m_winW - 1) >> 3;  // window is byte aligned
+  for (int y = 0; y < m_bandH; ++y) {
+    memset(&m_back[y * m_stride + b0], black ? 0xFF : 0x00, (size_t)(b1 - b0 + 1));
+  }
+}
+
+void EpdFrameShadow::commitPage() {
+  if (!m_recording) return;
+  m_recording = false;
+
+ // The very first frame has nothing to compare against.
+  if (m_frontValid) {
+    const int tw = m_diff.tileWidth;
+    const int th = m_diff.tileHeight;
+    const int b0 = m_winX >> 3;
+    const int b1 = (m_winX + m_winW - 1) >> 3;
+    for (int row = 0; row < m_bandH; ++row) {
+      const int y = m_bandY + row;
+      const uint8_t* f = &m_front[y * m_stride];
+      const uint8_t* b = &m_back[row * m_stride];
+      uint16_t* tileRow = &m_diff.tileChanged[(y / th) * EPD_DIFF_TILE_COLS];
+      for (int bx = b0; bx <= b1; ++bx) {
+        uint8_t x8 = (uint8_t)(f[bx] ^ b[bx]);
+        if (!x8) continue;
+        const int px = bx << 3;
+        const int t0 = px / tw;
+        const int t1 = (px + 7) / tw;
+        if (t0 == t1 || t1 >= EPD_DIFF_TILE_COLS) {
+          uint16_t n = (uint16_t)__builtin_popcount(x8);
+          tileRow[t0] += n;
+          m_diff.changedPixels += n;
+        } else {
+          for (int k = 0; k < 8; ++k) {
+            if (x8 & (0x80 >> k)) {
+              tileRow[(px + k) / tw]++;
+              m_diff.changedPixels++;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  memcpy(&m_front[m_bandY * m_stride], m_back, (size_t)m_stride * m_bandH);
+}
+
+void EpdFrameShadow::nextPage() {
+  if (!m_front) return;
+  m_bandY += m_pageH;
+  loadBand();
+}
+
+void EpdFrameShadow::endFrame() {
+  m_recording = false;
+  m_frames++;
+  if (!m_front) return;
+
+  if (m_full) m_frontValid = true;
+  if (m_observer) m_observer(m_diff);
+}
@@ -0,0 +1,297 @@
+// CryptoBar V0.99s (Heap monitor)
+// heap_monitor.cpp - Heap / stack sampling, degrade-mode hysteresis and the RTC trend ring
+#include "heap_monitor.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "app_log.h"
+#include "retained_state.h"
+#if HEAP_MONITOR_ENABLE
+#include "esp_heap_caps.h"
+#endif
+
+static_assert(sizeof(HeapTrendPoint) == 8, "HeapTrendPoint layout changed");
+
+// Sampling runs on the loop task only (heapMonitorPoll), so the state below
+// needs no lock; other tasks only read heapMonitorDegraded().
+static bool       s_forced     = false;
+static bool       s_degraded   = false;
+static uint32_t   s_entries    = 0;
+static HeapSample s_last       = {};
+
+bool heapMonitorDegraded() {
+  return s_forced || s_degraded;
+}
+
+void heapMonitorForceDegrade(bool on) {
+  if (on == s_forced) return;
+  s_forced = on;
+  if (on && !s_degraded) s_entries++;
+  LOGW(HEAP, "[Heap] Degrade mode %s (forced)", on ? "ON" : "released");
+}
+
+bool heapMonitorForced() {
+  return s_forced;
+}
+
+HeapSample heapMonitorLast() {
+  return s_last;
+}
+
+uint32_t heapMonitorDegradeEntries() {
+  return s_entries;
+}
+
+#if HEAP_MONITOR_ENABLE
+
+// ==================== Trend ring (RTC no-init) =====================
+//
+// Written once per minute; survives the software reset into maintenance mode
+// (validated as described in retained_state.h). heapMonitorBegin() keeps a
+// valid ring as "previous boot" and starts a new one.
+
+static const uint32_t kTrendMagic   = 0x31504548;  // "HEP1"
+static const uint16_t kTrendVersion = 1;
+
+struct HeapTrendRing {
+  uint32_t       magic;
+  uint16_t       version;
+  uint8_t        count;
+  uint8_t        head;  // next slot
+  HeapTrendPoint points[HEAP_TREND_MINUTES];
+  uint32_t       crc;
+};
+
+RTC_NOINIT_ATTR static HeapTrendRing s_ring;
+
+static HeapTrendPoint s_prev[HEAP_TREND_MINUTES];  // oldest first
+static uint8_t        s_prevCount = 0;
+
+static uint32_t ringCrc(const HeapTrendRing& r) {
+  return retainedCrc(&r, offsetof(HeapTrendRing, crc));
+}
+
+static uint8_t ringCopy(const HeapTrendRing& r, HeapTrendPoint* out, uint8_t maxPoints) {
+  const uint8_t n = (r.count < maxPoints) ? r.count : maxPoints;
+  // Newest n points, oldest first.
+  uint8_t idx = (uint8_t)((r.head + HEAP_TREND_MINUTES - n) % HEAP_TREND_MINUTES);
+  for (uint8_t i = 0; i < n; i++) {
+    out[i] = r.points[idx];
+    idx = (uint8_t)((idx + 1) % HEAP_TREND_MINUTES);
+  }
+  return n;
+}
+
+static inline uint16_t toKb(uint32_t bytes) {
+  const uint32_t kb = bytes / 1024;
+  return (kb > 0xFFFF) ? 0xFFFF : (uint16_t)kb;
+}
+
+// ==================== Sampling =====================
+
+struct WatchedTask {
+  TaskHandle_t handle;
+  uint32_t     stackBytes;
+  uint32_t     minFree;
+};
+
+static WatchedTask s_tasks[HEAP_MAX_TASKS];
+static uint8_t     s_taskCount = 0;
+
+static uint32_t s_lastSampleMs = 0;
+static bool     s_sampled      = false;
+static uint8_t  s_aboveCount   = 0;  // consecutive samples above HEAP_DEGRADE_EXIT_BYTES
+
+// Current minute of the trend.
+static uint32_t s_minuteStartMs  = 0;
+static uint32_t s_minuteFree     = UINT32_MAX;
+static uint32_t s_minuteLargest  = UINT32_MAX;
+static bool     s_minuteDegraded = false;
+
+static void updateDegrade(uint32_t largest) {
+  if (!s_degraded) {
+    if (largest < HEAP_DEGRADE_ENTER_BYTES) {
+      s_degraded   = true;
+      s_aboveCount = 0;
+      if (!s_forced) s_entries++;
+      LOGW(HEAP, "[Heap] Degrade mode ON: largest block %lu B < %u B (free %lu B)",
+                 (unsigned long)largest, (unsigned)HEAP_DEGRADE_ENTER_BYTES,
+                 (unsigned long)s_last.freeBytes);
+    }
+    return;
+  }
+  if (largest < HEAP_DEGRADE_EXIT_BYTES) {
+    s_aboveCount = 0;
+    return;
+  }
+  if (++s_aboveCount >= HEAP_DEGRADE_EXIT_SAMPLES) {
+    s_degraded = false;
+    LOGI(HEAP, "[Heap] Degrade mode off: largest block %lu B", (unsigned long)largest);
+  }
+}
+
+static void pushTrendPoint(uint32_t nowMs) {
+  HeapTrendPoint& p = s_ring.points[s_ring.head];
+  p.freeKb    = toKb(s_minuteFree);
+  p.largestKb = toKb(s_minuteLargest);
+  p.minEverKb = toKb(s_last.minEverFree);
+  p.degraded  = s_minuteDegraded ? 1 : 0;
+  p.reserved  = 0;
+  s_ring.head = (uint8_t)((s_ring.head + 1) % HEAP_TREND_MINUTES);
+  if (s_ring.count < HEAP_TREND_MINUTES) s_ring.count++;
+  s_ring.crc = ringCrc(s_ring);
+
+  s_minuteStartMs  = nowMs;
+  s_minuteFree     = UINT32_MAX;
+  s_minuteLargest  = UINT32_MAX;
+  s_minuteDegraded = false;
+}
+
+static void takeSample(uint32_t nowMs) {
+  HeapSample s;
+  s.freeBytes    = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  s.largestBlock = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  s.minEverFree  = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+  s.fragPct      = s.freeBytes ? (uint8_t)(100 - (uint64_t)s.largestBlock * 100 / s.freeBytes) : 0;
+  s_last    = s;
+  s_sampled = true;
+
+  for (uint8_t i = 0; i < s_taskCount; i++) {
+    s_tasks[i].minFree = uxTaskGetStackHighWaterMark(s_tasks[i].handle);
+  }
+
+  updateDegrade(s.largestBlock);
+
+  if (s.freeBytes < s_minuteFree)       s_minuteFree = s.freeBytes;
+  if (s.largestBlock < s_minuteLargest) s_minuteLargest = s.largestBlock;
+  if (heapMonitorDegraded())            s_minuteDegraded = true;
+  if (nowMs - s_minuteStartMs >= 60000UL) pushTrendPoint(nowMs);
+}
+
+#endif  // HEAP_MONITOR_ENABLE
+
+void heapMonitorBegin() {
+#if HEAP_MONITOR_ENABLE
+  if (s_ring.magic == kTrendMagic && s_ring.version == kTrendVersion &&
+      s_ring.count <= HEAP_TREND_MINUTES && s_ring.head < HEAP_TREND_MINUTES &&
+      s_ring.crc == ringCrc(s_ring)) {
+    s_prevCount = ringCopy(s_ring, s_prev, HEAP_TREND_MINUTES);
+    Serial.printf("[Heap] Previous boot: %u min of heap trend (send 'H' to dump)\n",
+                  (unsigned)s_prevCount);
+  }
+  memset(&s_ring, 0, sizeof(s_ring));
+  s_ring.magic   = kTrendMagic;
+  s_ring.version = kTrendVersion;
+  s_ring.crc     = ringCrc(s_ring);
+
+  s_minuteStartMs = millis();
+  heapMonitorPoll(true);
+#endif
+}
+
+void heapMonitorWatchTask(TaskHandle_t task, uint32_t stackBytes) {
+#if HEAP_MONITOR_ENABLE
+  if (!task || s_taskCount >= HEAP_MAX_TASKS) return;
+  for (uint8_t i = 0; i < s_taskCount; i++) {
+    if (s_tasks[i].handle == task) return;
+  }
+  WatchedTask& t = s_tasks[s_taskCount++];
+  t.handle     = task;
+  t.stackBytes = stackBytes;
+  t.minFree    = uxTaskGetStackHighWaterMark(task);
+#else
+  (void)task; (void)stackBytes;
+#endif
+}
+
+void heapMonitorPoll(bool force) {
+#if HEAP_MONITOR_ENABLE
+  const uint32_t nowMs = millis();
+  if (!force && s_sampled && nowMs - s_lastSampleMs < HEAP_SAMPLE_MS) return;
+  s_lastSampleMs = nowMs;
+  takeSample(nowMs);
+#else
+  (void)force;
+#endif
+}
+
+uint8_t heapMonitorTasks(HeapTaskStack* out, uint8_t maxTasks) {
+#if HEAP_MONITOR_ENABLE
+  const uint8_t n = (s_taskCount < maxTasks) ? s_taskCount : maxTasks;
+  for (uint8_t i = 0; i < n; i++) {
+    const char* name = pcTaskGetName(s_tasks[i].handle);
+    strncpy(out[i].name, name ? name : "?", HEAP_TASK_NAME - 1);
+    out[i].name[HEAP_TASK_NAME - 1] = '\0';
+    out[i].stackBytes   = s_tasks[i].stackBytes;
+    out[i].minFreeBytes = s_tasks[i].minFree;
+  }
+  return n;
+#else
+  (void)out; (void)maxTasks;
+  return 0;
+#endif
+}
+
+uint8_t heapMonitorTrend(HeapTrendPoint* out, uint8_t maxPoints, bool previous) {
+#if HEAP_MONITOR_ENABLE
+  if (!previous) return ringCopy(s_ring, out, maxPoints);
+  const uint8_t n = (s_prevCount < maxPoints) ? s_prevCount : maxPoints;
+  memcpy(out, &s_prev[s_prevCount - n], n * sizeof(HeapTrendPoint));
+  return n;
+#else
+  (void)out; (void)maxPoints; (void)previous;
+  return 0;
+#endif
+}
+
+// ==================== Serial =====================
+
+void heapMonitorLogStats() {
+#if HEAP_MONITOR_ENABLE
+  const HeapSample s = s_last;
+  LOGI(HEAP, "[Heap] free=%luK largest=%luK minEver=%luK frag=%u%% degrade=%s entries=%lu",
+             (unsigned long)(s.freeBytes / 1024), (unsigned long)(s.largestBlock / 1024),
+             (unsigned long)(s.minEverFree / 1024), (unsigned)s.fragPct,
+             heapMonitorDegraded() ? (s_forced ? "forced" : "on") : "off",
+             (unsigned long)s_entries);
+
+  char line[LOG_LINE_MAX];
+  size_t len = (size_t)snprintf(line, sizeof(line), "[Stack] min free:");
+  for (uint8_t i = 0; i < s_taskCount && len < sizeof(line); i++) {
+    const char* name = pcTaskGetName(s_tasks[i].handle);
+    len += (size_t)snprintf(line + len, sizeof(line) - len, " %s=%lu/%lu",
+                            name ? name : "?", (unsigned long)s_tasks[i].minFree,
+                            (unsigned long)s_tasks[i].stackBytes);
+  }
+  LOGI(HEAP, "%s", line);
+#endif
+}
+
+void heapMonitorDump(bool previous) {
+  static HeapTrendPoint points[HEAP_TREND_MINUTES];  // loop task only
+  const uint8_t n = heapMonitorTrend(points, HEAP_TREND_MINUTES, previous);
+
+  if (!previous) {
+    const HeapSample s = s_last;
+    Serial.printf("[Heap] free=%lu largest=%lu minEver=%lu frag=%u%% degrade=%s entries=%lu\n",
+                  (unsigned long)s.freeBytes, (unsigned long)s.largestBlock,
+                  (unsigned long)s.minEverFree, (unsigned)s.fragPct,
+                  heapMonitorDegraded() ? (s_forced ? "forced" : "on") : "off",
+                  (unsigned long)s_entries);
+    HeapTaskStack tasks[HEAP_MAX_TASKS];
+    const uint8_t tc = heapMonitorTasks(tasks, HEAP_MAX_TASKS);
+    for (uint8_t i = 0; i < tc; i++) {
+      Serial.printf("[Stack] %-11s %5lu / %5lu B free (min)\n", tasks[i].name,
+                    (unsigned long)tasks[i].minFreeBytes, (unsigned long)tasks[i].stackBytes);
+    }
+  }
+
+  Serial.printf("[Heap] %s boot trend, %u min (KB, minimum per minute)\n",
+                previous ? "Previous" : "This", (unsigned)n);
+  Serial.println("[Heap]  min   free largest minEver degrade");
+  for (uint8_t i = 0; i < n; i++) {
+    const HeapTrendPoint& p = points[i];
+    Serial.printf("[Heap] %4d %6u %7u %7u %s\n", (int)i - (int)n, (unsigned)p.freeKb,
+                  (unsigned)p.largestKb, (unsigned)p.minEverKb, p.degraded ? "yes" : "-");
+  }
+}
@@ -0,0 +1,149 @@
+// CryptoBar V0.99s (HTTP response cache)
+// http_cache.cpp - RAM table of per-URL validators + parsed results, mirrored to NVS on change
+#include "http_cache.h"
+
+#include <Preferences.h>
+#include <string.h>
+
+#include "app_log.h"
+#include "app_state.h"  // TIME_VALID_MIN_UTC
+
+static const char*   kNs      = "httpcache";
+static const uint8_t kVersion = 1;  // bump when HttpCacheEntry changes
+
+static HttpCacheEntry s_entries[HTTP_CACHE_ENTRIES];
+static bool           s_loaded = false;
+
+static uint32_t urlHash(const char* url) {
+  uint32_t h = 2166136261UL;
+  while (*url) {
+    h ^= (uint8_t)*url++;
+    h *= 16777619UL;
+  }
+  return h ? h : 1;  // 0 marks an empty slot
+}
+
+static void slotKey(int slot, char* key) {
+  key[0] = 'e';
+  key[1] = (char)('0' + slot);
+  key[2] = '\0';
+}
+
+static void ensureLoaded() {
+  if (s_loaded) return;
+  s_loaded = true;
+  memset(s_entries, 0, sizeof(s_entries));
+
+  Preferences pref;
+  if (!pref.begin(kNs, true)) return;  // nothing stored yet
+  if (pref.getUChar("ver", 0) == kVersion) {
+    int n = 0;
+    for (int i = 0; i < HTTP_CACHE_ENTRIES; i++) {
+      char key[4];
+      slotKey(i, key);
+      if (pref.getBytesLength(key) != sizeof(HttpCacheEntry)) continue;
+      pref.getBytes(key, &s_entries[i], sizeof(HttpCacheEntry));
+      if (s_entries[i].resultLen > HTTP_CACHE_RESULT_MAX) memset(&s_entries[i], 0, sizeof(HttpCacheEntry));
+      if (s_entries[i].urlHash) n++;
+    }
+    LOGD(NET, "[HttpCache] %d entr%s loaded", n, n == 1 ? "y" : "ies");
+  }
+  pref.end();
+}
+
+static void persist(int slot) {
+  Preferences pref;
+  if (!pref.begin(kNs, false)) {
+    LOGW(NET, "[HttpCache] NVS open failed");
+    return;
+  }
+  if (pref.getUChar("ver", 0) != kVersion) {
+    pref.clear();  // older layout: drop every slot
+    pref.putUChar("ver", kVersion);
+  }
+  char key[4];
+  slotKey(slot, key);
+  if (pref.putBytes(key, &s_entries[slot], sizeof(HttpCacheEntry)) != sizeof(HttpCacheEntry)) {
+    LOGW(NET, "[HttpCache] NVS write failed");
+  }
+  pref.end();
+}
+
+static int findSlot(uint32_t hash) {
+  for (int i = 0; i < HTTP_CACHE_ENTRIES; i++) {
+    if (s_entries[i].urlHash == hash) return i;
+  }
+  return -1;
+}
+
+bool httpCacheLookup(const char* url, HttpCacheEntry& out) {
+#if HTTP_CACHE_ENABLE
+  ensureLoaded();
+  int slot = findSlot(urlHash(url));
+  if (slot < 0) return false;
+  out = s_entries[slot];
+  return true;
+#else
+  (void)url;
+  (void)out;
+  return false;
+#endif
+}
+
+bool httpCacheFresh(const HttpCacheEntry& e, time_t nowUtc) {
+  if (e.validators.maxAgeS <= 0) return false;
+  if (nowUtc < TIME_VALID_MIN_UTC || (time_t)e.storedUtc < TIME_VALID_MIN_UTC) return false;
+  if (nowUtc < (time_t)e.storedUtc) return false;  // clock went back
+  return nowUtc - (time_t)e.storedUtc < (time_t)e.validators.maxAgeS;
+}
+
+void httpCacheStore(const char* url, const LiteHttpValidators& v, const void* result, size_t resultLen,
+                    time_t nowUtc) {
+#if HTTP_CACHE_ENABLE
+  if (!v.etag[0] && !v.lastModified[0] && v.maxAgeS <= 0) return;  // nothing to revalidate with
+  if (result && resultLen > HTTP_CACHE_RESULT_MAX) return;
+  ensureLoaded();
+
+  const uint32_t hash = urlHash(url);
+  int slot = findSlot(hash);
+  if (slot < 0) {
+    if (!result) return;  // 304 for an entry we no longer have
+    slot = 0;  // empty slot, else the least recently stored
+    for (int i = 0; i < HTTP_CACHE_ENTRIES; i++) {
+      if (!s_entries[i].urlHash) {
+        slot = i;
+        break;
+      }
+      if (s_entries[i].storedUtc < s_entries[slot].storedUtc) slot = i;
+    }
+    memset(&s_entries[slot], 0, sizeof(HttpCacheEntry));
+  }
+
+  HttpCacheEntry& e = s_entries[slot];
+  // Validators are strings: bytes past the terminator (left by whoever filled
+  // v) must not count as a change and cost a flash write.
+  bool changed = e.urlHash != hash || strncmp(e.validators.etag, v.etag, sizeof(v.etag)) != 0 ||
+                 strncmp(e.validators.lastModified, v.lastModified, sizeof(v.lastModified)) != 0;
+  if (result) {
+    changed |= e.resultLen != resultLen || memcmp(e.result, result, resultLen) != 0;
+    e.resultLen = (uint16_t)resultLen;
+    memcpy(e.result, result, resultLen);
+  }
+  e.urlHash = hash;
+  e.storedUtc = (uint32_t)nowUtc;
+  memset(&e.validators, 0, sizeof(e.validators));  // keep the blob free of stale bytes
+  snprintf(e.validators.etag, sizeof(e.validators.etag), "%s", v.etag);
+  snprintf(e.validators.lastModified, sizeof(e.validators.lastModified), "%s", v.lastModified);
+  e.validators.maxAgeS = v.maxAgeS;
+
+  // A new max-age alone is not worth a flash write: after a reboot the entry
+  // is simply revalidated.
+  if (changed) persist(slot);
+#else
+  (void)url;
+  (void)v;
+  (void)result;
+  (void)resultLen;
+  (void)nowUtc;
+#endif
+}
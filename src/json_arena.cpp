@@ -0,0 +1,135 @@
+// CryptoBar V0.99s (JSON arena)
+// json_arena.cpp - Bump allocator over a boot-time buffer for ArduinoJson documents
+#include "json_arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "app_log.h"
+
+// Each block carries an 8-byte header holding its size, so reallocate() can
+// copy it; blocks are 8-byte aligned.
+static const size_t kAlign  = 8;
+static const size_t kHeader = 8;
+
+static uint8_t*       s_arena   = nullptr;
+static size_t         s_cap     = 0;
+static size_t         s_used    = 0;  // bump offset
+static size_t         s_lastOff = 0;  // header offset of the newest block (grown / popped in place)
+static uint32_t       s_live    = 0;  // arena blocks not yet released; 0 rewinds the arena
+static JsonArenaStats s_stats   = {};
+static portMUX_TYPE   s_mux     = portMUX_INITIALIZER_UNLOCKED;
+
+JsonArenaAllocator jsonArenaAllocator;
+
+static inline size_t blockBytes(size_t size) {
+  return kHeader + ((size + kAlign - 1) & ~(kAlign - 1));
+}
+
+static inline bool inArena(const void* p) {
+  return s_arena && (const uint8_t*)p >= s_arena && (const uint8_t*)p < s_arena + s_cap;
+}
+
+static inline void noteUse() {
+  if (s_used > s_stats.highWater) s_stats.highWater = (uint32_t)s_used;
+}
+
+// Caller holds s_mux.
+static void* arenaAllocLocked(size_t size) {
+  const size_t need = blockBytes(size);
+  if (!s_arena || need > s_cap - s_used) return nullptr;
+  uint8_t* h = s_arena + s_used;
+  *(uint32_t*)h = (uint32_t)size;
+  s_lastOff = s_used;
+  s_used += need;
+  s_live++;
+  s_stats.allocations++;
+  noteUse();
+  return h + kHeader;
+}
+
+// Caller holds s_mux; p is an arena block.
+static void arenaReleaseLocked(void* p) {
+  if (s_live > 0 && --s_live == 0) {
+    s_used = 0;  // request finished: rewind
+  } else if ((uint8_t*)p - kHeader == s_arena + s_lastOff) {
+    s_used = s_lastOff;  // newest block: pop it
+  }
+}
+
+bool jsonArenaBegin() {
+  if (s_arena) return true;
+  s_arena = (uint8_t*)malloc(JSON_ARENA_BYTES);
+  if (!s_arena) {
+    LOGW(NET, "[JSON] Arena allocation failed (%u B), documents use the heap", (unsigned)JSON_ARENA_BYTES);
+    return false;
+  }
+  s_cap = JSON_ARENA_BYTES;
+  s_stats.capacity = (uint32_t)s_cap;
+  LOGI(NET, "[JSON] Arena: %u B", (unsigned)s_cap);
+  return true;
+}
+
+void jsonArenaGetStats(JsonArenaStats& out) {
+  portENTER_CRITICAL(&s_mux);
+  out = s_stats;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void* JsonArenaAllocator::allocate(size_t size) {
+  portENTER_CRITICAL(&s_mux);
+  void* p = arenaAllocLocked(size);
+  if (!p) s_stats.heapFallbacks++;
+  portEXIT_CRITICAL(&s_mux);
+  return p ? p : malloc(size);
+}
+
+void JsonArenaAllocator::deallocate(void* ptr) {
+  if (!ptr) return;
+  if (!inArena(ptr)) {
+    free(ptr);
+    return;
+  }
+  portENTER_CRITICAL(&s_mux);
+  arenaReleaseLocked(ptr);
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void* JsonArenaAllocator::reallocate(void* ptr, size_t newSize) {
+  if (!ptr) return allocate(newSize);
+  if (!inArena(ptr)) return realloc(ptr, newSize);
+
+  uint8_t* h = (uint8_t*)ptr - kHeader;
+  portENTER_CRITICAL(&s_mux);
+  const size_t oldSize = *(uint32_t*)h;
+  if (h == s_arena + s_lastOff && blockBytes(newSize) <= s_cap - s_lastOff) {
+    // Newest block: grow or shrink in place.
+    *(uint32_t*)h = (uint32_t)newSize;
+    s_used = s_lastOff + blockBytes(newSize);
+    noteUse();
+    portEXIT_CRITICAL(&s_mux);
+    return ptr;
+  }
+  if (newSize <= oldSize) {
+    // Older block shrinking (shrinkToFit() on a pool): keep it where it is;
+    // the tail comes back at the rewind.
+    *(uint32_t*)h = (uint32_t)newSize;
+    portEXIT_CRITICAL(&s_mux);
+    return ptr;
+  }
+  void* q = arenaAllocLocked(newSize);
+  if (q) {
+    memcpy(q, ptr, (oldSize < newSize) ? oldSize : newSize);
+    s_live--;  // the old block is dead (its space returns at the rewind); q keeps s_live > 0
+    portEXIT_CRITICAL(&s_mux);
+    return q;
+  }
+  s_stats.heapFallbacks++;
+  portEXIT_CRITICAL(&s_mux);
+
+  q = malloc(newSize);
+  if (!q) return nullptr;  // ArduinoJson keeps the old block
+  memcpy(q, ptr, (oldSize < newSize) ? oldSize : newSize);
+  deallocate(ptr);
+  return q;
+}
@@ -12,6 +12,7 @@
 #include "freertos/semphr.h"
 
 #include "led_status.h"
+#include "heap_monitor.h"
 
 // ===== NeoPixel instances =====
 static Adafruit_NeoPixel* s_pixel = nullptr;      // external WS2812
@@ -478,4 +479,5 @@ void ledAnimStartTask(uint16_t hz, uint8_t core) {
 
  // Create pinned task so LED breathing continues even if main loop is busy.
   xTaskCreatePinnedToCore(ledAnimTask, "ledAnim", 4096, nullptr, 1, &s_animTaskHandle, core);
+  heapMonitorWatchTask(s_animTaskHandle, 4096);
 }
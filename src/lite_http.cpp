@@ -0,0 +1,371 @@
+// CryptoBar V0.99s (Fixed-buffer HTTP client)
+// lite_http.cpp - Request, header parsing, redirects, Content-Length / chunked bodies and inflate hookup
+#include "lite_http.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const int kClosed = -1000;  // fill(): peer closed the connection
+
+// ==================== URL =====================
+
+struct UrlParts {
+  bool        tls;
+  uint16_t    port;
+  char        host[96];
+  const char* path;  // into the URL ("/" if it has none)
+};
+
+static bool parseUrl(const char* url, UrlParts& u) {
+  const char* p;
+  if (strncmp(url, "https://", 8) == 0) {
+    u.tls  = true;
+    u.port = 443;
+    p = url + 8;
+  } else if (strncmp(url, "http://", 7) == 0) {
+    u.tls  = false;
+    u.port = 80;
+    p = url + 7;
+  } else {
+    return false;
+  }
+
+  const size_t authLen = strcspn(p, "/?#");
+  const char*  colon   = (const char*)memchr(p, ':', authLen);
+  const size_t hostLen = colon ? (size_t)(colon - p) : authLen;
+  if (hostLen == 0 || hostLen >= sizeof(u.host)) return false;
+  memcpy(u.host, p, hostLen);
+  u.host[hostLen] = '\0';
+  if (colon) {
+    long port = strtol(colon + 1, nullptr, 10);
+    if (port <= 0 || port > 65535) return false;
+    u.port = (uint16_t)port;
+  }
+  u.path = (p[authLen] == '/') ? p + authLen : "/";
+  return true;
+}
+
+static bool defaultPort(const UrlParts& u) {
+  return u.port == (u.tls ? 443 : 80);
+}
+
+// Case-insensitive "Name:" prefix; returns the trimmed value or nullptr.
+static const char* headerValue(const char* line, const char* name) {
+  const size_t n = strlen(name);
+  if (strncasecmp(line, name, n) != 0 || line[n] != ':') return nullptr;
+  const char* v = line + n + 1;
+  while (*v == ' ' || *v == '\t') v++;
+  return v;
+}
+
+// ==================== Connection =====================
+
+LiteHttp::LiteHttp(NetSocket& socket, char* buf, size_t bufLen)
+    : m_sock(socket), m_buf(buf), m_bufLen(bufLen), m_pos(0), m_len(0), m_open(false),
+      m_mode(BODY_NONE), m_contentLength(-1), m_remaining(0), m_bodyRead(0), m_rawRead(0),
+      m_bodyError(0), m_headMs(0), m_inflate(nullptr), m_active(nullptr), m_encoding(0),
+      m_validators(nullptr) {
+  m_to.connectMs  = 5000;
+  m_to.headerMs   = 8000;
+  m_to.bodyIdleMs = 8000;
+  m_location[0]   = '\0';
+}
+
+void LiteHttp::end() {
+  if (m_open) m_sock.close();
+  m_open   = false;
+  m_mode   = BODY_NONE;
+  m_active = nullptr;
+  m_pos = m_len = 0;
+}
+
+int LiteHttp::fill(uint32_t timeoutMs) {
+  if (m_pos > 0) {
+    memmove(m_buf, m_buf + m_pos, m_len - m_pos);
+    m_len -= m_pos;
+    m_pos = 0;
+  }
+  if (m_len >= m_bufLen) return NET_ERR_LOST;  // caller keeps the buffer full (line too long)
+  int n = m_sock.read((uint8_t*)m_buf + m_len, m_bufLen - m_len, timeoutMs);
+  if (n > 0) m_len += (size_t)n;
+  return (n == 0) ? kClosed : n;
+}
+
+// Next line, NUL-terminated at m_buf + returned offset (valid until the next
+// read). Lines that do not fit the buffer are dropped and flagged as overflow.
+int LiteHttp::readLine(uint32_t deadlineMs, bool& overflow) {
+  overflow = false;
+  for (;;) {
+    char* start = m_buf + m_pos;
+    char* nl = (char*)memchr(start, '\n', m_len - m_pos);
+    if (nl) {
+      *nl = '\0';
+      if (nl > start && nl[-1] == '\r') nl[-1] = '\0';
+      const int off = (int)m_pos;
+      m_pos = (size_t)(nl - m_buf) + 1;
+      return off;
+    }
+    if (m_pos == 0 && m_len == m_bufLen) {
+      overflow = true;  // drop what we have and keep looking for the end of the line
+      m_len = 0;
+    }
+    const int32_t left = (int32_t)(deadlineMs - millis());
+    if (left <= 0) return NET_ERR_TIMEOUT;
+    int n = fill((uint32_t)left);
+    if (n == kClosed) return NET_ERR_LOST;
+    if (n < 0) return n;
+  }
+}
+
+// ==================== Request =====================
+
+int LiteHttp::request(const char* url) {
+  UrlParts u;
+  if (!parseUrl(url, u)) return NET_ERR_CONNECT;
+
+  m_pos = m_len = 0;
+  m_mode          = BODY_NONE;
+  m_contentLength = -1;
+  m_remaining     = 0;
+  m_bodyRead      = 0;
+  m_rawRead       = 0;
+  m_bodyError     = 0;
+  m_active        = nullptr;
+  m_encoding      = 0;
+  m_location[0]   = '\0';
+  m_seen.etag[0]         = '\0';
+  m_seen.lastModified[0] = '\0';
+  m_seen.maxAgeS         = -1;
+  int32_t age = 0;
+
+  if (!m_sock.connect(u.host, u.port, u.tls, m_to.connectMs)) return NET_ERR_CONNECT;
+  m_open = true;
+
+  char portSuffix[8] = "";
+  if (!defaultPort(u)) snprintf(portSuffix, sizeof(portSuffix), ":%u", (unsigned)u.port);
+  int n = snprintf(m_buf, m_bufLen,
+                   "GET %s HTTP/1.1\r\nHost: %s%s\r\nUser-Agent: ESP32HTTPClient\r\n"
+                   "Accept-Encoding: %s\r\n",
+                   u.path, u.host, portSuffix, m_inflate ? "gzip, deflate" : "identity");
+  if (n > 0 && (size_t)n < m_bufLen && m_validators && m_validators->etag[0]) {
+    n += snprintf(m_buf + n, m_bufLen - (size_t)n, "If-None-Match: %s\r\n", m_validators->etag);
+  }
+  if (n > 0 && (size_t)n < m_bufLen && m_validators && m_validators->lastModified[0]) {
+    n += snprintf(m_buf + n, m_bufLen - (size_t)n, "If-Modified-Since: %s\r\n", m_validators->lastModified);
+  }
+  if (n > 0 && (size_t)n < m_bufLen) n += snprintf(m_buf + n, m_bufLen - (size_t)n, "Connection: close\r\n\r\n");
+  if (n <= 0 || (size_t)n >= m_bufLen) return NET_ERR_SEND;
+  if (m_sock.write((const uint8_t*)m_buf, (size_t)n, m_to.headerMs) != n) return NET_ERR_SEND;
+
+  const uint32_t deadline = millis() + m_to.headerMs;
+  bool overflow;
+  int off = readLine(deadline, overflow);
+  if (off < 0) return off;
+  const char* status = m_buf + off;
+  if (overflow || strncmp(status, "HTTP/1.", 7) != 0) return NET_ERR_LOST;
+  const char* sp = strchr(status, ' ');
+  const int code = sp ? atoi(sp + 1) : 0;
+  if (code < 100) return NET_ERR_LOST;
+
+  bool chunked = false;
+  for (;;) {
+    off = readLine(deadline, overflow);
+    if (off < 0) return off;
+    const char* line = m_buf + off;
+    if (overflow) continue;
+    if (line[0] == '\0') break;
+
+    const char* v;
+    if ((v = headerValue(line, "Content-Length")) != nullptr) {
+      m_contentLength = (int32_t)strtol(v, nullptr, 10);
+    } else if ((v = headerValue(line, "Transfer-Encoding")) != nullptr) {
+      for (const char* p = v; *p; p++) {
+        if (strncasecmp(p, "chunked", 7) == 0) chunked = true;
+      }
+    } else if ((v = headerValue(line, "Content-Encoding")) != nullptr) {
+      if (strncasecmp(v, "gzip", 4) == 0 || strncasecmp(v, "x-gzip", 6) == 0) {
+        m_encoding = NET_INFLATE_GZIP + 1;
+      } else if (strncasecmp(v, "deflate", 7) == 0) {
+        m_encoding = NET_INFLATE_DEFLATE + 1;
+      }
+    } else if ((v = headerValue(line, "Location")) != nullptr) {
+      if (strncmp(v, "http://", 7) == 0 || strncmp(v, "https://", 8) == 0) {
+        snprintf(m_location, sizeof(m_location), "%s", v);
+      } else {
+        snprintf(m_location, sizeof(m_location), "%s://%s%s%s%s", u.tls ? "https" : "http",
+                 u.host, portSuffix, (v[0] == '/') ? "" : "/", v);
+      }
+    } else if ((v = headerValue(line, "ETag")) != nullptr) {
+      if (strlen(v) < sizeof(m_seen.etag)) strcpy(m_seen.etag, v);
+    } else if ((v = headerValue(line, "Last-Modified")) != nullptr) {
+      if (strlen(v) < sizeof(m_seen.lastModified)) strcpy(m_seen.lastModified, v);
+    } else if ((v = headerValue(line, "Cache-Control")) != nullptr) {
+      if (strcasestr(v, "no-store") || strcasestr(v, "no-cache")) {
+        m_seen.maxAgeS = 0;
+      } else if (const char* ma = strcasestr(v, "max-age=")) {
+        if (m_seen.maxAgeS != 0) m_seen.maxAgeS = (int32_t)strtol(ma + 8, nullptr, 10);
+      }
+    } else if ((v = headerValue(line, "Age")) != nullptr) {
+      age = (int32_t)strtol(v, nullptr, 10);
+    }
+  }
+  if (m_seen.maxAgeS > 0) m_seen.maxAgeS = (age < m_seen.maxAgeS) ? m_seen.maxAgeS - age : 0;
+
+  if (chunked) {
+    m_mode          = BODY_CHUNKED;
+    m_contentLength = -1;
+  } else if (code == 204 || code == 304 || code < 200) {
+    m_mode = BODY_NONE;
+  } else if (m_contentLength >= 0) {
+    m_remaining = (uint32_t)m_contentLength;
+    m_mode      = (m_remaining > 0) ? BODY_LENGTH : BODY_NONE;
+  } else {
+    m_mode = BODY_CLOSE;
+  }
+  if (m_encoding && m_inflate && m_mode != BODY_NONE) {
+    m_active = m_inflate;
+    m_active->begin(inflateSource, this, (NetInflateFormat)(m_encoding - 1));
+  }
+  return code;
+}
+
+int LiteHttp::get(const char* url, const LiteHttpTimeouts& timeouts, NetInflate* inflate,
+                  LiteHttpValidators* validators) {
+  end();
+  m_to         = timeouts;
+  m_inflate    = inflate;
+  m_validators = validators;
+  const uint32_t start = millis();
+  int code = NET_ERR_CONNECT;
+  for (int hop = 0; hop <= LITE_HTTP_MAX_REDIRECTS; hop++) {
+    code = request(hop == 0 ? url : m_location);
+    const bool redirect = (code == 301 || code == 302 || code == 303 || code == 307 || code == 308);
+    if (!redirect || m_location[0] == '\0' || hop == LITE_HTTP_MAX_REDIRECTS) break;
+    end();
+  }
+  m_headMs = millis() - start;
+  if (code < 0) end();
+
+  // 200: the response's validators replace the old ones; 304: headers it
+  // repeats are refreshed, the rest stay.
+  if (validators && code == 200) {
+    *validators = m_seen;
+  } else if (validators && code == 304) {
+    if (m_seen.etag[0]) strcpy(validators->etag, m_seen.etag);
+    if (m_seen.lastModified[0]) strcpy(validators->lastModified, m_seen.lastModified);
+    validators->maxAgeS = m_seen.maxAgeS;
+  }
+  return code;
+}
+
+// ==================== Body =====================
+
+// Start the next chunk (chunked mode, current one used up). False at the last
+// chunk or on an error (then bodyError() is set).
+bool LiteHttp::nextChunk() {
+  const uint32_t deadline = millis() + m_to.bodyIdleMs;
+  bool overflow;
+  for (;;) {
+    int off = readLine(deadline, overflow);
+    if (off < 0) {
+      m_bodyError = off;
+      return false;
+    }
+    const char* line = m_buf + off;
+    if (overflow) {
+      m_bodyError = NET_ERR_LOST;
+      return false;
+    }
+    if (line[0] == '\0') continue;  // CRLF after the previous chunk's data
+    if (!isxdigit((unsigned char)line[0])) {
+      m_bodyError = NET_ERR_LOST;
+      return false;
+    }
+    m_remaining = (uint32_t)strtoul(line, nullptr, 16);  // extensions after ';' are ignored
+    if (m_remaining > 0) return true;
+
+    // Last chunk: skip trailers up to the blank line.
+    do {
+      off = readLine(deadline, overflow);
+    } while (off >= 0 && (overflow || m_buf[off] != '\0'));
+    return false;
+  }
+}
+
+size_t LiteHttp::readRaw(char* out, size_t len) {
+  size_t n = 0;
+  while (n < len && m_mode != BODY_NONE) {
+    if (m_mode == BODY_CHUNKED && m_remaining == 0 && !nextChunk()) {
+      m_mode = BODY_NONE;
+      break;
+    }
+    if (m_pos == m_len) {
+      int r = fill(m_to.bodyIdleMs);
+      if (r <= 0) {
+        if (r != kClosed || m_mode != BODY_CLOSE) m_bodyError = (r == kClosed) ? NET_ERR_LOST : r;
+        m_mode = BODY_NONE;
+        break;
+      }
+    }
+    size_t take = m_len - m_pos;
+    if (take > len - n) take = len - n;
+    if (m_mode != BODY_CLOSE && take > m_remaining) take = m_remaining;
+    memcpy(out + n, m_buf + m_pos, take);
+    m_pos += take;
+    n += take;
+    if (m_mode != BODY_CLOSE) {
+      m_remaining -= (uint32_t)take;
+      if (m_mode == BODY_LENGTH && m_remaining == 0) m_mode = BODY_NONE;
+    }
+  }
+  m_rawRead += n;
+  return n;
+}
+
+size_t LiteHttp::inflateSource(void* ctx, uint8_t* buf, size_t len) {
+  return static_cast<LiteHttp*>(ctx)->readRaw((char*)buf, len);
+}
+
+size_t LiteHttp::readBytes(char* out, size_t len) {
+  if (!m_active) {
+    size_t n = readRaw(out, len);
+    m_bodyRead += n;
+    return n;
+  }
+  size_t n = m_active->readBytes(out, len);
+  m_bodyRead += n;
+  if (n < len && m_bodyError == 0) {
+    switch (m_active->error()) {
+      case NET_INFLATE_OK:        break;
+      case NET_INFLATE_ERR_INPUT: m_bodyError = NET_ERR_LOST; break;
+      default:                    m_bodyError = NET_ERR_ENCODING; break;
+    }
+  }
+  return n;
+}
+
+int LiteHttp::read() {
+  // Fast path: a buffered byte of the current Content-Length span / chunk.
+  if (!m_active && m_pos < m_len && m_remaining > 1 && (m_mode == BODY_LENGTH || m_mode == BODY_CHUNKED)) {
+    m_remaining--;
+    m_rawRead++;
+    m_bodyRead++;
+    return (uint8_t)m_buf[m_pos++];
+  }
+  char c;
+  return (readBytes(&c, 1) == 1) ? (uint8_t)c : -1;
+}
+
+size_t LiteHttp::readAll(char* out, size_t cap) {
+  size_t total = 0;
+  if (cap > 0) {
+    total = readBytes(out, cap - 1);
+    out[total] = '\0';
+  }
+  char scratch[64];
+  size_t n;
+  while ((n = readBytes(scratch, sizeof(scratch))) > 0) total += n;
+  return total;
+}
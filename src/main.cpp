@@ -6,7 +6,7 @@
 #include <time.h>
 #include <esp_sntp.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 #include <Fonts/FreeSansBold9pt7b.h>
 #include <Fonts/FreeSansBold12pt7b.h>
 #include <Fonts/FreeSansBold18pt7b.h>
@@ -34,6 +34,16 @@
 #include "day_avg.h"
 #include "network.h"
 #include "ui.h"
+#include "render_task.h"
+#include "refresh_scheduler.h"
+#include "app_log.h"
+#include "profile.h"
+#include "trace.h"
+#include "heap_monitor.h"
+#include "json_arena.h"
+#include "boot_timeline.h"
+#include "boot_cache.h"
+#include "warm_restart.h"
 
 #include <string.h> // for strcmp
 
@@ -52,7 +62,7 @@
 
 // ==================== e-paper display =====================
 
-GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display(
+EpdDisplay display(
   GxEPD2_290_BS(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY)
 );
 
@@ -100,6 +110,77 @@ void updateAvgLineReference(time_t nowUtc) {
   }
 }
 
+// ==================== Main-loop stall tracking (V0.99s) =====================
+// Measures the time between consecutive loop() entries, so any blocking work
+// (network, synchronous e-paper refresh) shows up. Reported once per minute;
+// build with -DRENDER_TASK_ENABLE=0 to compare against synchronous rendering.
+static const uint32_t LOOP_STALL_REPORT_MS  = 60000;
+static const uint32_t LOOP_STALL_SLOW_US    = 100000;  // iterations >100ms count as stalls
+
+static void loopStallTrack() {
+  static uint32_t s_lastEntryUs   = 0;
+  static uint32_t s_windowStartMs = 0;
+  static uint32_t s_iterations    = 0;
+  static uint32_t s_slowCount     = 0;
+  static uint32_t s_maxUs         = 0;
+  static uint64_t s_sumUs         = 0;
+
+  uint32_t nowUs = micros();
+  uint32_t nowMs = millis();
+  if (s_lastEntryUs != 0) {
+    uint32_t dt = nowUs - s_lastEntryUs;
+    static ProfileZoneStats* s_loopZone = profileZone("loop");
+    profileRecordUs(s_loopZone, dt);
+    s_iterations++;
+    s_sumUs += dt;
+    if (dt > s_maxUs) s_maxUs = dt;
+    if (dt >= LOOP_STALL_SLOW_US) s_slowCount++;
+  } else {
+    s_windowStartMs = nowMs;
+  }
+  s_lastEntryUs = nowUs;
+
+  if (nowMs - s_windowStartMs >= LOOP_STALL_REPORT_MS && s_iterations > 0) {
+    LOGI(MAIN, "[Loop] %lus: iters=%lu avg=%luus max=%lums stalls(>%lums)=%lu render=%s",
+               (unsigned long)((nowMs - s_windowStartMs) / 1000UL),
+               (unsigned long)s_iterations,
+               (unsigned long)(s_sumUs / s_iterations),
+               (unsigned long)(s_maxUs / 1000UL),
+               (unsigned long)(LOOP_STALL_SLOW_US / 1000UL),
+               (unsigned long)s_slowCount,
+               RENDER_TASK_ENABLE ? "async" : "sync");
+    renderTaskLogStats();
+    refreshSchedulerLogStats();
+    heapMonitorLogStats();
+    profileCheckpoint();
+    s_windowStartMs = nowMs;
+    s_iterations = 0;
+    s_slowCount = 0;
+    s_maxUs = 0;
+    s_sumUs = 0;
+  }
+}
+
+// ==================== Serial diagnostics (V0.99s) =====================
+// 'p' / 'P': profile zones (this / previous boot)
+// 'h' / 'H': heap, stacks and heap trend (this / previous boot)
+// 'd':       toggle forced low-memory degrade mode
+// 'b' / 'B': boot timeline (this / previous boot)
+static void serialCommandPoll() {
+  while (Serial.available() > 0) {
+    switch (Serial.read()) {
+      case 'b': bootTimelineDump(false); break;
+      case 'B': bootTimelineDump(true); break;
+      case 'p': profileDump(false); break;
+      case 'P': profileDump(true); break;
+      case 'h': heapMonitorPoll(true); heapMonitorDump(false); break;
+      case 'H': heapMonitorDump(true); break;
+      case 'd': heapMonitorForceDegrade(!heapMonitorForced()); break;
+      default: break;
+    }
+  }
+}
+
 // LED functions moved to led_status.cpp (setLed*, updateLedForPrice, ledAnimLoop)
 // WiFi functions moved to app_wifi.cpp (loadWifiCreds, connectWiFiSta, etc.)
 // Time/scheduler functions moved to app_time.cpp & app_scheduler.cpp
@@ -167,9 +248,100 @@ void showWifiSetupRequired(unsigned long splashStartMs, bool enforceSplashDelay
   g_appState = APP_STATE_NEED_WIFI;
 }
 
+// ==================== Startup pipeline (V0.99s) =====================
+// startNormalOperation() used to run TZ detect -> NTP wait (up to 20 s) -> FX
+// -> history -> price strictly in sequence before the first main screen.
+// Now each step waits only for what it actually needs:
+//
+//   SNTP       : configTime() only; syncs on the lwIP task meanwhile
+//   price      : WiFi                          -> first screen (render task)
+//   FX         : price (skipped when the price brought its own rate or a
+//                stored table exists; else fetched before the first screen)
+//   TZ detect  : first screen (fresh devices only; runs while SNTP syncs)
+//   history    : valid clock (ET cycle)        -> chart redraw
+//
+// The first screen is refreshed by the render task while loop() carries on
+// with the stages below, one per pass, so input stays responsive.
+static uint32_t s_startupMs             = 0;  // startNormalOperation() entry
+static bool     s_fastBootShown         = false;  // setup() drew the boot cache
+static bool     s_startupTzPending      = false;
+static bool     s_startupTimePending    = false;
+static bool     s_startupHistoryPending = false;
+
+static void startupPipelinePoll() {
+  if (s_startupTzPending) {
+    s_startupTzPending = false;
+    const int32_t offsetBefore = g_localUtcOffsetSec;
+    autoDetectTimezoneIfNeeded();
+    bootMark("tz");
+    if (g_localUtcOffsetSec != offsetBefore && g_uiMode == UI_MODE_NORMAL) {
+      drawMainScreenTimeOnly(false);
+    }
+    return;
+  }
+
+  if (s_startupTimePending) {
+    if (!setupTimePoll()) return;
+    s_startupTimePending = false;
+    bootMark("time");
+  }
+
+  // History is laid out on the 7pm ET cycle: it needs the real clock. After
+  // NTP FAILED this keeps waiting for a late SNTP sync.
+  if (s_startupHistoryPending && isTimeValidNow()) {
+    s_startupHistoryPending = false;
+    updateEtCycle();
+    // V0.99s: a recent warm restart already brought this cycle's chart and mean
+    if (warmRestartChartFresh(time(nullptr)) && g_chartSampleCount > 0) {
+      LOGI(MAIN, "[Startup] Chart kept from warm restart; history bootstrap skipped");
+    } else {
+      bootstrapHistoryFromKrakenOHLC();
+    }
+
+    if (g_lastPriceOk) {
+      time_t nowUtc = time(nullptr);
+      dayAvgRollingAdd(nowUtc, g_lastPriceUsd);
+      updateAvgLineReference(nowUtc);
+      addChartSampleForNow(g_lastPriceUsd);
+    }
+    LOGI(MAIN, "[Startup] Chart ready %lu ms after start (%d samples, %s)",
+               (unsigned long)(millis() - s_startupMs), g_chartSampleCount,
+               g_currentHistoryApi ? g_currentHistoryApi : "-");
+
+    if (g_uiMode == UI_MODE_NORMAL) {
+      drawMainScreen(g_lastPriceUsd, g_lastChange24h, false);
+    }
+
+    // V0.99s: complete screen data for the next boot's first frame
+    bootCacheSave(true);
+    bootMark("history");
+    bootTimelineDump(false);
+  }
+}
+
+// V0.99s: First frame from the warm restart snapshot or the boot cache (no
+// network). The render task refreshes the panel while setup() goes on to
+// connect WiFi.
+static bool fastBootRender() {
+  if (!warmRestartRestored()) {
+    if (!bootCacheRestore()) return false;
+    if (restoreExchangeRates()) {
+      g_fxValid = true;
+    }
+  }
+  g_priceStale = true;
+  g_uiMode = UI_MODE_NORMAL;
+  drawMainScreen(g_lastPriceUsd, g_lastChange24h, true);
+  renderTaskFlush();  // loop() is not running yet
+  return true;
+}
+
 // ==================== Normal Operation Startup =====================
 
 static void startNormalOperation(bool enforceSplashDelay, uint32_t splashStartMs) {
+  s_startupMs = millis();
+  bootMark("wifi.up");
+
  // Stop portal/AP if it was running
   wifiPortalStop();
   WiFi.mode(WIFI_STA);
@@ -180,49 +352,58 @@ static void startNormalOperation(bool enforceSplashDelay, uint32_t splashStartMs
   g_uiMode = UI_MODE_NORMAL;
   g_appState = APP_STATE_RUNNING;
 
- // V0.97: One-time best-effort timezone auto-detect on fresh devices.
- // This does NOT change the NTP sync logic; it only sets g_localUtcOffsetSec for display.
-  autoDetectTimezoneIfNeeded();
-
-  setupTime();
-
-
- // V0.99f: Fetch FX rates for all currencies (except USD) after WiFi+NTP ready
-  if (g_displayCurrency != (int)CURR_USD && WiFi.status() == WL_CONNECTED) {
-    if (fetchExchangeRates()) {
-      g_fxValid = true;
-      Serial.printf("[FX] Multi-currency rates fetched (display: %s)\n",
-                    CURRENCY_INFO[g_displayCurrency].code);
-    } else {
-      g_fxValid = false;
-      Serial.println("[FX] Multi-currency fetch failed");
-    }
-    g_nextFxUpdateUtc = time(nullptr) + 3600;  // 1 hour (V0.99f: reduced API load)
+ // V0.99s: SNTP syncs in the background while the price is fetched; the
+ // tick scheduler is armed by startupPipelinePoll() once the clock is valid.
+  setupTimeBegin();
+
+ // V0.99s: Start from the last good FX table in NVS: the first screen is
+ // already converted, and loop()'s hourly FX update refreshes it in the
+ // background instead of delaying the first price.
+  // (A warm restart already restored it, with native-quote rates on top.)
+  const bool fxRestored = warmRestartRestored() ? g_fxValid : restoreExchangeRates();
+  if (fxRestored) {
+    g_fxValid = true;
   }
-  updateEtCycle();
-  bootstrapHistoryFromKrakenOHLC();
 
   double price  = 0.0;
   double change = 0.0;
 
   g_lastPriceOk = fetchPrice(price, change);
+  const uint32_t priceMs = millis() - s_startupMs;
+  bootMark("price");
   if (g_lastPriceOk) {
     g_lastPriceUsd  = price;
     g_lastChange24h = change;
-
-    time_t nowUtc = time(nullptr);
-    if (nowUtc > 100000) {
-      dayAvgRollingAdd(nowUtc, price);
-    }
-    updateAvgLineReference(nowUtc);
-
-
-    addChartSampleForNow(price);
-  } else {
+    g_priceStale    = false;
+  } else if (!g_priceStale) {
     g_prevDayRefValid = false;
     g_lastPriceUsd = 0.0f;
     g_lastChange24h = 0.0f;
   }
+  // (A failed fetch after a fast boot keeps the cached screen, still marked.)
+
+ // V0.99f: Fetch FX rates for all currencies (except USD)
+ // V0.99s: Only when the first screen would otherwise have no rate: a native
+ // quote in this price or a stored table defers it to loop().
+  if (g_displayCurrency != (int)CURR_USD) {
+    const bool native = g_lastPriceOk && fxQuotedNatively(time(nullptr));
+    if (fxRestored || native) {
+      g_nextFxUpdateUtc = 0;  // due at the first loop() pass with a valid clock
+      LOGI(MAIN, "[FX] %s (display: %s); FX table refresh in background",
+                 native ? "Native quote" : "Using stored rates", CURRENCY_INFO[g_displayCurrency].code);
+    } else if (WiFi.status() == WL_CONNECTED) {
+      if (fetchExchangeRates()) {
+        g_fxValid = true;
+        LOGI(MAIN, "[FX] Multi-currency rates fetched (display: %s)",
+                   CURRENCY_INFO[g_displayCurrency].code);
+      } else {
+        g_fxValid = false;
+        LOGW(MAIN, "[FX] Multi-currency fetch failed");
+      }
+      g_nextFxUpdateUtc = time(nullptr) + 3600;  // 1 hour (V0.99f: reduced API load)
+      bootMark("fx");
+    }
+  }
 
   updateLedForPrice(g_lastChange24h, g_lastPriceOk);
 
@@ -234,9 +415,20 @@ static void startNormalOperation(bool enforceSplashDelay, uint32_t splashStartMs
     if (elapsed < 3000) delay(3000 - elapsed);
   }
 
-  drawMainScreen(g_lastPriceUsd, g_lastChange24h, true);
+  // V0.99s: after a fast boot the panel was just fully refreshed
+  drawMainScreen(g_lastPriceUsd, g_lastChange24h, !s_fastBootShown);
+  renderTaskMarkBootPhase("first.frame");  // when the panel refresh is done, not now
+
+  LOGI(MAIN, "[Startup] First price %s: %lu ms after start (fetch %lu ms, %s), %lu ms after boot",
+             g_lastPriceOk ? "shown" : "FAILED", (unsigned long)(millis() - s_startupMs),
+             (unsigned long)priceMs, g_currentPriceApi ? g_currentPriceApi : "-", (unsigned long)millis());
+
+ // V0.97: One-time best-effort timezone auto-detect on fresh devices.
+ // This does NOT change the NTP sync logic; it only sets g_localUtcOffsetSec for display.
+  s_startupTzPending      = true;
+  s_startupTimePending    = true;
+  s_startupHistoryPending = true;
 
-  g_partialRefreshCount = 0;
   lastUpdate = millis();
 }
 
@@ -276,7 +468,12 @@ static void enterMaintenanceMode(bool fromBoot, bool drawScreen = true) {
 // : Request maintenance mode via reboot (more stable than switching modes at runtime).
 static void requestMaintenanceModeReboot() {
   Serial.println("[MAINT] Request (reboot into update AP)");
+  renderTaskWaitIdle(5000);  // don't reset in the middle of a panel refresh
+  bootCacheSave(true);       // the boot after the update starts from this screen
+  warmRestartSave();         // ...and with chart, mean, FX and prefetch intact
   maintBootRequest();
+  profileCheckpoint();  // stats survive into the maintenance page
+  appLogFlush(500);
   delay(80);
   ESP.restart();
 }
@@ -295,20 +492,31 @@ static void exitMaintenanceModeToNormal() {
 
 void setup() {
   Serial.begin(115200);
+  bootTimelineBegin();  // V0.99s: marks printed / kept for the maintenance page
   unsigned long start = millis();
   while (!Serial && (millis() - start < 5000)) {
     delay(10);
   }
+  bootMark("serial");
 
   Serial.println();
   Serial.println("=== CryptoBar ===");
   Serial.printf("[Version] %s\n", CRYPTOBAR_VERSION);
+  profileBegin();
+  traceBegin();
+  heapMonitorBegin();
+  heapMonitorWatchTask(xTaskGetCurrentTaskHandle(), getArduinoLoopTaskStackSize());
+  jsonArenaBegin();  // before WiFi/TLS buffers fragment the heap
+#ifdef CRYPTOBAR_API_BASE
+  Serial.printf("[Net] API base override: %s (replay build, not for release)\n", CRYPTOBAR_API_BASE);
+#endif
 
  // OTA safety guard: if a freshly-updated firmware keeps rebooting before it
  // stabilizes, automatically roll back to the previous slot.
   otaGuardBootBegin();
 
   loadSettings();
+  bootMark("settings");
 
  // LEDs (external + onboard)
   ledStatusBegin(NEOPIXEL_PIN, NEOPIXEL_COUNT, BOARD_RGB_PIN, BOARD_RGB_COUNT);
@@ -322,10 +530,46 @@ void setup() {
   SPI.begin(EPD_SCK, -1, EPD_MOSI);
   display.init(115200);
   display.setRotation(1);
+  LOGI(MAIN, "[EPD] Page divisor %d: %u page(s), frame buffer %lu B, shadow %lu B",
+                EPD_PAGE_DIVISOR, (unsigned)EpdDisplay::kPages,
+                (unsigned long)EpdDisplay::kBufferBytes, (unsigned long)EpdDisplay::kShadowBytes);
+
+ // V0.99s: main-screen refreshes run on a render task (core 0) so loop() keeps polling
+ // the encoder / network while the panel is busy.
+  renderTaskBegin(0);
+
+ // V0.99s: fetch / render / loop logs go through a ring drained by an idle-priority
+ // task, so Serial output no longer blocks those paths.
+  appLogBegin(0);
+
+ // V0.99s: full refreshes are scheduled from per-region frame diffs (ghosting budget)
+  refreshSchedulerBegin();
+  bootMark("display");
+
+  const bool maintRequested = maintBootConsumeRequested();
+
+ // Load WiFi credentials from NVS (no more hardcoded defaults)
+  loadWifiCreds();
+
+ // V0.99s: Runtime state from before an intentional restart. The maintenance
+ // boot does not restore it; the boot after it does, unless the snapshot is
+ // from other firmware (an upload discards it) or too old.
+  if (!maintRequested && warmRestartRestore()) {
+    bootMark("warm");
+  }
 
  // ==================== Boot welcome screen =====================
+ // V0.99s: Fast boot: with saved WiFi and a boot cache for this coin, the
+ // first frame is the last price / chart (marked "Cached") instead of the
+ // splash; WiFi, price and history then replace it as they arrive.
+  if (!maintRequested && g_hasWifiCreds && fastBootRender()) {
+    s_fastBootShown = true;
+    bootMark("cached");
+  } else {
  // Show version to user first; screen stays visible while WiFi/NTP connection takes time
-  drawSplashScreen(CRYPTOBAR_VERSION);
+    drawSplashScreen(CRYPTOBAR_VERSION);
+    bootMark("splash");
+  }
   uint32_t splashStartMs = millis();
 
   // Encoder button pin (CLK/DT pins are configured inside encoderPcntBegin)
@@ -336,7 +580,7 @@ void setup() {
   encoderPcntBegin(ENC_CLK_PIN, ENC_DT_PIN);
 
  // : enter maintenance mode via reboot flag (requested from UI).
-  if (maintBootConsumeRequested()) {
+  if (maintRequested) {
     Serial.println("[MAINT] Boot request detected");
     // Show "Starting Update AP..." message with enough display time
     drawFirmwareUpdateApScreen(CRYPTOBAR_VERSION, "Starting Update AP...", "", false);
@@ -357,12 +601,10 @@ void setup() {
 
     // Now draw the final maintenance AP instructions screen
     drawFirmwareUpdateApScreen(CRYPTOBAR_VERSION, maintModeApSsid().c_str(), maintModeApIp().c_str(), false);
+    bootMark("maint.ap");
     return;
   }
 
-// Load WiFi credentials from NVS (no more hardcoded defaults)
-loadWifiCreds();
-
 if (!g_hasWifiCreds) {
   Serial.println("[WiFi] No credentials saved. Waiting for provisioning...");
   showWifiSetupRequired(splashStartMs);
@@ -379,12 +621,15 @@ WiFi.disconnect(true);
 delay(100);
 WiFi.begin(g_wifiSsid.c_str(), g_wifiPass.c_str());
 setLedBlue();
+bootMark("wifi.begin");
 
 // Ensure splash screen displays for full 3 seconds
+// (V0.99s: after a fast boot nothing needs showing; this is only the WiFi wait)
 unsigned long elapsed = millis() - splashStartMs;
 if (elapsed < 3000) {
   uint32_t remaining = 3000 - elapsed;
-  Serial.printf("[Boot] Splash screen: waiting %lums (WiFi connecting in background)\n", (unsigned long)remaining);
+  LOGI(MAIN, "[Boot] %s: waiting %lums (WiFi connecting in background)",
+                s_fastBootShown ? "Cached screen" : "Splash screen", (unsigned long)remaining);
 
   // Poll WiFi status while waiting
   uint32_t checkInterval = 100;
@@ -426,9 +671,10 @@ if (WiFi.status() == WL_CONNECTED) {
 }
 
 // WiFi not connected after 3 seconds, show connecting screen and retry
+// (V0.99s: the cached screen stays up instead; only a final failure replaces it)
 Serial.println("[WiFi] Not connected after splash, showing connection UI...");
 if (!connectWiFiStaWithRetries(g_wifiSsid.c_str(), g_wifiPass.c_str(),
-                              5, 12000, true)) {
+                              5, 12000, !s_fastBootShown)) {
   Serial.println("[WiFi] Failed to connect with saved credentials (all attempts).");
   showWifiSetupRequired(splashStartMs, false);  // Don't enforce splash delay
   return;
@@ -437,7 +683,23 @@ if (!connectWiFiStaWithRetries(g_wifiSsid.c_str(), g_wifiPass.c_str(),
 startNormalOperation(false, splashStartMs);  // No splash delay needed
 }
 
+// Encoder steps applied to a list cursor; computed before the single store, so
+// the index is never out of range in between.
+static int wrapMenuIndex(int idx, int count) {
+  if (count <= 0) return 0;
+  idx %= count;
+  return (idx < 0) ? idx + count : idx;
+}
+
 void loop() {
+  loopStallTrack();
+  heapMonitorPoll();
+  serialCommandPoll();
+
+ // V0.99s: release main-screen redraws requested during the previous pass as one
+ // merged frame (price tick + FX update + clock due in the same second).
+  renderTaskFlush();
+
   unsigned long now = millis();
 
  // V0.99i: Track consecutive identical price updates to detect stale API data
@@ -682,66 +944,28 @@ String apIp = WiFi.softAPIP().toString();
 
   if (steps != 0) {
     if (g_uiMode == UI_MODE_MENU) {
-      g_menuIndex += steps;
-      while (g_menuIndex < 0) g_menuIndex += MENU_COUNT;
-      while (g_menuIndex >= MENU_COUNT) g_menuIndex -= MENU_COUNT;
+      g_menuIndex = wrapMenuIndex(g_menuIndex + steps, MENU_COUNT);
       ensureMainMenuVisible();
-      g_menuDirty = true;
     } else if (g_uiMode == UI_MODE_TZ_SUB) {
-      g_tzMenuIndex += steps;
-      while (g_tzMenuIndex < 0) g_tzMenuIndex += TIMEZONE_COUNT;
-      while (g_tzMenuIndex >= TIMEZONE_COUNT) g_tzMenuIndex -= TIMEZONE_COUNT;
+      g_tzMenuIndex = wrapMenuIndex(g_tzMenuIndex + steps, TIMEZONE_COUNT);
       ensureTzMenuVisible();
-      g_tzDirty = true;
     } else if (g_uiMode == UI_MODE_COIN_SUB) {
-      g_coinMenuIndex += steps;
-      int n = coinCount();
-      while (g_coinMenuIndex < 0) g_coinMenuIndex += n;
-      while (g_coinMenuIndex >= n) g_coinMenuIndex -= n;
+      g_coinMenuIndex = wrapMenuIndex(g_coinMenuIndex + steps, coinCount());
       ensureCoinMenuVisible();
-      g_coinDirty = true;
     } else if (g_uiMode == UI_MODE_CURRENCY_SUB) {
-      g_currencyMenuIndex += steps;
-      while (g_currencyMenuIndex < 0) g_currencyMenuIndex += (int)CURR_COUNT;
-      while (g_currencyMenuIndex >= (int)CURR_COUNT) g_currencyMenuIndex -= (int)CURR_COUNT;
+      g_currencyMenuIndex = wrapMenuIndex(g_currencyMenuIndex + steps, (int)CURR_COUNT);
       ensureCurrencyMenuVisible();
-      g_currencyDirty = true;
     } else if (g_uiMode == UI_MODE_UPDATE_SUB) {
       // V0.99r: Handle update interval submenu navigation
-      g_updateMenuIndex += steps;
-      while (g_updateMenuIndex < 0) g_updateMenuIndex += UPDATE_PRESETS_COUNT;
-      while (g_updateMenuIndex >= UPDATE_PRESETS_COUNT) g_updateMenuIndex -= UPDATE_PRESETS_COUNT;
+      g_updateMenuIndex = wrapMenuIndex(g_updateMenuIndex + steps, UPDATE_PRESETS_COUNT);
       ensureUpdateMenuVisible();
-      g_updateDirty = true;
     }
-  }
 
- // ===== throttle menu redraw =====
-  uint32_t ms = millis();
-  if (ms - g_lastUiDrawMs >= UI_DRAW_MIN_MS) {
-    if (g_uiMode == UI_MODE_MENU && g_menuDirty) {
-      drawMenuScreen(false);
-      g_menuDirty = false;
-      g_lastUiDrawMs = ms;
-    } else if (g_uiMode == UI_MODE_TZ_SUB && g_tzDirty) {
-      drawTimezoneMenu(false);
-      g_tzDirty = false;
-      g_lastUiDrawMs = ms;
-    } else if (g_uiMode == UI_MODE_COIN_SUB && g_coinDirty) {
-      drawCoinMenu(false);
-      g_coinDirty = false;
-      g_lastUiDrawMs = ms;
-    } else if (g_uiMode == UI_MODE_CURRENCY_SUB && g_currencyDirty) {
-      drawCurrencyMenu(false);
-      g_currencyDirty = false;
-      g_lastUiDrawMs = ms;
-    } else if (g_uiMode == UI_MODE_UPDATE_SUB && g_updateDirty) {
-      // V0.99r: Handle update interval submenu redraw
-      drawUpdateMenu(false);
-      g_updateDirty = false;
-      g_lastUiDrawMs = ms;
-    }
+ // V0.99s: no throttling; the render queue keeps only the latest cursor position
+ // and abandons an in-progress menu frame when a newer one is queued.
+    renderTaskSubmitInput(g_uiMode, false);
   }
+
  // ==================== Runtime WiFi drop handling (V0.97) ====================
  // If WiFi drops during normal use, DO NOT auto-start AP.
  // We retry STA in small batches with a backoff. AP can be started manually via long-press while offline.
@@ -749,7 +973,7 @@ String apIp = WiFi.softAPIP().toString();
  // If somehow we never had a successful connection (e.g., boot edge-case), keep the original behavior.
     if (!g_wifiEverConnected) {
       if (!connectWiFiStaWithRetries(g_wifiSsid.c_str(), g_wifiPass.c_str(), 5, 12000, true)) {
-        Serial.println("[WiFi] Failed to connect with saved credentials (all attempts).");
+        LOGW(MAIN, "[WiFi] Failed to connect with saved credentials (all attempts).");
         showWifiSetupRequired(0, false);
         return;
       }
@@ -762,16 +986,16 @@ String apIp = WiFi.softAPIP().toString();
           String label = String(g_wifiSsid) + " (reconnect)";
           drawWifiConnectingScreen(CRYPTOBAR_VERSION, label.c_str(), false);  // Partial refresh
         }
-        Serial.printf("[WiFi] Runtime reconnect batch %u (attempts=%u, timeout=%lums)\n",
-                      (unsigned)g_runtimeReconnectBatch + 1, (unsigned)RUNTIME_RECONNECT_ATTEMPTS,
-                      (unsigned long)RUNTIME_RECONNECT_TIMEOUT_MS);
+        LOGI(MAIN, "[WiFi] Runtime reconnect batch %u (attempts=%u, timeout=%lums)",
+                   (unsigned)g_runtimeReconnectBatch + 1, (unsigned)RUNTIME_RECONNECT_ATTEMPTS,
+                   (unsigned long)RUNTIME_RECONNECT_TIMEOUT_MS);
         bool ok = connectWiFiStaWithRetries(g_wifiSsid.c_str(), g_wifiPass.c_str(),
                                            RUNTIME_RECONNECT_ATTEMPTS, RUNTIME_RECONNECT_TIMEOUT_MS, showUi);
         if (!ok) {
           g_runtimeReconnectBatch++;
           g_nextRuntimeReconnectMs = nowMs + RUNTIME_RECONNECT_BACKOFF_MS;
-          Serial.printf("[WiFi] Runtime reconnect failed. Next retry in %lus (no AP auto-start).\n",
-                      (unsigned long)(RUNTIME_RECONNECT_BACKOFF_MS / 1000UL));
+          LOGW(MAIN, "[WiFi] Runtime reconnect failed. Next retry in %lus (no AP auto-start).",
+                     (unsigned long)(RUNTIME_RECONNECT_BACKOFF_MS / 1000UL));
           if (showUi) {
             setLedRed();
             String label = String("Offline, retry in ") + String(RUNTIME_RECONNECT_BACKOFF_MS / 1000UL) + "s";
@@ -792,6 +1016,9 @@ String apIp = WiFi.softAPIP().toString();
     }
   }
 
+ // V0.99s: startup stages still waiting for their inputs (TZ, clock, history)
+  startupPipelinePoll();
+
  // ===== periodic updates (tick-aligned once time is valid) =====
   uint32_t intervalSec = updateIntervalSec();
   time_t nowUtc = time(nullptr);
@@ -809,11 +1036,11 @@ String apIp = WiFi.softAPIP().toString();
       time_t localSec = (time_t)utc + g_localUtcOffsetSec;
       struct tm local;
       if (gmtime_r(&localSec, &local)) {
-        Serial.printf("[Time][SNTP] Sync event: %02d:%02d  %02d/%02d/%04d\n",
-                      local.tm_hour, local.tm_min,
-                      local.tm_mon + 1, local.tm_mday, local.tm_year + 1900);
+        LOGI(MAIN, "[Time][SNTP] Sync event: %02d:%02d  %02d/%02d/%04d",
+                   local.tm_hour, local.tm_min,
+                   local.tm_mon + 1, local.tm_mday, local.tm_year + 1900);
       } else {
-        Serial.printf("[Time][SNTP] Sync event: utc=%lld\n", (long long)utc);
+        LOGI(MAIN, "[Time][SNTP] Sync event: utc=%lld", (long long)utc);
       }
  // Re-align update ticks after time correction so multiple stacked units stay in phase.
       tickSchedulerReset("SNTP");
@@ -841,20 +1068,22 @@ String apIp = WiFi.softAPIP().toString();
     if (!g_prefetchValid && nowUtc >= prefetchAtUtc && nowUtc < g_nextUpdateUtc && WiFi.status() == WL_CONNECTED) {
       double p = 0.0;
       double c = 0.0;
-      Serial.printf("[Prefetch] Tick=%ld (in %ld s) prefetchAt=%ld (lead=%lu)\n",
-                    (long)g_nextUpdateUtc,
-                    (long)(g_nextUpdateUtc - nowUtc),
-                    (long)prefetchAtUtc,
-                    (unsigned long)((g_nextUpdateUtc > prefetchAtUtc) ? (g_nextUpdateUtc - prefetchAtUtc) : 0));
+      LOGI(MAIN, "[Prefetch] Tick=%ld (in %ld s) prefetchAt=%ld (lead=%lu)",
+                 (long)g_nextUpdateUtc,
+                 (long)(g_nextUpdateUtc - nowUtc),
+                 (long)prefetchAtUtc,
+                 (unsigned long)((g_nextUpdateUtc > prefetchAtUtc) ? (g_nextUpdateUtc - prefetchAtUtc) : 0));
+      traceBeginEvent(TRACE_PREFETCH);
       bool ok = fetchPrice(p, c);
+      traceEndEvent(TRACE_PREFETCH, ok ? 1 : 0);
       if (ok) {
         g_prefetchPrice = p;
         g_prefetchChange = c;
         g_prefetchForUtc = g_nextUpdateUtc;
         g_prefetchValid = true;
-        Serial.println("[Prefetch] OK");
+        LOGI(MAIN, "[Prefetch] OK");
       } else {
-        Serial.println("[Prefetch] FAILED");
+        LOGW(MAIN, "[Prefetch] FAILED");
       }
     }
   }
@@ -879,14 +1108,22 @@ String apIp = WiFi.softAPIP().toString();
   // V0.99f: Update FX rates hourly for all non-USD currencies
   if (!doUpdate && g_timeValid && WiFi.status() == WL_CONNECTED && g_displayCurrency != (int)CURR_USD) {
     time_t nowFxUtc = time(nullptr);
-    if (g_nextFxUpdateUtc == 0 || nowFxUtc >= g_nextFxUpdateUtc) {
+    if ((g_nextFxUpdateUtc == 0 || nowFxUtc >= g_nextFxUpdateUtc) && fxQuotedNatively(nowFxUtc)) {
+      // V0.99s: the price already carries the display-currency rate
+      LOGD(MAIN, "[FX] Native quote current; FX request skipped");
+      g_nextFxUpdateUtc = nowFxUtc + 3600;
+    } else if (g_nextFxUpdateUtc == 0 || nowFxUtc >= g_nextFxUpdateUtc) {
       if (fetchExchangeRates()) {
         g_fxValid = true;
-        Serial.printf("[FX] Multi-currency rates updated (display: %s, rate: %.4f)\n",
-                      CURRENCY_INFO[g_displayCurrency].code, g_usdToRate[g_displayCurrency]);
+        LOGI(MAIN, "[FX] Multi-currency rates updated (display: %s, rate: %.4f)",
+                   CURRENCY_INFO[g_displayCurrency].code, g_usdToRate[g_displayCurrency]);
+        // V0.99s: show the new rate (merged with a clock refresh due in this pass)
+        if (g_uiMode == UI_MODE_NORMAL && g_lastPriceUsd > 0.0) {
+          drawMainScreen(g_lastPriceUsd, g_lastChange24h, false);
+        }
       } else {
         g_fxValid = false;
-        Serial.println("[FX] Multi-currency update failed");
+        LOGW(MAIN, "[FX] Multi-currency update failed");
       }
       g_nextFxUpdateUtc = nowFxUtc + 3600; // 1 hour (V0.99f: reduced API load)
     }
@@ -895,19 +1132,19 @@ String apIp = WiFi.softAPIP().toString();
  // ===== V0.99q: Independent time refresh (coordinated with price refresh) =====
  // Refresh time display every minute, but only when price refresh is NOT scheduled
  // This prevents duplicate refreshes at the same timestamp
- // Time refreshes do NOT count toward the partial refresh limit
+ // V0.99s: The refresh scheduler may promote this frame to a full refresh
   if (!doUpdate && nowUtc >= TIME_VALID_MIN_UTC && g_timeRefreshEnabled && g_uiMode == UI_MODE_NORMAL) {
     // Initialize time refresh schedule (align to next minute boundary)
     if (g_nextTimeRefreshUtc == 0) {
       g_nextTimeRefreshUtc = (nowUtc / 60 + 1) * 60;
-      Serial.printf("[Time] Time refresh scheduled at next minute: %ld\n", (long)g_nextTimeRefreshUtc);
+      LOGI(MAIN, "[Time] Time refresh scheduled at next minute: %ld", (long)g_nextTimeRefreshUtc);
     }
 
     // Check if it's time for a time-only refresh
     // Only execute if doUpdate=false (no price refresh scheduled)
     if (nowUtc >= g_nextTimeRefreshUtc) {
-      Serial.printf("[Time] Time-only refresh (UTC: %ld, next price: %ld)\n",
-                    (long)nowUtc, (long)g_nextUpdateUtc);
+      LOGI(MAIN, "[Time] Time-only refresh (UTC: %ld, next price: %ld)",
+                 (long)nowUtc, (long)g_nextUpdateUtc);
 
       // Perform time-only partial refresh (full-area, only time changes)
       drawMainScreenTimeOnly(false);
@@ -915,8 +1152,8 @@ String apIp = WiFi.softAPIP().toString();
       // Schedule next time refresh (next minute boundary)
       g_nextTimeRefreshUtc = (nowUtc / 60 + 1) * 60;
 
-      // Note: Do NOT increment g_partialRefreshCount
-      // Time refreshes are independent and don't count toward the limit
+      // V0.99s: Clock changes are counted by the refresh scheduler's frame diffs
+      // (small area, so they only slowly add to the ghosting budget)
     }
   }
 
@@ -952,7 +1189,7 @@ if (doUpdate) {
       ok = true;
       g_prefetchValid = false;
       g_prefetchForUtc = 0;
-      Serial.println("[Prefetch] Using cached result for tick");
+      LOGI(MAIN, "[Prefetch] Using cached result for tick");
     } else {
       ok = fetchPrice(price, change);
     }
@@ -965,16 +1202,16 @@ if (doUpdate) {
 
       if (s_lastFetchedPrice > 0.0 && fabs(price - s_lastFetchedPrice) < PRICE_EPSILON) {
         s_duplicatePriceCount++;
-        Serial.printf("[Price] Duplicate #%d: $%.6f (no change)\n", s_duplicatePriceCount, price);
+        LOGI(MAIN, "[Price] Duplicate #%d: $%.6f (no change)", s_duplicatePriceCount, price);
 
         // Warning: if price hasn't changed for 3+ consecutive updates, API might be stale
         if (s_duplicatePriceCount == 3) {
-          Serial.println("[Price] WARNING: Price unchanged for 3 updates - possible stale API data");
+          LOGW(MAIN, "[Price] WARNING: Price unchanged for 3 updates - possible stale API data");
         }
       } else {
         if (s_duplicatePriceCount > 0) {
-          Serial.printf("[Price] CHANGED after %d duplicates: $%.6f -> $%.6f\n",
-                        s_duplicatePriceCount, s_lastFetchedPrice, price);
+          LOGI(MAIN, "[Price] CHANGED after %d duplicates: $%.6f -> $%.6f",
+                     s_duplicatePriceCount, s_lastFetchedPrice, price);
         }
         s_duplicatePriceCount = 0;
       }
@@ -982,6 +1219,7 @@ if (doUpdate) {
 
       g_lastPriceUsd  = price;
       g_lastChange24h = change;
+      g_priceStale    = false;
       if (nowUtc >= TIME_VALID_MIN_UTC) {
         dayAvgRollingAdd(nowUtc, price);
       }
@@ -989,26 +1227,13 @@ if (doUpdate) {
 
       addChartSampleForNow(price);
       updateLedForPrice(g_lastChange24h, g_lastPriceOk);
+      bootCacheSave(false);  // V0.99s: rate-limited (BOOT_CACHE_SAVE_INTERVAL_MS)
 
       if (g_uiMode == UI_MODE_NORMAL) {
- // Refresh mode rules:
- // - Partial mode: accumulate partials, full refresh after PARTIAL_REFRESH_LIMIT
- // - Full mode: always do full refresh on main screen
-        bool doFull = false;
-        if (g_refreshMode == 1) {
-          doFull = true;
-        } else {
-          doFull = (g_partialRefreshCount >= PARTIAL_REFRESH_LIMIT);
-        }
-
-        drawMainScreen(g_lastPriceUsd, g_lastChange24h, doFull);
-
-        if (g_refreshMode == 0) {
-          if (doFull) g_partialRefreshCount = 0;
-          else        g_partialRefreshCount++;
-        } else {
-          g_partialRefreshCount = 0;
-        }
+ // V0.99s: Refresh mode only selects the ghosting budget (Full = strict, Partial = relaxed);
+ // the refresh scheduler promotes a tick to a full refresh when the budget is used up,
+ // after the ET cycle rollover, or after PARTIAL_REFRESH_LIMIT partials.
+        drawMainScreen(g_lastPriceUsd, g_lastChange24h, false);
 
  // V0.99q: Reset time refresh schedule after price update
  // (since time was also updated with the price)
@@ -1033,7 +1258,7 @@ if (doUpdate) {
         ntpResyncReset("SCHED");
       } else {
  // If offline, keep trying (do not advance schedule) so it re-syncs immediately once WiFi returns.
-        Serial.println("[Time][SNTP] Resync due, but WiFi is offline.");
+        LOGI(MAIN, "[Time][SNTP] Resync due, but WiFi is offline.");
  // Backoff to avoid spamming the serial log; retry soon.
         g_nextNtpResyncUtc = now2 + 30;
       }
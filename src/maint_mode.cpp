@@ -2,6 +2,13 @@
 #include "maint_mode.h"
 
 #include "ota_guard.h"
+#include "net_capture.h"
+#include "profile.h"
+#include "boot_timeline.h"
+#include "trace.h"
+#include "heap_monitor.h"
+#include "json_arena.h"
+#include "warm_restart.h"
 
 #include <WiFi.h>
 #include <WebServer.h>
@@ -144,6 +151,96 @@ static String macTail4() {
   return String(buf);
 }
 
+// V0.99s: Profiling zones (us) for one boot: n / mean / p50 / p90 / p99 / max.
+static void appendProfileTable(String& html, const char* title, bool previous) {
+  static ProfileZoneStats zones[PROFILE_MAX_ZONES];  // server runs on the loop task only
+  uint32_t uptimeMs = millis();
+  const uint8_t n = previous ? profilePrevious(zones, PROFILE_MAX_ZONES, &uptimeMs)
+                             : profileSnapshot(zones, PROFILE_MAX_ZONES);
+
+  html += "<h2>";
+  html += title;
+  html += "</h2>";
+  if (n == 0) {
+    html += "<div class='sub'>No data.</div>";
+    return;
+  }
+  html += "<div class='sub'>" + htmlEscape(fmtUptime(uptimeMs)) + " of uptime, times in &micro;s (percentiles rounded up to a power of two)</div>";
+  html += "<table class='prof'><tr><th>Zone</th><th>n</th><th>mean</th><th>p50</th><th>p90</th><th>p99</th><th>max</th></tr>";
+  for (uint8_t i = 0; i < n; i++) {
+    const ProfileZoneStats& z = zones[i];
+    const uint32_t mean = z.count ? (uint32_t)(z.totalUs / z.count) : 0;
+    html += "<tr><td>" + htmlEscape(String(z.name)) + "</td><td>" + String(z.count) + "</td><td>" + String(mean) +
+            "</td><td>" + String(profilePercentileUs(z, 50)) + "</td><td>" + String(profilePercentileUs(z, 90)) +
+            "</td><td>" + String(profilePercentileUs(z, 99)) + "</td><td>" + String(z.maxUs) + "</td></tr>";
+  }
+  html += "</table>";
+}
+
+// V0.99s: Boot phases for one boot (ms since reset; step = time since the previous phase).
+static void appendBootTable(String& html, const char* title, bool previous) {
+  BootPhaseMark marks[BOOT_TIMELINE_MAX];
+  const uint8_t n = bootTimelineGet(marks, BOOT_TIMELINE_MAX, previous);
+
+  html += "<h2>";
+  html += title;
+  html += "</h2>";
+  if (n == 0) {
+    html += "<div class='sub'>No data.</div>";
+    return;
+  }
+  html += "<div class='sub'>Milliseconds since reset</div>";
+  html += "<table class='prof'><tr><th>Phase</th><th>at</th><th>step</th></tr>";
+  for (uint8_t i = 0; i < n; i++) {
+    const uint32_t step = i ? marks[i].ms - marks[i - 1].ms : marks[i].ms;
+    html += "<tr><td>" + htmlEscape(String(marks[i].name)) + "</td><td>" + String(marks[i].ms) + "</td><td>" +
+            String(step) + "</td></tr>";
+  }
+  html += "</table>";
+}
+
+// V0.99s: Per-task stack high-water marks (this boot).
+static void appendStackTable(String& html) {
+  HeapTaskStack tasks[HEAP_MAX_TASKS];
+  const uint8_t n = heapMonitorTasks(tasks, HEAP_MAX_TASKS);
+  html += "<h2>Task stacks</h2>";
+  if (n == 0) {
+    html += "<div class='sub'>No data.</div>";
+    return;
+  }
+  html += "<div class='sub'>Lowest free stack since boot (high-water mark)</div>";
+  html += "<table class='prof'><tr><th>Task</th><th>stack</th><th>min free</th><th>peak use</th></tr>";
+  for (uint8_t i = 0; i < n; i++) {
+    const HeapTaskStack& t = tasks[i];
+    const uint32_t usedPct = t.stackBytes ? 100 - (uint32_t)((uint64_t)t.minFreeBytes * 100 / t.stackBytes) : 0;
+    html += "<tr><td>" + htmlEscape(String(t.name)) + "</td><td>" + fmtBytes(t.stackBytes) + "</td><td>" +
+            fmtBytes(t.minFreeBytes) + "</td><td>" + String(usedPct) + "%</td></tr>";
+  }
+  html += "</table>";
+}
+
+// V0.99s: Heap trend for one boot, one row per minute (newest first).
+static void appendHeapTrendTable(String& html, const char* title, bool previous) {
+  static HeapTrendPoint points[HEAP_TREND_MINUTES];  // server runs on the loop task only
+  const uint8_t n = heapMonitorTrend(points, HEAP_TREND_MINUTES, previous);
+
+  html += "<h2>";
+  html += title;
+  html += "</h2>";
+  if (n == 0) {
+    html += "<div class='sub'>No data.</div>";
+    return;
+  }
+  html += "<div class='sub'>KB, lowest value in each minute</div>";
+  html += "<table class='prof'><tr><th>Minute</th><th>free</th><th>largest</th><th>min ever</th><th>degrade</th></tr>";
+  for (int i = n - 1; i >= 0; i--) {
+    const HeapTrendPoint& p = points[i];
+    html += "<tr><td>" + String(i - (int)n) + "</td><td>" + String(p.freeKb) + "</td><td>" + String(p.largestKb) +
+            "</td><td>" + String(p.minEverKb) + "</td><td>" + (p.degraded ? "yes" : "-") + "</td></tr>";
+  }
+  html += "</table>";
+}
+
 static void handleRoot() {
   const esp_partition_t* running = esp_ota_get_running_partition();
   const esp_partition_t* boot    = esp_ota_get_boot_partition();
@@ -161,14 +258,37 @@ static void handleRoot() {
   const String mac     = WiFi.softAPmacAddress();
   const String heap    = fmtBytes((uint32_t)ESP.getFreeHeap());
   const String heapMin = fmtBytes((uint32_t)ESP.getMinFreeHeap());
+  heapMonitorPoll(true);
+  const HeapSample hs = heapMonitorLast();
+  const String heapLargest = fmtBytes(hs.largestBlock) + " (" + String(hs.fragPct) + "% fragmented)";
+  String degradeStr = heapMonitorDegraded() ? (heapMonitorForced() ? "ON (forced)" : "ON") : "Off";
+  degradeStr += " / " + String(heapMonitorDegradeEntries()) + " entries this boot";
+  JsonArenaStats arena;
+  jsonArenaGetStats(arena);
+  String arenaStr = "Unavailable (documents use the heap)";
+  if (arena.capacity > 0) {
+    arenaStr = fmtBytes(arena.capacity) + ", peak " + fmtBytes(arena.highWater) + " / " +
+               String(arena.heapFallbacks) + " heap fallbacks";
+  }
   const String flashSz = fmtBytes((uint32_t)ESP.getFlashChipSize());
   const uint32_t flashMhz = ESP.getFlashChipSpeed() / 1000000UL;
   const String rst = String(resetReasonStr(esp_reset_reason()));
   const String runningLabel = otaLabel(running);
   const String bootLabel    = otaLabel(boot);
 
+  NetCaptureInfo cap;
+  netCaptureInfo(cap);
+  String capStr;
+  if (!cap.available) {
+    capStr = "Unavailable (no spiffs partition)";
+  } else {
+    capStr = String(cap.enabled ? "ON" : "Off") + " / " + String(cap.records) + " of " + String(cap.slots) +
+             " slots, " + fmtBytes(cap.exportBytes);
+    if (cap.writeErrors > 0) capStr += " / " + String(cap.writeErrors) + " write errors";
+  }
+
   String html;
-  html.reserve(2200);
+  html.reserve(3000 + 2 * 160 * PROFILE_MAX_ZONES + 2 * 110 * HEAP_TREND_MINUTES + 2 * 60 * BOOT_TIMELINE_MAX);
   html += "<!doctype html><html><head><meta charset='utf-8'>";
   html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
   html += "<title>CryptoBar Maintenance</title>";
@@ -184,6 +304,9 @@ static void handleRoot() {
   html += ".pill{display:inline-block;background:#eef2ff;color:#3730a3;border-radius:999px;padding:2px 10px;font-size:12px;margin-left:6px;}";
   html += "a.btn{display:inline-block;margin-top:10px;margin-right:8px;padding:10px 12px;border-radius:12px;border:1px solid #e5e7eb;text-decoration:none;color:#111827;background:#fff;}";
   html += "a.btn.primary{background:#111827;color:#fff;border-color:#111827;}";
+  html += "h2{font-size:15px;margin:18px 0 2px 0;}";
+  html += "table.prof{font-size:12px;} table.prof th{text-align:right;color:#6b7280;font-weight:600;padding:4px 6px;}";
+  html += "table.prof td{text-align:right;padding:4px 6px;font-variant-numeric:tabular-nums;} table.prof td:first-child,table.prof th:first-child{text-align:left;}";
   html += "</style></head><body>";
 
   html += "<div class='card'>";
@@ -200,14 +323,35 @@ static void handleRoot() {
   html += "<tr><td class='k'>Maintenance IP</td><td class='v'>" + htmlEscape(apIp) + "</td></tr>";
   html += "<tr><td class='k'>MAC (AP)</td><td class='v'>" + htmlEscape(mac) + "</td></tr>";
   html += "<tr><td class='k'>Free heap</td><td class='v'>" + htmlEscape(heap) + " (min " + htmlEscape(heapMin) + ")</td></tr>";
+  html += "<tr><td class='k'>Largest free block</td><td class='v'>" + htmlEscape(heapLargest) + "</td></tr>";
+  html += "<tr><td class='k'>Low-memory mode</td><td class='v'>" + htmlEscape(degradeStr) + "</td></tr>";
+  html += "<tr><td class='k'>JSON arena</td><td class='v'>" + htmlEscape(arenaStr) + "</td></tr>";
   html += "<tr><td class='k'>Flash</td><td class='v'>" + htmlEscape(flashSz) + " @ " + String(flashMhz) + " MHz</td></tr>";
   html += "<tr><td class='k'>OTA slot</td><td class='v'>running: <b>" + htmlEscape(runningLabel) + "</b> / boot: <b>" + htmlEscape(bootLabel) + "</b></td></tr>";
  // OTA safety guard is our pragmatic rollback layer (NVS-based) that reduces the risk of getting
  // stuck after flashing a bad image. (Full ESP-IDF rollback can be added later if desired.)
   html += "<tr><td class='k'>OTA safety guard</td><td class='v'>Enabled (2 failed boots on new slot → rollback).</td></tr>";
+  html += "<tr><td class='k'>Response capture</td><td class='v'>" + htmlEscape(capStr) + "</td></tr>";
   html += "</table>";
   html += "<a class='btn primary' href='/update'>Update firmware</a>";
   html += "<a class='btn' href='/exit'>Exit (return to normal)</a><a class='btn' href='/reboot'>Reboot</a>";
+  if (cap.available) {
+    html += "<br>";
+    html += cap.enabled ? "<a class='btn' href='/capture/off'>Stop capture</a>"
+                        : "<a class='btn' href='/capture/on'>Start capture</a>";
+    if (cap.records > 0) {
+      html += "<a class='btn' href='/capture/download'>Download capture</a>";
+      html += "<a class='btn' href='/capture/clear'>Clear capture</a>";
+    }
+  }
+  html += "<br><a class='btn' href='/trace.json'>Download event trace</a>";
+  appendBootTable(html, "Boot timeline: previous boot", true);
+  appendBootTable(html, "Boot timeline: this boot", false);
+  appendProfileTable(html, "Profile: previous boot", true);
+  appendProfileTable(html, "Profile: this boot", false);
+  appendStackTable(html);
+  appendHeapTrendTable(html, "Heap: previous boot", true);
+  appendHeapTrendTable(html, "Heap: this boot", false);
   html += "</div></body></html>";
 
   s_server.send(200, "text/html; charset=utf-8", html);
@@ -368,6 +512,8 @@ static void handleUpdateUpload() {
       if (prevLabel.length() > 0 && newLabel.length() > 0) {
         otaGuardSetPending(prevLabel, newLabel);
       }
+ // V0.99s: the new image starts from the network, not from this build's state.
+      warmRestartDiscard();
     } else {
       if (s_lastUpdateMsg.length() == 0) {
         s_lastUpdateMsg = String("Update.end failed: ") + String(Update.errorString());
@@ -394,6 +540,60 @@ static void handleReboot() {
   scheduleReboot(300);
 }
 
+// ==================== Response capture =====================
+
+static void redirectHome() {
+  s_server.sendHeader("Location", "/");
+  s_server.send(303, "text/plain", "");
+}
+
+static void handleCaptureOn() {
+  netCaptureSetEnabled(true);
+  redirectHome();
+}
+
+static void handleCaptureOff() {
+  netCaptureSetEnabled(false);
+  redirectHome();
+}
+
+static void handleCaptureClear() {
+  netCaptureClear();
+  redirectHome();
+}
+
+static bool contentSink(const uint8_t* data, size_t len, void* ctx) {
+  (void)ctx;
+  s_server.sendContent((const char*)data, len);
+  return s_server.client().connected();
+}
+
+// Raw .cbcap records (oldest first); serve with host/replay/replay_server --capture.
+static void handleCaptureDownload() {
+  NetCaptureInfo cap;
+  if (!netCaptureInfo(cap) || cap.records == 0) {
+    s_server.send(404, "text/plain", "No capture records\n");
+    return;
+  }
+
+  s_server.sendHeader("Content-Disposition", "attachment; filename=\"cryptobar_capture.cbcap\"");
+  s_server.setContentLength(cap.exportBytes);
+  s_server.send(200, "application/octet-stream", "");
+  size_t sent = netCaptureExport(contentSink, nullptr);
+  Serial.printf("[MAINT] Capture download: %u/%lu bytes, %u records\n",
+                (unsigned)sent, (unsigned long)cap.exportBytes, (unsigned)cap.records);
+}
+
+// Chrome Trace Event JSON of the event ring (chrome://tracing, ui.perfetto.dev).
+static void handleTraceJson() {
+  s_server.sendHeader("Content-Disposition", "attachment; filename=\"cryptobar_trace.json\"");
+  s_server.setContentLength(CONTENT_LENGTH_UNKNOWN);  // chunked
+  s_server.send(200, "application/json", "");
+  size_t sent = traceExport(contentSink, nullptr);
+  s_server.sendContent("");
+  Serial.printf("[MAINT] Trace download: %u bytes\n", (unsigned)sent);
+}
+
 static void handleNotFound() {
   s_server.send(404, "text/plain", "Not found");
 }
@@ -426,6 +626,11 @@ void maintModeEnter(const char* version) {
   s_server.on("/update", HTTP_POST, handleUpdatePostDone, handleUpdateUpload);
   s_server.on("/exit", handleExit);
   s_server.on("/reboot", handleReboot);
+  s_server.on("/capture/on", handleCaptureOn);
+  s_server.on("/capture/off", handleCaptureOff);
+  s_server.on("/capture/clear", handleCaptureClear);
+  s_server.on("/capture/download", HTTP_GET, handleCaptureDownload);
+  s_server.on("/trace.json", HTTP_GET, handleTraceJson);
  // Common OS captive portal paths (keeps Serial log clean)
   s_server.on("/favicon.ico", handleNoContent);
   s_server.on("/generate_204", handleNoContent);
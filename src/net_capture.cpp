@@ -0,0 +1,256 @@
+// CryptoBar V0.99s (Provider response capture)
+// net_capture.cpp - Opt-in flash ring of raw API responses (see net_capture.h)
+#include "net_capture.h"
+
+#if NET_CAPTURE_ENABLE
+
+#include <Preferences.h>
+#include <esp_partition.h>
+#include <rom/crc.h>
+#include <time.h>
+#include "app_log.h"
+
+static_assert(sizeof(NetCaptureHeader) == 44, "NetCaptureHeader must stay 44 bytes (file format)");
+
+// NVS namespace + keys
+static const char* kNs  = "net_capture";
+static const char* kKey = "on"; // bool
+
+static const char*    kPartLabel  = "spiffs";
+static const uint32_t kSectorSize = 4096;
+
+static const esp_partition_t* s_part = nullptr;
+static bool     s_init        = false;
+static bool     s_enabled     = false;
+static uint16_t s_slots       = 0;
+static uint16_t s_nextSlot    = 0;   // slot the next record goes into (= oldest)
+static uint32_t s_nextSeq     = 1;
+static uint32_t s_writeErrors = 0;
+
+// ==================== Ring helpers =====================
+
+static uint32_t slotOffset(uint16_t slot) {
+  return (uint32_t)slot * NET_CAPTURE_SLOT_SIZE;
+}
+
+static bool headerValid(const NetCaptureHeader& h) {
+  if (h.magic != NET_CAPTURE_MAGIC) return false;
+  if (h.urlLen == 0) return false;
+  return (uint32_t)sizeof(h) + h.urlLen + h.bodyLen <= NET_CAPTURE_SLOT_SIZE;
+}
+
+static bool readHeader(uint16_t slot, NetCaptureHeader& h) {
+  if (esp_partition_read(s_part, slotOffset(slot), &h, sizeof(h)) != ESP_OK) return false;
+  return headerValid(h);
+}
+
+// Lazy: finds the partition, loads the setting and scans the slot headers
+// (37 x 44-byte reads on the 8 MB layout) to resume after the newest record.
+static void ensureInit() {
+  if (s_init) return;
+  s_init = true;
+
+  Preferences pref;
+  if (pref.begin(kNs, true)) {
+    s_enabled = pref.getBool(kKey, false);
+    pref.end();
+  }
+
+  s_part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, kPartLabel);
+  if (!s_part) {
+    LOGW(NET, "[Capture] No spiffs partition; capture unavailable.");
+    return;
+  }
+  s_slots = (uint16_t)(s_part->size / NET_CAPTURE_SLOT_SIZE);
+  if (s_slots == 0) {
+    s_part = nullptr;
+    return;
+  }
+
+  uint32_t newestSeq = 0;
+  for (uint16_t i = 0; i < s_slots; i++) {
+    NetCaptureHeader h;
+    if (readHeader(i, h) && h.seq >= newestSeq) {
+      newestSeq  = h.seq;
+      s_nextSlot = (uint16_t)((i + 1) % s_slots);
+    }
+  }
+  s_nextSeq = newestSeq + 1;
+
+  LOGI(NET, "[Capture] %u slots on '%s', next seq %lu, capture %s",
+                (unsigned)s_slots, kPartLabel, (unsigned long)s_nextSeq,
+                s_enabled ? "ON" : "off");
+}
+
+// Erase only the sectors this record covers, write url + body, then the header.
+// A record is valid only once its header (magic) lands.
+static bool writeRecord(NetCaptureHeader& h, const char* url, const uint8_t* body) {
+  const uint32_t base = slotOffset(s_nextSlot);
+  const uint32_t len  = sizeof(h) + h.urlLen + h.bodyLen;
+  const uint32_t span = (len + kSectorSize - 1) / kSectorSize * kSectorSize;
+
+  if (esp_partition_erase_range(s_part, base, span) != ESP_OK) return false;
+  if (esp_partition_write(s_part, base + sizeof(h), url, h.urlLen) != ESP_OK) return false;
+  if (h.bodyLen > 0 &&
+      esp_partition_write(s_part, base + sizeof(h) + h.urlLen, body, h.bodyLen) != ESP_OK) {
+    return false;
+  }
+  if (esp_partition_write(s_part, base, &h, sizeof(h)) != ESP_OK) return false;
+
+  s_nextSlot = (uint16_t)((s_nextSlot + 1) % s_slots);
+  return true;
+}
+
+// No Serial here: this runs inside every fetch while capture is on.
+static void record(const char* url, int code, const String& payload, uint32_t headMs, uint32_t bodyMs) {
+  ensureInit();
+  if (!s_part) return;
+
+  size_t urlLen = strlen(url);
+  if (urlLen == 0 || urlLen > 1024) return;
+
+  NetCaptureHeader h;
+  memset(&h, 0, sizeof(h));
+  h.magic    = NET_CAPTURE_MAGIC;
+  h.seq      = s_nextSeq++;
+  h.utc      = (uint32_t)time(nullptr);
+  h.uptimeMs = millis();
+  h.httpCode = code;
+  h.urlLen   = (uint16_t)urlLen;
+  h.fullLen  = payload.length();
+  h.headMs   = headMs;
+  h.bodyMs   = bodyMs;
+
+  const uint32_t room = NET_CAPTURE_SLOT_SIZE - sizeof(h) - h.urlLen;
+  h.bodyLen = h.fullLen;
+  if (h.bodyLen > room) {
+    h.bodyLen = room;
+    h.flags  |= NET_CAPTURE_F_TRUNCATED;
+  }
+
+  const uint8_t* body = (const uint8_t*)payload.c_str();
+  uint32_t crc = crc32_le(0, (const uint8_t*)url, h.urlLen);
+  h.crc = crc32_le(crc, body, h.bodyLen);
+
+  if (!writeRecord(h, url, body)) s_writeErrors++;
+}
+
+// ==================== Public API =====================
+
+int netCaptureHttpGet(HTTPClient& http, const char* url, String& payload) {
+  ensureInit();
+  const bool capture = s_enabled && s_part;
+
+  uint32_t t0 = millis();
+  int code = http.GET();
+  uint32_t t1 = millis();
+  if (code == 200) payload = http.getString();
+  uint32_t t2 = millis();
+
+  if (capture) record(url, code, payload, t1 - t0, t2 - t1);
+  return code;
+}
+
+void netCaptureSetEnabled(bool enabled) {
+  ensureInit();
+  s_enabled = enabled;
+
+  Preferences pref;
+  if (!pref.begin(kNs, false)) return;
+  pref.putBool(kKey, enabled);
+  pref.end();
+
+  LOGI(NET, "[Capture] Capture %s", enabled ? "ON" : "off");
+}
+
+bool netCaptureEnabled() {
+  ensureInit();
+  return s_enabled;
+}
+
+bool netCaptureInfo(NetCaptureInfo& out) {
+  ensureInit();
+  memset(&out, 0, sizeof(out));
+  out.enabled     = s_enabled;
+  out.available   = (s_part != nullptr);
+  out.slots       = s_slots;
+  out.writeErrors = s_writeErrors;
+  if (!s_part) return false;
+
+  for (uint16_t i = 0; i < s_slots; i++) {
+    NetCaptureHeader h;
+    if (!readHeader(i, h)) continue;
+    out.records++;
+    out.exportBytes += sizeof(h) + h.urlLen + h.bodyLen;
+    if (out.oldestUtc == 0 || h.utc < out.oldestUtc) out.oldestUtc = h.utc;
+    if (h.utc > out.newestUtc) out.newestUtc = h.utc;
+  }
+  return true;
+}
+
+bool netCaptureClear() {
+  ensureInit();
+  if (!s_part) return false;
+
+ // Invalidating the first sector of each slot is enough (header lives there).
+  bool ok = true;
+  for (uint16_t i = 0; i < s_slots; i++) {
+    if (esp_partition_erase_range(s_part, slotOffset(i), kSectorSize) != ESP_OK) ok = false;
+  }
+  s_nextSlot = 0;
+  LOGI(NET, "[Capture] Ring cleared%s", ok ? "" : " (erase errors)");
+  return ok;
+}
+
+size_t netCaptureExport(NetCaptureSink sink, void* ctx) {
+  ensureInit();
+  if (!s_part || !sink) return 0;
+
+  uint8_t buf[1024];
+  size_t sent = 0;
+
+ // Ring order from the next write slot is oldest -> newest.
+  for (uint16_t n = 0; n < s_slots; n++) {
+    const uint16_t slot = (uint16_t)((s_nextSlot + n) % s_slots);
+    NetCaptureHeader h;
+    if (!readHeader(slot, h)) continue;
+
+    const uint32_t len = sizeof(h) + h.urlLen + h.bodyLen;
+    for (uint32_t off = 0; off < len; ) {
+      uint32_t chunk = len - off;
+      if (chunk > sizeof(buf)) chunk = sizeof(buf);
+      if (esp_partition_read(s_part, slotOffset(slot) + off, buf, chunk) != ESP_OK) return sent;
+      if (!sink(buf, chunk, ctx)) return sent;
+      sent += chunk;
+      off  += chunk;
+    }
+  }
+  return sent;
+}
+
+#else  // !NET_CAPTURE_ENABLE
+
+int netCaptureHttpGet(HTTPClient& http, const char* url, String& payload) {
+  (void)url;
+  int code = http.GET();
+  if (code == 200) payload = http.getString();
+  return code;
+}
+
+void netCaptureSetEnabled(bool enabled) { (void)enabled; }
+bool netCaptureEnabled() { return false; }
+
+bool netCaptureInfo(NetCaptureInfo& out) {
+  memset(&out, 0, sizeof(out));
+  return false;
+}
+
+bool netCaptureClear() { return false; }
+
+size_t netCaptureExport(NetCaptureSink sink, void* ctx) {
+  (void)sink;
+  (void)ctx;
+  return 0;
+}
+
+#endif  // NET_CAPTURE_ENABLE
@@ -0,0 +1,381 @@
+// CryptoBar V0.99s (Streaming inflate)
+// net_inflate.cpp - RFC 1951 deflate decoder with gzip (RFC 1952) and zlib (RFC 1950) wrappers
+#include "net_inflate.h"
+
+#include <string.h>
+
+// ==================== Tables =====================
+
+static const uint16_t kLengthBase[29] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const uint8_t kLengthExtra[29] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+  3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const uint16_t kDistBase[30] = {
+  1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+  257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const uint8_t kDistExtra[30] = {
+  0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+  7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+// Order of the code length code lengths in a dynamic block header.
+static const uint8_t kCodeLengthOrder[19] = {
+  16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+// ==================== Input =====================
+
+NetInflate::NetInflate(uint8_t* window, size_t windowLen)
+    : m_src(nullptr), m_ctx(nullptr), m_format(NET_INFLATE_GZIP), m_zlib(false),
+      m_inPos(0), m_inLen(0), m_inEnd(true), m_bitBuf(0), m_bitCnt(0),
+      m_state(ST_ERROR), m_err(NET_INFLATE_ERR_INPUT), m_lastBlock(false),
+      m_storedLeft(0), m_copyLen(0), m_copyDist(0),
+      m_window(nullptr), m_windowMask(0), m_inTotal(0), m_outTotal(0) {
+  setWindow(window, windowLen);
+}
+
+void NetInflate::setWindow(uint8_t* window, size_t windowLen) {
+  m_window     = (window && windowLen) ? window : nullptr;
+  m_windowMask = m_window ? windowLen - 1 : 0;
+}
+
+void NetInflate::begin(Source src, void* ctx, NetInflateFormat format) {
+  m_src        = src;
+  m_ctx        = ctx;
+  m_format     = format;
+  m_zlib       = false;
+  m_inPos      = 0;
+  m_inLen      = 0;
+  m_inEnd      = false;
+  m_bitBuf     = 0;
+  m_bitCnt     = 0;
+  m_state      = ST_HEADER;
+  m_err        = NET_INFLATE_OK;
+  m_lastBlock  = false;
+  m_storedLeft = 0;
+  m_copyLen    = 0;
+  m_copyDist   = 0;
+  m_inTotal    = 0;
+  m_outTotal   = 0;
+  if (!m_window) {
+    m_state = ST_ERROR;
+    m_err   = NET_INFLATE_ERR_WINDOW;
+  }
+}
+
+void NetInflate::fail(NetInflateError err) {
+  if (m_err == NET_INFLATE_OK) m_err = err;
+  m_state = ST_ERROR;
+}
+
+// Byte `ahead` positions past the cursor without consuming it, -1 past the end.
+int NetInflate::peekByte(size_t ahead) {
+  while ((size_t)(m_inLen - m_inPos) <= ahead && !m_inEnd) {
+    if (m_inPos > 0) {
+      memmove(m_in, m_in + m_inPos, m_inLen - m_inPos);
+      m_inLen -= m_inPos;
+      m_inPos = 0;
+    }
+    size_t n = m_src(m_ctx, m_in + m_inLen, sizeof(m_in) - m_inLen);
+    if (n == 0) m_inEnd = true;
+    m_inLen += (uint8_t)n;
+    m_inTotal += n;
+  }
+  return ((size_t)(m_inLen - m_inPos) > ahead) ? m_in[m_inPos + ahead] : -1;
+}
+
+int NetInflate::getByte() {
+  if (m_inPos == m_inLen && peekByte(0) < 0) {
+    fail(NET_INFLATE_ERR_INPUT);
+    return -1;
+  }
+  return m_in[m_inPos++];
+}
+
+// n <= 16 bits, LSB first. Keeps fewer than 8 bits buffered between calls, so
+// dropping m_bitCnt bits aligns to the next byte.
+uint32_t NetInflate::bits(uint8_t n) {
+  while (m_bitCnt < n) {
+    int b = getByte();
+    if (b < 0) return 0;
+    m_bitBuf |= (uint32_t)b << m_bitCnt;
+    m_bitCnt += 8;
+  }
+  uint32_t v = m_bitBuf & ((1u << n) - 1);
+  m_bitBuf >>= n;
+  m_bitCnt -= n;
+  return v;
+}
+
+// ==================== Wrappers =====================
+
+bool NetInflate::streamHeader() {
+  if (m_format == NET_INFLATE_GZIP) {
+    // ID1 ID2 CM FLG MTIME(4) XFL OS [FEXTRA] [FNAME] [FCOMMENT] [FHCRC]
+    if (getByte() != 0x1f || getByte() != 0x8b || getByte() != 8) {
+      fail(NET_INFLATE_ERR_DATA);
+      return false;
+    }
+    const int flg = getByte();
+    for (int i = 0; i < 6; i++) getByte();
+    if (flg & 0x04) {
+      int xlen = getByte();
+      xlen |= getByte() << 8;
+      while (xlen-- > 0 && m_err == NET_INFLATE_OK) getByte();
+    }
+    if (flg & 0x08) while (getByte() > 0) {}
+    if (flg & 0x10) while (getByte() > 0) {}
+    if (flg & 0x02) {
+      getByte();
+      getByte();
+    }
+    return m_err == NET_INFLATE_OK;
+  }
+
+  // "deflate" is meant to be zlib-wrapped, but some servers send raw deflate.
+  const int cmf = peekByte(0);
+  const int flg = peekByte(1);
+  if (cmf < 0 || flg < 0) {
+    fail(NET_INFLATE_ERR_INPUT);
+    return false;
+  }
+  if ((cmf & 0x0f) == 8 && ((cmf << 8) | flg) % 31 == 0) {
+    m_zlib = true;
+    m_inPos += 2;
+    if ((flg & 0x20) != 0) {  // preset dictionary
+      fail(NET_INFLATE_ERR_DATA);
+      return false;
+    }
+    if ((1u << ((cmf >> 4) + 8)) > m_windowMask + 1) {
+      fail(NET_INFLATE_ERR_WINDOW);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool NetInflate::streamTrailer() {
+  m_bitBuf = 0;
+  m_bitCnt = 0;
+  if (m_format == NET_INFLATE_GZIP) {
+    for (int i = 0; i < 4; i++) getByte();  // CRC-32 (not checked)
+    uint32_t isize = 0;
+    for (int i = 0; i < 4; i++) isize |= (uint32_t)getByte() << (8 * i);
+    if (m_err != NET_INFLATE_OK) return false;
+    if (isize != (uint32_t)m_outTotal) {
+      fail(NET_INFLATE_ERR_DATA);
+      return false;
+    }
+  } else if (m_zlib) {
+    for (int i = 0; i < 4; i++) getByte();  // Adler-32 (not checked)
+    if (m_err != NET_INFLATE_OK) return false;
+  }
+  return true;
+}
+
+// ==================== Blocks =====================
+
+void NetInflate::buildTable(Huffman& h, const uint8_t* lengths, uint16_t n) {
+  uint16_t offs[16];
+  memset(h.counts, 0, sizeof(h.counts));
+  for (uint16_t i = 0; i < n; i++) h.counts[lengths[i]]++;
+  h.counts[0] = 0;
+  for (uint16_t i = 0, sum = 0; i < 16; i++) {
+    offs[i] = sum;
+    sum += h.counts[i];
+  }
+  for (uint16_t i = 0; i < n; i++) {
+    if (lengths[i]) h.symbols[offs[lengths[i]]++] = i;
+  }
+}
+
+// Canonical decode, one bit at a time: -1 on an invalid code.
+int NetInflate::decodeSymbol(const Huffman& h) {
+  int code = 0, first = 0, index = 0;
+  for (uint8_t len = 1; len < 16; len++) {
+    code |= (int)bits(1);
+    const int count = h.counts[len];
+    if (code - first < count) return h.symbols[index + code - first];
+    index += count;
+    first = (first + count) << 1;
+    code <<= 1;
+  }
+  fail(NET_INFLATE_ERR_DATA);
+  return -1;
+}
+
+bool NetInflate::dynamicTables() {
+  uint8_t lengths[288 + 32];
+  const uint16_t hlit  = (uint16_t)bits(5) + 257;
+  const uint16_t hdist = (uint16_t)bits(5) + 1;
+  const uint8_t  hclen = (uint8_t)bits(4) + 4;
+  if (hlit > 286 || hdist > 30) {
+    fail(NET_INFLATE_ERR_DATA);
+    return false;
+  }
+
+  memset(lengths, 0, 19);
+  for (uint8_t i = 0; i < hclen; i++) lengths[kCodeLengthOrder[i]] = (uint8_t)bits(3);
+  buildTable(m_dist, lengths, 19);  // code length code, until the real tables are built
+
+  for (uint16_t i = 0; i < hlit + hdist && m_err == NET_INFLATE_OK;) {
+    int sym = decodeSymbol(m_dist);
+    if (sym < 0) return false;
+    if (sym < 16) {
+      lengths[i++] = (uint8_t)sym;
+      continue;
+    }
+    uint8_t  value = 0;
+    uint16_t repeat;
+    if (sym == 16) {
+      if (i == 0) {
+        fail(NET_INFLATE_ERR_DATA);
+        return false;
+      }
+      value  = lengths[i - 1];
+      repeat = 3 + (uint16_t)bits(2);
+    } else if (sym == 17) {
+      repeat = 3 + (uint16_t)bits(3);
+    } else {
+      repeat = 11 + (uint16_t)bits(7);
+    }
+    if (i + repeat > hlit + hdist) {
+      fail(NET_INFLATE_ERR_DATA);
+      return false;
+    }
+    while (repeat--) lengths[i++] = value;
+  }
+  if (m_err != NET_INFLATE_OK) return false;
+
+  buildTable(m_lit, lengths, hlit);
+  buildTable(m_dist, lengths + hlit, hdist);
+  return true;
+}
+
+bool NetInflate::blockHeader() {
+  m_lastBlock = bits(1) != 0;
+  const uint32_t type = bits(2);
+  if (m_err != NET_INFLATE_OK) return false;
+
+  if (type == 0) {
+    m_bitBuf = 0;  // stored: skip to the byte boundary
+    m_bitCnt = 0;
+    uint16_t len  = (uint16_t)getByte();
+    len          |= (uint16_t)(getByte() << 8);
+    uint16_t nlen = (uint16_t)getByte();
+    nlen         |= (uint16_t)(getByte() << 8);
+    if (m_err != NET_INFLATE_OK) return false;
+    if ((uint16_t)~nlen != len) {
+      fail(NET_INFLATE_ERR_DATA);
+      return false;
+    }
+    m_storedLeft = len;
+    m_state = ST_STORED;
+    return true;
+  }
+  if (type == 1) {
+    uint8_t lengths[288];
+    memset(lengths, 8, 144);
+    memset(lengths + 144, 9, 112);
+    memset(lengths + 256, 7, 24);
+    memset(lengths + 280, 8, 8);
+    buildTable(m_lit, lengths, 288);
+    memset(lengths, 5, 30);
+    buildTable(m_dist, lengths, 30);
+  } else if (type != 2 || !dynamicTables()) {
+    fail(NET_INFLATE_ERR_DATA);
+    return false;
+  }
+  m_state = ST_HUFFMAN;
+  return true;
+}
+
+// ==================== Output =====================
+
+size_t NetInflate::readBytes(char* out, size_t len) {
+  size_t n = 0;
+  while (n < len) {
+    if (m_copyLen > 0) {
+      const uint8_t b = m_window[(m_outTotal - m_copyDist) & m_windowMask];
+      m_window[m_outTotal++ & m_windowMask] = b;
+      out[n++] = (char)b;
+      m_copyLen--;
+      continue;
+    }
+
+    switch (m_state) {
+      case ST_HEADER:
+        if (streamHeader()) m_state = ST_BLOCK;
+        break;
+
+      case ST_BLOCK:
+        if (m_lastBlock) {
+          m_state = streamTrailer() ? ST_DONE : ST_ERROR;
+        } else {
+          blockHeader();
+        }
+        break;
+
+      case ST_STORED: {
+        if (m_storedLeft == 0) {
+          m_state = ST_BLOCK;
+          break;
+        }
+        const int b = getByte();
+        if (b < 0) break;
+        m_window[m_outTotal++ & m_windowMask] = (uint8_t)b;
+        out[n++] = (char)b;
+        m_storedLeft--;
+        break;
+      }
+
+      case ST_HUFFMAN: {
+        const int sym = decodeSymbol(m_lit);
+        if (sym < 0 || m_err != NET_INFLATE_OK) break;
+        if (sym < 256) {
+          m_window[m_outTotal++ & m_windowMask] = (uint8_t)sym;
+          out[n++] = (char)sym;
+        } else if (sym == 256) {
+          m_state = ST_BLOCK;
+        } else {
+          const int li = sym - 257;
+          if (li >= 29) {
+            fail(NET_INFLATE_ERR_DATA);
+            break;
+          }
+          const uint16_t length = kLengthBase[li] + (uint16_t)bits(kLengthExtra[li]);
+          const int di = decodeSymbol(m_dist);
+          if (di < 0 || di >= 30) {
+            fail(NET_INFLATE_ERR_DATA);
+            break;
+          }
+          const uint32_t dist = kDistBase[di] + bits(kDistExtra[di]);
+          if (m_err != NET_INFLATE_OK) break;
+          if (dist > m_outTotal) {
+            fail(NET_INFLATE_ERR_DATA);
+          } else if (dist > m_windowMask + 1) {
+            fail(NET_INFLATE_ERR_WINDOW);
+          } else {
+            m_copyLen  = length;
+            m_copyDist = (uint16_t)dist;
+          }
+        }
+        break;
+      }
+
+      case ST_DONE:
+      case ST_ERROR:
+        return n;
+    }
+  }
+  return n;
+}
+
+int NetInflate::read() {
+  char c;
+  return (readBytes(&c, 1) == 1) ? (uint8_t)c : -1;
+}
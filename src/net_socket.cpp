@@ -0,0 +1,79 @@
+// CryptoBar V0.99s (Socket abstraction)
+// net_socket.cpp - NetSocket over the ESP32 core's WiFiClient / WiFiClientSecure
+#include "net_socket.h"
+
+#include <WiFi.h>
+#include <WiFiClientSecure.h>
+
+namespace {
+
+class EspSocket : public NetSocket {
+ public:
+  bool connect(const char* host, uint16_t port, bool tls, uint32_t timeoutMs) override {
+    close();
+    if (tls) {
+      m_tls.setInsecure();  // same trust model as HTTPClient::begin(url) without a CA
+      m_tls.setHandshakeTimeout((timeoutMs + 999) / 1000);
+      m_client = &m_tls;
+      if (!m_tls.connect(host, port, (int32_t)timeoutMs)) {
+        m_client = nullptr;
+        return false;
+      }
+    } else {
+      m_client = &m_plain;
+      if (!m_plain.connect(host, port, (int32_t)timeoutMs)) {
+        m_client = nullptr;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  int write(const uint8_t* data, size_t len, uint32_t timeoutMs) override {
+    if (!m_client) return NET_ERR_SEND;
+    const uint32_t start = millis();
+    size_t off = 0;
+    while (off < len) {
+      size_t n = m_client->write(data + off, len - off);
+      if (n == 0) {
+        if (!m_client->connected() || millis() - start >= timeoutMs) return NET_ERR_SEND;
+        delay(1);
+        continue;
+      }
+      off += n;
+    }
+    return (int)len;
+  }
+
+  int read(uint8_t* buf, size_t len, uint32_t timeoutMs) override {
+    if (!m_client) return NET_ERR_LOST;
+    const uint32_t start = millis();
+    for (;;) {
+      int avail = m_client->available();
+      if (avail > 0) {
+        int n = m_client->read(buf, ((size_t)avail < len) ? (size_t)avail : len);
+        return (n > 0) ? n : NET_ERR_LOST;
+      }
+      if (!m_client->connected()) return 0;
+      if (millis() - start >= timeoutMs) return NET_ERR_TIMEOUT;
+      delay(1);
+    }
+  }
+
+  void close() override {
+    if (m_client) m_client->stop();
+    m_client = nullptr;
+  }
+
+ private:
+  WiFiClient       m_plain;
+  WiFiClientSecure m_tls;
+  WiFiClient*      m_client = nullptr;
+};
+
+}  // namespace
+
+NetSocket& netSocketDefault() {
+  static EspSocket s_socket;
+  return s_socket;
+}
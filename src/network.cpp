@@ -4,6 +4,7 @@
 #include <ArduinoJson.h>
 #include <time.h>
 #include <string.h>
+#include <ctype.h>
 
 #include "config.h"
 #include "app_state.h"
@@ -11,6 +12,15 @@
 #include "chart.h"
 #include "day_avg.h"
 #include "network.h"
+#include "net_capture.h"
+#include "app_log.h"
+#include "profile.h"
+#include "trace.h"
+#include "heap_monitor.h"
+#include "json_arena.h"
+#include "lite_http.h"
+#include "http_cache.h"
+#include "settings_store.h"
 
 // Some values were originally from config.h; these are fallback defaults
 #ifndef MARKET_GMT_OFFSET_SEC
@@ -31,7 +41,7 @@ const CoinInfo& currentCoin();
 void updateEtCycle() {
   time_t nowUtc = time(nullptr);
   if (nowUtc <= 0) {
-    Serial.println("[Cycle] time(nullptr) failed.");
+    LOGW(NET, "[Cycle] time(nullptr) failed.");
     return;
   }
 
@@ -55,8 +65,8 @@ void updateEtCycle() {
     g_cycleEndUtc      = endUtc;
     g_chartSampleCount = 0;
   dayAvgRollingReset();
-    Serial.printf("[Cycle] New ET day: startUtc=%ld, endUtc=%ld\n",
-                  (long)g_cycleStartUtc, (long)g_cycleEndUtc);
+    LOGI(NET, "[Cycle] New ET day: startUtc=%ld, endUtc=%ld",
+              (long)g_cycleStartUtc, (long)g_cycleEndUtc);
   }
 }
 
@@ -79,6 +89,7 @@ static void addChartSampleUtc(time_t sampleUtc, double price) {
   if (g_chartSampleCount < MAX_CHART_SAMPLES) {
     g_chartSamples[g_chartSampleCount].pos   = pos;
     g_chartSamples[g_chartSampleCount].price = price;
+    if (g_chartSampleCount < g_chartDirtyFrom) g_chartDirtyFrom = g_chartSampleCount;
     g_chartSampleCount++;
   } else {
  // Rolling buffer: discard oldest
@@ -87,6 +98,7 @@ static void addChartSampleUtc(time_t sampleUtc, double price) {
     }
     g_chartSamples[MAX_CHART_SAMPLES - 1].pos   = pos;
     g_chartSamples[MAX_CHART_SAMPLES - 1].price = price;
+    g_chartDirtyFrom = 0;  // every index moved
   }
 }
 
@@ -97,7 +109,7 @@ static void addChartSampleUtc(time_t sampleUtc, double price) {
 void addChartSampleForNow(double price) {
   time_t nowUtc = time(nullptr);
   if (nowUtc <= 0) {
-    Serial.println("[Chart] time(nullptr) failed in addChartSampleForNow().");
+    LOGW(NET, "[Chart] time(nullptr) failed in addChartSampleForNow().");
     return;
   }
 
@@ -119,6 +131,7 @@ void addChartSampleForNow(double price) {
  // Same bucket: update last point, don't add new one (prevents filling 300 samples too quickly)
   if (bucket == s_lastBucket && g_chartSampleCount > 0) {
     g_chartSamples[g_chartSampleCount - 1].price = price;
+    if (g_chartSampleCount - 1 < g_chartDirtyFrom) g_chartDirtyFrom = g_chartSampleCount - 1;
     return;
   }
 
@@ -128,65 +141,241 @@ void addChartSampleForNow(double price) {
   addChartSampleUtc(bucketUtc, price);
 }
 
+// ==================== Provider transport =====================
+
+// V0.99s: Provider responses stream from LiteHttp's fixed buffer into the
+// parsers: no String for the URL, headers or body. Capture recording and the
+// verbose payload dump need the whole body, so with either on the response
+// goes through HTTPClient + netCaptureHttpGet() and is read back from a String.
+// TRACE_PARSE spans on the streaming path include the body transfer.
+
+static char s_httpBuf[1024];  // LiteHttp request/header/body buffer (loop task only)
+
+static const LiteHttpTimeouts kProviderTimeouts = { 5000, 8000, 8000 };
+
+#if NET_INFLATE_ENABLE
+// V0.99s: History and FX responses (7-36 KB of JSON) are offered gzip/deflate.
+// Only the decoder's tables are static; its 32 KB window is borrowed from the
+// heap for the one fetch (ProviderBody) and the request asks for identity if
+// that allocation fails.
+static NetInflate s_inflate;
+#endif
+
+class ProviderBody {
+ public:
+  ProviderBody() : m_http(netSocketDefault(), s_httpBuf, sizeof(s_httpBuf)), m_buffered(false), m_pos(0) {}
+#if NET_INFLATE_ENABLE
+  ~ProviderBody() { releaseWindow(); }
+#endif
+
+  // GET url; returns the HTTP status or a negative transport error. With
+  // validators the streaming request is conditional (304 = not modified);
+  // the buffered path sends none and clears them.
+  int get(const char* url, bool wantPayload = false, bool compressed = false,
+          LiteHttpValidators* validators = nullptr) {
+    m_buffered = wantPayload || netCaptureEnabled();
+#if NET_INFLATE_ENABLE
+    if (!m_buffered) {
+      NetInflate* inflate = (compressed && borrowWindow()) ? &s_inflate : nullptr;
+      return m_http.get(url, kProviderTimeouts, inflate, validators);
+    }
+#else
+    (void)compressed;
+    if (!m_buffered) return m_http.get(url, kProviderTimeouts, nullptr, validators);
+#endif
+    if (validators) memset(validators, 0, sizeof(*validators));
+
+    HTTPClient http;
+    http.begin(url);
+    http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+    http.setTimeout(8000);
+    int code = netCaptureHttpGet(http, url, m_payload);
+    http.end();
+    return code;
+  }
+
+  // Large responses: accept gzip/deflate (streaming path only).
+  int getCompressed(const char* url, LiteHttpValidators* validators = nullptr) {
+    return get(url, false, true, validators);
+  }
+
+  // ArduinoJson custom reader interface.
+  int read() {
+    if (!m_buffered) return m_http.read();
+    return (m_pos < m_payload.length()) ? (uint8_t)m_payload[m_pos++] : -1;
+  }
+  size_t readBytes(char* out, size_t len) {
+    if (!m_buffered) return m_http.readBytes(out, len);
+    size_t n = m_payload.length() - m_pos;
+    if (n > len) n = len;
+    memcpy(out, m_payload.c_str() + m_pos, n);
+    m_pos += n;
+    return n;
+  }
+
+  // Whole body (buffered mode only, i.e. get(url, true)).
+  const String& payload() const { return m_payload; }
+
+  // Body bytes received (streaming: handed to the parser so far), and the
+  // part of them that crossed the network (less when compressed).
+  size_t bytes() const { return m_buffered ? m_payload.length() : m_http.bodyBytes(); }
+  size_t wireBytes() const { return m_buffered ? m_payload.length() : m_http.wireBytes(); }
+
+ private:
+#if NET_INFLATE_ENABLE
+  bool borrowWindow() {
+    if (!m_window) m_window = (uint8_t*)malloc(NET_INFLATE_WINDOW_BYTES);
+    if (!m_window) {
+      LOGW(NET, "[HTTP] No %u B for the inflate window, requesting identity",
+                (unsigned)NET_INFLATE_WINDOW_BYTES);
+      return false;
+    }
+    s_inflate.setWindow(m_window, NET_INFLATE_WINDOW_BYTES);
+    return true;
+  }
+  void releaseWindow() {
+    if (!m_window) return;
+    s_inflate.setWindow(nullptr, 0);
+    free(m_window);
+    m_window = nullptr;
+  }
+
+  uint8_t* m_window = nullptr;  // inflate window, owned for this fetch
+#endif
+  LiteHttp m_http;
+  bool     m_buffered;
+  String   m_payload;
+  size_t   m_pos;
+};
+
 // ==================== Price fetching =====================
 
+// V0.99s: Native quotes. With QUOTE_NATIVE and a non-USD display currency,
+// CoinGecko and CoinPaprika are asked for the display currency in the same
+// request. The quote's own USD -> display rate replaces that FX table entry
+// (UI, chart and day average keep converting from USD with it), so the
+// hourly FX request is only needed when the price came from a provider
+// without fiat quotes: Kraken and Binance are only asked for the USD pair
+// in the coin table (krakenPair / binanceSymbol), there is no fiat-pair table.
+static int    s_quoteCur = -1;  // currency of the last native quote
+static time_t s_quoteUtc = 0;
+
+// Display currency to request natively, or -1.
+static int nativeQuoteCurrency() {
+  if (g_quoteMode != QUOTE_NATIVE) return -1;
+  if (g_displayCurrency <= (int)CURR_USD || g_displayCurrency >= (int)CURR_COUNT) return -1;
+  return g_displayCurrency;
+}
+
+// Quote in currency cur next to the USD one: take its rate and change.
+static void applyNativeQuote(const char* tag, int cur, double priceUsd, double priceNative,
+                             double changeNative, double& change24h) {
+  if (priceUsd <= 0.0 || priceNative <= 0.0) return;
+  const double rate = priceNative / priceUsd;
+  if (!(rate > 0.001 && rate < 1000000.0)) return;
+  g_usdToRate[cur] = rate;
+  g_fxValid        = true;
+  change24h        = changeNative;
+  // Before NTP the clock reads ~1970: such a stamp would look current (or
+  // from the future) once the time is set, so only stamp with a valid clock.
+  // Unstamped, fxQuotedNatively() stays false and the FX table is refreshed.
+  const time_t now = time(nullptr);
+  s_quoteCur       = cur;
+  s_quoteUtc       = (now >= TIME_VALID_MIN_UTC) ? now : 0;
+  LOGD(NET, "%s Native %s: %.6f (USD->%s %.6f, 24h: %.2f%%)", tag, CURRENCY_INFO[cur].code,
+            priceNative, CURRENCY_INFO[cur].code, rate, changeNative);
+}
+
+bool fxQuotedNatively(time_t nowUtc) {
+  return s_quoteCur >= 0 && s_quoteCur == g_displayCurrency && s_quoteUtc > 0 &&
+         nowUtc >= s_quoteUtc && nowUtc - s_quoteUtc < 3600;
+}
+
+void fxNativeQuoteGet(int& cur, time_t& quoteUtc) {
+  cur      = s_quoteCur;
+  quoteUtc = s_quoteUtc;
+}
+
+void fxNativeQuoteSet(int cur, time_t quoteUtc) {
+  if (cur < 0 || cur >= (int)CURR_COUNT) {
+    cur      = -1;
+    quoteUtc = 0;
+  }
+  s_quoteCur = cur;
+  s_quoteUtc = quoteUtc;
+}
+
 static bool fetchPriceFromPaprika(double& priceUsd, double& change24h) {
+  PROFILE_ZONE("fetch.cp");
+  TRACE_SCOPE(TRACE_FETCH_CP);
   const CoinInfo& coin = currentCoin();
 
   if (!coin.paprikaId || coin.paprikaId[0] == '\0') {
-    Serial.println("[CP] No paprikaId configured for this coin.");
+    LOGD(NET, "[CP] No paprikaId configured for this coin.");
     return false;
   }
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[CP] WiFi not connected.");
+    LOGW(NET, "[CP] WiFi not connected.");
     return false;
   }
 
-  HTTPClient http;
   // V0.99b: Avoid String concatenation (heap fragmentation)
+  // V0.99s: quotes=USD,<display> for a native quote
+  const int quoteCur = nativeQuoteCurrency();
   char url[128];
-  snprintf(url, sizeof(url), "https://api.coinpaprika.com/v1/tickers/%s", coin.paprikaId);
-
-  Serial.print("[CP] GET ");
-  Serial.println(url);
+  if (quoteCur >= 0) {
+    snprintf(url, sizeof(url), API_ORIGIN("api.coinpaprika.com") "/v1/tickers/%s?quotes=USD,%s",
+             coin.paprikaId, CURRENCY_INFO[quoteCur].code);
+  } else {
+    snprintf(url, sizeof(url), API_ORIGIN("api.coinpaprika.com") "/v1/tickers/%s", coin.paprikaId);
+  }
 
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
+  LOGD(NET, "[CP] GET %s", url);
 
-  int code = http.GET();
+  ProviderBody body;
+  int code = body.get(url);
   if (code != 200) {
-    Serial.printf("[CP] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[CP] HTTP error: %d", code);
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
-
  // Parse only the fields we need to keep memory usage low.
-  StaticJsonDocument<128> filter;
+  JsonDocument filter(&jsonArenaAllocator);
   filter["quotes"]["USD"]["price"] = true;
   filter["quotes"]["USD"]["percent_change_24h"] = true;
+  if (quoteCur >= 0) {
+    filter["quotes"][CURRENCY_INFO[quoteCur].code]["price"] = true;
+    filter["quotes"][CURRENCY_INFO[quoteCur].code]["percent_change_24h"] = true;
+  }
 
-  DynamicJsonDocument doc(1024);
-  DeserializationError err = deserializeJson(doc, payload, DeserializationOption::Filter(filter));
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
-    Serial.printf("[CP] JSON parse error: %s\n", err.c_str());
+    LOGW(NET, "[CP] JSON parse error: %s", err.c_str());
     return false;
   }
 
   JsonObject usd = doc["quotes"]["USD"].as<JsonObject>();
   if (usd.isNull()) {
-    Serial.println("[CP] quotes.USD missing.");
+    LOGW(NET, "[CP] quotes.USD missing.");
     return false;
   }
 
   priceUsd  = usd["price"].as<double>();
   change24h = usd["percent_change_24h"].as<double>();
 
-  Serial.printf("[CP] %s: $%.6f (24h: %.2f%%)\n",
-                coin.ticker, priceUsd, change24h);
+  if (quoteCur >= 0) {
+    JsonObject native = doc["quotes"][CURRENCY_INFO[quoteCur].code].as<JsonObject>();
+    if (!native.isNull()) {
+      applyNativeQuote("[CP]", quoteCur, priceUsd, native["price"].as<double>(),
+                       native["percent_change_24h"].as<double>(), change24h);
+    }
+  }
+
+  LOGI(NET, "[CP] %s: $%.6f (24h: %.2f%%)",
+            coin.ticker, priceUsd, change24h);
 
   // V0.99m: Track successful API source
   if (priceUsd > 0.0) {
@@ -197,60 +386,52 @@ static bool fetchPriceFromPaprika(double& priceUsd, double& change24h) {
 }
 
 static bool fetchPriceFromKraken(double& priceUsd, double& change24h) {
+  PROFILE_ZONE("fetch.kraken");
+  TRACE_SCOPE(TRACE_FETCH_KRAKEN);
   const CoinInfo& coin = currentCoin();
 
   if (!coin.krakenPair || coin.krakenPair[0] == '\0') {
-    Serial.println("[Kraken] No krakenPair configured for this coin.");
+    LOGD(NET, "[Kraken] No krakenPair configured for this coin.");
     return false;
   }
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[Kraken] WiFi not connected.");
+    LOGW(NET, "[Kraken] WiFi not connected.");
     return false;
   }
 
-  HTTPClient http;
   // V0.99b: Avoid String concatenation (heap fragmentation)
   char url[128];
-  snprintf(url, sizeof(url), "https://api.kraken.com/0/public/Ticker?pair=%s", coin.krakenPair);
-
-  Serial.print("[Kraken] GET ");
-  Serial.println(url);
+  snprintf(url, sizeof(url), API_ORIGIN("api.kraken.com") "/0/public/Ticker?pair=%s", coin.krakenPair);
 
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
+  LOGD(NET, "[Kraken] GET %s", url);
 
-  int code = http.GET();
+  ProviderBody body;
+  int code = body.get(url);
   if (code != 200) {
-    Serial.printf("[Kraken] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[Kraken] HTTP error: %d", code);
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
-
-  // V0.99k: Debug - show first 300 chars of raw JSON response
-  Serial.print("[Kraken] Raw JSON payload (first 300 chars): ");
-  Serial.println(payload.substring(0, 300));
-
-  StaticJsonDocument<4096> doc;
-  DeserializationError err = deserializeJson(doc, payload);
+  // V0.99s: JSON arena, not the loop task's stack (was StaticJsonDocument<4096>)
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body);
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
-    Serial.printf("[Kraken] JSON parse error: %s\n", err.c_str());
+    LOGW(NET, "[Kraken] JSON parse error: %s", err.c_str());
     return false;
   }
 
   if (doc["error"].size() > 0) {
-    Serial.print("[Kraken] API error: ");
-    serializeJson(doc["error"], Serial);
-    Serial.println();
+    char apiErr[96];
+    serializeJson(doc["error"], apiErr, sizeof(apiErr));
+    LOGW(NET, "[Kraken] API error: %s", apiErr);
     return false;
   }
 
   JsonObject result = doc["result"];
   if (result.isNull()) {
-    Serial.println("[Kraken] result is null.");
+    LOGW(NET, "[Kraken] result is null.");
     return false;
   }
 
@@ -260,7 +441,7 @@ static bool fetchPriceFromKraken(double& priceUsd, double& change24h) {
     break;   // Only grab the first key
   }
   if (ticker.isNull()) {
-    Serial.println("[Kraken] ticker missing.");
+    LOGW(NET, "[Kraken] ticker missing.");
     return false;
   }
 
@@ -272,7 +453,7 @@ static bool fetchPriceFromKraken(double& priceUsd, double& change24h) {
   const char* openStr = ticker["o"] | "0";
 
   // V0.99k: Debug - show raw JSON strings
-  Serial.printf("[Kraken] Raw JSON: c[0]=\"%s\", o=\"%s\"\n", lastStr, openStr);
+  LOGD(NET, "[Kraken] Raw JSON: c[0]=\"%s\", o=\"%s\"", lastStr, openStr);
 
   // Use strtod() instead of atof() for better precision control
   char* endPtr1;
@@ -280,7 +461,7 @@ static bool fetchPriceFromKraken(double& priceUsd, double& change24h) {
   priceUsd = strtod(lastStr, &endPtr1);
   double open = strtod(openStr, &endPtr2);
 
-  Serial.printf("[Kraken] Parsed: price=%.10f, open=%.10f\n", priceUsd, open);
+  LOGD(NET, "[Kraken] Parsed: price=%.10f, open=%.10f", priceUsd, open);
 
   if (open <= 0.0) {
     change24h = 0.0;
@@ -288,8 +469,8 @@ static bool fetchPriceFromKraken(double& priceUsd, double& change24h) {
     change24h = (priceUsd - open) / open * 100.0;
   }
 
-  Serial.printf("[Kraken] %s: $%.6f (24h: %.2f%%)\n",
-                coin.ticker, priceUsd, change24h);
+  LOGI(NET, "[Kraken] %s: $%.6f (24h: %.2f%%)",
+            coin.ticker, priceUsd, change24h);
 
   // V0.99m: Track successful API source
   g_currentPriceApi = "Kraken";
@@ -298,49 +479,40 @@ static bool fetchPriceFromKraken(double& priceUsd, double& change24h) {
 }
 
 static bool fetchPriceFromBinance(double& priceUsd, double& change24h) {
+  PROFILE_ZONE("fetch.binance");
+  TRACE_SCOPE(TRACE_FETCH_BINANCE);
   const CoinInfo& coin = currentCoin();
 
   if (!coin.binanceSymbol || coin.binanceSymbol[0] == '\0') {
-    Serial.println("[Binance] No binanceSymbol configured for this coin.");
+    LOGD(NET, "[Binance] No binanceSymbol configured for this coin.");
     return false;
   }
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[Binance] WiFi not connected.");
+    LOGW(NET, "[Binance] WiFi not connected.");
     return false;
   }
 
-  HTTPClient http;
   char url[192];
   snprintf(url, sizeof(url),
-           "https://api.binance.com/api/v3/ticker/24hr?symbol=%s",
+           API_ORIGIN("api.binance.com") "/api/v3/ticker/24hr?symbol=%s",
            coin.binanceSymbol);
 
-  Serial.print("[Binance] GET ");
-  Serial.println(url);
+  LOGD(NET, "[Binance] GET %s", url);
 
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
-
-  int code = http.GET();
+  ProviderBody body;
+  int code = body.get(url);
   if (code != 200) {
-    Serial.printf("[Binance] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[Binance] HTTP error: %d", code);
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
-
-  // V0.99k: Debug - show first 200 chars of raw JSON response
-  Serial.print("[Binance] Raw JSON payload (first 200 chars): ");
-  Serial.println(payload.substring(0, 200));
-
   // Parse Binance 24hr ticker response
-  StaticJsonDocument<512> doc;
-  DeserializationError err = deserializeJson(doc, payload);
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body);
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
-    Serial.printf("[Binance] JSON parse error: %s\n", err.c_str());
+    LOGW(NET, "[Binance] JSON parse error: %s", err.c_str());
     return false;
   }
 
@@ -348,7 +520,7 @@ static bool fetchPriceFromBinance(double& priceUsd, double& change24h) {
   if (doc.containsKey("code")) {
     int errCode = doc["code"].as<int>();
     const char* msg = doc["msg"] | "unknown";
-    Serial.printf("[Binance] API error %d: %s\n", errCode, msg);
+    LOGW(NET, "[Binance] API error %d: %s", errCode, msg);
     return false;
   }
 
@@ -357,7 +529,7 @@ static bool fetchPriceFromBinance(double& priceUsd, double& change24h) {
   const char* changePercentStr = doc["priceChangePercent"] | "0";
 
   // V0.99k: Debug - show raw JSON string values
-  Serial.printf("[Binance] Raw JSON: price=\"%s\", change=\"%s\"\n", lastPriceStr, changePercentStr);
+  LOGD(NET, "[Binance] Raw JSON: price=\"%s\", change=\"%s\"", lastPriceStr, changePercentStr);
 
   // Use strtod() for string-to-double conversion with full precision
   char* endPtr1;
@@ -365,9 +537,9 @@ static bool fetchPriceFromBinance(double& priceUsd, double& change24h) {
   priceUsd  = strtod(lastPriceStr, &endPtr1);
   change24h = strtod(changePercentStr, &endPtr2);
 
-  Serial.printf("[Binance] Parsed: $%.10f (24h: %.2f%%)\n", priceUsd, change24h);
-  Serial.printf("[Binance] %s: $%.6f (24h: %.2f%%)\n",
-                coin.ticker, priceUsd, change24h);
+  LOGD(NET, "[Binance] Parsed: $%.10f (24h: %.2f%%)", priceUsd, change24h);
+  LOGI(NET, "[Binance] %s: $%.6f (24h: %.2f%%)",
+            coin.ticker, priceUsd, change24h);
 
   // V0.99m: Track successful API source
   if (priceUsd > 0.0) {
@@ -378,60 +550,67 @@ static bool fetchPriceFromBinance(double& priceUsd, double& change24h) {
 }
 
 static bool fetchPriceFromCoingecko(double& priceUsd, double& change24h) {
+  PROFILE_ZONE("fetch.cg");
+  TRACE_SCOPE(TRACE_FETCH_CG);
   const CoinInfo& coin = currentCoin();
 
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[CG] WiFi not connected.");
+    LOGW(NET, "[CG] WiFi not connected.");
     return false;
   }
 
  // Use registry-provided CoinGecko id when available.
   if (!coin.geckoId || coin.geckoId[0] == '\0') {
-    Serial.println("[CG] No geckoId configured for this coin.");
+    LOGD(NET, "[CG] No geckoId configured for this coin.");
     return false;
   }
 
-  HTTPClient http;
+  // V0.99s: vs_currencies=usd,<display> for a native quote (CoinGecko keys are lower case)
+  const int quoteCur = nativeQuoteCurrency();
+  char vs[8] = "usd";
+  char quoteKey[4] = "";
+  char quoteChangeKey[16] = "";
+  if (quoteCur >= 0) {
+    for (int i = 0; i < 3; i++) quoteKey[i] = (char)tolower((unsigned char)CURRENCY_INFO[quoteCur].code[i]);
+    quoteKey[3] = '\0';
+    snprintf(vs, sizeof(vs), "usd,%s", quoteKey);
+    snprintf(quoteChangeKey, sizeof(quoteChangeKey), "%s_24h_change", quoteKey);
+  }
+
   // V0.99b: Avoid String concatenation (heap fragmentation)
   // V0.99p: Added precision=full parameter to request maximum decimal places
   char url[256];
   snprintf(url, sizeof(url),
-           "https://api.coingecko.com/api/v3/simple/price?ids=%s&vs_currencies=usd&include_24hr_change=true&precision=full",
-           coin.geckoId);
-
-  Serial.print("[CG] GET ");
-  Serial.println(url);
+           API_ORIGIN("api.coingecko.com") "/api/v3/simple/price?ids=%s&vs_currencies=%s&include_24hr_change=true&precision=full",
+           coin.geckoId, vs);
 
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
+  LOGD(NET, "[CG] GET %s", url);
 
-  int code = http.GET();
+  // V0.99p: Enhanced debug - show complete raw JSON response
+  // V0.99s: verbose level only (build with -DLOG_LEVEL_NET=LOG_LEVEL_VERBOSE)
+  const bool dumpRaw = LOG_ENABLED(NET, VERBOSE);
+  ProviderBody body;
+  int code = body.get(url, dumpRaw);
   if (code != 200) {
-    Serial.printf("[CG] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[CG] HTTP error: %d", code);
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
+  if (dumpRaw) appLogDump("[CG] raw:", body.payload().c_str(), body.payload().length());
 
-  // V0.99p: Enhanced debug - show complete raw JSON response
-  Serial.println("[CG] ========== RAW JSON RESPONSE ==========");
-  Serial.println(payload);
-  Serial.println("[CG] ======================================");
-
-  StaticJsonDocument<512> doc;
-  DeserializationError err = deserializeJson(doc, payload);
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body);
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
-    Serial.printf("[CG] JSON parse error: %s\n", err.c_str());
+    LOGW(NET, "[CG] JSON parse error: %s", err.c_str());
     return false;
   }
 
   // V0.99b: Use coin.geckoId directly instead of String temporary
   JsonObject coinObj = doc[coin.geckoId];
   if (coinObj.isNull()) {
-    Serial.println("[CG] Coin id missing.");
+    LOGW(NET, "[CG] Coin id missing.");
     return false;
   }
 
@@ -444,10 +623,14 @@ static bool fetchPriceFromCoingecko(double& priceUsd, double& change24h) {
 
   // V0.99k: Debug - show raw JSON and parsed values
   // V0.99p: Show up to 10 decimal places to verify precision
-  Serial.printf("[CG] Raw JSON: usd=%s, change=%s\n", rawPrice, rawChange);
-  Serial.printf("[CG] Parsed: $%.10f (24h: %.2f%%)\n", priceUsd, change24h);
-  Serial.printf("[CG] %s: $%.10f (24h: %.2f%%)\n",
-                coin.ticker, priceUsd, change24h);
+  LOGD(NET, "[CG] Raw JSON: usd=%s, change=%s", rawPrice, rawChange);
+  LOGD(NET, "[CG] Parsed: $%.10f (24h: %.2f%%)", priceUsd, change24h);
+  if (quoteCur >= 0 && coinObj[quoteKey].is<double>()) {
+    applyNativeQuote("[CG]", quoteCur, priceUsd, coinObj[quoteKey].as<double>(),
+                     coinObj[quoteChangeKey].as<double>(), change24h);
+  }
+  LOGI(NET, "[CG] %s: $%.10f (24h: %.2f%%)",
+            coin.ticker, priceUsd, change24h);
 
   // V0.99m: Track successful API source
   g_currentPriceApi = "CoinGecko";
@@ -457,7 +640,7 @@ static bool fetchPriceFromCoingecko(double& priceUsd, double& change24h) {
 
 bool fetchPrice(double& priceUsd, double& change24h) {
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[Price] WiFi not connected.");
+    LOGW(NET, "[Price] WiFi not connected.");
     return false;
   }
 
@@ -467,50 +650,120 @@ bool fetchPrice(double& priceUsd, double& change24h) {
   if (fetchPriceFromCoingecko(priceUsd, change24h)) {
     return true;
   }
-  Serial.println("[Price] CoinGecko failed, falling back to CoinPaprika...");
+  LOGW(NET, "[Price] CoinGecko failed, falling back to CoinPaprika...");
 
   if (fetchPriceFromPaprika(priceUsd, change24h)) {
     return true;
   }
-  Serial.println("[Price] CoinPaprika failed, falling back to Kraken...");
+
+  LOGW(NET, "[Price] CoinPaprika failed, falling back to Kraken...");
 
   if (fetchPriceFromKraken(priceUsd, change24h)) {
     return true;
   }
-  Serial.println("[Price] Kraken failed, falling back to Binance...");
+  LOGW(NET, "[Price] Kraken failed, falling back to Binance...");
 
   if (fetchPriceFromBinance(priceUsd, change24h)) {
     return true;
   }
 
-  Serial.println("[Price] All providers failed.");
+  LOGE(NET, "[Price] All providers failed.");
   return false;
 }
 
 // ==================== Historical OHLC bootstrap =====================
 
+// One CoinGecko market_chart point: feeds the rolling 24h mean (full last-day
+// window), and the chart when inside the ET cycle. Returns true if charted.
+static bool addHistoryPoint(time_t tUtc, double price, time_t windowStartUtc, time_t windowEndUtc) {
+  if (price <= 0.0) return false;
+  dayAvgRollingAdd(tUtc, price);
+  if (tUtc < windowStartUtc || tUtc > windowEndUtc) return false;
+  addChartSampleUtc(tUtc, price);
+  return true;
+}
+
+// Next byte that is not JSON whitespace (or one of the extra skip chars), -1 at the end.
+static int scanSkip(ProviderBody& body, const char* skip) {
+  int c;
+  do {
+    c = body.read();
+  } while (c == ' ' || c == '\n' || c == '\r' || c == '\t' || (c > 0 && strchr(skip, c)));
+  return c;
+}
+
+// One JSON number after optional whitespace; term gets the byte that ended it.
+static bool scanNumber(ProviderBody& body, double& out, int& term) {
+  char num[32];
+  size_t n = 0;
+  int c = scanSkip(body, "");
+  while ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+    if (n + 1 >= sizeof(num)) return false;
+    num[n++] = (char)c;
+    c = body.read();
+  }
+  num[n] = '\0';
+  if (c == ' ' || c == '\n' || c == '\r' || c == '\t') c = scanSkip(body, "");
+  term = c;
+  if (n == 0) return false;
+  out = strtod(num, nullptr);
+  return true;
+}
+
+// V0.99s: Low-memory path for market_chart: walks "prices":[[ms,price],...]
+// as it streams in, without a JsonDocument. Returns the samples charted, or -1
+// if there is no "prices" array (chart and rolling mean left untouched).
+static int scanCoingeckoPrices(ProviderBody& body, time_t windowStartUtc, time_t windowEndUtc) {
+  static const char kKey[] = "\"prices\"";
+  size_t matched = 0;
+  while (matched < sizeof(kKey) - 1) {
+    int c = body.read();
+    if (c < 0) return -1;
+    matched = (c == kKey[matched]) ? matched + 1 : (c == '"') ? 1 : 0;
+  }
+  if (scanSkip(body, ":") != '[') return -1;
+
+  g_chartSampleCount = 0;
+  dayAvgRollingReset();
+  int kept = 0;
+
+  for (;;) {
+    if (scanSkip(body, ",") != '[') break;  // ']' closes "prices"; anything else is malformed
+
+ // CoinGecko timestamps are milliseconds.
+    double tMs, price;
+    int term;
+    if (!scanNumber(body, tMs, term) || term != ',') break;
+    if (!scanNumber(body, price, term) || term != ']') break;
+
+    if (addHistoryPoint((time_t)(tMs / 1000.0), price, windowStartUtc, windowEndUtc)) kept++;
+  }
+  return kept;
+}
+
 static bool bootstrapHistoryFromCoingeckoMarketChart() {
+  PROFILE_ZONE("hist.cg");
   const CoinInfo& coin = currentCoin();
 
   if (!coin.geckoId || coin.geckoId[0] == '\0') {
-    Serial.println("[History][CG] No geckoId configured for this coin.");
+    LOGD(NET, "[History][CG] No geckoId configured for this coin.");
     return false;
   }
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[History][CG] WiFi not connected.");
+    LOGW(NET, "[History][CG] WiFi not connected.");
     return false;
   }
 
  // Ensure 7pm ET cycle exists (still needed for Cycle mean mode).
   updateEtCycle();
   if (!g_cycleInit) {
-    Serial.println("[History][CG] cycle not initialized.");
+    LOGW(NET, "[History][CG] cycle not initialized.");
     return false;
   }
 
   time_t nowUtc = time(nullptr);
   if (nowUtc <= 0) {
-    Serial.println("[History][CG] time(nullptr) failed.");
+    LOGW(NET, "[History][CG] time(nullptr) failed.");
     return false;
   }
 
@@ -519,51 +772,59 @@ static bool bootstrapHistoryFromCoingeckoMarketChart() {
   time_t windowEndUtc   = g_cycleEndUtc;
   if (nowUtc < windowEndUtc) windowEndUtc = nowUtc;
 
-  HTTPClient http;
   // V0.99b: Avoid String concatenation (heap fragmentation)
   char url[192];
   snprintf(url, sizeof(url),
-           "https://api.coingecko.com/api/v3/coins/%s/market_chart?vs_currency=usd&days=1",
+           API_ORIGIN("api.coingecko.com") "/api/v3/coins/%s/market_chart?vs_currency=usd&days=1",
            coin.geckoId);
 
-  Serial.print("[History][CG] GET ");
-  Serial.println(url);
-
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
+  LOGD(NET, "[History][CG] GET %s", url);
 
-  int code = http.GET();
+  ProviderBody body;
+  int code = body.getCompressed(url);
   if (code != 200) {
-    Serial.printf("[History][CG] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[History][CG] HTTP error: %d", code);
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
+  // V0.99s: Low-memory mode: no 16 KB document, scan the body as it arrives
+  if (heapMonitorDegraded()) {
+    traceBeginEvent(TRACE_PARSE);
+    int kept = scanCoingeckoPrices(body, windowStartUtc, windowEndUtc);
+    traceEndEvent(TRACE_PARSE, body.bytes());
+    if (kept < 0) {
+      LOGW(NET, "[History][CG] prices missing.");
+      return false;
+    }
+    LOGI(NET, "[History][CG] Kept %d samples into chart (low-memory scan).", kept);
+    if (kept > 0) {
+      g_currentHistoryApi = "CoinGecko";
+    }
+    return (kept > 0);
+  }
 
  // Only keep the 'prices' array to reduce memory usage.
-  StaticJsonDocument<64> filter;
+  JsonDocument filter(&jsonArenaAllocator);
   filter["prices"] = true;
 
- // V0.99b: Reduced from 24576 to 16384 (33% reduction) to save heap
  // Filter extracts only "prices" array, reducing memory footprint
-  DynamicJsonDocument doc(16384);
-  DeserializationError err = deserializeJson(doc, payload, DeserializationOption::Filter(filter));
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
     if (err == DeserializationError::NoMemory) {
-      Serial.printf("[History][CG] Insufficient memory for parsing (need >16KB)\n");
-      Serial.printf("[History][CG] Free heap: %u bytes\n", ESP.getFreeHeap());
+      LOGW(NET, "[History][CG] Insufficient memory for parsing (need >16KB)");
+      LOGW(NET, "[History][CG] Free heap: %u bytes", ESP.getFreeHeap());
     } else {
-      Serial.printf("[History][CG] JSON parse error: %s\n", err.c_str());
+      LOGW(NET, "[History][CG] JSON parse error: %s", err.c_str());
     }
     return false;
   }
 
   JsonArray prices = doc["prices"].as<JsonArray>();
   if (prices.isNull()) {
-    Serial.println("[History][CG] prices missing.");
+    LOGW(NET, "[History][CG] prices missing.");
     return false;
   }
 
@@ -579,16 +840,10 @@ static bool bootstrapHistoryFromCoingeckoMarketChart() {
     long long tMs = row[0].as<long long>();
     time_t tUtc = (time_t)(tMs / 1000LL);
     double price = row[1].as<double>();
-    if (price <= 0.0) continue;
-
- // Rolling 24h mean uses full last-day window (seeded from CoinGecko)
-    dayAvgRollingAdd(tUtc, price);
-    if (tUtc < windowStartUtc || tUtc > windowEndUtc) continue;
-    addChartSampleUtc(tUtc, price);
-    kept++;
+    if (addHistoryPoint(tUtc, price, windowStartUtc, windowEndUtc)) kept++;
   }
 
-  Serial.printf("[History][CG] Kept %d samples into chart.\n", kept);
+  LOGI(NET, "[History][CG] Kept %d samples into chart.", kept);
 
   // V0.99m: Track successful history API source
   if (kept > 0) {
@@ -599,27 +854,35 @@ static bool bootstrapHistoryFromCoingeckoMarketChart() {
 }
 
 static bool bootstrapHistoryFromBinanceKlines() {
+  PROFILE_ZONE("hist.binance");
   const CoinInfo& coin = currentCoin();
 
   if (!coin.binanceSymbol || coin.binanceSymbol[0] == '\0') {
-    Serial.println("[History][Binance] No binanceSymbol configured for this coin.");
+    LOGD(NET, "[History][Binance] No binanceSymbol configured for this coin.");
+    return false;
+  }
+  // V0.99s: Streamed, the klines response needs no heap (document in the JSON
+  // arena); with capture on it is read into one ~36 KB String first
+  if (heapMonitorDegraded() && netCaptureEnabled()) {
+    LOGW(NET, "[History][Binance] Skipped: low memory (largest block %lu B)",
+              (unsigned long)heapMonitorLast().largestBlock);
     return false;
   }
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[History][Binance] WiFi not connected.");
+    LOGW(NET, "[History][Binance] WiFi not connected.");
     return false;
   }
 
   // Ensure 7pm ET cycle exists (still needed for Cycle mean mode)
   updateEtCycle();
   if (!g_cycleInit) {
-    Serial.println("[History][Binance] cycle not initialized.");
+    LOGW(NET, "[History][Binance] cycle not initialized.");
     return false;
   }
 
   time_t nowUtc = time(nullptr);
   if (nowUtc <= 0) {
-    Serial.println("[History][Binance] time(nullptr) failed.");
+    LOGW(NET, "[History][Binance] time(nullptr) failed.");
     return false;
   }
 
@@ -634,59 +897,53 @@ static bool bootstrapHistoryFromBinanceKlines() {
   // Convert to milliseconds for Binance API
   long long startTimeMs = (long long)sinceUtc * 1000LL;
 
-  HTTPClient http;
   char url[256];
   snprintf(url, sizeof(url),
-           "https://api.binance.com/api/v3/klines?symbol=%s&interval=5m&startTime=%lld&limit=500",
+           API_ORIGIN("api.binance.com") "/api/v3/klines?symbol=%s&interval=5m&startTime=%lld&limit=500",
            coin.binanceSymbol, startTimeMs);
 
-  Serial.print("[History][Binance] GET ");
-  Serial.println(url);
-
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
+  LOGD(NET, "[History][Binance] GET %s", url);
 
-  int code = http.GET();
+  ProviderBody body;
+  int code = body.getCompressed(url);
   if (code != 200) {
-    Serial.printf("[History][Binance] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[History][Binance] HTTP error: %d", code);
     return false;
   }
 
-  String payload = http.getString();
-  http.end();
-
-  Serial.printf("[History][Binance] Payload length: %d bytes\n", payload.length());
-
   // Parse klines data
-  DynamicJsonDocument doc(32768);
-  DeserializationError err = deserializeJson(doc, payload);
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body);
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
     if (err == DeserializationError::NoMemory) {
-      Serial.printf("[History][Binance] Insufficient memory for parsing (need >32KB)\n");
-      Serial.printf("[History][Binance] Free heap: %u bytes\n", ESP.getFreeHeap());
+      LOGW(NET, "[History][Binance] Insufficient memory for parsing (need >32KB)");
+      LOGW(NET, "[History][Binance] Free heap: %u bytes", ESP.getFreeHeap());
     } else {
-      Serial.printf("[History][Binance] JSON parse error: %s\n", err.c_str());
+      LOGW(NET, "[History][Binance] JSON parse error: %s", err.c_str());
     }
     return false;
   }
 
+  LOGD(NET, "[History][Binance] Payload length: %u bytes (%u on the wire)",
+            (unsigned)body.bytes(), (unsigned)body.wireBytes());
+
   // Check for API error
   if (doc.containsKey("code")) {
     int errCode = doc["code"].as<int>();
     const char* msg = doc["msg"] | "unknown";
-    Serial.printf("[History][Binance] API error %d: %s\n", errCode, msg);
+    LOGW(NET, "[History][Binance] API error %d: %s", errCode, msg);
     return false;
   }
 
   JsonArray klines = doc.as<JsonArray>();
   if (klines.isNull()) {
-    Serial.println("[History][Binance] klines array missing.");
+    LOGW(NET, "[History][Binance] klines array missing.");
     return false;
   }
 
-  Serial.printf("[History][Binance] Klines raw size: %u\n", (unsigned)klines.size());
+  LOGD(NET, "[History][Binance] Klines raw size: %u", (unsigned)klines.size());
 
   g_chartSampleCount = 0;
   dayAvgRollingReset();
@@ -713,8 +970,8 @@ static bool bootstrapHistoryFromBinanceKlines() {
     kept++;
   }
 
-  Serial.printf("[History][Binance] Kept %d samples into chart.\n", kept);
-  Serial.printf("[History][Binance] g_chartSampleCount = %d\n", g_chartSampleCount);
+  LOGI(NET, "[History][Binance] Kept %d samples into chart.", kept);
+  LOGD(NET, "[History][Binance] g_chartSampleCount = %d", g_chartSampleCount);
 
   // V0.99m: Track successful history API source
   if (kept > 0) {
@@ -725,22 +982,24 @@ static bool bootstrapHistoryFromBinanceKlines() {
 }
 
 void bootstrapHistoryFromKrakenOHLC() {
+  PROFILE_ZONE("hist.total");
+  TRACE_SCOPE(TRACE_HISTORY);
   const CoinInfo& coin = currentCoin();
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[History] WiFi not connected, skip.");
+    LOGW(NET, "[History] WiFi not connected, skip.");
     return;
   }
 
  // Ensure 7pm ET cycle is established first (still needed for Cycle mean mode)
   updateEtCycle();
   if (!g_cycleInit) {
-    Serial.println("[History] cycle not initialized, abort.");
+    LOGW(NET, "[History] cycle not initialized, abort.");
     return;
   }
 
   time_t nowUtc = time(nullptr);
   if (nowUtc <= 0) {
-    Serial.println("[History] time(nullptr) failed.");
+    LOGW(NET, "[History] time(nullptr) failed.");
     return;
   }
 
@@ -749,84 +1008,81 @@ void bootstrapHistoryFromKrakenOHLC() {
   time_t windowEndUtc   = g_cycleEndUtc;
   if (nowUtc < windowEndUtc) windowEndUtc = nowUtc;
 
-  Serial.printf("[History] ET Cycle window: %ld .. %ld\n",
-                (long)windowStartUtc, (long)windowEndUtc);
+  LOGD(NET, "[History] ET Cycle window: %ld .. %ld",
+            (long)windowStartUtc, (long)windowEndUtc);
+
+  // V0.99s: Fresh heap sample, so degrade mode reflects the heap right now
+  heapMonitorPoll(true);
 
   // V0.99k: Prioritize aggregated market data for history
   // Try CoinGecko first (aggregated), then Binance (single exchange) as fallback
-  Serial.println("[History] Using aggregated market data (CoinGecko)...");
+  LOGI(NET, "[History] Using aggregated market data (CoinGecko)...");
   if (bootstrapHistoryFromCoingeckoMarketChart()) {
     return;
   }
 
-  Serial.println("[History] CoinGecko failed, trying Binance...");
+  LOGW(NET, "[History] CoinGecko failed, trying Binance...");
   if (bootstrapHistoryFromBinanceKlines()) {
     return;
   }
 
   // If both aggregated sources fail and Kraken is available, use it
   if (!coin.krakenPair || coin.krakenPair[0] == '\0') {
-    Serial.println("[History] All history sources failed.");
+    LOGE(NET, "[History] All history sources failed.");
     return;
   }
-  Serial.println("[History] Falling back to Kraken OHLC...");
+  LOGI(NET, "[History] Falling back to Kraken OHLC...");
   // Continue to Kraken OHLC below
 
  // Seed rolling 24h mean buffer with same 24h window
   dayAvgRollingReset();
   time_t sinceUtc = windowStartUtc;
 
-  HTTPClient http;
   // V0.99b: Avoid String concatenation (heap fragmentation)
   // V0.99p: Fetch past 24h data to match chart window
   char url[192];
   snprintf(url, sizeof(url),
-           "https://api.kraken.com/0/public/OHLC?pair=%s&interval=5&since=%ld",
+           API_ORIGIN("api.kraken.com") "/0/public/OHLC?pair=%s&interval=5&since=%ld",
            coin.krakenPair, (long)sinceUtc);
 
-  Serial.print("[History] GET ");
-  Serial.println(url);
-
-  http.begin(url);
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
-  http.setTimeout(8000);
+  LOGD(NET, "[History] GET %s", url);
 
-  int code = http.GET();
+  ProviderBody body;
+  int code = body.getCompressed(url);
   if (code != 200) {
-    Serial.printf("[History] HTTP error: %d\n", code);
-    http.end();
+    LOGW(NET, "[History] HTTP error: %d", code);
     return;
   }
 
-  String payload = http.getString();
-  http.end();
-
-  Serial.printf("[History] Payload length: %d bytes\n", payload.length());
-
  // V0.99b: Reduced from 49152 to 32768 (33% reduction) to save heap
  // With since= parameter, payload is filtered to current cycle only
-  DynamicJsonDocument doc(32768);
-  DeserializationError err = deserializeJson(doc, payload);
+  JsonDocument doc(&jsonArenaAllocator);
+  traceBeginEvent(TRACE_PARSE);
+  DeserializationError err = deserializeJson(doc, body);
+  traceEndEvent(TRACE_PARSE, body.bytes());
   if (err) {
     if (err == DeserializationError::NoMemory) {
-      Serial.printf("[History] Insufficient memory for OHLC parsing (need >32KB)\n");
-      Serial.printf("[History] Free heap: %u bytes\n", ESP.getFreeHeap());
+      LOGW(NET, "[History] Insufficient memory for OHLC parsing (need >32KB)");
+      LOGW(NET, "[History] Free heap: %u bytes", ESP.getFreeHeap());
     } else {
-      Serial.printf("[History] JSON parse error: %s\n", err.c_str());
+      LOGW(NET, "[History] JSON parse error: %s", err.c_str());
     }
     return;
   }
 
+  LOGD(NET, "[History] Payload length: %u bytes (%u on the wire)",
+            (unsigned)body.bytes(), (unsigned)body.wireBytes());
+
   if (doc["error"].size() > 0) {
-    Serial.print("[History] API error: ");
-    serializeJson(doc["error"], Serial);
-    Serial.println();
+    char apiErr[96];
+    serializeJson(doc["error"], apiErr, sizeof(apiErr));
+    LOGW(NET, "[History] API error: %s", apiErr);
     return;
   }
 
   JsonObject result = doc["result"];
   if (result.isNull()) {
-    Serial.println("[History] result is null.");
+    LOGW(NET, "[History] result is null.");
     return;
   }
 
@@ -839,19 +1095,19 @@ void bootstrapHistoryFromKrakenOHLC() {
   }
   if (ohlcArr.isNull()) {
     // V0.99g: Try Binance first, fallback to CoinGecko
-    Serial.println("[History] OHLC array missing or wrong type.");
-    Serial.println("[History] Trying Binance...");
+    LOGW(NET, "[History] OHLC array missing or wrong type.");
+    LOGI(NET, "[History] Trying Binance...");
     if (bootstrapHistoryFromBinanceKlines()) {
       return;
     }
-    Serial.println("[History] Binance history failed, trying CoinGecko...");
+    LOGW(NET, "[History] Binance history failed, trying CoinGecko...");
     if (!bootstrapHistoryFromCoingeckoMarketChart()) {
-      Serial.println("[History] CoinGecko history failed.");
+      LOGW(NET, "[History] CoinGecko history failed.");
     }
     return;
   }
 
-  Serial.printf("[History] OHLC raw size: %u\n", (unsigned)ohlcArr.size());
+  LOGD(NET, "[History] OHLC raw size: %u", (unsigned)ohlcArr.size());
 
   g_chartSampleCount = 0;
   dayAvgRollingReset();
@@ -878,11 +1134,11 @@ void bootstrapHistoryFromKrakenOHLC() {
     kept++;
   }
 
-  Serial.printf("[History] OHLC timestamp range UTC: %ld .. %ld\n",
-                (minT == LONG_MAX ? 0 : minT),
-                (maxT == LONG_MIN ? 0 : maxT));
-  Serial.printf("[History] Kept %d samples into chart.\n", kept);
-  Serial.printf("[History] g_chartSampleCount = %d\n", g_chartSampleCount);
+  LOGD(NET, "[History] OHLC timestamp range UTC: %ld .. %ld",
+            (minT == LONG_MAX ? 0 : minT),
+            (maxT == LONG_MIN ? 0 : maxT));
+  LOGI(NET, "[History] Kept %d samples into chart.", kept);
+  LOGD(NET, "[History] g_chartSampleCount = %d", g_chartSampleCount);
 
   // V0.99m: Track successful history API source
   if (kept > 0) {
@@ -894,53 +1150,113 @@ void bootstrapHistoryFromKrakenOHLC() {
 // ------------------------------
 // FX: USD -> Multi-currency (V0.99f)
 // ------------------------------
+// V0.99s: The last good table is kept in NVS so a reboot starts with real
+// rates instead of the compile-time defaults. Written only when it changes
+// (about once a day), not on every hourly confirmation.
+static double s_fxSaved[CURR_COUNT];  // table in NVS (zeros: unknown)
+
+static void fxAccepted(time_t nowUtc) {
+  g_fxUpdatedUtc = nowUtc;
+  if (memcmp(s_fxSaved, g_usdToRate, sizeof(s_fxSaved)) == 0) return;
+  if (settingsStoreSaveFx(g_usdToRate, CURR_COUNT, (uint32_t)nowUtc)) {
+    memcpy(s_fxSaved, g_usdToRate, sizeof(s_fxSaved));
+  } else {
+    LOGW(NET, "[FX] Could not save rates to NVS");
+  }
+}
+
+bool restoreExchangeRates() {
+  double rates[CURR_COUNT];
+  uint32_t savedUtc = 0;
+  if (!settingsStoreLoadFx(rates, CURR_COUNT, savedUtc)) return false;
+  for (int c = 0; c < (int)CURR_COUNT; c++) {
+    if (!(rates[c] > 0.001 && rates[c] < 1000000.0)) return false;  // corrupt entry: keep defaults
+  }
+  memcpy(g_usdToRate, rates, sizeof(g_usdToRate));
+  memcpy(s_fxSaved, rates, sizeof(s_fxSaved));
+  g_fxUpdatedUtc = (time_t)savedUtc;
+
+  const time_t nowUtc = time(nullptr);
+  if (nowUtc >= TIME_VALID_MIN_UTC && nowUtc >= (time_t)savedUtc) {
+    LOGI(NET, "[FX] Restored rates from NVS (%ld min old)", (long)((nowUtc - (time_t)savedUtc) / 60));
+  } else {
+    LOGI(NET, "[FX] Restored rates from NVS (saved at %lu)", (unsigned long)savedUtc);
+  }
+  return true;
+}
+
 // Fetches exchange rates for all supported currencies
 // Returns: true if at least one rate was successfully fetched
 bool fetchExchangeRates() {
+  PROFILE_ZONE("fetch.fx");
+  TRACE_SCOPE(TRACE_FETCH_FX);
   if (WiFi.status() != WL_CONNECTED) {
-    Serial.println("[FX] WiFi not connected; skip");
+    LOGW(NET, "[FX] WiFi not connected; skip");
     return false;
   }
 
   // V0.99f: Primary API with fallback
   const char* urls[] = {
-    "https://open.er-api.com/v6/latest/USD",        // Primary: 1500/month, 160+ currencies
-    "https://api.fxratesapi.com/latest?base=USD",   // Fallback: unlimited, 170+ currencies
-  };
-
-  // Currency codes to extract
-  const char* currCodes[CURR_COUNT] = {
-    "USD", "TWD", "EUR", "GBP", "CAD", "JPY", "KRW", "SGD", "AUD"
+    API_ORIGIN("open.er-api.com") "/v6/latest/USD",        // Primary: 1500/month, 160+ currencies
+    API_ORIGIN("api.fxratesapi.com") "/latest?base=USD",   // Fallback: unlimited, 170+ currencies
   };
 
+  const time_t nowUtc = time(nullptr);
   for (size_t i = 0; i < sizeof(urls) / sizeof(urls[0]); i++) {
     const char* url = urls[i];
-    HTTPClient http;
-    http.setTimeout(8000);
-    http.begin(url);
 
-    Serial.printf("[FX] GET %s\n", url);
-    int httpCode = http.GET();
+    // V0.99s: The rate table changes daily. While the server's max-age lasts
+    // no request is made; after that the request is conditional and a 304
+    // reuses the stored table (the cache survives reboots in NVS).
+    HttpCacheEntry cached;
+    const bool haveCached = httpCacheLookup(url, cached) && cached.resultLen == sizeof(g_usdToRate);
+    if (haveCached && httpCacheFresh(cached, nowUtc)) {
+      memcpy(g_usdToRate, cached.result, sizeof(g_usdToRate));
+      LOGI(NET, "[FX] Cached rates still fresh (max-age %ld s), no request", (long)cached.validators.maxAgeS);
+      fxAccepted(nowUtc);
+      return true;
+    }
+
+    LiteHttpValidators validators;
+    if (haveCached) {
+      validators = cached.validators;
+    } else {
+      memset(&validators, 0, sizeof(validators));
+    }
+
+    LOGD(NET, "[FX] GET %s%s", url, (validators.etag[0] || validators.lastModified[0]) ? " (conditional)" : "");
+    ProviderBody body;
+    int httpCode = body.getCompressed(url, &validators);
+    if (httpCode == 304 && haveCached) {
+      memcpy(g_usdToRate, cached.result, sizeof(g_usdToRate));
+      httpCacheStore(url, validators, nullptr, 0, nowUtc);
+      LOGI(NET, "[FX] Not modified: cached rates");
+      fxAccepted(nowUtc);
+      return true;
+    }
     if (httpCode != HTTP_CODE_OK) {
-      Serial.printf("[FX] HTTP %d\n", httpCode);
-      http.end();
+      LOGW(NET, "[FX] HTTP %d", httpCode);
       continue;
     }
 
-    String payload = http.getString();
-    http.end();
-
-    // Parse full rates object
-    DynamicJsonDocument doc(8192);
-    DeserializationError err = deserializeJson(doc, payload);
+    // V0.99s: Keep only the CURRENCY_INFO rates (was the full 160+ entry
+    // object); the rest of the table is skipped while parsing.
+    JsonDocument filter(&jsonArenaAllocator);
+    for (int c = 0; c < (int)CURR_COUNT; c++) {
+      filter["rates"][CURRENCY_INFO[c].code] = true;
+    }
+    JsonDocument doc(&jsonArenaAllocator);
+    traceBeginEvent(TRACE_PARSE);
+    DeserializationError err = deserializeJson(doc, body, DeserializationOption::Filter(filter));
+    traceEndEvent(TRACE_PARSE, body.bytes());
     if (err) {
-      Serial.printf("[FX] JSON error: %s\n", err.c_str());
+      LOGW(NET, "[FX] JSON error: %s", err.c_str());
       continue;
     }
 
     JsonObject rates = doc["rates"].as<JsonObject>();
     if (rates.isNull()) {
-      Serial.println("[FX] Missing rates object");
+      LOGW(NET, "[FX] Missing rates object");
       continue;
     }
 
@@ -953,23 +1269,25 @@ bool fetchExchangeRates() {
         continue;
       }
 
-      double rate = rates[currCodes[c]].as<double>();
+      double rate = rates[CURRENCY_INFO[c].code].as<double>();
       if (rate > 0.001 && rate < 1000000.0) {
         g_usdToRate[c] = rate;
         successCount++;
-        Serial.printf("[FX] USD->%s: %.6f\n", currCodes[c], rate);
+        LOGD(NET, "[FX] USD->%s: %.6f", CURRENCY_INFO[c].code, rate);
       } else {
-        Serial.printf("[FX] Invalid/missing rate for %s\n", currCodes[c]);
+        LOGW(NET, "[FX] Invalid/missing rate for %s", CURRENCY_INFO[c].code);
       }
     }
 
     if (successCount >= (int)CURR_COUNT / 2) {
-      Serial.printf("[FX] Success: %d/%d rates fetched\n", successCount, (int)CURR_COUNT);
+      LOGI(NET, "[FX] Success: %d/%d rates fetched", successCount, (int)CURR_COUNT);
+      httpCacheStore(url, validators, g_usdToRate, sizeof(g_usdToRate), nowUtc);
+      fxAccepted(nowUtc);
       return true;
     }
   }
 
-  Serial.println("[FX] All FX endpoints failed");
+  LOGE(NET, "[FX] All FX endpoints failed");
   return false;
 }
 
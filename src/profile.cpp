@@ -0,0 +1,173 @@
+// CryptoBar V0.99s (Profiling zones)
+// profile.cpp - Zone registry, log2 histograms and the RTC checkpoint
+#include "profile.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "retained_state.h"
+
+static_assert(sizeof(ProfileZoneStats) == 128, "ProfileZoneStats layout changed");
+
+// ==================== Live stats =====================
+
+static ProfileZoneStats s_zones[PROFILE_MAX_ZONES];
+static uint8_t          s_zoneCount = 0;
+static portMUX_TYPE     s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Zones longer than this use the tick delta (CCOUNT wraps after ~17.9 s at 240 MHz).
+static const uint32_t kCycleLimitMs = 10000;
+
+static inline uint8_t bucketFor(uint32_t us) {
+  if (us < 2) return 0;
+  uint8_t b = (uint8_t)(31 - __builtin_clz(us));  // floor(log2(us)) >= 1
+  return (b < PROFILE_BUCKETS) ? b : (PROFILE_BUCKETS - 1);
+}
+
+static inline void recordLocked(ProfileZoneStats* z, uint32_t us) {
+  z->count++;
+  z->totalUs += us;
+  if (us > z->maxUs) z->maxUs = us;
+  z->buckets[bucketFor(us)]++;
+}
+
+ProfileZoneStats* profileZone(const char* name) {
+  ProfileZoneStats* found = nullptr;
+  portENTER_CRITICAL(&s_mux);
+  for (uint8_t i = 0; i < s_zoneCount; i++) {
+    if (strncmp(s_zones[i].name, name, PROFILE_NAME_LEN - 1) == 0) {
+      found = &s_zones[i];
+      break;
+    }
+  }
+  if (!found && s_zoneCount < PROFILE_MAX_ZONES) {
+    found = &s_zones[s_zoneCount++];
+    memset(found, 0, sizeof(*found));
+    strncpy(found->name, name, PROFILE_NAME_LEN - 1);
+  }
+  portEXIT_CRITICAL(&s_mux);
+  return found;
+}
+
+void profileRecordUs(ProfileZoneStats* zone, uint32_t us) {
+  if (!zone) return;
+  portENTER_CRITICAL(&s_mux);
+  recordLocked(zone, us);
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void profileRecordCycles(ProfileZoneStats* zone, uint32_t cycles, uint32_t ticks) {
+  const uint32_t ms = ticks * portTICK_PERIOD_MS;
+  uint32_t us;
+  if (ms > kCycleLimitMs) {
+    us = (ms > UINT32_MAX / 1000) ? UINT32_MAX : ms * 1000;
+  } else {
+    static uint32_t s_cyclesPerUs = 0;
+    if (s_cyclesPerUs == 0) s_cyclesPerUs = ESP.getCpuFreqMHz();
+    us = cycles / s_cyclesPerUs;
+  }
+  profileRecordUs(zone, us);
+}
+
+uint8_t profileSnapshot(ProfileZoneStats* out, uint8_t maxZones) {
+  portENTER_CRITICAL(&s_mux);
+  uint8_t n = (s_zoneCount < maxZones) ? s_zoneCount : maxZones;
+  memcpy(out, s_zones, n * sizeof(ProfileZoneStats));
+  portEXIT_CRITICAL(&s_mux);
+  return n;
+}
+
+uint32_t profilePercentileUs(const ProfileZoneStats& zone, uint8_t pct) {
+  if (zone.count == 0) return 0;
+  // Rank of the pct-th percentile sample (1-based, rounded up).
+  const uint64_t rank = ((uint64_t)zone.count * pct + 99) / 100;
+  uint64_t seen = 0;
+  for (uint8_t b = 0; b < PROFILE_BUCKETS; b++) {
+    seen += zone.buckets[b];
+    if (seen >= rank) {
+      if (b == PROFILE_BUCKETS - 1) return zone.maxUs;
+      const uint32_t upper = 2UL << b;
+      return (upper < zone.maxUs) ? upper : zone.maxUs;
+    }
+  }
+  return zone.maxUs;
+}
+
+// ==================== RTC checkpoint =====================
+// RTC no-init memory; validated as described in retained_state.h.
+
+static const uint32_t kSavedMagic   = 0x31464250;  // "PBF1"
+static const uint16_t kSavedVersion = 1;
+
+struct ProfileSaved {
+  uint32_t         magic;
+  uint16_t         version;
+  uint8_t          zoneCount;
+  uint8_t          reserved;
+  uint32_t         uptimeMs;
+  ProfileZoneStats zones[PROFILE_MAX_ZONES];
+  uint32_t         crc;
+};
+
+RTC_NOINIT_ATTR static ProfileSaved s_saved;
+
+// Restored from s_saved by profileBegin() (s_saved is overwritten by this boot's checkpoints).
+static ProfileZoneStats s_prev[PROFILE_MAX_ZONES];
+static uint8_t          s_prevCount    = 0;
+static uint32_t         s_prevUptimeMs = 0;
+
+static uint32_t savedCrc(const ProfileSaved& s) {
+  return retainedCrc(&s, offsetof(ProfileSaved, crc));
+}
+
+void profileBegin() {
+  if (s_saved.magic == kSavedMagic && s_saved.version == kSavedVersion &&
+      s_saved.zoneCount <= PROFILE_MAX_ZONES && s_saved.crc == savedCrc(s_saved)) {
+    s_prevCount    = s_saved.zoneCount;
+    s_prevUptimeMs = s_saved.uptimeMs;
+    memcpy(s_prev, s_saved.zones, s_prevCount * sizeof(ProfileZoneStats));
+    Serial.printf("[Prof] Previous boot: %u zone(s) over %lu s (send 'P' to dump)\n",
+                  (unsigned)s_prevCount, (unsigned long)(s_prevUptimeMs / 1000));
+  }
+  s_saved.magic = 0;  // invalid until this boot's first checkpoint
+}
+
+void profileCheckpoint() {
+  s_saved.magic     = 0;
+  s_saved.version   = kSavedVersion;
+  s_saved.reserved  = 0;
+  s_saved.uptimeMs  = millis();
+  s_saved.zoneCount = profileSnapshot(s_saved.zones, PROFILE_MAX_ZONES);
+  memset(&s_saved.zones[s_saved.zoneCount], 0,
+         (PROFILE_MAX_ZONES - s_saved.zoneCount) * sizeof(ProfileZoneStats));
+  s_saved.magic = kSavedMagic;
+  s_saved.crc   = savedCrc(s_saved);
+}
+
+uint8_t profilePrevious(ProfileZoneStats* out, uint8_t maxZones, uint32_t* uptimeMs) {
+  uint8_t n = (s_prevCount < maxZones) ? s_prevCount : maxZones;
+  memcpy(out, s_prev, n * sizeof(ProfileZoneStats));
+  if (uptimeMs) *uptimeMs = s_prevUptimeMs;
+  return n;
+}
+
+// ==================== Serial =====================
+
+void profileDump(bool previous) {
+  static ProfileZoneStats zones[PROFILE_MAX_ZONES];  // loop task only; keeps 2 KB off the stack
+  uint32_t uptimeMs = millis();
+  uint8_t n = previous ? profilePrevious(zones, PROFILE_MAX_ZONES, &uptimeMs)
+                       : profileSnapshot(zones, PROFILE_MAX_ZONES);
+
+  Serial.printf("[Prof] %s boot, %lu s, %u zone(s) (us; percentiles are log2 bucket bounds)\n",
+                previous ? "Previous" : "This", (unsigned long)(uptimeMs / 1000), (unsigned)n);
+  Serial.println("[Prof] zone                  n       mean        p50        p90        p99        max");
+  for (uint8_t i = 0; i < n; i++) {
+    const ProfileZoneStats& z = zones[i];
+    const uint32_t mean = z.count ? (uint32_t)(z.totalUs / z.count) : 0;
+    Serial.printf("[Prof] %-15s %8lu %10lu %10lu %10lu %10lu %10lu\n", z.name,
+                  (unsigned long)z.count, (unsigned long)mean,
+                  (unsigned long)profilePercentileUs(z, 50), (unsigned long)profilePercentileUs(z, 90),
+                  (unsigned long)profilePercentileUs(z, 99), (unsigned long)z.maxUs);
+  }
+}
@@ -0,0 +1,166 @@
+// CryptoBar V0.99s (Adaptive full-refresh scheduler)
+// refresh_scheduler.cpp - Ghosting budget from per-region frame diffs + daily refresh metrics
+#include "refresh_scheduler.h"
+
+#include <string.h>
+
+#include "app_state.h"
+#include "app_log.h"
+#include "epd_display.h"
+
+// ==================== Budget =====================
+// Ghost load unit: average transitions per pixel of a region, in Q8.
+// Partial mode: a big price digit area reaches 4.0 after ~20 price changes,
+// the small clock after a few hours. Full mode keeps the old "always crisp" look
+// with a much tighter budget instead of flashing on every tick.
+static const uint32_t kGhostBudgetPartialQ8 = 4 * 256;
+static const uint32_t kGhostBudgetFullQ8    = 1 * 256;
+
+// At quiet time, clean up if at least this share of the budget has accumulated.
+static const uint32_t kQuietMinPercent = 25;
+
+// ==================== State =====================
+// Ghost load is only touched by the display owner (frame observer / decision),
+// metrics are also read by other tasks and are guarded by s_statsMux.
+static uint32_t s_tileLoad[EPD_DIFF_TILES];  // transitions since last full refresh
+static uint32_t s_tileArea = 1;
+static uint16_t s_partialsSinceFull = 0;
+static bool     s_quietArmed = false;
+static time_t   s_cycleSeen  = 0;
+static uint8_t  s_nextFullReason = REFRESH_FULL_FORCED;
+
+static RefreshDayStats s_today;
+static RefreshDayStats s_yesterday;
+static portMUX_TYPE    s_statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// ==================== Helpers =====================
+
+static uint32_t activeBudgetQ8() {
+  return (g_refreshMode == 1) ? kGhostBudgetFullQ8 : kGhostBudgetPartialQ8;
+}
+
+static uint32_t worstLoadQ8() {
+  uint32_t worst = 0;
+  for (int i = 0; i < EPD_DIFF_TILES; ++i) {
+    if (s_tileLoad[i] > worst) worst = s_tileLoad[i];
+  }
+  return (uint32_t)(((uint64_t)worst * 256u) / s_tileArea);
+}
+
+static void logDay(const char* tag, const RefreshDayStats& d) {
+  LOGI(RENDER, "[Refresh] %s: full=%lu (forced %lu, budget %lu, quiet %lu, cap %lu) partial=%lu px=%lu",
+               tag,
+               (unsigned long)d.fullCount,
+               (unsigned long)d.fullByReason[REFRESH_FULL_FORCED],
+               (unsigned long)d.fullByReason[REFRESH_FULL_BUDGET],
+               (unsigned long)d.fullByReason[REFRESH_FULL_QUIET],
+               (unsigned long)d.fullByReason[REFRESH_FULL_CAP],
+               (unsigned long)d.partialCount,
+               (unsigned long)d.changedPixels);
+}
+
+// ==================== Frame observer =====================
+
+static void onFrameDiff(const EpdFrameDiff& diff) {
+  uint32_t area = (uint32_t)diff.tileWidth * diff.tileHeight;
+  if (area) s_tileArea = area;
+
+  portENTER_CRITICAL(&s_statsMux);
+  s_today.changedPixels += diff.changedPixels;
+  if (diff.fullRefresh) {
+    s_today.fullCount++;
+    s_today.fullByReason[s_nextFullReason & 3]++;
+  } else {
+    s_today.partialCount++;
+  }
+  portEXIT_CRITICAL(&s_statsMux);
+
+  if (diff.fullRefresh) {
+    memset(s_tileLoad, 0, sizeof(s_tileLoad));
+    s_partialsSinceFull = 0;
+    s_quietArmed = false;
+  } else {
+    for (int i = 0; i < EPD_DIFF_TILES; ++i) {
+      s_tileLoad[i] += diff.tileChanged[i];
+    }
+    if (s_partialsSinceFull < 0xFFFF) s_partialsSinceFull++;
+  }
+  s_nextFullReason = REFRESH_FULL_FORCED;
+  g_partialRefreshCount = s_partialsSinceFull;
+}
+
+// ==================== Public API =====================
+
+void refreshSchedulerBegin() {
+  memset(s_tileLoad, 0, sizeof(s_tileLoad));
+  memset(&s_today, 0, sizeof(s_today));
+  memset(&s_yesterday, 0, sizeof(s_yesterday));
+  display.shadow().setObserver(onFrameDiff);
+}
+
+bool refreshSchedulerWantFull(bool requestedFull, time_t cycleStartUtc) {
+ // Cycle rollover: close the day's metrics and arm a quiet-time cleanup.
+  if (cycleStartUtc != 0 && cycleStartUtc != s_cycleSeen) {
+    if (s_cycleSeen != 0) {
+      portENTER_CRITICAL(&s_statsMux);
+      s_yesterday = s_today;
+      memset(&s_today, 0, sizeof(s_today));
+      portEXIT_CRITICAL(&s_statsMux);
+      logDay("cycle done", s_yesterday);
+      s_quietArmed = true;
+    }
+    s_cycleSeen = cycleStartUtc;
+  }
+
+  if (requestedFull) {
+    s_nextFullReason = REFRESH_FULL_FORCED;
+    return true;
+  }
+
+  const uint32_t budget = activeBudgetQ8();
+  const uint32_t load   = worstLoadQ8();
+
+  if (load >= budget) {
+    LOGI(RENDER, "[Refresh] Ghost budget reached (%lu%%), full refresh",
+                 (unsigned long)(load * 100u / budget));
+    s_nextFullReason = REFRESH_FULL_BUDGET;
+    return true;
+  }
+  if (s_partialsSinceFull >= PARTIAL_REFRESH_LIMIT) {
+    LOGI(RENDER, "[Refresh] %u partials since last full, full refresh",
+                 (unsigned)s_partialsSinceFull);
+    s_nextFullReason = REFRESH_FULL_CAP;
+    return true;
+  }
+  if (s_quietArmed) {
+    s_quietArmed = false;
+    if (load * 100u >= budget * kQuietMinPercent) {
+      LOGI(RENDER, "[Refresh] Cycle rollover, quiet-time full refresh");
+      s_nextFullReason = REFRESH_FULL_QUIET;
+      return true;
+    }
+  }
+  return false;
+}
+
+uint16_t refreshSchedulerGhostPercent() {
+  uint32_t pct = worstLoadQ8() * 100u / activeBudgetQ8();
+  return (uint16_t)(pct > 0xFFFF ? 0xFFFF : pct);
+}
+
+void refreshSchedulerGetStats(RefreshDayStats& today, RefreshDayStats& yesterday) {
+  portENTER_CRITICAL(&s_statsMux);
+  today     = s_today;
+  yesterday = s_yesterday;
+  portEXIT_CRITICAL(&s_statsMux);
+}
+
+void refreshSchedulerLogStats() {
+  RefreshDayStats today, yesterday;
+  refreshSchedulerGetStats(today, yesterday);
+  logDay("today", today);
+  LOGI(RENDER, "[Refresh] ghost=%u%% of %s budget, partials since full=%u",
+               (unsigned)refreshSchedulerGhostPercent(),
+               (g_refreshMode == 1) ? "Full" : "Partial",
+               (unsigned)s_partialsSinceFull);
+}
@@ -0,0 +1,404 @@
+// CryptoBar V0.99s (Async e-paper render task)
+// render_task.cpp - Prioritized, latest-state-wins render queue for the e-paper panel
+#include "render_task.h"
+
+#include "app_state.h"
+#include "ui.h"
+#include "refresh_scheduler.h"
+#include "app_log.h"
+#include "trace.h"
+#include "heap_monitor.h"
+#include "boot_timeline.h"
+
+#if RENDER_TASK_ENABLE
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#endif
+
+// ==================== Main-screen snapshot slots =====================
+// Slot index is only handed between tasks under s_stateLock.
+static UiMainModel s_models[2];
+static bool        s_slotFull[2];
+static bool        s_slotTimeOnly[2];
+static const char* s_slotBootMark[2];  // boot phase to mark once the slot is on the panel
+
+// ==================== Menu snapshot =====================
+// The page being drawn; only the display owner touches it.
+static UiMenuModel s_inputDraw;
+
+// ==================== Statistics =====================
+static uint32_t s_framesRendered  = 0;
+static uint32_t s_inputFrames     = 0;
+static uint32_t s_framesDropped   = 0;  // superseded before rendering started
+static uint32_t s_framesMerged    = 0;  // main requests folded into a held one (same pass)
+static uint32_t s_framesCancelled = 0;  // cancelled by a synchronous screen
+static uint32_t s_framesPreempted = 0;  // abandoned mid-draw for newer input
+static uint32_t s_lastRenderMs    = 0;  // whole frame (CPU + BUSY)
+static uint32_t s_lastBusyMs      = 0;  // time spent waiting on EPD BUSY
+static uint32_t s_maxRenderMs     = 0;
+
+// Accumulated inside the busy callback; only the display owner touches it.
+static uint32_t s_busyAccumUs = 0;
+
+// Current BUSY wait for the trace: callbacks less than kBusyGapUs apart belong
+// to the same wait, which is recorded as one complete event.
+static const uint32_t kBusyGapUs      = 1000;
+static bool           s_busySpanOpen  = false;
+static uint32_t       s_busySpanStart = 0;
+static uint32_t       s_busySpanEnd   = 0;
+
+static void busySpanFlush() {
+  if (!s_busySpanOpen) return;
+  traceComplete(TRACE_PANEL_BUSY, s_busySpanStart, s_busySpanEnd - s_busySpanStart);
+  s_busySpanOpen = false;
+}
+
+#if RENDER_TASK_ENABLE
+static TaskHandle_t      s_task        = nullptr;
+static SemaphoreHandle_t s_stateLock   = nullptr;  // request bookkeeping
+static SemaphoreHandle_t s_displayLock = nullptr;  // recursive; owns 'display' while drawing
+static SemaphoreHandle_t s_busySem     = nullptr;  // given by the BUSY pin ISR
+
+// Main-screen request
+static int  s_pendingIdx  = -1;
+static bool s_pendingHeld = false;  // queued this loop() pass, waiting for renderTaskFlush()
+static int  s_renderIdx   = -1;
+
+// Input request (latest wins). s_inputModel is written by the loop task under
+// s_stateLock; the render task copies it into s_inputDraw under the same lock.
+static UiMenuModel s_inputModel;
+static bool s_inputPending   = false;
+static bool s_inputFull      = false;
+static bool s_inputRendering = false;
+
+// Set by DisplayLock so an in-flight frame yields to a synchronous screen.
+static volatile bool s_syncWaiting = false;
+
+// Upper bound for one sleep while BUSY is asserted (a missed edge costs at most this).
+static const uint32_t kBusyWaitSliceMs = 20;
+
+static void IRAM_ATTR epdBusyIsr() {
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(s_busySem, &woken);
+  portYIELD_FROM_ISR(woken);
+}
+
+static inline bool onRenderTask() {
+  return s_task && xTaskGetCurrentTaskHandle() == s_task;
+}
+#endif
+
+// GxEPD2 calls this repeatedly while BUSY is asserted (instead of delay(1)).
+static void epdBusyCallback(const void* param) {
+  (void)param;
+  uint32_t t0 = micros();
+#if RENDER_TASK_ENABLE
+  if (s_busySem) {
+    xSemaphoreTake(s_busySem, pdMS_TO_TICKS(kBusyWaitSliceMs));
+  } else {
+    delay(1);
+  }
+#else
+  delay(1);
+#endif
+  const uint32_t waitedUs = micros() - t0;
+  s_busyAccumUs += waitedUs;
+
+  const uint32_t end   = traceNowUs();
+  const uint32_t start = end - waitedUs;
+  if (s_busySpanOpen && start - s_busySpanEnd > kBusyGapUs) busySpanFlush();
+  if (!s_busySpanOpen) {
+    s_busySpanOpen  = true;
+    s_busySpanStart = start;
+  }
+  s_busySpanEnd = end;
+}
+
+// ==================== Rendering =====================
+
+static void frameStatsBegin(uint32_t& t0) {
+  busySpanFlush();
+  s_busyAccumUs = 0;
+  t0 = millis();
+}
+
+static void frameStatsEnd(uint32_t t0) {
+  busySpanFlush();
+  s_lastRenderMs = millis() - t0;
+  s_lastBusyMs   = s_busyAccumUs / 1000UL;
+  if (s_lastBusyMs > s_lastRenderMs) s_lastBusyMs = s_lastRenderMs;
+  if (s_lastRenderMs > s_maxRenderMs) s_maxRenderMs = s_lastRenderMs;
+  s_framesRendered++;
+}
+
+static void renderSlot(int idx) {
+  TRACE_SCOPE(TRACE_RENDER);
+  uint32_t t0;
+  frameStatsBegin(t0);
+
+  bool full = refreshSchedulerWantFull(s_slotFull[idx], s_models[idx].cycleStartUtc);
+  if (!uiRenderMainScreen(s_models[idx], full, s_slotTimeOnly[idx])) {
+    busySpanFlush();
+    s_framesPreempted++;
+    return;
+  }
+
+  frameStatsEnd(t0);
+  if (s_slotBootMark[idx]) {
+    bootMark(s_slotBootMark[idx]);
+    s_slotBootMark[idx] = nullptr;
+  }
+}
+
+static void renderInput(const UiMenuModel& m, bool full) {
+  TRACE_SCOPE(TRACE_RENDER);
+  uint32_t t0;
+  frameStatsBegin(t0);
+
+  uiRenderMenu(m, full);
+
+  frameStatsEnd(t0);
+  s_inputFrames++;
+}
+
+#if RENDER_TASK_ENABLE
+static void renderTaskMain(void* arg) {
+  (void)arg;
+  while (true) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+ // Drain: input first, then the newest released main-screen snapshot.
+    while (true) {
+      xSemaphoreTakeRecursive(s_displayLock, portMAX_DELAY);
+
+      xSemaphoreTake(s_stateLock, portMAX_DELAY);
+      bool input = s_inputPending;
+      bool full  = s_inputFull;
+      int  idx   = -1;
+      if (input) {
+        s_inputDraw      = s_inputModel;
+        s_inputPending   = false;
+        s_inputRendering = true;
+      } else if (s_pendingIdx >= 0 && !s_pendingHeld) {
+        idx = s_pendingIdx;
+        s_pendingIdx = -1;
+        s_renderIdx  = idx;
+      }
+      xSemaphoreGive(s_stateLock);
+
+      if (!input && idx < 0) {
+        xSemaphoreGiveRecursive(s_displayLock);
+        break;
+      }
+
+      if (input) renderInput(s_inputDraw, full);
+      else       renderSlot(idx);
+
+      xSemaphoreTake(s_stateLock, portMAX_DELAY);
+      s_inputRendering = false;
+      s_renderIdx = -1;
+      xSemaphoreGive(s_stateLock);
+
+      xSemaphoreGiveRecursive(s_displayLock);
+    }
+  }
+}
+#endif
+
+// ==================== Public API =====================
+
+void renderTaskBegin(uint8_t core) {
+  display.epd2.setBusyCallback(epdBusyCallback);
+
+#if RENDER_TASK_ENABLE
+  if (s_task) return;
+
+  s_stateLock   = xSemaphoreCreateMutex();
+  s_displayLock = xSemaphoreCreateRecursiveMutex();
+  s_busySem     = xSemaphoreCreateBinary();
+  if (!s_stateLock || !s_displayLock || !s_busySem) {
+    LOGE(RENDER, "[Render] Failed to create semaphores, staying synchronous");
+    return;
+  }
+
+  attachInterrupt(digitalPinToInterrupt(EPD_BUSY), epdBusyIsr, CHANGE);
+
+  if (core > 1) core = 0;
+  xTaskCreatePinnedToCore(renderTaskMain, "render", 8192, nullptr, 1, &s_task, core);
+  heapMonitorWatchTask(s_task, 8192);
+  LOGI(RENDER, "[Render] Task started on core %u", (unsigned)core);
+#else
+  (void)core;
+  LOGI(RENDER, "[Render] Synchronous rendering (RENDER_TASK_ENABLE=0)");
+#endif
+}
+
+void renderTaskSubmitMain(double priceUsd, double change24h, bool fullRefresh, bool timeOnly) {
+#if RENDER_TASK_ENABLE
+  if (s_task) {
+    xSemaphoreTake(s_stateLock, portMAX_DELAY);
+    int idx = (s_renderIdx == 0) ? 1 : 0;  // never touch the slot being rendered
+    if (s_pendingIdx >= 0) {
+ // Replace the pending frame, but keep its stronger refresh requirements.
+      idx = s_pendingIdx;
+      fullRefresh = fullRefresh || s_slotFull[idx];
+      timeOnly    = timeOnly && s_slotTimeOnly[idx];
+      if (s_pendingHeld) s_framesMerged++;
+      else               s_framesDropped++;
+    } else {
+      s_slotBootMark[idx] = nullptr;
+    }
+    uiCaptureMainModel(s_models[idx], priceUsd, change24h);
+    s_slotFull[idx]     = fullRefresh;
+    s_slotTimeOnly[idx] = timeOnly;
+    s_pendingIdx  = idx;
+    s_pendingHeld = true;  // released by renderTaskFlush() (next loop() pass)
+    xSemaphoreGive(s_stateLock);
+    return;
+  }
+#endif
+
+  DisplayLock lock;
+  uiCaptureMainModel(s_models[0], priceUsd, change24h);
+  s_slotFull[0]     = fullRefresh;
+  s_slotTimeOnly[0] = timeOnly;
+  renderSlot(0);
+}
+
+void renderTaskSubmitInput(uint8_t uiMode, bool fullRefresh) {
+#if RENDER_TASK_ENABLE
+  if (s_task) {
+    UiMenuModel m;
+    if (!uiCaptureMenuModel(m, uiMode)) return;
+
+    xSemaphoreTake(s_stateLock, portMAX_DELAY);
+    if (s_inputPending) {
+      if (s_inputModel.mode == uiMode) fullRefresh = fullRefresh || s_inputFull;
+      s_framesDropped++;
+    }
+    s_inputModel   = m;
+    s_inputPending = true;
+    s_inputFull    = fullRefresh;
+    xSemaphoreGive(s_stateLock);
+
+    xTaskNotifyGive(s_task);
+    return;
+  }
+#endif
+
+  if (!uiCaptureMenuModel(s_inputDraw, uiMode)) return;
+  renderInput(s_inputDraw, fullRefresh);
+}
+
+void renderTaskMarkBootPhase(const char* phase) {
+#if RENDER_TASK_ENABLE
+  if (s_task) {
+    xSemaphoreTake(s_stateLock, portMAX_DELAY);
+    const bool queued = (s_pendingIdx >= 0);
+    if (queued) s_slotBootMark[s_pendingIdx] = phase;
+    xSemaphoreGive(s_stateLock);
+    if (queued) return;
+  }
+#endif
+  bootMark(phase);  // synchronous: the frame is already on the panel
+}
+
+void renderTaskFlush() {
+#if RENDER_TASK_ENABLE
+  if (!s_task) return;
+  xSemaphoreTake(s_stateLock, portMAX_DELAY);
+  bool release = (s_pendingIdx >= 0 && s_pendingHeld);
+  s_pendingHeld = false;
+  xSemaphoreGive(s_stateLock);
+  if (release) xTaskNotifyGive(s_task);
+#endif
+}
+
+void renderTaskCancelPending() {
+#if RENDER_TASK_ENABLE
+  if (!s_task) return;
+  xSemaphoreTake(s_stateLock, portMAX_DELAY);
+  if (s_pendingIdx >= 0) {
+    s_pendingIdx = -1;
+    s_framesCancelled++;
+  }
+  if (s_inputPending) {
+    s_inputPending = false;
+    s_framesCancelled++;
+  }
+  s_pendingHeld = false;
+  xSemaphoreGive(s_stateLock);
+#endif
+}
+
+bool renderTaskWaitIdle(uint32_t timeoutMs) {
+#if RENDER_TASK_ENABLE
+  if (!s_task) return true;
+  renderTaskFlush();
+  uint32_t start = millis();
+  while (true) {
+    xSemaphoreTake(s_stateLock, portMAX_DELAY);
+    bool idle = (s_pendingIdx < 0 && s_renderIdx < 0 &&
+                 !s_inputPending && !s_inputRendering);
+    xSemaphoreGive(s_stateLock);
+    if (idle) return true;
+    if (millis() - start >= timeoutMs) return false;
+    delay(5);
+  }
+#else
+  (void)timeoutMs;
+  return true;
+#endif
+}
+
+bool renderTaskPreempted() {
+#if RENDER_TASK_ENABLE
+  if (!onRenderTask()) return false;
+  return s_inputPending || s_syncWaiting;
+#else
+  return false;
+#endif
+}
+
+void renderTaskLogStats() {
+  LOGI(RENDER, "[Render] frames=%lu (input %lu) dropped=%lu merged=%lu cancelled=%lu preempted=%lu "
+               "last=%lums (busy %lums, cpu %lums, %u page(s)) max=%lums",
+               (unsigned long)s_framesRendered, (unsigned long)s_inputFrames,
+               (unsigned long)s_framesDropped, (unsigned long)s_framesMerged,
+               (unsigned long)s_framesCancelled, (unsigned long)s_framesPreempted,
+               (unsigned long)s_lastRenderMs, (unsigned long)s_lastBusyMs,
+               (unsigned long)(s_lastRenderMs - s_lastBusyMs), (unsigned)EpdDisplay::kPages,
+               (unsigned long)s_maxRenderMs);
+}
+
+void renderTaskGetStats(RenderTaskStats& out) {
+  out.framesRendered  = s_framesRendered;
+  out.inputFrames     = s_inputFrames;
+  out.framesDropped   = s_framesDropped;
+  out.framesMerged    = s_framesMerged;
+  out.framesCancelled = s_framesCancelled;
+  out.framesPreempted = s_framesPreempted;
+  out.maxRenderMs     = s_maxRenderMs;
+}
+
+// ==================== DisplayLock =====================
+
+DisplayLock::DisplayLock() : m_held(false) {
+#if RENDER_TASK_ENABLE
+  if (!s_task) return;
+ // Menu redraws dispatched by the render task already own the display.
+  if (onRenderTask()) return;
+  renderTaskCancelPending();
+  s_syncWaiting = true;
+  xSemaphoreTakeRecursive(s_displayLock, portMAX_DELAY);
+  s_syncWaiting = false;
+  m_held = true;
+#endif
+}
+
+DisplayLock::~DisplayLock() {
+#if RENDER_TASK_ENABLE
+  if (m_held) xSemaphoreGiveRecursive(s_displayLock);
+#endif
+}
@@ -7,6 +7,7 @@
 #include <Preferences.h>
 
 #include "settings_store.h"
+#include "profile.h"
 #include "config.h" // DEFAULT_TIMEZONE_INDEX, TIMEZONE_COUNT
 
 static const char* kNvsNamespace = "cryptobar";
@@ -64,11 +65,16 @@ bool settingsStoreLoad(StoredSettings& out) {
     out.dispCur = (int)CURR_USD;
   }
 
+  // V0.99s: Quote source
+  out.quoteMd   = prefs.getInt("quoteMd",   out.quoteMd);
+  if (out.quoteMd < 0 || out.quoteMd > 1) out.quoteMd = 1;
+
   prefs.end();
   return true;
 }
 
 bool settingsStoreSave(const StoredSettings& in) {
+  PROFILE_ZONE("nvs.save");
   Preferences prefs;
   if (!prefs.begin(kNvsNamespace, false)) {
     return false;
@@ -89,6 +95,7 @@ bool settingsStoreSave(const StoredSettings& in) {
   ok &= prefs.putInt("rfMode",    in.rfMode) > 0;
 
   ok &= prefs.putInt("dispCur",  in.dispCur) > 0;
+  ok &= prefs.putInt("quoteMd",  in.quoteMd) > 0;
  // Best-effort cleanup legacy key (not fatal if it fails).
   if (prefs.isKey("coinIndex")) {
     prefs.remove("coinIndex");
@@ -135,6 +142,31 @@ bool settingsStoreClearWifi() {
   return ok;
 }
 
+bool settingsStoreLoadFx(double* rates, size_t count, uint32_t& outUtc) {
+  Preferences prefs;
+  if (!prefs.begin(kNvsNamespace, true)) {
+    return false;
+  }
+  const size_t bytes = count * sizeof(double);
+  bool ok = prefs.getBytesLength("fxRates") == bytes && prefs.getBytes("fxRates", rates, bytes) == bytes;
+  outUtc = prefs.getUInt("fxUtc", 0);
+  prefs.end();
+  return ok;
+}
+
+bool settingsStoreSaveFx(const double* rates, size_t count, uint32_t utc) {
+  PROFILE_ZONE("nvs.save");
+  Preferences prefs;
+  if (!prefs.begin(kNvsNamespace, false)) {
+    return false;
+  }
+  const size_t bytes = count * sizeof(double);
+  bool ok = prefs.putBytes("fxRates", rates, bytes) == bytes;
+  ok &= prefs.putUInt("fxUtc", utc) > 0;
+  prefs.end();
+  return ok;
+}
+
 bool settingsStoreHasTzIndex() {
   Preferences prefs;
   if (!prefs.begin(kNvsNamespace, true)) {
@@ -0,0 +1,284 @@
+// CryptoBar V0.99s (Event trace)
+// trace.cpp - Event ring in RTC memory + Chrome Trace Event JSON export
+#include "trace.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+static_assert((TRACE_RING_EVENTS & (TRACE_RING_EVENTS - 1)) == 0, "TRACE_RING_EVENTS must be a power of two");
+
+// ==================== Event names =====================
+
+struct TraceEventInfo {
+  const char* name;
+  const char* cat;
+  const char* argName;  // end / instant events: exported as args.<argName> (nullptr: no arg)
+};
+
+static const TraceEventInfo kEventInfo[TRACE_EVENT_COUNT] = {
+  { "boot",           "sys",   nullptr },
+  { "prefetch",       "sched", "ok"    },
+  { "fetch.cg",       "net",   nullptr },
+  { "fetch.cp",       "net",   nullptr },
+  { "fetch.kraken",   "net",   nullptr },
+  { "fetch.binance",  "net",   nullptr },
+  { "fetch.fx",       "net",   nullptr },
+  { "history",        "net",   nullptr },
+  { "parse",          "net",   "bytes" },
+  { "render",         "epd",   nullptr },
+  { "panel.busy",     "epd",   nullptr },
+  { "ntp.sync",       "time",  "ok"    },
+  { "ntp.update",     "time",  nullptr },
+  { "wifi.connect",   "wifi",  "ok"    },
+};
+
+// ==================== Ring (RTC no-init) =====================
+//
+// Power-on leaves garbage here; the magic/version/bounds check at traceBegin()
+// resets it. Software resets keep it, and traceBegin() only bumps the boot number.
+
+#define TRACE_MAX_TASKS 8
+#define TRACE_TASK_NAME 12
+
+static const uint32_t kRingMagic   = 0x31525443;  // "CTR1"
+static const uint16_t kRingVersion = 1;
+static const uint32_t kMask        = TRACE_RING_EVENTS - 1;
+
+struct TraceRecord {
+  uint32_t ts;   // micros() since boot
+  uint32_t arg;  // 'X': duration (us), 'E' / 'i': argument
+  uint8_t  id;
+  uint8_t  ph;   // 'B', 'E', 'X', 'i'
+  uint8_t  tid;  // index into taskNames
+  uint8_t  boot;
+};
+static_assert(sizeof(TraceRecord) == 12, "TraceRecord layout changed");
+
+struct TraceRing {
+  uint32_t    magic;
+  uint16_t    version;
+  uint8_t     boot;
+  uint8_t     taskCount;
+  uint32_t    head;  // events written (index = head & kMask)
+  char        taskNames[TRACE_MAX_TASKS][TRACE_TASK_NAME];
+  TraceRecord events[TRACE_RING_EVENTS];
+};
+
+RTC_NOINIT_ATTR static TraceRing s_ring;
+
+static bool         s_ready = false;
+static portMUX_TYPE s_mux   = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_taskHandles[TRACE_MAX_TASKS];  // this boot's handle per taskNames slot
+static uint32_t   (*s_clock)() = nullptr;
+
+uint32_t traceNowUs() {
+  return s_clock ? s_clock() : (uint32_t)micros();
+}
+
+void traceSetClock(uint32_t (*nowUs)()) {
+  s_clock = nowUs;
+}
+
+void traceBegin() {
+#if TRACE_ENABLE
+  if (s_ring.magic != kRingMagic || s_ring.version != kRingVersion || s_ring.taskCount > TRACE_MAX_TASKS) {
+    memset(&s_ring, 0, sizeof(s_ring));
+    s_ring.magic   = kRingMagic;
+    s_ring.version = kRingVersion;
+  }
+  s_ring.boot++;
+  s_ready = true;
+  traceInstant(TRACE_BOOT);
+#endif
+}
+
+#if TRACE_ENABLE
+
+// Task slot of the caller. Names persist across boots, so a task keeps its
+// thread id in the exported trace; the last slot is shared once the table is full.
+static uint8_t taskSlot() {
+  TaskHandle_t h = xTaskGetCurrentTaskHandle();
+  const uint8_t n = s_ring.taskCount;
+  for (uint8_t i = 0; i < n; i++) {
+    if (s_taskHandles[i] == h) return i;
+  }
+
+  const char* name = pcTaskGetName(h);
+  if (!name) name = "?";
+  uint8_t slot = TRACE_MAX_TASKS - 1;
+  portENTER_CRITICAL(&s_mux);
+  bool found = false;
+  for (uint8_t i = 0; i < s_ring.taskCount; i++) {
+    if (strncmp(s_ring.taskNames[i], name, TRACE_TASK_NAME - 1) == 0) {
+      slot = i;
+      found = true;
+      break;
+    }
+  }
+  if (!found && s_ring.taskCount < TRACE_MAX_TASKS) {
+    slot = s_ring.taskCount++;
+    strncpy(s_ring.taskNames[slot], name, TRACE_TASK_NAME - 1);
+    s_ring.taskNames[slot][TRACE_TASK_NAME - 1] = '\0';
+    found = true;
+  }
+  if (found) s_taskHandles[slot] = h;
+  portEXIT_CRITICAL(&s_mux);
+  return slot;
+}
+
+static void push(TraceEventId id, char ph, uint32_t ts, uint32_t arg) {
+  if (!s_ready || id >= TRACE_EVENT_COUNT) return;
+  const uint8_t tid = taskSlot();
+  portENTER_CRITICAL(&s_mux);
+  TraceRecord& r = s_ring.events[s_ring.head & kMask];
+  r.ts   = ts;
+  r.arg  = arg;
+  r.id   = (uint8_t)id;
+  r.ph   = (uint8_t)ph;
+  r.tid  = tid;
+  r.boot = s_ring.boot;
+  s_ring.head++;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+#endif  // TRACE_ENABLE
+
+void traceBeginEvent(TraceEventId id) {
+#if TRACE_ENABLE
+  push(id, 'B', traceNowUs(), 0);
+#else
+  (void)id;
+#endif
+}
+
+void traceEndEvent(TraceEventId id, uint32_t arg) {
+#if TRACE_ENABLE
+  push(id, 'E', traceNowUs(), arg);
+#else
+  (void)id; (void)arg;
+#endif
+}
+
+void traceInstant(TraceEventId id, uint32_t arg) {
+#if TRACE_ENABLE
+  push(id, 'i', traceNowUs(), arg);
+#else
+  (void)id; (void)arg;
+#endif
+}
+
+void traceComplete(TraceEventId id, uint32_t startUs, uint32_t durUs) {
+#if TRACE_ENABLE
+  push(id, 'X', startUs, durUs);
+#else
+  (void)id; (void)startUs; (void)durUs;
+#endif
+}
+
+// ==================== Chrome Trace Event JSON =====================
+
+namespace {
+
+struct JsonOut {
+  TraceSink sink;
+  void*     ctx;
+  size_t    total;
+  bool      ok;
+  size_t    len;
+  char      buf[512];
+
+  void flush() {
+    if (ok && len > 0) {
+      ok = sink((const uint8_t*)buf, len, ctx);
+      if (ok) total += len;
+    }
+    len = 0;
+  }
+
+  __attribute__((format(printf, 2, 3))) void add(const char* fmt, ...) {
+    if (!ok) return;
+    if (len > sizeof(buf) - 200) flush();
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf + len, sizeof(buf) - len, fmt, ap);
+    va_end(ap);
+    if (n > 0) len += ((size_t)n < sizeof(buf) - len) ? (size_t)n : sizeof(buf) - len - 1;
+  }
+};
+
+}  // namespace
+
+size_t traceExport(TraceSink sink, void* ctx) {
+  JsonOut out;
+  out.sink  = sink;
+  out.ctx   = ctx;
+  out.total = 0;
+  out.ok    = true;
+  out.len   = 0;
+
+  out.add("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+#if TRACE_ENABLE
+  // Snapshot so tasks can keep tracing while the export streams out.
+  TraceRecord* snap = s_ready ? (TraceRecord*)malloc(sizeof(s_ring.events)) : nullptr;
+  if (snap) {
+    char     names[TRACE_MAX_TASKS][TRACE_TASK_NAME];
+    uint8_t  taskCount;
+    uint32_t head;
+    portENTER_CRITICAL(&s_mux);
+    memcpy(snap, s_ring.events, sizeof(s_ring.events));
+    memcpy(names, s_ring.taskNames, sizeof(names));
+    taskCount = s_ring.taskCount;
+    head      = s_ring.head;
+    portEXIT_CRITICAL(&s_mux);
+
+    const uint32_t count = (head < TRACE_RING_EVENTS) ? head : TRACE_RING_EVENTS;
+    bool     first   = true;
+    int      curBoot = -1;
+    uint64_t extTs   = 0;  // 64-bit time of the previous event in this boot (micros() wraps at ~71 min)
+
+    for (uint32_t i = head - count; i != head && out.ok; i++) {
+      const TraceRecord& r = snap[i & kMask];
+      if (r.id >= TRACE_EVENT_COUNT) continue;
+      const char ph = (char)r.ph;
+      if (ph != 'B' && ph != 'E' && ph != 'X' && ph != 'i') continue;
+
+      if ((int)r.boot != curBoot) {
+        curBoot = r.boot;
+        extTs   = r.ts;
+        out.add("%s{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"boot %u\"}}",
+                first ? "" : ",", (unsigned)curBoot, (unsigned)curBoot);
+        out.add(",{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"sort_index\":%u}}",
+                (unsigned)curBoot, (unsigned)curBoot);
+        for (uint8_t t = 0; t < taskCount; t++) {
+          out.add(",{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%.*s\"}}",
+                  (unsigned)curBoot, (unsigned)t, TRACE_TASK_NAME, names[t]);
+        }
+        first = false;
+      } else {
+        extTs += (int64_t)(int32_t)(r.ts - (uint32_t)extTs);  // signed delta: wraps forward, tolerates reordering
+      }
+
+      const TraceEventInfo& info = kEventInfo[r.id];
+      out.add(",{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%llu,\"pid\":%u,\"tid\":%u",
+              info.name, info.cat, ph, (unsigned long long)extTs, (unsigned)r.boot, (unsigned)r.tid);
+      if (ph == 'X') {
+        out.add(",\"dur\":%lu}", (unsigned long)r.arg);
+      } else {
+        if (ph == 'i') out.add(",\"s\":\"t\"");
+        if (ph != 'B' && info.argName) out.add(",\"args\":{\"%s\":%lu}", info.argName, (unsigned long)r.arg);
+        out.add("}");
+      }
+    }
+    free(snap);
+  }
+#endif
+
+  out.add("]}\n");
+  out.flush();
+  return out.total;
+}
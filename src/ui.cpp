@@ -1,7 +1,8 @@
 #include <Arduino.h>
 #include <time.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
+#include <Adafruit_GFX.h>
 #include <Fonts/FreeSansBold9pt7b.h>
 #include <Fonts/FreeSansBold12pt7b.h>
 #include <Fonts/FreeSansBold18pt7b.h>
@@ -12,13 +13,14 @@
 #include "app_state.h"
 #include "coins.h"
 #include "chart.h"
+#include "chart_raster.h"
 #include "ui.h"
+#include "render_task.h"
+#include "app_log.h"
+#include "profile.h"
 
 // ===== Global objects and variables from main.cpp (extern declarations) =====
 
-// e-paper display object
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
-
 // Layout: left symbol panel width
 extern const int SYMBOL_PANEL_WIDTH;
 
@@ -29,8 +31,8 @@ extern int   g_dtSize; // 0=Small, 1=Large
 
 // Large mode: shift right-side content down slightly for comfortable date/time spacing.
 // Note: This offset affects dt/price/chart together to maintain consistent spacing.
-static inline int16_t largeContentYOffset() {
-  return (g_dtSize == 1) ? 8 : 0;
+static inline int16_t largeContentYOffset(const UiMainModel& m) {
+  return (m.dtSize == 1) ? 8 : 0;
 }
 extern int   g_timezoneIndex;
 #include "day_avg.h"
@@ -71,8 +73,8 @@ const CoinInfo& currentCoin();
 
 // ===== Date/Time formatting =====
 
-static void formatDateString(char* buf, size_t bufSize, const struct tm& local) {
-  switch (g_dateFormatIndex) {
+static void formatDateString(char* buf, size_t bufSize, const struct tm& local, int dateFormat) {
+  switch (dateFormat) {
     case DATE_DD_MM_YYYY:
       strftime(buf, bufSize, "%d/%m/%Y", &local);
       break;
@@ -88,8 +90,8 @@ static void formatDateString(char* buf, size_t bufSize, const struct tm& local)
 
 static void formatTimeString(char* timeBuf, size_t timeSize,
                              char* ampmBuf, size_t ampmSize,
-                             const struct tm& local) {
-  if (g_timeFormat == TIME_24H) {
+                             const struct tm& local, int timeFormat) {
+  if (timeFormat == TIME_24H) {
     strftime(timeBuf, timeSize, "%H:%M", &local);
     ampmBuf[0] = '\0';
   } else {
@@ -104,16 +106,15 @@ static void formatTimeString(char* timeBuf, size_t timeSize,
 
 // Small date/time display (top-left small text)
 // Note: Small/Large both respect date/time format settings; differ only in font and position
-static void drawHeaderDateTimeSmall() {
+static void drawHeaderDateTimeSmall(const UiMainModel& m) {
   char dateBuf[20] = "--/--/----";
   char timeBuf[16] = "--:--";
   char ampmBuf[4]  = "";
   char fullTimeBuf[24] = "--:--";   // time + optional AM/PM
 
-  struct tm local;
-  if (getLocalTimeLocal(&local)) {
-    formatDateString(dateBuf, sizeof(dateBuf), local);
-    formatTimeString(timeBuf, sizeof(timeBuf), ampmBuf, sizeof(ampmBuf), local);
+  if (m.timeOk) {
+    formatDateString(dateBuf, sizeof(dateBuf), m.local, m.dateFormat);
+    formatTimeString(timeBuf, sizeof(timeBuf), ampmBuf, sizeof(ampmBuf), m.local, m.timeFormat);
   }
 
  // Combine time string with AM/PM
@@ -152,18 +153,17 @@ static void drawHeaderDateTimeSmall() {
 
 // Centered large date/time (Large mode)
 // Goal: equal spacing between date/time ↔ price ↔ chart; date/time can be slightly compressed near top edge of white panel
-static void drawHeaderDateTimeLarge() {
-  const int16_t yOff = largeContentYOffset();
+static void drawHeaderDateTimeLarge(const UiMainModel& m) {
+  const int16_t yOff = largeContentYOffset(m);
   char dateBuf[20] = "--/--/----";
   char timeBuf[16] = "--:--";
   char ampmBuf[4]  = "";
   char fullTimeBuf[24] = "--:--";
   char dtBuf[64] = "--/--/---- --:--";
 
-  struct tm local;
-  if (getLocalTimeLocal(&local)) {
-    formatDateString(dateBuf, sizeof(dateBuf), local);
-    formatTimeString(timeBuf, sizeof(timeBuf), ampmBuf, sizeof(ampmBuf), local);
+  if (m.timeOk) {
+    formatDateString(dateBuf, sizeof(dateBuf), m.local, m.dateFormat);
+    formatTimeString(timeBuf, sizeof(timeBuf), ampmBuf, sizeof(ampmBuf), m.local, m.timeFormat);
   }
 
   if (ampmBuf[0]) {
@@ -234,67 +234,68 @@ static void drawHeaderDateTimeLarge() {
 }
 
 // Header wrapper: switch between Small / Large based on dtSize
-static void drawHeaderDateTime() {
-  if (g_dtSize == 1) {
-    drawHeaderDateTimeLarge();
+static void drawHeaderDateTime(const UiMainModel& m) {
+  if (m.dtSize == 1) {
+    drawHeaderDateTimeLarge(m);
   } else {
-    drawHeaderDateTimeSmall();
+    drawHeaderDateTimeSmall(m);
   }
 }
 
 // V0.99m: Left black panel: price API + currency + coin symbol + 24h change + history API
-static void drawSymbolPanel(const char* symbol, float change24h) {
-  int panelWidth = SYMBOL_PANEL_WIDTH;
-
-  display.fillRect(0, 0, panelWidth, display.height(), GxEPD_BLACK);
-  display.setTextColor(GxEPD_WHITE);
+// ==================== Symbol panel (V0.99s: cached static layer) =====================
+// The black panel's labels (price API, currency, ticker, history API) only change
+// with settings / API fallbacks, so they are rasterized once into a 1-bpp bitmap
+// (set bit = white text) and composited on every frame; only change% is drawn live.
+
+struct SymbolPanelLayout {
+  int16_t apiX, apiY;
+  int16_t currX, currY;
+  int16_t sx, sy;
+  int16_t cy;            // change% baseline (x depends on the text)
+  int16_t histX, histY;
+};
+
+static GFXcanvas1* s_panelCanvas = nullptr;
+static bool        s_panelValid  = false;
+static char        s_panelKey[64];
+static int16_t     s_panelChangeY = 0;
+
+// Same layout as before V0.99s: BTC centered, other elements stacked around it.
+// Uses the change% text height (cH) but not its width.
+static void layoutSymbolPanel(Adafruit_GFX& gfx, const UiMainModel& m,
+                              uint16_t cH, SymbolPanelLayout& out) {
+  const int panelWidth = SYMBOL_PANEL_WIDTH;
 
   const GFXfont* bigFont   = &FreeSansBold18pt7b;
   const GFXfont* smallFont = &FreeSansBold9pt7b;
 
-  // V0.99m: API source labels (dynamic, updated by network.cpp)
-  const char* priceApiLabel = g_currentPriceApi;      // Real-time price data source
-  const char* historyApiLabel = g_currentHistoryApi;  // Historical data source
-
-  // Get bounds for all elements
-
   // Price API label bounds (extra small font - default 6x8)
-  display.setFont();  // Use default 6x8 font for extra small text
-  display.setTextSize(1);
+  gfx.setFont();  // Use default 6x8 font for extra small text
+  gfx.setTextSize(1);
   int16_t apiX1, apiY1;
   uint16_t apiW, apiH;
-  display.getTextBounds(priceApiLabel, 0, 0, &apiX1, &apiY1, &apiW, &apiH);
+  gfx.getTextBounds(m.priceApi, 0, 0, &apiX1, &apiY1, &apiW, &apiH);
 
   // Currency code bounds (small font)
-  const CurrencyInfo& curr = CURRENCY_INFO[g_displayCurrency];
-  const char* currCode = curr.code;  // Just the code, no symbol
-
-  display.setFont(smallFont);
+  const char* currCode = CURRENCY_INFO[m.displayCurrency].code;  // Just the code, no symbol
+  gfx.setFont(smallFont);
   int16_t currX1, currY1;
   uint16_t currW, currH;
-  display.getTextBounds(currCode, 0, 0, &currX1, &currY1, &currW, &currH);
+  gfx.getTextBounds(currCode, 0, 0, &currX1, &currY1, &currW, &currH);
 
   // Coin symbol bounds (big font)
-  display.setFont(bigFont);
+  gfx.setFont(bigFont);
   int16_t sx1, sy1;
   uint16_t sW, sH;
-  display.getTextBounds(symbol, 0, 0, &sx1, &sy1, &sW, &sH);
-
-  // Change percentage bounds (small font)
-  char changeBuf[24];
-  snprintf(changeBuf, sizeof(changeBuf), "%+.2f%%", change24h);
-
-  display.setFont(smallFont);
-  int16_t cx1, cy1;
-  uint16_t cW, cH;
-  display.getTextBounds(changeBuf, 0, 0, &cx1, &cy1, &cW, &cH);
+  gfx.getTextBounds(m.ticker, 0, 0, &sx1, &sy1, &sW, &sH);
 
   // History API label bounds (extra small font - default 6x8)
-  display.setFont();
-  display.setTextSize(1);
+  gfx.setFont();
+  gfx.setTextSize(1);
   int16_t histX1, histY1;
   uint16_t histW, histH;
-  display.getTextBounds(historyApiLabel, 0, 0, &histX1, &histY1, &histW, &histH);
+  gfx.getTextBounds(m.historyApi, 0, 0, &histX1, &histY1, &histW, &histH);
 
   // Calculate vertical layout with BTC centered in black panel (128px height)
   // Spacing: topApiGap=22px, normalGap=7px, bottomApiGap=4px
@@ -305,55 +306,138 @@ static void drawSymbolPanel(const char* symbol, float change24h) {
   // Center BTC symbol at display midpoint
   // BTC baseline calculation: center - sy1 - sH/2 (to position visual center at midpoint)
   int16_t btcCenter = display.height() / 2;  // 64 for 128px display
-  int16_t sy = btcCenter - sy1 - sH / 2;
-  int16_t sx = (panelWidth - sW) / 2;
-
-  // Calculate baselines using spacing formula:
-  // Upper element: current_baseline - (current_height + gap)
-  // Lower element: current_baseline + (gap + element_height)
+  out.sy = btcCenter - sy1 - sH / 2;
+  out.sx = (panelWidth - sW) / 2;
 
   // USD baseline (above BTC): BTC_baseline - (BTC_height + gap)
-  int16_t currY = sy - sH - normalGap;
-  int16_t currX = (panelWidth - currW) / 2;
+  out.currY = out.sy - sH - normalGap;
+  out.currX = (panelWidth - currW) / 2;
 
   // Paprika baseline (above USD): USD_baseline - (USD_height + gap)
-  int16_t apiY = currY - currH - topApiGap;
-  int16_t apiX = (panelWidth - apiW) / 2;
+  out.apiY = out.currY - currH - topApiGap;
+  out.apiX = (panelWidth - apiW) / 2;
 
   // Change% baseline (below BTC): BTC_baseline + (gap + change_height)
-  int16_t cy = sy + normalGap + cH;
-  int16_t cx = (panelWidth - cW) / 2;
+  out.cy = out.sy + normalGap + cH;
 
   // CoinGecko baseline (below %): change_baseline + (change_height + gap)
-  int16_t histY = cy + cH + bottomApiGap;
-  int16_t histX = (panelWidth - histW) / 2;
+  out.histY = out.cy + cH + bottomApiGap;
+  out.histX = (panelWidth - histW) / 2;
+}
+
+// Draw the four static labels in 'color' (white on the display, 1 on the canvas).
+static void drawSymbolPanelStatic(Adafruit_GFX& gfx, const UiMainModel& m,
+                                  const SymbolPanelLayout& l, uint16_t color) {
+  gfx.setTextColor(color);
 
   // Draw price API label (top, extra small)
-  display.setFont();
-  display.setTextSize(1);
-  display.setCursor(apiX, apiY);
-  display.print(priceApiLabel);
+  gfx.setFont();
+  gfx.setTextSize(1);
+  gfx.setCursor(l.apiX, l.apiY);
+  gfx.print(m.priceApi);
 
   // Draw currency code
-  display.setFont(smallFont);
-  display.setCursor(currX, currY);
-  display.print(currCode);
+  gfx.setFont(&FreeSansBold9pt7b);
+  gfx.setCursor(l.currX, l.currY);
+  gfx.print(CURRENCY_INFO[m.displayCurrency].code);
 
   // Draw coin symbol (centered in black panel)
-  display.setFont(bigFont);
-  display.setCursor(sx, sy);
-  display.print(symbol);
-
-  // Draw change percentage
-  display.setFont(smallFont);
-  display.setCursor(cx, cy);
-  display.print(changeBuf);
+  gfx.setFont(&FreeSansBold18pt7b);
+  gfx.setCursor(l.sx, l.sy);
+  gfx.print(m.ticker);
 
   // Draw history API label (bottom, extra small)
-  display.setFont();
+  gfx.setFont();
+  gfx.setTextSize(1);
+  gfx.setCursor(l.histX, l.histY);
+  gfx.print(m.historyApi);
+}
+
+// Build (if the key changed) the cached static layer. Returns false when no
+// bitmap is available (allocation failed) and the caller must draw directly.
+static bool ensureSymbolPanelCache(const UiMainModel& m, uint16_t cH) {
+  char key[sizeof(s_panelKey)];
+  snprintf(key, sizeof(key), "%s|%s|%s|%s|%u", m.ticker,
+           CURRENCY_INFO[m.displayCurrency].code, m.priceApi, m.historyApi, (unsigned)cH);
+  if (s_panelValid && strcmp(key, s_panelKey) == 0) return true;
+
+  if (!s_panelCanvas) {
+    s_panelCanvas = new GFXcanvas1(SYMBOL_PANEL_WIDTH, display.height());
+    if (!s_panelCanvas || !s_panelCanvas->getBuffer()) {
+      LOGW(RENDER, "[UI] Symbol panel cache allocation failed, drawing directly");
+      delete s_panelCanvas;
+      s_panelCanvas = nullptr;
+      return false;
+    }
+    // Measure/print like the 296px-wide display did (no wrap at the 90px canvas edge)
+    s_panelCanvas->setTextWrap(false);
+  }
+
+  SymbolPanelLayout l;
+  layoutSymbolPanel(*s_panelCanvas, m, cH, l);
+  s_panelCanvas->fillScreen(0);
+  drawSymbolPanelStatic(*s_panelCanvas, m, l, 1);
+
+  s_panelChangeY = l.cy;
+  snprintf(s_panelKey, sizeof(s_panelKey), "%s", key);
+  s_panelValid = true;
+  return true;
+}
+
+// Black background, then white runs from the bitmap (empty bytes are skipped).
+static void compositeSymbolPanel() {
+  const int w = SYMBOL_PANEL_WIDTH;
+  const int h = display.height();
+  const int stride = (w + 7) / 8;
+  const uint8_t* buf = s_panelCanvas->getBuffer();
+
+  display.fillRect(0, 0, w, h, GxEPD_BLACK);
+  for (int y = 0; y < h; ++y) {
+    const uint8_t* row = &buf[y * stride];
+    int x = 0;
+    while (x < w) {
+      uint8_t v = row[x >> 3];
+      if (!v && (x & 7) == 0) { x += 8; continue; }
+      if (!(v & (0x80 >> (x & 7)))) { ++x; continue; }
+      int runStart = x;
+      while (x < w && (row[x >> 3] & (0x80 >> (x & 7)))) ++x;
+      display.drawFastHLine(runStart, y, x - runStart, GxEPD_WHITE);
+    }
+  }
+}
+
+static void drawSymbolPanel(const UiMainModel& m) {
+  const float change24h = (float)m.change24h;
+  int panelWidth = SYMBOL_PANEL_WIDTH;
+
+  // Change percentage bounds (small font)
+  char changeBuf[24];
+  snprintf(changeBuf, sizeof(changeBuf), "%+.2f%%", change24h);
+
+  display.setFont(&FreeSansBold9pt7b);
   display.setTextSize(1);
-  display.setCursor(histX, histY);
-  display.print(historyApiLabel);
+  int16_t cx1, cy1;
+  uint16_t cW, cH;
+  display.getTextBounds(changeBuf, 0, 0, &cx1, &cy1, &cW, &cH);
+
+  int16_t cy;
+  if (ensureSymbolPanelCache(m, cH)) {
+    compositeSymbolPanel();
+    cy = s_panelChangeY;
+  } else {
+    SymbolPanelLayout l;
+    layoutSymbolPanel(display, m, cH, l);
+    display.fillRect(0, 0, panelWidth, display.height(), GxEPD_BLACK);
+    drawSymbolPanelStatic(display, m, l, GxEPD_WHITE);
+    cy = l.cy;
+  }
+
+  // Draw change percentage (the only per-tick element)
+  int16_t cx = (panelWidth - cW) / 2;
+  display.setTextColor(GxEPD_WHITE);
+  display.setFont(&FreeSansBold9pt7b);
+  display.setCursor(cx, cy);
+  display.print(changeBuf);
 
   display.setTextColor(GxEPD_BLACK);
 }
@@ -388,19 +472,15 @@ static int detectDecimalPlaces(double price, int maxDecimals) {
 }
 
 // V0.99f: Center price display with multi-currency support (number only)
-static void drawPriceCenter(double priceUsd) {
+static void drawPriceCenter(const UiMainModel& m) {
   int panelLeft  = SYMBOL_PANEL_WIDTH;
   int panelWidth = display.width() - panelLeft;
 
-  // Convert for display if needed
-  double fx = 1.0;
-  if (g_displayCurrency != (int)CURR_USD && g_displayCurrency < (int)CURR_COUNT) {
-    fx = g_usdToRate[g_displayCurrency];
-  }
-  double price = priceUsd * fx;
+  // Convert for display if needed (rate captured in the model)
+  double price = m.priceUsd * m.fxRate;
 
   // Get currency metadata
-  const CurrencyInfo& curr = CURRENCY_INFO[g_displayCurrency];
+  const CurrencyInfo& curr = CURRENCY_INFO[m.displayCurrency];
 
   // V0.99p: Length-based decimal precision (auto-adjust for display width)
   // All currencies use same logic: 4 → 2 → 0 decimals based on total length
@@ -446,12 +526,12 @@ static void drawPriceCenter(double priceUsd) {
       display.getTextBounds(numBuf, 0, 0, &x1, &y1, &wNum, &hNum);
       if ((int)wNum <= maxNumberW) break;
     }
-    Serial.printf("[UI] Price downgraded to 12pt font: %s\n", numBuf);
+    LOGD(RENDER, "[UI] Price downgraded to 12pt font: %s", numBuf);
   }
 
   // Center the number horizontally
   int16_t xStart = panelLeft + (panelWidth - (int)wNum) / 2;
-  int16_t yBase  = 52 + largeContentYOffset();
+  int16_t yBase  = 52 + largeContentYOffset(m);
 
   // Draw price number only (no currency symbol)
   display.setFont(numFont);
@@ -460,18 +540,16 @@ static void drawPriceCenter(double priceUsd) {
 }
 
 // Main chart (including previous day average reference line)
-static void drawHistoryChart() {
- // V0.97: Chart always stays in USD scale.
- // (Only the big price display converts to NTD; the chart has no unit labels.)
-  const float fx = 1.0f;
-
+// V0.99s: Rasterized by chart_raster (fixed-point mapping, span fill, cached plane)
+static void drawHistoryChart(const UiMainModel& m) {
+ // V0.99s: m.chart / m.refPrice are already in the display currency (see uiCaptureMainModel).
   int panelLeft   = SYMBOL_PANEL_WIDTH;
   int panelRight  = display.width();
-  int chartTop    = 70 + largeContentYOffset();
+  int chartTop    = 70 + largeContentYOffset(m);
   int chartBottom = display.height() - 6;
 
   const int MIN_POINTS_FOR_CHART = 4;
-  if (g_chartSampleCount < MIN_POINTS_FOR_CHART) {
+  if (m.chartCount < MIN_POINTS_FOR_CHART) {
     display.setFont();
     display.setTextSize(1);
     display.setTextColor(GxEPD_BLACK);
@@ -480,77 +558,18 @@ static void drawHistoryChart() {
     return;
   }
 
-    double minP = g_chartSamples[0].price * fx;
-  double maxP = g_chartSamples[0].price * fx;
-  for (int i = 1; i < g_chartSampleCount; ++i) {
-        double p0 = g_chartSamples[i].price * fx;
-    if (p0 < minP) minP = p0;
-    if (p0 > maxP) maxP = p0;
-  }
-
-  if (g_dayAvgMode != DAYAVG_OFF && g_prevDayRefValid) {
-        double p = g_prevDayRefPrice * fx;
-    if (p < minP) minP = p;
-    if (p > maxP) maxP = p;
-  }
-
-  if (minP == maxP) {
-    maxP = minP + 1.0;
-  }
-
-  int chartHeight = chartBottom - chartTop;
-  int chartWidth  = panelRight - panelLeft - 4;
-
-  int yDayAvg = -1;
-  if (g_dayAvgMode != DAYAVG_OFF && g_prevDayRefValid) {
-        double norm = ((g_prevDayRefPrice * fx) - minP) / (maxP - minP);
-    if (norm < 0.0) norm = 0.0;
-    if (norm > 1.0) norm = 1.0;
-    yDayAvg = chartBottom - int(norm * chartHeight);
-  }
-
-  if (yDayAvg >= chartTop && yDayAvg <= chartBottom) {
-    int xStart = panelLeft + 2;
-    int xEnd   = panelRight - 2;
-    int dashLen = 4;
-    int gapLen  = 4;
-    int x = xStart;
-    while (x < xEnd) {
-      int x2 = x + dashLen;
-      if (x2 > xEnd) x2 = xEnd;
-      display.drawLine(x, yDayAvg, x2, yDayAvg, GxEPD_BLACK);
-      x = x2 + gapLen;
-    }
-  }
-
-  int prevX = 0, prevY = 0;
-  for (int i = 0; i < g_chartSampleCount; ++i) {
-    float pos = g_chartSamples[i].pos;
-        double p   = g_chartSamples[i].price * fx;
-
-    if (pos < 0.0f) pos = 0.0f;
-    if (pos > 1.0f) pos = 1.0f;
-
-    int x = panelLeft + 2 + int(pos * (chartWidth - 1));
-    if (x < panelLeft + 2)  x = panelLeft + 2;
-    if (x > panelRight - 2) x = panelRight - 2;
-
-    float norm = (p - minP) / (maxP - minP);
-    if (norm < 0.0f) norm = 0.0f;
-    if (norm > 1.0f) norm = 1.0f;
-
-    int y = chartBottom - int(norm * chartHeight);
+  ChartRect rect;
+  rect.left   = (int16_t)(panelLeft + 2);
+  rect.top    = (int16_t)chartTop;
+  rect.right  = (int16_t)(panelRight - 2);
+  rect.bottom = (int16_t)chartBottom;
 
-    if (i > 0) {
-      display.drawLine(prevX, prevY, x, y, GxEPD_BLACK);
-    }
-    prevX = x;
-    prevY = y;
-  }
+  chartRasterDraw(m.chart, m.chartCount, m.chartGen, m.refShown, m.refPrice, rect);
 }
 
 // Boot splash screen
 void drawSplashScreen(const char* version) {
+  DisplayLock lock;
   const char* title = "CryptoBar";
 
   display.setFullWindow();
@@ -591,6 +610,7 @@ void drawSplashScreen(const char* version) {
 // WiFi provisioning / status screens
 // Preparing AP screen (AP startup can take ~30s on some boards/firmware)
 void drawWifiPreparingApScreen(const char* version, bool fullRefresh) {
+  DisplayLock lock;
   if (fullRefresh) {
     display.setFullWindow();
   } else {
@@ -628,6 +648,7 @@ void drawWifiPreparingApScreen(const char* version, bool fullRefresh) {
 
 // WiFi AP portal instructions screen
 void drawWifiPortalScreen(const char* version, const char* apSsid, const char* apIp, bool fullRefresh) {
+  DisplayLock lock;
   if (fullRefresh) {
     display.setFullWindow();
   } else {
@@ -683,6 +704,7 @@ void drawWifiPortalScreen(const char* version, const char* apSsid, const char* a
 
 // Firmware update confirm screen (enter maintenance AP)
 void drawFirmwareUpdateConfirmScreen(const char* version) {
+  DisplayLock lock;
   display.setFullWindow();
 
   display.firstPage();
@@ -722,6 +744,7 @@ void drawFirmwareUpdateConfirmScreen(const char* version) {
 
 // Firmware update / maintenance AP instructions
 void drawFirmwareUpdateApScreen(const char* version, const char* apSsid, const char* apIp, bool fullRefresh) {
+  DisplayLock lock;
   if (fullRefresh) {
     display.setFullWindow();
   } else {
@@ -779,6 +802,7 @@ void drawFirmwareUpdateApScreen(const char* version, const char* apSsid, const c
 }
 
 void drawWifiConnectingScreen(const char* version, const char* ssid, bool fullRefresh) {
+  DisplayLock lock;
   if (fullRefresh) {
     display.setFullWindow();
   } else {
@@ -822,6 +846,7 @@ void drawWifiConnectingScreen(const char* version, const char* ssid, bool fullRe
 }
 
 void drawWifiConnectFailedScreen(const char* version, bool fullRefresh) {
+  DisplayLock lock;
   if (fullRefresh) {
     display.setFullWindow();
   } else {
@@ -862,6 +887,7 @@ void drawWifiConnectFailedScreen(const char* version, bool fullRefresh) {
 
 void drawWifiInfoScreen(const char* version, const char* mac, const char* staIp,
                         int signalBars, int channel, bool connected) {
+  DisplayLock lock;
   display.setFullWindow();
 
   display.firstPage();
@@ -930,56 +956,107 @@ void drawWifiInfoScreen(const char* version, const char* mac, const char* staIp,
 
 
 
-// Main screen (full / partial refresh)
-void drawMainScreen(double priceUsd, double change24h, bool fullRefresh) {
-  if (fullRefresh) {
-    display.setFullWindow();
-  } else {
-    display.setPartialWindow(SYMBOL_PANEL_WIDTH, 0,
-                             display.width() - SYMBOL_PANEL_WIDTH,
-                             display.height());
-  }
+// ==================== Main screen (V0.99s: model-based) =====================
 
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
+// Chart series in the display currency. g_chartSamples stay in USD, so an FX
+// update never needs the history again; this copy is reconverted in full only
+// when the rate changes, otherwise just the samples written since the last
+// capture (g_chartDirtyFrom) are scaled. Each change bumps s_dispChartGen,
+// which keys the chart raster cache.
+static ChartSample s_dispChart[MAX_CHART_SAMPLES];
+static double      s_dispRate = 0.0;
+static uint32_t    s_dispChartGen = 0;
 
-    drawSymbolPanel(currentCoin().ticker, change24h);
-    drawHeaderDateTime();
-    drawPriceCenter(priceUsd);
-    drawHistoryChart();
+static void refreshDisplayChart(int n, double rate) {
+  int from = g_chartDirtyFrom;
+  if (rate != s_dispRate) {
+    s_dispRate = rate;
+    from = 0;
+  }
+  if (from < n) s_dispChartGen++;
+  for (int i = from; i < n; ++i) {
+    s_dispChart[i].pos   = g_chartSamples[i].pos;
+    s_dispChart[i].price = g_chartSamples[i].price * rate;
+  }
+  g_chartDirtyFrom = MAX_CHART_SAMPLES;
+}
 
-  } while (display.nextPage());
+void uiCaptureMainModel(UiMainModel& m, double priceUsd, double change24h) {
+  m.priceUsd  = priceUsd;
+  m.change24h = change24h;
+  snprintf(m.ticker, sizeof(m.ticker), "%s", currentCoin().ticker);
+  // V0.99s: a fast-boot frame names its source instead of a price API
+  snprintf(m.priceApi, sizeof(m.priceApi), "%s",
+           g_priceStale ? "Cached" : (g_currentPriceApi ? g_currentPriceApi : ""));
+  snprintf(m.historyApi, sizeof(m.historyApi), "%s", g_currentHistoryApi ? g_currentHistoryApi : "");
+
+  int cur = g_displayCurrency;
+  if (cur < 0 || cur >= (int)CURR_COUNT) cur = (int)CURR_USD;
+  m.displayCurrency = cur;
+  m.fxRate = (cur != (int)CURR_USD) ? g_usdToRate[cur] : 1.0;
+
+  m.dtSize     = g_dtSize;
+  m.dateFormat = g_dateFormatIndex;
+  m.timeFormat = g_timeFormat;
+  m.timeOk     = getLocalTimeLocal(&m.local);
+  m.cycleStartUtc = g_cycleInit ? g_cycleStartUtc : 0;
+
+  m.refShown = (g_dayAvgMode != DAYAVG_OFF && g_prevDayRefValid);
+  m.refPrice = g_prevDayRefPrice * m.fxRate;
+
+  int n = g_chartSampleCount;
+  if (n < 0) n = 0;
+  if (n > MAX_CHART_SAMPLES) n = MAX_CHART_SAMPLES;
+  refreshDisplayChart(n, m.fxRate);
+  m.chartCount = n;
+  m.chartGen   = s_dispChartGen;
+  memcpy(m.chart, s_dispChart, (size_t)n * sizeof(ChartSample));
 }
 
-// V0.99q: Time-only refresh (full-area partial refresh)
-// Updates the entire white panel with partial refresh, but only the time actually changes
-// GxEPD2 will only refresh pixels that differ from the previous state
-// This avoids artifacts around the price area and ensures clean time updates
-void drawMainScreenTimeOnly(bool fullRefresh) {
+// Main screen (full / partial refresh)
+// V0.99q: timeOnly=true is the per-minute clock refresh. It uses a full-area partial window
+// over the white panel: GxEPD2 only refreshes pixels that differ (the time), which avoids
+// artifacts around the price area. The black panel is left untouched.
+bool uiRenderMainScreen(const UiMainModel& m, bool fullRefresh, bool timeOnly) {
+  PROFILE_ZONE("draw.main");  // includes the panel refresh (BUSY wait)
   if (fullRefresh) {
     display.setFullWindow();
   } else {
-    // Partial window: entire right-side panel (not just time area)
-    // This prevents partial refresh artifacts bleeding into price/chart areas
     display.setPartialWindow(SYMBOL_PANEL_WIDTH, 0,
                              display.width() - SYMBOL_PANEL_WIDTH,
                              display.height());
   }
 
+  bool firstPass = true;
   display.firstPage();
   do {
-    // Clear and redraw the entire white panel
-    // GxEPD2 compares old vs new pixels and only refreshes what changed (time area)
     display.fillScreen(GxEPD_WHITE);
 
-    // Redraw all content with current data
-    // Only time will change, price/chart data remains the same
-    drawHeaderDateTime();           // Time updates (changes)
-    drawPriceCenter(g_lastPriceUsd);    // Price stays same (no refresh)
-    drawHistoryChart();             // Chart stays same (no refresh)
-
+    if (fullRefresh || !timeOnly) {
+      drawSymbolPanel(m);
+    }
+    drawHeaderDateTime(m);
+    drawPriceCenter(m);
+    drawHistoryChart(m);
+
+ // V0.99s: Newer input is waiting: drop this frame before anything reaches the panel.
+    if (firstPass && renderTaskPreempted()) {
+      display.cancelFrame();
+      return false;
+    }
+    firstPass = false;
   } while (display.nextPage());
+  return true;
+}
+
+void drawMainScreen(double priceUsd, double change24h, bool fullRefresh) {
+  renderTaskSubmitMain(priceUsd, change24h, fullRefresh, false);
+}
+
+// V0.99q: Time-only refresh (full-area partial refresh)
+// Only the time changes; price/chart are redrawn from the same data.
+void drawMainScreenTimeOnly(bool fullRefresh) {
+  renderTaskSubmitMain(g_lastPriceUsd, g_lastChange24h, fullRefresh, true);
 }
 
 // Draw scrollbar (shared by menu / tz menu)
@@ -1,20 +1,18 @@
 #include <Arduino.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 
 #include "coins.h"
+#include "app_state.h"
 #include "ui.h"
 #include "ui_list.h"
-
-// e-paper display object (defined in main.cpp)
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+#include "render_task.h"
 
 // Coin menu state (defined in main.cpp)
 extern int g_coinMenuIndex;
 extern int g_coinMenuTopIndex;
 
-static const int VISIBLE_COIN_LINES = 5;
-static const int COIN_MENU_X        = 8;
+static const int VISIBLE_COIN_LINES = UI_MENU_VISIBLE_LINES;
 
 void ensureCoinMenuVisible() {
   if (g_coinMenuIndex < g_coinMenuTopIndex) {
@@ -30,37 +28,19 @@ void ensureCoinMenuVisible() {
   }
 }
 
-static void printCoinItem(int i) {
+static void formatCoinItem(int i, char* out, size_t len) {
   const CoinInfo& c = coinAt(i);
-  display.print("#");
-  display.print((int)c.marketRank);
-  display.print(" ");
-  display.print(c.ticker);
+  snprintf(out, len, "#%d %s", (int)c.marketRank, c.ticker);
 }
 
-void drawCoinMenu(bool fullRefresh) {
-  if (fullRefresh) {
-    display.setFullWindow();
-  } else {
-    display.setPartialWindow(0, 0, display.width(), display.height());
-  }
-
+void captureCoinMenu(UiMenuModel& m) {
   ensureCoinMenuVisible();
+  uiMenuFillPage(m, coinCount(), g_coinMenuTopIndex, g_coinMenuIndex, formatCoinItem);
+}
 
-  const UiListLayout layout {
-    .x = COIN_MENU_X,
-    .titleY = 30,
-    .listYStart = 54,
-    .lineStep = 18,
-    .trackX = (int)display.width() - 5,
-    .trackTop = 40,
-    .trackBottom = (int)display.height() - 10
-  };
-
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    uiDrawListPage("Coin", layout, coinCount(), g_coinMenuTopIndex,
-                   VISIBLE_COIN_LINES, g_coinMenuIndex, printCoinItem);
-  } while (display.nextPage());
+void drawCoinMenu(bool fullRefresh) {
+  DisplayLock lock;
+  UiMenuModel m;
+  uiCaptureMenuModel(m, UI_MODE_COIN_SUB);
+  uiRenderMenu(m, fullRefresh);
 }
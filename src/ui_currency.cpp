@@ -3,21 +3,19 @@
 
 #include <Arduino.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 
 #include "config.h"
+#include "app_state.h"
 #include "ui.h"
 #include "ui_list.h"
-
-// e-paper display object (defined in main.cpp)
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+#include "render_task.h"
 
 // Currency menu state (defined in app_state.cpp)
 extern int g_currencyMenuIndex;
 extern int g_currencyMenuTopIndex;
 
-static const int VISIBLE_CURRENCY_LINES = 5;
-static const int CURRENCY_MENU_X        = 8;
+static const int VISIBLE_CURRENCY_LINES = UI_MENU_VISIBLE_LINES;
 
 void ensureCurrencyMenuVisible() {
   if (g_currencyMenuIndex < g_currencyMenuTopIndex) {
@@ -33,37 +31,22 @@ void ensureCurrencyMenuVisible() {
   }
 }
 
-static void printCurrencyItem(int i) {
+static void formatCurrencyItem(int i, char* out, size_t len) {
   if (i >= 0 && i < (int)CURR_COUNT) {
     const CurrencyInfo& curr = CURRENCY_INFO[i];
     // Display currency code only (e.g., "USD", "JPY")
-    display.print(curr.code);
+    snprintf(out, len, "%s", curr.code);
   }
 }
 
-void drawCurrencyMenu(bool fullRefresh) {
-  if (fullRefresh) {
-    display.setFullWindow();
-  } else {
-    display.setPartialWindow(0, 0, display.width(), display.height());
-  }
-
+void captureCurrencyMenu(UiMenuModel& m) {
   ensureCurrencyMenuVisible();
+  uiMenuFillPage(m, (int)CURR_COUNT, g_currencyMenuTopIndex, g_currencyMenuIndex, formatCurrencyItem);
+}
 
-  const UiListLayout layout {
-    .x = CURRENCY_MENU_X,
-    .titleY = 30,
-    .listYStart = 54,
-    .lineStep = 18,
-    .trackX = (int)display.width() - 5,
-    .trackTop = 40,
-    .trackBottom = (int)display.height() - 10
-  };
-
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    uiDrawListPage("Currency", layout, (int)CURR_COUNT, g_currencyMenuTopIndex,
-                   VISIBLE_CURRENCY_LINES, g_currencyMenuIndex, printCurrencyItem);
-  } while (display.nextPage());
+void drawCurrencyMenu(bool fullRefresh) {
+  DisplayLock lock;
+  UiMenuModel m;
+  uiCaptureMenuModel(m, UI_MODE_CURRENCY_SUB);
+  uiRenderMenu(m, fullRefresh);
 }
@@ -1,13 +1,11 @@
 #include <Arduino.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 #include <Fonts/FreeSansBold9pt7b.h>
 #include <Fonts/FreeSansBold12pt7b.h>
 
 #include "ui_list.h"
-
-// e-paper display object (defined in main.cpp)
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+#include "render_task.h"
 
 // Draw a simple vertical scrollbar (shared by list pages).
 static void uiDrawScrollbar(int16_t trackX, int16_t trackTop, int16_t trackBottom,
@@ -30,13 +28,29 @@ static void uiDrawScrollbar(int16_t trackX, int16_t trackTop, int16_t trackBotto
   display.fillRect(trackX - 1, barTop, 3, barHeight, GxEPD_BLACK);
 }
 
-void uiDrawListPage(const char* title,
-                    const UiListLayout& layout,
-                    int totalItems,
-                    int firstIndex,
-                    int visibleLines,
-                    int selectedIndex,
-                    UiListPrintItemFn printItem) {
+// ==================== Last drawn page (V0.99s) =====================
+// Pages are identified by their title pointer; frameCount tells whether any
+// other screen was drawn after our last frame.
+static const char* s_lastTitle    = nullptr;
+static int         s_lastTotal    = -1;
+static int         s_lastFirst    = -1;
+static int         s_lastSelected = -1;
+static uint32_t    s_lastFrame    = 0;
+
+// Vertical extent of one list row (baseline-relative, FreeSansBold9pt7b).
+static void uiListRowSpan(const UiListLayout& layout, int row, int16_t& top, int16_t& bottom) {
+  int baseline = layout.listYStart + row * layout.lineStep;
+  top    = (int16_t)(baseline - layout.lineStep + 5);
+  bottom = (int16_t)(baseline + 4);
+}
+
+static void uiDrawListContent(const char* title,
+                              const UiListLayout& layout,
+                              int totalItems,
+                              int firstIndex,
+                              int visibleLines,
+                              int selectedIndex,
+                              UiListPrintItemFn printItem) {
  // Title
   display.setFont(&FreeSansBold12pt7b);
   display.setTextColor(GxEPD_BLACK);
@@ -63,3 +77,59 @@ void uiDrawListPage(const char* title,
   uiDrawScrollbar(layout.trackX, layout.trackTop, layout.trackBottom,
                   totalItems, firstIndex, visibleLines);
 }
+
+void uiDrawListPage(const char* title,
+                    const UiListLayout& layout,
+                    int totalItems,
+                    int firstIndex,
+                    int visibleLines,
+                    int selectedIndex,
+                    UiListPrintItemFn printItem,
+                    bool fullRefresh) {
+  bool cursorOnly = !fullRefresh &&
+                    title == s_lastTitle &&
+                    totalItems == s_lastTotal &&
+                    firstIndex == s_lastFirst &&
+                    selectedIndex != s_lastSelected &&
+                    s_lastSelected >= firstIndex && s_lastSelected < firstIndex + visibleLines &&
+                    selectedIndex >= firstIndex && selectedIndex < firstIndex + visibleLines &&
+                    display.shadow().frameCount() == s_lastFrame;
+
+  if (fullRefresh) {
+    display.setFullWindow();
+  } else if (cursorOnly) {
+ // Rows between old and new cursor (adjacent for a single encoder step).
+    int rowA = s_lastSelected - firstIndex;
+    int rowB = selectedIndex - firstIndex;
+    int16_t top, bottom, topB, bottomB;
+    uiListRowSpan(layout, min(rowA, rowB), top, bottomB);
+    uiListRowSpan(layout, max(rowA, rowB), topB, bottom);
+    if (top < 0) top = 0;
+    if (bottom >= display.height()) bottom = display.height() - 1;
+    display.setPartialWindow(0, top, display.width(), bottom - top + 1);
+  } else {
+    display.setPartialWindow(0, 0, display.width(), display.height());
+  }
+
+ // The whole page is drawn every time; GxEPD2 clips it to the window.
+  bool firstPass = true;
+  display.firstPage();
+  do {
+    display.fillScreen(GxEPD_WHITE);
+    uiDrawListContent(title, layout, totalItems, firstIndex, visibleLines,
+                      selectedIndex, printItem);
+
+ // The cursor already moved on: skip this frame, the newer request redraws.
+    if (firstPass && renderTaskPreempted()) {
+      display.cancelFrame();
+      return;
+    }
+    firstPass = false;
+  } while (display.nextPage());
+
+  s_lastTitle    = title;
+  s_lastTotal    = totalItems;
+  s_lastFirst    = firstIndex;
+  s_lastSelected = selectedIndex;
+  s_lastFrame    = display.shadow().frameCount();
+}
@@ -1,13 +1,12 @@
 #include <Arduino.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 
 #include "coins.h"
 #include "ui.h"
+#include "app_state.h"
 #include "ui_list.h"
-
-// e-paper display object (defined in main.cpp)
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+#include "render_task.h"
 
 // Menu state (defined in main.cpp)
 extern int g_menuIndex;
@@ -25,6 +24,7 @@ extern int g_brightnessPresetIndex;
 extern int g_updatePresetIndex;
 extern int g_refreshMode;
 extern int g_displayCurrency;
+extern int g_quoteMode;
 
 // Labels (defined in main.cpp)
 extern const char* BRIGHTNESS_LABELS[];
@@ -32,6 +32,7 @@ extern const char* UPDATE_PRESET_LABELS[];
 extern const char* DATE_FORMAT_LABELS[];
 extern const char* DTSIZE_LABELS[];
 extern const char* REFRESH_MODE_LABELS[];
+extern const char* QUOTE_MODE_LABELS[];
 
 // Helper (implemented in main.cpp)
 const CoinInfo& currentCoin();
@@ -41,7 +42,7 @@ static const char* CURRENCY_LABELS[] = {
   "USD", "TWD", "EUR", "GBP", "CAD", "JPY", "KRW", "SGD", "AUD"
 };
 
-static const int VISIBLE_MENU_LINES = 5;
+static const int VISIBLE_MENU_LINES = UI_MENU_VISIBLE_LINES;
 static const int MENU_X             = 8;
 
 void ensureMainMenuVisible() {
@@ -55,78 +56,125 @@ void ensureMainMenuVisible() {
     g_menuTopIndex = max(0, MENU_COUNT - VISIBLE_MENU_LINES);
 }
 
-static void printMenuItem(int i) {
+static void formatMenuItem(int i, char* out, size_t len) {
+  const char* label = "";
+  const char* value = nullptr;
   switch (i) {
     case MENU_COIN:
-      display.print("Coin: ");
-      display.print(currentCoin().ticker);
+      label = "Coin: ";
+      value = currentCoin().ticker;
       break;
     case MENU_UPDATE_INTERVAL:
-      display.print("Update: ");
-      display.print(UPDATE_PRESET_LABELS[g_updatePresetIndex]);
+      label = "Update: ";
+      value = UPDATE_PRESET_LABELS[g_updatePresetIndex];
       break;
     case MENU_REFRESH_MODE:
-      display.print("Refresh: ");
-      display.print(REFRESH_MODE_LABELS[g_refreshMode]);
+      label = "Refresh: ";
+      value = REFRESH_MODE_LABELS[g_refreshMode];
       break;
     case MENU_CURRENCY: {
-      display.print("Currency: ");
+      label = "Currency: ";
       int idx = (g_displayCurrency>=0 && g_displayCurrency < (int)CURR_COUNT) ? g_displayCurrency : 0;
       // V0.99f: Display currency code only (e.g., "USD", "TWD")
-      display.print(CURRENCY_INFO[idx].code);
+      value = CURRENCY_INFO[idx].code;
       break;
     }
+    case MENU_QUOTE:
+      label = "Quote: ";
+      value = QUOTE_MODE_LABELS[(g_quoteMode == 0) ? 0 : 1];
+      break;
     case MENU_LED_BRIGHTNESS:
-      display.print("LED: ");
-      display.print(BRIGHTNESS_LABELS[g_brightnessPresetIndex]);
+      label = "LED: ";
+      value = BRIGHTNESS_LABELS[g_brightnessPresetIndex];
       break;
     case MENU_TIME_FORMAT:
-      display.print("Time: ");
-      display.print((g_timeFormat == TIME_24H) ? "24h" : "12h");
+      label = "Time: ";
+      value = (g_timeFormat == TIME_24H) ? "24h" : "12h";
       break;
     case MENU_DATE_FORMAT:
-      display.print("Date: ");
-      display.print(DATE_FORMAT_LABELS[g_dateFormatIndex]);
+      label = "Date: ";
+      value = DATE_FORMAT_LABELS[g_dateFormatIndex];
       break;
     case MENU_DATETIME_SIZE:
-      display.print("DT Size: ");
-      display.print(DTSIZE_LABELS[(g_dtSize >= 0 && g_dtSize < 2) ? g_dtSize : 1]);
+      label = "DT Size: ";
+      value = DTSIZE_LABELS[(g_dtSize >= 0 && g_dtSize < 2) ? g_dtSize : 1];
       break;
     case MENU_TIMEZONE:
-      display.print("Time zone: ");
-      display.print(TIMEZONES[g_timezoneIndex].label);
+      label = "Time zone: ";
+      value = TIMEZONES[g_timezoneIndex].label;
       break;
     case MENU_DAYAVG_LINE:
-      display.print("Day avg: ");
+      label = "Day avg: ";
       switch (g_dayAvgMode) {
-        case DAYAVG_OFF:     display.print("Off");       break;
-        case DAYAVG_ROLLING: display.print("24h mean");  break;
-        case DAYAVG_CYCLE:   display.print("Cycle mean");break;
-        default:             display.print("24h mean");  break;
+        case DAYAVG_OFF:     value = "Off";        break;
+        case DAYAVG_ROLLING: value = "24h mean";   break;
+        case DAYAVG_CYCLE:   value = "Cycle mean"; break;
+        default:             value = "24h mean";   break;
       }
       break;
 
     case MENU_FIRMWARE_UPDATE:
-      display.print("Firmware Update");
+      label = "Firmware Update";
       break;
     case MENU_WIFI_INFO:
-      display.print("WiFi Info");
+      label = "WiFi Info";
       break;
     case MENU_EXIT:
-      display.print("Exit");
+      label = "Exit";
       break;
   }
+  snprintf(out, len, "%s%s", label, value ? value : "");
 }
 
-void drawMenuScreen(bool fullRefresh) {
-  if (fullRefresh) {
-    display.setFullWindow();
-  } else {
-    display.setPartialWindow(0, 0, display.width(), display.height());
+void captureMainMenu(UiMenuModel& m) {
+  ensureMainMenuVisible();
+  uiMenuFillPage(m, MENU_COUNT, g_menuTopIndex, g_menuIndex, formatMenuItem);
+}
+
+// ==================== Shared list-menu capture / render (V0.99s) =====================
+
+void uiMenuFillPage(UiMenuModel& m, int total, int first, int selected, UiMenuFormatFn format) {
+  m.total    = total;
+  m.first    = first;
+  m.selected = selected;
+  for (int row = 0; row < UI_MENU_VISIBLE_LINES; ++row) {
+    m.labels[row][0] = '\0';
+    if (first + row < total) format(first + row, m.labels[row], UI_MENU_LABEL_LEN);
   }
+}
 
-  ensureMainMenuVisible();
+bool uiCaptureMenuModel(UiMenuModel& m, uint8_t uiMode) {
+  m.mode = uiMode;
+  switch (uiMode) {
+    case UI_MODE_MENU:         captureMainMenu(m);     return true;
+    case UI_MODE_TZ_SUB:       captureTimezoneMenu(m); return true;
+    case UI_MODE_COIN_SUB:     captureCoinMenu(m);     return true;
+    case UI_MODE_CURRENCY_SUB: captureCurrencyMenu(m); return true;
+    case UI_MODE_UPDATE_SUB:   captureUpdateMenu(m);   return true;
+    default:                   return false;
+  }
+}
+
+// Page being drawn (uiDrawListPage's callback only gets the item index);
+// only the display owner touches it.
+static const UiMenuModel* s_drawModel = nullptr;
+
+static void printCapturedItem(int i) {
+  int row = i - s_drawModel->first;
+  if (row >= 0 && row < UI_MENU_VISIBLE_LINES) display.print(s_drawModel->labels[row]);
+}
+
+static const char* menuTitle(uint8_t mode) {
+  switch (mode) {
+    case UI_MODE_TZ_SUB:       return "Time zone";
+    case UI_MODE_COIN_SUB:     return "Coin";
+    case UI_MODE_CURRENCY_SUB: return "Currency";
+    case UI_MODE_UPDATE_SUB:   return "Update Interval";
+    default:                   return "Settings";
+  }
+}
 
+void uiRenderMenu(const UiMenuModel& m, bool fullRefresh) {
   const UiListLayout layout {
     .x = MENU_X,
     .titleY = 30,
@@ -137,10 +185,16 @@ void drawMenuScreen(bool fullRefresh) {
     .trackBottom = (int)display.height() - 10
   };
 
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    uiDrawListPage("Settings", layout, MENU_COUNT, g_menuTopIndex,
-                   VISIBLE_MENU_LINES, g_menuIndex, printMenuItem);
-  } while (display.nextPage());
+  s_drawModel = &m;
+  uiDrawListPage(menuTitle(m.mode), layout, m.total, m.first,
+                 UI_MENU_VISIBLE_LINES, m.selected, printCapturedItem,
+                 fullRefresh);
+  s_drawModel = nullptr;
+}
+
+void drawMenuScreen(bool fullRefresh) {
+  DisplayLock lock;
+  UiMenuModel m;
+  uiCaptureMenuModel(m, UI_MODE_MENU);
+  uiRenderMenu(m, fullRefresh);
 }
@@ -1,20 +1,18 @@
 #include <Arduino.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 
 #include "config.h"
+#include "app_state.h"
 #include "ui.h"
 #include "ui_list.h"
-
-// e-paper display object (defined in main.cpp)
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+#include "render_task.h"
 
 // Timezone menu state (defined in main.cpp)
 extern int g_tzMenuIndex;
 extern int g_tzMenuTopIndex;
 
-static const int VISIBLE_TZ_LINES = 5;
-static const int TZ_MENU_X        = 8;
+static const int VISIBLE_TZ_LINES = UI_MENU_VISIBLE_LINES;
 
 void ensureTzMenuVisible() {
   if (g_tzMenuIndex < g_tzMenuTopIndex) {
@@ -27,34 +25,19 @@ void ensureTzMenuVisible() {
     g_tzMenuTopIndex = max(0, TIMEZONE_COUNT - VISIBLE_TZ_LINES);
 }
 
-static void printTimezoneItem(int i) {
+static void formatTimezoneItem(int i, char* out, size_t len) {
   int tzIdx = tzIndexFromDisplayPos(i);
-  display.print(TIMEZONES[tzIdx].label);
+  snprintf(out, len, "%s", TIMEZONES[tzIdx].label);
 }
 
-void drawTimezoneMenu(bool fullRefresh) {
-  if (fullRefresh) {
-    display.setFullWindow();
-  } else {
-    display.setPartialWindow(0, 0, display.width(), display.height());
-  }
-
+void captureTimezoneMenu(UiMenuModel& m) {
   ensureTzMenuVisible();
+  uiMenuFillPage(m, TIMEZONE_COUNT, g_tzMenuTopIndex, g_tzMenuIndex, formatTimezoneItem);
+}
 
-  const UiListLayout layout {
-    .x = TZ_MENU_X,
-    .titleY = 30,
-    .listYStart = 54,
-    .lineStep = 18,
-    .trackX = (int)display.width() - 5,
-    .trackTop = 40,
-    .trackBottom = (int)display.height() - 10
-  };
-
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    uiDrawListPage("Time zone", layout, TIMEZONE_COUNT, g_tzMenuTopIndex,
-                   VISIBLE_TZ_LINES, g_tzMenuIndex, printTimezoneItem);
-  } while (display.nextPage());
+void drawTimezoneMenu(bool fullRefresh) {
+  DisplayLock lock;
+  UiMenuModel m;
+  uiCaptureMenuModel(m, UI_MODE_TZ_SUB);
+  uiRenderMenu(m, fullRefresh);
 }
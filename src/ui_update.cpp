@@ -3,21 +3,18 @@
 
 #include <Arduino.h>
 
-#include <GxEPD2_BW.h>
+#include "epd_display.h"
 
 #include "app_state.h"
 #include "ui.h"
 #include "ui_list.h"
-
-// e-paper display object (defined in main.cpp)
-extern GxEPD2_BW<GxEPD2_290_BS, GxEPD2_290_BS::HEIGHT> display;
+#include "render_task.h"
 
 // Update menu state (defined in app_state.cpp)
 extern int g_updateMenuIndex;
 extern int g_updateMenuTopIndex;
 
-static const int VISIBLE_UPDATE_LINES = 5;
-static const int UPDATE_MENU_X        = 8;
+static const int VISIBLE_UPDATE_LINES = UI_MENU_VISIBLE_LINES;
 
 void ensureUpdateMenuVisible() {
   if (g_updateMenuIndex < g_updateMenuTopIndex) {
@@ -33,36 +30,21 @@ void ensureUpdateMenuVisible() {
   }
 }
 
-static void printUpdateItem(int i) {
+static void formatUpdateItem(int i, char* out, size_t len) {
   if (i >= 0 && i < UPDATE_PRESETS_COUNT) {
     // Display update interval label (e.g., "1m", "3m", "5m", "10m")
-    display.print(UPDATE_PRESET_LABELS[i]);
+    snprintf(out, len, "%s", UPDATE_PRESET_LABELS[i]);
   }
 }
 
-void drawUpdateMenu(bool fullRefresh) {
-  if (fullRefresh) {
-    display.setFullWindow();
-  } else {
-    display.setPartialWindow(0, 0, display.width(), display.height());
-  }
-
+void captureUpdateMenu(UiMenuModel& m) {
   ensureUpdateMenuVisible();
+  uiMenuFillPage(m, UPDATE_PRESETS_COUNT, g_updateMenuTopIndex, g_updateMenuIndex, formatUpdateItem);
+}
 
-  const UiListLayout layout {
-    .x = UPDATE_MENU_X,
-    .titleY = 30,
-    .listYStart = 54,
-    .lineStep = 18,
-    .trackX = (int)display.width() - 5,
-    .trackTop = 40,
-    .trackBottom = (int)display.height() - 10
-  };
-
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    uiDrawListPage("Update Interval", layout, UPDATE_PRESETS_COUNT, g_updateMenuTopIndex,
-                   VISIBLE_UPDATE_LINES, g_updateMenuIndex, printUpdateItem);
-  } while (display.nextPage());
+void drawUpdateMenu(bool fullRefresh) {
+  DisplayLock lock;
+  UiMenuModel m;
+  uiCaptureMenuModel(m, UI_MODE_UPDATE_SUB);
+  uiRenderMenu(m, fullRefresh);
 }
@@ -0,0 +1,280 @@
+// CryptoBar V0.99s (Warm restart)
+// warm_restart.cpp - Versioned, CRC-checked runtime snapshot in no-init RAM
+#include "warm_restart.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "app_log.h"
+#include "app_state.h"
+#include "chart.h"
+#include "coins.h"
+#include "day_avg.h"
+#include "network.h"
+#include "retained_state.h"
+
+// Helper provided by main.cpp (declaration only; definition in main.cpp)
+const CoinInfo& currentCoin();
+
+// ==================== Snapshot =====================
+// .noinit internal RAM; validated as described in retained_state.h.
+
+static const uint32_t kSnapMagic   = 0x31525750;  // "PWR1"
+static const uint16_t kSnapVersion = 2;           // bump when WarmSnapshot changes
+
+struct WarmChartSample {
+  float pos;
+  float price;  // USD
+};
+
+struct WarmMeanSample {
+  uint32_t bucketUtc;
+  float    price;  // USD
+};
+
+struct WarmSnapshot {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t size;      // sizeof(WarmSnapshot): catches a layout change without a version bump
+  uint32_t savedUtc;  // 0 = clock not valid when saved
+  char     firmware[16];  // CRYPTOBAR_VERSION that saved it
+  char     ticker[12];
+
+  double   priceUsd;
+  double   change24h;
+  double   refPrice;
+  uint8_t  refValid;
+  uint8_t  fxValid;
+  uint8_t  prefetchValid;
+  int8_t   quoteCur;
+  uint32_t quoteUtc;
+
+  uint32_t cycleStartUtc;  // 0 = no cycle
+  uint32_t cycleEndUtc;
+
+  double   usdToRate[CURR_COUNT];
+  uint32_t fxUpdatedUtc;
+
+  uint32_t prefetchForUtc;
+  double   prefetchPrice;
+  double   prefetchChange;
+
+  char     priceApi[16];
+  char     historyApi[16];
+
+  uint16_t        chartCount;
+  uint16_t        meanCount;
+  WarmChartSample chart[MAX_CHART_SAMPLES];
+  WarmMeanSample  mean[DAYAVG_ROLLING_MAX];
+
+  uint32_t crc;
+};
+
+__NOINIT_ATTR static WarmSnapshot s_snap;
+
+static bool   s_restored = false;
+static time_t s_savedUtc = 0;
+
+// Restored labels (g_currentPriceApi / g_currentHistoryApi point at string storage)
+static char s_priceApi[16];
+static char s_historyApi[16];
+
+static uint32_t snapCrc(const WarmSnapshot& s) {
+  return retainedCrc(&s, offsetof(WarmSnapshot, crc));
+}
+
+static void copyLabel(char* dst, size_t len, const char* src) {
+  strncpy(dst, src ? src : "", len - 1);
+  dst[len - 1] = '\0';
+}
+
+// ==================== Public API =====================
+
+void warmRestartSave() {
+#if WARM_RESTART_ENABLE
+  WarmSnapshot& s = s_snap;
+  memset(&s, 0, sizeof(s));  // magic stays 0 until the CRC is written
+
+  const time_t nowUtc = time(nullptr);
+  s.version  = kSnapVersion;
+  s.size     = sizeof(WarmSnapshot);
+  s.savedUtc = (nowUtc >= TIME_VALID_MIN_UTC) ? (uint32_t)nowUtc : 0;
+  copyLabel(s.firmware, sizeof(s.firmware), CRYPTOBAR_VERSION);
+  copyLabel(s.ticker, sizeof(s.ticker), currentCoin().ticker);
+
+  s.priceUsd  = g_lastPriceUsd;
+  s.change24h = g_lastChange24h;
+  s.refPrice  = g_prevDayRefPrice;
+  s.refValid  = g_prevDayRefValid ? 1 : 0;
+
+  int    quoteCur = -1;
+  time_t quoteUtc = 0;
+  fxNativeQuoteGet(quoteCur, quoteUtc);
+  s.quoteCur = (int8_t)quoteCur;
+  s.quoteUtc = (uint32_t)quoteUtc;
+
+  s.cycleStartUtc = g_cycleInit ? (uint32_t)g_cycleStartUtc : 0;
+  s.cycleEndUtc   = g_cycleInit ? (uint32_t)g_cycleEndUtc : 0;
+
+  s.fxValid = g_fxValid ? 1 : 0;
+  memcpy(s.usdToRate, g_usdToRate, sizeof(s.usdToRate));
+  s.fxUpdatedUtc = (uint32_t)g_fxUpdatedUtc;
+
+  s.prefetchValid  = g_prefetchValid ? 1 : 0;
+  s.prefetchForUtc = (uint32_t)g_prefetchForUtc;
+  s.prefetchPrice  = g_prefetchPrice;
+  s.prefetchChange = g_prefetchChange;
+
+  copyLabel(s.priceApi, sizeof(s.priceApi), g_currentPriceApi);
+  copyLabel(s.historyApi, sizeof(s.historyApi), g_currentHistoryApi);
+
+  int n = g_chartSampleCount;
+  if (n < 0) n = 0;
+  if (n > MAX_CHART_SAMPLES) n = MAX_CHART_SAMPLES;
+  for (int i = 0; i < n; i++) {
+    s.chart[i].pos   = g_chartSamples[i].pos;
+    s.chart[i].price = (float)g_chartSamples[i].price;
+  }
+  s.chartCount = (uint16_t)n;
+
+  int m = 0;
+  time_t bucketUtc;
+  double price;
+  while (m < DAYAVG_ROLLING_MAX && dayAvgRollingAt(m, bucketUtc, price)) {
+    s.mean[m].bucketUtc = (uint32_t)bucketUtc;
+    s.mean[m].price     = (float)price;
+    m++;
+  }
+  s.meanCount = (uint16_t)m;
+
+  s.magic = kSnapMagic;
+  s.crc   = snapCrc(s);
+  LOGI(MAIN, "[Warm] Saved %s: %d chart / %d mean samples (%u B)", s.ticker, n, m, (unsigned)sizeof(s));
+#endif
+}
+
+bool warmRestartRestore() {
+#if WARM_RESTART_ENABLE
+  WarmSnapshot& s = s_snap;
+  if (s.magic != kSnapMagic) return false;  // power-on, or no intentional restart
+  const bool intact = s.version == kSnapVersion && s.size == sizeof(WarmSnapshot) && s.crc == snapCrc(s);
+  s.magic = 0;  // consumed: a later crash does not replay it
+
+  if (!intact) {
+    LOGW(MAIN, "[Warm] Snapshot layout / CRC mismatch; ignored");
+    return false;
+  }
+  s.firmware[sizeof(s.firmware) - 1] = '\0';
+  if (strcmp(s.firmware, CRYPTOBAR_VERSION) != 0) {
+    LOGI(MAIN, "[Warm] Snapshot from firmware %s, running %s; ignored", s.firmware, CRYPTOBAR_VERSION);
+    return false;
+  }
+  // The RTC clock survives a software reset. Without it on this side the
+  // age is unknown, so only a snapshot saved without a clock is kept.
+  const time_t nowUtc = time(nullptr);
+  if (s.savedUtc != 0) {
+    const bool clockOk = nowUtc >= TIME_VALID_MIN_UTC && nowUtc >= (time_t)s.savedUtc;
+    if (!clockOk || nowUtc - (time_t)s.savedUtc > (time_t)WARM_RESTART_MAX_AGE_SEC) {
+      LOGI(MAIN, "[Warm] Snapshot too old (or clock lost); ignored");
+      return false;
+    }
+  }
+  s.ticker[sizeof(s.ticker) - 1] = '\0';
+  if (s.chartCount > MAX_CHART_SAMPLES || s.meanCount > DAYAVG_ROLLING_MAX || !(s.priceUsd > 0.0) ||
+      strcmp(s.ticker, currentCoin().ticker) != 0) {
+    LOGI(MAIN, "[Warm] Snapshot for %s not usable for %s; ignored", s.ticker, currentCoin().ticker);
+    return false;
+  }
+
+  for (int i = 0; i < s.chartCount; i++) {
+    g_chartSamples[i].pos   = s.chart[i].pos;
+    g_chartSamples[i].price = (double)s.chart[i].price;
+  }
+  g_chartSampleCount = s.chartCount;
+  g_chartDirtyFrom   = 0;
+
+  // As with the boot cache, updateEtCycle() resets chart and mean once the
+  // clock shows a different ET day.
+  g_cycleInit     = s.cycleStartUtc != 0;
+  g_cycleStartUtc = (time_t)s.cycleStartUtc;
+  g_cycleEndUtc   = (time_t)s.cycleEndUtc;
+
+  dayAvgRollingReset();
+  for (int i = 0; i < s.meanCount; i++) {
+    dayAvgRollingAdd((time_t)s.mean[i].bucketUtc, (double)s.mean[i].price);
+  }
+
+  g_lastPriceUsd    = s.priceUsd;
+  g_lastChange24h   = s.change24h;
+  g_prevDayRefPrice = s.refPrice;
+  g_prevDayRefValid = s.refValid != 0;
+
+  // The NVS table first (it tracks what is stored), then the newer snapshot
+  // table on top (it also carries native-quote rates).
+  bool fxOk = restoreExchangeRates();
+  if (s.fxValid) {
+    bool sane = true;
+    for (int c = 0; c < (int)CURR_COUNT; c++) {
+      if (!(s.usdToRate[c] > 0.001 && s.usdToRate[c] < 1000000.0)) sane = false;
+    }
+    if (sane) {
+      memcpy(g_usdToRate, s.usdToRate, sizeof(g_usdToRate));
+      g_fxUpdatedUtc = (time_t)s.fxUpdatedUtc;
+      fxOk = true;
+    }
+  }
+  if (fxOk) g_fxValid = true;
+  fxNativeQuoteSet(s.quoteCur, (time_t)s.quoteUtc);
+
+  // A prefetch is only worth keeping for a tick that is still ahead.
+  if (s.prefetchValid && nowUtc >= TIME_VALID_MIN_UTC && (time_t)s.prefetchForUtc > nowUtc) {
+    g_prefetchValid  = true;
+    g_prefetchForUtc = (time_t)s.prefetchForUtc;
+    g_prefetchPrice  = s.prefetchPrice;
+    g_prefetchChange = s.prefetchChange;
+  }
+
+  copyLabel(s_priceApi, sizeof(s_priceApi), s.priceApi);
+  copyLabel(s_historyApi, sizeof(s_historyApi), s.historyApi);
+  if (s_priceApi[0]) g_currentPriceApi = s_priceApi;
+  if (s_historyApi[0]) g_currentHistoryApi = s_historyApi;
+
+  s_restored = true;
+  s_savedUtc = (time_t)s.savedUtc;
+  if (s_savedUtc > 0 && nowUtc >= s_savedUtc) {
+    LOGI(MAIN, "[Warm] Restored %s: %d chart / %d mean samples, FX %s (saved %ld s ago)", s.ticker,
+               (int)s.chartCount, (int)s.meanCount, fxOk ? "ok" : "-", (long)(nowUtc - s_savedUtc));
+  } else {
+    LOGI(MAIN, "[Warm] Restored %s: %d chart / %d mean samples, FX %s", s.ticker, (int)s.chartCount,
+               (int)s.meanCount, fxOk ? "ok" : "-");
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void warmRestartDiscard() {
+#if WARM_RESTART_ENABLE
+  if (s_snap.magic != kSnapMagic) return;
+  s_snap.magic = 0;
+  LOGI(MAIN, "[Warm] Snapshot discarded");
+#endif
+}
+
+bool warmRestartRestored() {
+  return s_restored;
+}
+
+bool warmRestartChartFresh(time_t nowUtc) {
+  if (!s_restored || s_savedUtc <= 0 || nowUtc < s_savedUtc) return false;
+  return nowUtc - s_savedUtc <= (time_t)WARM_RESTART_HISTORY_MAX_AGE_SEC;
+}
+
+#ifdef PIO_UNIT_TESTING
+uint8_t* warmRestartSnapshotRaw(size_t& crcOffset) {
+  crcOffset = offsetof(WarmSnapshot, crc);
+  return (uint8_t*)&s_snap;
+}
+#endif
@@ -0,0 +1,186 @@
+// CryptoBar V0.99s (Unit tests)
+// test_boot_cache - NVS round trip, save rate limit, coin and layout checks, clear
+#include <unity.h>
+
+#include <Preferences.h>
+#include <math.h>
+#include <string.h>
+
+#include "host_hal.h"
+#include "app_state.h"
+#include "boot_cache.h"
+#include "coins.h"
+
+static const time_t kNow = 1760850000;  // a valid clock (2025-10-19)
+
+static void resetState() {
+  g_lastPriceUsd      = 0.0;
+  g_lastChange24h     = 0.0;
+  g_prevDayRefPrice   = 0.0;
+  g_prevDayRefValid   = false;
+  g_chartSampleCount  = 0;
+  g_cycleInit         = false;
+  g_currentHistoryApi = "-";
+}
+
+// A running device on XRP with n chart samples spread over the day.
+static void runningState(int n) {
+  g_currentCoinIndex  = coinIndexFromTicker("XRP");
+  g_lastPriceUsd      = 2.4375;
+  g_lastChange24h     = -1.25;
+  g_prevDayRefPrice   = 2.5;
+  g_prevDayRefValid   = true;
+  g_cycleInit         = true;
+  g_cycleStartUtc     = kNow - 3600;
+  g_cycleEndUtc       = kNow + 82800;
+  g_currentHistoryApi = "Binance";
+  g_chartSampleCount  = n;
+  for (int i = 0; i < n; i++) {
+    g_chartSamples[i].pos   = (float)i / (float)(n > 1 ? n - 1 : 1);
+    g_chartSamples[i].price = 2.0 + 0.001 * i;
+  }
+}
+
+// Rewrite the stored blob (bytes = its new length, at most the stored one).
+static void rewriteBlob(void (*edit)(uint8_t* blob, size_t& bytes)) {
+  static uint8_t blob[4096];
+  Preferences pref;
+  pref.begin("bootcache", false);
+  size_t bytes = pref.getBytes("snap", blob, sizeof(blob));
+  TEST_ASSERT_TRUE(bytes > 0);
+  edit(blob, bytes);
+  pref.putBytes("snap", blob, bytes);
+  pref.end();
+}
+
+void setUp() {
+  hostPrefsClear();
+  hostClockSetUtc(kNow);
+  bootCacheClear();
+  resetState();
+}
+
+void tearDown() {}
+
+// ==================== Round trip =====================
+
+static void test_nothing_stored() {
+  TEST_ASSERT_FALSE(bootCacheRestore());
+}
+
+static void test_no_price_not_saved() {
+  runningState(3);
+  g_lastPriceUsd = 0.0;
+  TEST_ASSERT_FALSE(bootCacheSave(true));
+  TEST_ASSERT_FALSE(bootCacheRestore());
+}
+
+static void test_round_trip() {
+  runningState(3);
+  g_chartSamples[1].pos = 0.123f;  // between two Q16 steps
+  TEST_ASSERT_TRUE(bootCacheSave(true));
+  resetState();
+
+  TEST_ASSERT_TRUE(bootCacheRestore());
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 2.4375);
+  TEST_ASSERT_TRUE(g_lastChange24h == -1.25);
+  TEST_ASSERT_TRUE(g_prevDayRefValid);
+  TEST_ASSERT_TRUE(g_prevDayRefPrice == 2.5);
+  TEST_ASSERT_TRUE(g_cycleInit);
+  TEST_ASSERT_TRUE(g_cycleStartUtc == kNow - 3600);
+  TEST_ASSERT_EQUAL_STRING("Binance", g_currentHistoryApi);
+  TEST_ASSERT_EQUAL_INT(3, g_chartSampleCount);
+  TEST_ASSERT_TRUE(g_chartSamples[0].pos == 0.0f);
+  TEST_ASSERT_TRUE(g_chartSamples[2].pos == 1.0f);
+  TEST_ASSERT_TRUE(fabsf(g_chartSamples[1].pos - 0.123f) <= 0.5f / 65535.0f);  // nearest step
+  TEST_ASSERT_TRUE(g_chartSamples[2].price == (double)(float)2.002);
+}
+
+static void test_full_day_round_trip() {
+  runningState(MAX_CHART_SAMPLES);
+  TEST_ASSERT_TRUE(bootCacheSave(true));
+  resetState();
+
+  TEST_ASSERT_TRUE(bootCacheRestore());
+  TEST_ASSERT_EQUAL_INT(MAX_CHART_SAMPLES, g_chartSampleCount);
+  const int last = MAX_CHART_SAMPLES - 1;
+  TEST_ASSERT_TRUE(g_chartSamples[last].pos == 1.0f);
+  TEST_ASSERT_TRUE(g_chartSamples[last].price == (double)(float)(2.0 + 0.001 * last));
+}
+
+// ==================== Save rate limit =====================
+
+static void test_unforced_saves_rate_limited() {
+  runningState(3);
+  TEST_ASSERT_TRUE(bootCacheSave(false));  // first save of this boot
+  TEST_ASSERT_FALSE(bootCacheSave(false));
+  hostClockAdvanceMs(BOOT_CACHE_SAVE_INTERVAL_MS - 1);
+  TEST_ASSERT_FALSE(bootCacheSave(false));
+  TEST_ASSERT_TRUE(bootCacheSave(true));   // before a restart
+
+  hostClockAdvanceMs(BOOT_CACHE_SAVE_INTERVAL_MS);
+  TEST_ASSERT_TRUE(bootCacheSave(false));
+}
+
+// ==================== Rejected caches =====================
+
+static void test_other_coin_rejected() {
+  runningState(3);
+  TEST_ASSERT_TRUE(bootCacheSave(true));
+  resetState();
+
+  g_currentCoinIndex = coinIndexFromTicker("BTC");
+  TEST_ASSERT_FALSE(bootCacheRestore());
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 0.0);  // globals untouched
+  TEST_ASSERT_EQUAL_INT(0, g_chartSampleCount);
+}
+
+static void test_layout_version_rejected() {
+  runningState(3);
+  TEST_ASSERT_TRUE(bootCacheSave(true));
+  resetState();
+
+  rewriteBlob([](uint8_t* blob, size_t& bytes) {
+    (void)bytes;
+    blob[0]++;  // BootCacheHeader::version
+  });
+  TEST_ASSERT_FALSE(bootCacheRestore());
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 0.0);
+}
+
+static void test_truncated_blob_rejected() {
+  runningState(3);
+  TEST_ASSERT_TRUE(bootCacheSave(true));
+  resetState();
+
+  rewriteBlob([](uint8_t* blob, size_t& bytes) {
+    (void)blob;
+    bytes -= sizeof(float);  // last chart price missing
+  });
+  TEST_ASSERT_FALSE(bootCacheRestore());
+  TEST_ASSERT_EQUAL_INT(0, g_chartSampleCount);
+}
+
+static void test_clear() {
+  runningState(3);
+  TEST_ASSERT_TRUE(bootCacheSave(false));
+  bootCacheClear();
+  TEST_ASSERT_FALSE(bootCacheRestore());
+  TEST_ASSERT_TRUE(bootCacheSave(false));  // the rate limit starts over
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_nothing_stored);
+  RUN_TEST(test_no_price_not_saved);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_full_day_round_trip);
+  RUN_TEST(test_unforced_saves_rate_limited);
+  RUN_TEST(test_other_coin_rejected);
+  RUN_TEST(test_layout_version_rejected);
+  RUN_TEST(test_truncated_blob_rejected);
+  RUN_TEST(test_clear);
+  return UNITY_END();
+}
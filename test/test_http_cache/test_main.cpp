@@ -0,0 +1,179 @@
+// CryptoBar V0.99s (Unit tests)
+// test_http_cache - Store / lookup, max-age freshness, 304 refresh, NVS writes only on change
+#include <unity.h>
+
+#include <Preferences.h>
+#include <string.h>
+
+#include "host_hal.h"
+#include "http_cache.h"
+
+static const time_t kNow = 1760850000;  // a valid clock (2025-10-19)
+
+static const char* kFxUrl = "https://open.er-api.com/v6/latest/USD";
+
+// Validators as a response parser may leave them: bytes past each terminator
+// are whatever the struct held before.
+static LiteHttpValidators validators(const char* etag, const char* lastModified, int32_t maxAgeS,
+                                     uint8_t fill = 0) {
+  LiteHttpValidators v;
+  memset(&v, fill, sizeof(v));
+  strcpy(v.etag, etag);
+  strcpy(v.lastModified, lastModified);
+  v.maxAgeS = maxAgeS;
+  return v;
+}
+
+// The entry as last written to NVS (storedUtc 0 if the URL was never persisted).
+static HttpCacheEntry persisted(const char* url) {
+  HttpCacheEntry want, e;
+  memset(&e, 0, sizeof(e));
+  if (!httpCacheLookup(url, want)) return e;
+
+  Preferences pref;
+  pref.begin("httpcache", true);
+  for (int i = 0; i < HTTP_CACHE_ENTRIES; i++) {
+    char key[4] = { 'e', (char)('0' + i), '\0' };
+    HttpCacheEntry slot;
+    if (pref.getBytes(key, &slot, sizeof(slot)) == sizeof(slot) && slot.urlHash == want.urlHash) e = slot;
+  }
+  pref.end();
+  return e;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ==================== Store / lookup =====================
+
+static void test_store_and_lookup() {
+  const double rates[3] = { 1.0, 32.1, 0.95 };
+  httpCacheStore(kFxUrl, validators("\"a1\"", "Sun, 19 Oct 2025 05:00:00 GMT", 3600), rates, sizeof(rates),
+                 kNow);
+
+  HttpCacheEntry e;
+  TEST_ASSERT_TRUE(httpCacheLookup(kFxUrl, e));
+  TEST_ASSERT_EQUAL_STRING("\"a1\"", e.validators.etag);
+  TEST_ASSERT_EQUAL_STRING("Sun, 19 Oct 2025 05:00:00 GMT", e.validators.lastModified);
+  TEST_ASSERT_EQUAL_INT(3600, e.validators.maxAgeS);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)kNow, e.storedUtc);
+  TEST_ASSERT_EQUAL_size_t(sizeof(rates), e.resultLen);
+  TEST_ASSERT_EQUAL_MEMORY(rates, e.result, sizeof(rates));
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)kNow, persisted(kFxUrl).storedUtc);
+}
+
+static void test_nothing_to_revalidate_is_not_stored() {
+  const uint8_t r = 1;
+  httpCacheStore("https://a.test/none", validators("", "", -1), &r, 1, kNow);
+  httpCacheStore("https://a.test/big", validators("\"x\"", "", -1), &r, HTTP_CACHE_RESULT_MAX + 1, kNow);
+
+  HttpCacheEntry e;
+  TEST_ASSERT_FALSE(httpCacheLookup("https://a.test/none", e));
+  TEST_ASSERT_FALSE(httpCacheLookup("https://a.test/big", e));
+}
+
+static void test_304_for_unknown_url_is_ignored() {
+  httpCacheStore("https://a.test/gone", validators("\"g\"", "", 60), nullptr, 0, kNow);
+  HttpCacheEntry e;
+  TEST_ASSERT_FALSE(httpCacheLookup("https://a.test/gone", e));
+}
+
+// ==================== Freshness =====================
+
+static void test_fresh_while_max_age_lasts() {
+  HttpCacheEntry e;
+  memset(&e, 0, sizeof(e));
+  e.storedUtc = (uint32_t)kNow;
+  e.validators.maxAgeS = 600;
+
+  TEST_ASSERT_TRUE(httpCacheFresh(e, kNow));
+  TEST_ASSERT_TRUE(httpCacheFresh(e, kNow + 599));
+  TEST_ASSERT_FALSE(httpCacheFresh(e, kNow + 600));
+  TEST_ASSERT_FALSE(httpCacheFresh(e, kNow - 1));   // clock went back
+  TEST_ASSERT_FALSE(httpCacheFresh(e, 1000));       // clock not set
+
+  e.validators.maxAgeS = 0;  // no-cache / no-store
+  TEST_ASSERT_FALSE(httpCacheFresh(e, kNow));
+  e.validators.maxAgeS = -1;  // none
+  TEST_ASSERT_FALSE(httpCacheFresh(e, kNow));
+}
+
+// ==================== Validators and flash writes =====================
+
+static void test_304_keeps_result_without_flash_write() {
+  const char* url = "https://a.test/304";
+  const uint8_t result[4] = { 1, 2, 3, 4 };
+  httpCacheStore(url, validators("\"v1\"", "", 300), result, sizeof(result), kNow);
+
+  // Same validators (stale bytes after the terminators differ), no result.
+  httpCacheStore(url, validators("\"v1\"", "", 300, 0xA5), nullptr, 0, kNow + 100);
+
+  HttpCacheEntry e;
+  TEST_ASSERT_TRUE(httpCacheLookup(url, e));
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)(kNow + 100), e.storedUtc);  // RAM: refreshed
+  TEST_ASSERT_EQUAL_size_t(sizeof(result), e.resultLen);
+  TEST_ASSERT_EQUAL_MEMORY(result, e.result, sizeof(result));
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)kNow, persisted(url).storedUtc);  // NVS: not rewritten
+}
+
+static void test_same_200_without_flash_write() {
+  const char* url = "https://a.test/same";
+  const uint8_t result[2] = { 7, 8 };
+  httpCacheStore(url, validators("\"s\"", "Sun, 19 Oct 2025 05:00:00 GMT", 60), result, sizeof(result), kNow);
+  httpCacheStore(url, validators("\"s\"", "Sun, 19 Oct 2025 05:00:00 GMT", 120, 0xFF), result, sizeof(result),
+                 kNow + 60);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)kNow, persisted(url).storedUtc);
+
+  HttpCacheEntry e;
+  TEST_ASSERT_TRUE(httpCacheLookup(url, e));
+  TEST_ASSERT_EQUAL_INT(120, e.validators.maxAgeS);
+  // Stored validators are clean strings whatever the caller's padding was.
+  TEST_ASSERT_EQUAL_UINT8(0, (uint8_t)e.validators.etag[sizeof(e.validators.etag) - 1]);
+}
+
+static void test_new_etag_or_result_is_written() {
+  const char* url = "https://a.test/new";
+  const uint8_t r1[2] = { 1, 1 };
+  const uint8_t r2[2] = { 2, 2 };
+  httpCacheStore(url, validators("\"n1\"", "", 60), r1, sizeof(r1), kNow);
+  httpCacheStore(url, validators("\"n2\"", "", 60), r1, sizeof(r1), kNow + 10);
+  HttpCacheEntry nv = persisted(url);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)(kNow + 10), nv.storedUtc);
+  TEST_ASSERT_EQUAL_STRING("\"n2\"", nv.validators.etag);
+
+  httpCacheStore(url, validators("\"n2\"", "", 60), r2, sizeof(r2), kNow + 20);
+  nv = persisted(url);
+  TEST_ASSERT_EQUAL_UINT32((uint32_t)(kNow + 20), nv.storedUtc);
+  TEST_ASSERT_EQUAL_MEMORY(r2, nv.result, sizeof(r2));
+}
+
+// ==================== Eviction =====================
+
+static void test_least_recently_stored_is_replaced() {
+  char urls[HTTP_CACHE_ENTRIES + 1][32];
+  const uint8_t r = 9;
+  for (int i = 0; i <= HTTP_CACHE_ENTRIES; i++) {
+    snprintf(urls[i], sizeof(urls[i]), "https://evict.test/%d", i);
+    httpCacheStore(urls[i], validators("\"e\"", "", 60), &r, 1, kNow + 1000 + i);
+  }
+
+  HttpCacheEntry e;
+  TEST_ASSERT_FALSE(httpCacheLookup(urls[0], e));
+  for (int i = 1; i <= HTTP_CACHE_ENTRIES; i++) TEST_ASSERT_TRUE(httpCacheLookup(urls[i], e));
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  hostPrefsClear();
+  UNITY_BEGIN();
+  RUN_TEST(test_store_and_lookup);
+  RUN_TEST(test_nothing_to_revalidate_is_not_stored);
+  RUN_TEST(test_304_for_unknown_url_is_ignored);
+  RUN_TEST(test_fresh_while_max_age_lasts);
+  RUN_TEST(test_304_keeps_result_without_flash_write);
+  RUN_TEST(test_same_200_without_flash_write);
+  RUN_TEST(test_new_etag_or_result_is_written);
+  RUN_TEST(test_least_recently_stored_is_replaced);
+  return UNITY_END();
+}
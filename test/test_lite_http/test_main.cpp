@@ -0,0 +1,228 @@
+// CryptoBar V0.99s (Unit tests)
+// test_lite_http - Chunked bodies, Content-Length, redirects and validators over a scripted socket
+#include <unity.h>
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "lite_http.h"
+
+// ==================== Scripted socket =====================
+// Answers each request with the response registered for its host + path and
+// hands it out in 'step'-byte reads, so framing is split at awkward places.
+
+struct ScriptRoute {
+  std::string host;
+  std::string path;
+  std::string response;
+};
+
+class ScriptSocket : public NetSocket {
+ public:
+  std::vector<ScriptRoute> routes;
+  std::vector<std::string> requests;  // raw request text, one per connect
+  std::string lastHost;
+  bool        lastTls = false;
+  size_t      step    = 3;
+
+  bool connect(const char* host, uint16_t port, bool tls, uint32_t timeoutMs) override {
+    (void)port;
+    (void)timeoutMs;
+    lastHost = host;
+    lastTls  = tls;
+    requests.push_back("");
+    m_out.clear();
+    m_pos = 0;
+    return true;
+  }
+
+  int write(const uint8_t* data, size_t len, uint32_t timeoutMs) override {
+    (void)timeoutMs;
+    requests.back().append((const char*)data, len);
+    if (m_out.empty() && requests.back().find("\r\n\r\n") != std::string::npos) route();
+    return (int)len;
+  }
+
+  int read(uint8_t* buf, size_t len, uint32_t timeoutMs) override {
+    (void)timeoutMs;
+    size_t n = m_out.size() - m_pos;
+    if (n > len) n = len;
+    if (n > step) n = step;
+    memcpy(buf, m_out.data() + m_pos, n);
+    m_pos += n;
+    return (int)n;  // 0 = peer closed
+  }
+
+  void close() override {}
+
+ private:
+  void route() {
+    const std::string& req = requests.back();
+    const size_t sp = req.find(' ');
+    const std::string path = req.substr(sp + 1, req.find(' ', sp + 1) - sp - 1);
+    for (const ScriptRoute& r : routes) {
+      if (r.host == lastHost && r.path == path) {
+        m_out = r.response;
+        return;
+      }
+    }
+    m_out = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+  }
+
+  std::string m_out;
+  size_t      m_pos = 0;
+};
+
+static const LiteHttpTimeouts kTimeouts = { 1000, 1000, 1000 };
+
+static ScriptSocket* s_sock;
+static char          s_buf[256];  // the smallest buffer lite_http supports
+
+void setUp() {
+  s_sock = new ScriptSocket();
+}
+
+void tearDown() {
+  delete s_sock;
+}
+
+// ==================== Bodies =====================
+
+static void test_content_length_body() {
+  s_sock->routes.push_back({ "api.test", "/price",
+                             "HTTP/1.1 200 OK\r\nContent-Length: 11\r\n\r\n{\"p\":1.25}\nEXTRA" });
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(200, http.get("https://api.test/price", kTimeouts));
+  TEST_ASSERT_EQUAL_INT(11, http.contentLength());
+
+  char body[64];
+  TEST_ASSERT_EQUAL_size_t(11, http.readAll(body, sizeof(body)));
+  TEST_ASSERT_EQUAL_STRING("{\"p\":1.25}\n", body);
+  TEST_ASSERT_EQUAL_INT(0, http.bodyError());
+  TEST_ASSERT_TRUE(s_sock->lastTls);
+}
+
+static void test_chunked_body_with_extensions_and_trailer() {
+  s_sock->routes.push_back({ "api.test", "/klines",
+                             "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                             "5\r\n[1,2,\r\n"
+                             "a;name=value\r\n3,4,5,6,7,\r\n"
+                             "1\r\n8\r\n"
+                             "0\r\nX-Trailer: yes\r\n\r\n" });
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(200, http.get("https://api.test/klines", kTimeouts));
+  TEST_ASSERT_EQUAL_INT(-1, http.contentLength());
+
+  char body[64];
+  TEST_ASSERT_EQUAL_size_t(16, http.readAll(body, sizeof(body)));
+  TEST_ASSERT_EQUAL_STRING("[1,2,3,4,5,6,7,8", body);
+  TEST_ASSERT_EQUAL_INT(0, http.bodyError());
+  TEST_ASSERT_EQUAL_INT(-1, http.read());
+}
+
+static void test_chunked_body_read_bytewise() {
+  s_sock->routes.push_back({ "api.test", "/b",
+                             "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                             "3\r\nabc\r\n2\r\nde\r\n0\r\n\r\n" });
+  s_sock->step = 1;
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(200, http.get("http://api.test/b", kTimeouts));
+
+  std::string got;
+  int c;
+  while ((c = http.read()) >= 0) got += (char)c;
+  TEST_ASSERT_EQUAL_STRING("abcde", got.c_str());
+  TEST_ASSERT_EQUAL_size_t(5, http.bodyBytes());
+}
+
+static void test_chunked_body_cut_short() {
+  s_sock->routes.push_back({ "api.test", "/cut",
+                             "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n"
+                             "8\r\nabcd" });
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(200, http.get("https://api.test/cut", kTimeouts));
+
+  char body[16];
+  TEST_ASSERT_EQUAL_size_t(4, http.readAll(body, sizeof(body)));
+  TEST_ASSERT_EQUAL_INT(NET_ERR_LOST, http.bodyError());
+}
+
+static void test_bad_chunk_size() {
+  s_sock->routes.push_back({ "api.test", "/bad",
+                             "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\nab\r\n0\r\n\r\n" });
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(200, http.get("https://api.test/bad", kTimeouts));
+
+  char body[16];
+  TEST_ASSERT_EQUAL_size_t(0, http.readAll(body, sizeof(body)));
+  TEST_ASSERT_EQUAL_INT(NET_ERR_LOST, http.bodyError());
+}
+
+// ==================== Redirects =====================
+
+static void test_redirect_absolute_and_relative() {
+  s_sock->routes.push_back({ "old.test", "/v1/price",
+                             "HTTP/1.1 301 Moved Permanently\r\n"
+                             "Location: https://new.test/v1/price?x=1\r\nContent-Length: 0\r\n\r\n" });
+  s_sock->routes.push_back({ "new.test", "/v1/price?x=1",
+                             "HTTP/1.1 302 Found\r\nLocation: /v2/price\r\nContent-Length: 3\r\n\r\nabc" });
+  s_sock->routes.push_back({ "new.test", "/v2/price",
+                             "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok" });
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(200, http.get("http://old.test/v1/price", kTimeouts));
+
+  char body[8];
+  http.readAll(body, sizeof(body));
+  TEST_ASSERT_EQUAL_STRING("ok", body);
+  TEST_ASSERT_EQUAL_size_t(3, s_sock->requests.size());
+  TEST_ASSERT_EQUAL_STRING("new.test", s_sock->lastHost.c_str());
+  TEST_ASSERT_TRUE(s_sock->lastTls);  // http -> https switch
+}
+
+static void test_redirect_limit() {
+  s_sock->routes.push_back({ "loop.test", "/a",
+                             "HTTP/1.1 307 Temporary Redirect\r\nLocation: /a\r\nContent-Length: 0\r\n\r\n" });
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(307, http.get("https://loop.test/a", kTimeouts));
+  TEST_ASSERT_EQUAL_size_t(LITE_HTTP_MAX_REDIRECTS + 1, s_sock->requests.size());
+}
+
+// ==================== Validators =====================
+
+static void test_validators_sent_and_refreshed() {
+  s_sock->routes.push_back({ "api.test", "/fx",
+                             "HTTP/1.1 304 Not Modified\r\nETag: \"v2\"\r\n"
+                             "Cache-Control: max-age=600\r\nAge: 100\r\n\r\n" });
+  LiteHttpValidators v;
+  memset(&v, 0, sizeof(v));
+  strcpy(v.etag, "\"v1\"");
+  strcpy(v.lastModified, "Mon, 19 Oct 2026 06:00:00 GMT");
+  v.maxAgeS = -1;
+
+  LiteHttp http(*s_sock, s_buf, sizeof(s_buf));
+  TEST_ASSERT_EQUAL_INT(304, http.get("https://api.test/fx", kTimeouts, nullptr, &v));
+
+  const std::string& req = s_sock->requests.back();
+  TEST_ASSERT_TRUE(req.find("If-None-Match: \"v1\"\r\n") != std::string::npos);
+  TEST_ASSERT_TRUE(req.find("If-Modified-Since: Mon, 19 Oct 2026 06:00:00 GMT\r\n") != std::string::npos);
+  TEST_ASSERT_EQUAL_STRING("\"v2\"", v.etag);
+  TEST_ASSERT_EQUAL_STRING("Mon, 19 Oct 2026 06:00:00 GMT", v.lastModified);  // not repeated: kept
+  TEST_ASSERT_EQUAL_INT(500, v.maxAgeS);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_content_length_body);
+  RUN_TEST(test_chunked_body_with_extensions_and_trailer);
+  RUN_TEST(test_chunked_body_read_bytewise);
+  RUN_TEST(test_chunked_body_cut_short);
+  RUN_TEST(test_bad_chunk_size);
+  RUN_TEST(test_redirect_absolute_and_relative);
+  RUN_TEST(test_redirect_limit);
+  RUN_TEST(test_validators_sent_and_refreshed);
+  return UNITY_END();
+}
@@ -0,0 +1,334 @@
+// CryptoBar V0.99s (Unit tests)
+// test_net_inflate - gzip / zlib / raw deflate decoding, window limits and corrupt input
+#include <unity.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "net_inflate.h"
+
+// ==================== Test payload =====================
+// 1500 pseudo-random "ACGT" letters, twice: the second half is one long
+// back-reference 1500 bytes back (past a 1 KB window).
+
+static std::string payload() {
+  std::string half;
+  uint32_t x = 1;
+  for (int i = 0; i < 1500; i++) {
+    x = x * 1103515245u + 12345u;
+    half += "ACGT"[(x >> 16) & 3];
+  }
+  return half + half;
+}
+
+// gzip -9 of payload() (zlib 1.x: 10-byte header, no optional fields).
+static const uint8_t kGzip[] = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0x94, 0xdb, 0x91, 0xc3, 0x50,
+  0x08, 0x43, 0x6b, 0x63, 0xf8, 0xa0, 0x01, 0xfa, 0xaf, 0x65, 0x39, 0x47, 0xf6, 0xce, 0xd6, 0xb0,
+  0xe3, 0x71, 0x12, 0x3b, 0xd7, 0x3c, 0x84, 0x04, 0xcc, 0xf4, 0xee, 0xce, 0xd6, 0xdd, 0xab, 0x7a,
+  0xef, 0x9a, 0x19, 0x8f, 0x7a, 0xee, 0x80, 0xe7, 0xe9, 0x2e, 0xde, 0xdd, 0xc3, 0xce, 0xdc, 0xf3,
+  0x62, 0xd2, 0x3a, 0x9e, 0x67, 0xe3, 0x31, 0x75, 0x9f, 0x7b, 0x5a, 0xdf, 0x6f, 0xd7, 0x5d, 0x5d,
+  0x17, 0xe3, 0xde, 0x73, 0xe8, 0xd7, 0x3f, 0x17, 0xf6, 0x2c, 0xcf, 0x1c, 0x6b, 0x62, 0x0f, 0x79,
+  0xce, 0x89, 0xec, 0xda, 0x2f, 0x91, 0x9b, 0x00, 0xe4, 0xc0, 0x0d, 0x93, 0x01, 0xa9, 0xc1, 0x47,
+  0x30, 0x17, 0x7d, 0xc8, 0x03, 0x62, 0x9e, 0x29, 0x20, 0x60, 0x30, 0xb8, 0xd0, 0x45, 0xaa, 0x3b,
+  0xc2, 0xd4, 0xb3, 0x0b, 0x7e, 0x7e, 0x45, 0x88, 0x02, 0xcb, 0x8a, 0xdc, 0x84, 0x94, 0x45, 0x45,
+  0x03, 0x52, 0x2c, 0x01, 0x01, 0x27, 0x6b, 0x59, 0x41, 0x1a, 0x4a, 0xce, 0xfc, 0xe0, 0xae, 0x71,
+  0xe5, 0xad, 0xfb, 0x2d, 0xb9, 0xf7, 0x29, 0xbd, 0xb4, 0xde, 0x96, 0xa8, 0x12, 0x08, 0x65, 0x5e,
+  0xd8, 0xde, 0x37, 0xe8, 0xb1, 0x60, 0x39, 0xb2, 0x37, 0xf2, 0x85, 0x1d, 0x81, 0xa9, 0xdf, 0x4a,
+  0x8a, 0x83, 0x06, 0x7f, 0xeb, 0x29, 0xe7, 0x0a, 0x41, 0xd9, 0x02, 0x39, 0x36, 0x0f, 0x84, 0x15,
+  0x28, 0x56, 0x45, 0xca, 0x16, 0x7e, 0x41, 0x75, 0x44, 0x23, 0x98, 0x50, 0x16, 0xbc, 0xeb, 0x55,
+  0x86, 0x51, 0x4b, 0x20, 0xa7, 0xfa, 0x70, 0xa3, 0xc8, 0xad, 0xac, 0x1d, 0x2f, 0xfc, 0x01, 0x32,
+  0x91, 0x69, 0xd5, 0x40, 0xf2, 0x4d, 0x2c, 0xbc, 0x4a, 0x61, 0x84, 0x23, 0xd9, 0xa3, 0x41, 0x2b,
+  0xf7, 0x94, 0xd5, 0xc7, 0x29, 0x55, 0x40, 0xb9, 0xf4, 0xed, 0x68, 0x10, 0xa9, 0x57, 0x9a, 0xc5,
+  0x45, 0x26, 0x0a, 0x42, 0x69, 0x21, 0x13, 0xc0, 0xc4, 0x36, 0xab, 0x65, 0x9a, 0x63, 0xeb, 0x51,
+  0xfd, 0xa1, 0x0b, 0xc3, 0xf2, 0x6e, 0x4f, 0x86, 0x6d, 0x70, 0x79, 0x56, 0xe1, 0x13, 0xfe, 0x21,
+  0x14, 0xd2, 0x14, 0x83, 0x3b, 0xee, 0x76, 0x4a, 0xa7, 0xeb, 0x63, 0xb8, 0x0a, 0x53, 0x41, 0x33,
+  0x29, 0xad, 0x04, 0x58, 0xe9, 0x78, 0x4b, 0xe8, 0x87, 0xc9, 0x96, 0x01, 0xd3, 0x8d, 0xed, 0xd6,
+  0xef, 0xa3, 0xfd, 0x81, 0xb9, 0x6c, 0xa4, 0x49, 0x10, 0xc9, 0x76, 0x2a, 0x75, 0xcc, 0x0f, 0x34,
+  0x1b, 0xb4, 0xd2, 0xfb, 0xf5, 0xdb, 0x3e, 0x30, 0x95, 0x91, 0x8b, 0x94, 0xbe, 0x63, 0x5e, 0x47,
+  0xf0, 0xa3, 0x48, 0x1b, 0xf4, 0xbf, 0x01, 0x33, 0x9a, 0x20, 0xd7, 0x19, 0xff, 0x9e, 0x87, 0xd2,
+  0x8c, 0x14, 0x81, 0xe9, 0x01, 0x2c, 0x46, 0xde, 0x6d, 0x70, 0xad, 0x6d, 0x46, 0xda, 0x3a, 0x4a,
+  0x46, 0xdd, 0x55, 0xd1, 0xb4, 0xdb, 0x03, 0xc4, 0xd7, 0x66, 0xdd, 0x67, 0x46, 0xe6, 0x9d, 0x79,
+  0x87, 0xab, 0x52, 0xac, 0x13, 0xb5, 0x56, 0x1d, 0x6f, 0x6c, 0x85, 0xb1, 0xce, 0x74, 0x7a, 0xaa,
+  0x43, 0x75, 0xa7, 0x07, 0x02, 0xc4, 0x16, 0x84, 0xca, 0x4e, 0x16, 0x59, 0x4c, 0x65, 0x82, 0x49,
+  0x9e, 0x55, 0x6d, 0xd9, 0x9e, 0xec, 0x26, 0xd7, 0x89, 0x45, 0x3a, 0xf3, 0xfc, 0xd9, 0x74, 0xb7,
+  0x45, 0xd6, 0x3c, 0x8b, 0xc0, 0x8e, 0xb4, 0x87, 0x48, 0x9d, 0x5e, 0xcf, 0xac, 0x88, 0x27, 0xfb,
+  0x0d, 0x8e, 0x9d, 0x52, 0x14, 0x70, 0xf2, 0xbc, 0xeb, 0x6b, 0x5e, 0x9b, 0x53, 0xdd, 0x6c, 0x02,
+  0x84, 0x35, 0xb1, 0x55, 0xd4, 0x1f, 0xc5, 0xa5, 0xcb, 0x75, 0xd0, 0xf9, 0xae, 0x6b, 0x62, 0x5f,
+  0xc2, 0x32, 0x58, 0xd2, 0x09, 0x53, 0xfb, 0x76, 0x67, 0x64, 0x0e, 0xf9, 0xce, 0xf1, 0x64, 0xab,
+  0x72, 0x39, 0x71, 0xeb, 0xe2, 0x9b, 0x6f, 0xb7, 0x7f, 0xbb, 0xfd, 0xdb, 0xed, 0xdf, 0x6e, 0xff,
+  0x76, 0xfb, 0xbf, 0xdb, 0xed, 0x3f, 0xef, 0x80, 0xc8, 0x9c, 0xb8, 0x0b, 0x00, 0x00,
+};
+
+// Same payload, raw deflate with fixed Huffman codes only (Z_FIXED).
+static const uint8_t kFixed[] = {
+  0x73, 0x77, 0x77, 0x0e, 0x09, 0x09, 0x71, 0x0f, 0x71, 0x04, 0xd2, 0x8e, 0x8e, 0xce, 0x21, 0x40,
+  0xe8, 0xee, 0xee, 0x0e, 0x16, 0x72, 0x76, 0x07, 0x0a, 0x80, 0xd8, 0xee, 0xce, 0xce, 0x8e, 0x20,
+  0x39, 0x20, 0x23, 0xc4, 0xdd, 0x1d, 0xc8, 0x0e, 0x01, 0x29, 0x71, 0x06, 0x6b, 0x04, 0xea, 0x74,
+  0x06, 0xe9, 0x70, 0x77, 0x04, 0x22, 0x20, 0x2b, 0x04, 0x2c, 0x1f, 0xe2, 0xec, 0x08, 0x84, 0xce,
+  0x8e, 0x40, 0x33, 0x80, 0xf2, 0x20, 0x41, 0x30, 0x06, 0x73, 0x80, 0xc6, 0x02, 0x55, 0x02, 0x95,
+  0x83, 0x54, 0x83, 0xcc, 0x76, 0x07, 0xd9, 0x03, 0xd4, 0x04, 0xb2, 0x1d, 0xac, 0x3e, 0x04, 0x64,
+  0xb2, 0x33, 0xc8, 0x00, 0x90, 0x1d, 0x20, 0x6d, 0x20, 0x25, 0xee, 0x20, 0x97, 0x82, 0x0d, 0x77,
+  0x07, 0x3b, 0x06, 0x68, 0xba, 0x3b, 0xc8, 0x1e, 0x90, 0x8b, 0x41, 0x6c, 0x90, 0x07, 0x20, 0x8e,
+  0x01, 0x29, 0x00, 0x1a, 0xed, 0x08, 0xb2, 0x0a, 0x28, 0x04, 0x52, 0x0a, 0x16, 0x03, 0x1a, 0x0e,
+  0xd4, 0xe7, 0x08, 0x32, 0xc2, 0x11, 0xe4, 0x96, 0x10, 0xb0, 0xcb, 0xc1, 0x16, 0x82, 0xbc, 0x05,
+  0xf2, 0x91, 0x3b, 0xc8, 0xa5, 0x20, 0x95, 0x20, 0x47, 0x80, 0xc2, 0x24, 0x04, 0xec, 0x2d, 0x88,
+  0x4b, 0x21, 0x41, 0x02, 0x54, 0x0e, 0x74, 0x6e, 0x08, 0xd8, 0x5c, 0x70, 0xb8, 0x39, 0x3b, 0xc3,
+  0xbc, 0xec, 0x1c, 0x02, 0xf5, 0xba, 0x23, 0x58, 0x75, 0x88, 0x33, 0x38, 0xa0, 0x1c, 0xc1, 0x0e,
+  0x01, 0x79, 0x13, 0x68, 0xac, 0x73, 0x08, 0xcc, 0x50, 0x60, 0x28, 0x80, 0xbd, 0x03, 0x0e, 0x3d,
+  0x77, 0x70, 0x78, 0x81, 0xd4, 0x81, 0x0c, 0x06, 0xf9, 0x1f, 0xec, 0x13, 0x47, 0x90, 0x80, 0x33,
+  0xc8, 0xfd, 0xce, 0x60, 0x9d, 0xe0, 0x30, 0x07, 0x47, 0x04, 0xc8, 0xdb, 0x60, 0x87, 0x00, 0x43,
+  0x13, 0xe8, 0x08, 0xb0, 0x0f, 0xc0, 0x91, 0xe5, 0x08, 0x89, 0x4a, 0x67, 0xb0, 0xf3, 0x1d, 0x41,
+  0x41, 0x0d, 0x89, 0x34, 0x90, 0x61, 0x60, 0xa7, 0x84, 0x80, 0xdc, 0x1b, 0x02, 0x86, 0x8e, 0x60,
+  0x63, 0xc0, 0x71, 0x09, 0x72, 0x32, 0xc4, 0xf7, 0x90, 0xb0, 0x01, 0x47, 0xb2, 0x33, 0x38, 0x5a,
+  0x9d, 0x21, 0xba, 0x40, 0xfa, 0x41, 0x0e, 0x71, 0x87, 0x44, 0x53, 0x08, 0x38, 0x0e, 0xc0, 0x81,
+  0x0f, 0xb6, 0x18, 0xec, 0x3c, 0x47, 0x88, 0xc7, 0x40, 0xc6, 0x81, 0x2c, 0x83, 0xc6, 0x81, 0x33,
+  0x38, 0xba, 0xdd, 0x1d, 0xc1, 0xbe, 0x87, 0x68, 0x82, 0xf8, 0x02, 0x14, 0xe4, 0xe0, 0xe0, 0x0b,
+  0x71, 0x07, 0x2b, 0x80, 0x44, 0x75, 0x08, 0x38, 0x98, 0xc1, 0xee, 0x02, 0xd9, 0x04, 0xf2, 0x10,
+  0x28, 0xa6, 0xc1, 0x4e, 0x06, 0x19, 0x00, 0xb6, 0x18, 0x9c, 0x58, 0xc1, 0xde, 0x04, 0xdb, 0x11,
+  0xe2, 0x08, 0x8d, 0x75, 0x68, 0x70, 0x81, 0x14, 0x3a, 0x82, 0x69, 0x70, 0x9a, 0x84, 0x84, 0x36,
+  0xc8, 0x5d, 0x60, 0x31, 0x47, 0x48, 0x78, 0x82, 0xc2, 0x1f, 0x14, 0xa0, 0xa0, 0x40, 0x03, 0x47,
+  0x06, 0x88, 0x06, 0x69, 0x07, 0xa7, 0x14, 0x67, 0x48, 0xaa, 0x87, 0x28, 0x0c, 0x01, 0x47, 0x8c,
+  0x23, 0xc4, 0x35, 0xee, 0x10, 0xaf, 0x39, 0x82, 0x1d, 0xe8, 0x08, 0x49, 0xf1, 0x60, 0x2f, 0x38,
+  0x43, 0x43, 0xd2, 0x19, 0x1c, 0x02, 0x60, 0xeb, 0xdc, 0xc1, 0xc9, 0xcd, 0x19, 0xc6, 0x04, 0xa7,
+  0x0f, 0x90, 0x72, 0x70, 0x68, 0x40, 0x12, 0x09, 0x28, 0x92, 0xc0, 0xc9, 0xc9, 0x11, 0x1c, 0x8f,
+  0x10, 0x02, 0x14, 0xcc, 0x60, 0x43, 0x1d, 0x21, 0x69, 0xdf, 0x11, 0x9e, 0x7c, 0x40, 0x21, 0x05,
+  0xc9, 0x72, 0x90, 0xa8, 0x04, 0xcb, 0x81, 0xf2, 0xab, 0x3b, 0xd8, 0xf1, 0xee, 0xe0, 0x48, 0x0a,
+  0x81, 0xb8, 0x1e, 0x6e, 0x20, 0x24, 0x6b, 0x82, 0x5c, 0x0e, 0xd6, 0x0c, 0xd2, 0xef, 0xec, 0x0e,
+  0x0d, 0x52, 0x48, 0x96, 0x02, 0x19, 0x0c, 0x4a, 0x03, 0x20, 0x15, 0xee, 0xe0, 0x70, 0x07, 0x27,
+  0x70, 0xb0, 0x6a, 0x70, 0x62, 0x04, 0x25, 0x6b, 0x48, 0x4c, 0x42, 0x62, 0x37, 0x04, 0x1c, 0xa3,
+  0x90, 0xe4, 0x06, 0x75, 0x08, 0x58, 0x1a, 0x6c, 0x6b, 0x08, 0x34, 0x8f, 0xb8, 0xc3, 0xf2, 0x3c,
+  0x38, 0x73, 0x39, 0x42, 0x3c, 0x0b, 0xce, 0x51, 0x21, 0x60, 0x5f, 0x43, 0x74, 0x83, 0xd4, 0x82,
+  0x9d, 0x11, 0x02, 0xce, 0xd3, 0x90, 0x34, 0xe5, 0x0c, 0x09, 0x6a, 0x67, 0x48, 0x1a, 0x80, 0x38,
+  0x04, 0x9c, 0x04, 0x41, 0x41, 0xe9, 0x0c, 0xb1, 0x05, 0x1c, 0x8a, 0x10, 0x9f, 0x81, 0x1d, 0x03,
+  0xb1, 0x27, 0x04, 0x1c, 0xdb, 0xe0, 0xd0, 0x76, 0x87, 0x94, 0x4d, 0xe0, 0xe2, 0x04, 0xec, 0x49,
+  0x70, 0x9e, 0x07, 0x71, 0x42, 0x20, 0xa9, 0x1b, 0xec, 0x49, 0x47, 0x77, 0x68, 0x41, 0x00, 0x4e,
+  0x91, 0xe0, 0x34, 0x04, 0xb2, 0x1a, 0x92, 0xd6, 0x21, 0x79, 0x05, 0xec, 0x1e, 0x48, 0xf9, 0x06,
+  0x0a, 0x63, 0x70, 0x2e, 0x05, 0xc5, 0x00, 0x38, 0xe7, 0x81, 0x69, 0xb0, 0x5e, 0xb0, 0xbd, 0xe0,
+  0xc4, 0x09, 0x8e, 0x37, 0x70, 0x22, 0x00, 0x45, 0x2c, 0xd8, 0x62, 0xb0, 0x2f, 0x1c, 0x91, 0x62,
+  0x1c, 0x1c, 0x5c, 0xe0, 0xe2, 0xc0, 0x19, 0x82, 0x43, 0xc0, 0xc5, 0x44, 0x08, 0x2c, 0xc0, 0x20,
+  0x19, 0x0b, 0x1c, 0x9c, 0xa0, 0x90, 0x0a, 0x81, 0xa5, 0x4e, 0x48, 0x34, 0x43, 0x02, 0x1f, 0x9c,
+  0x8f, 0xdd, 0x21, 0xa5, 0x2a, 0x08, 0x82, 0x73, 0x5c, 0x08, 0xb8, 0xe0, 0x73, 0x1f, 0x2d, 0xdb,
+  0x47, 0xcb, 0xf6, 0xd1, 0xb2, 0x7d, 0xb4, 0x6c, 0x1f, 0x2d, 0xdb, 0x87, 0x5d, 0xd9, 0x0e, 0x00,
+};
+
+static const size_t kGzipHeader  = 10;
+static const size_t kGzipTrailer = 8;
+
+static std::vector<uint8_t> rawDeflate() {
+  return std::vector<uint8_t>(kGzip + kGzipHeader, kGzip + sizeof(kGzip) - kGzipTrailer);
+}
+
+static std::vector<uint8_t> zlibWrapped() {
+  const std::string p = payload();
+  uint32_t a = 1, b = 0;  // Adler-32
+  for (unsigned char c : p) {
+    a = (a + c) % 65521;
+    b = (b + a) % 65521;
+  }
+  const uint32_t adler = (b << 16) | a;
+  std::vector<uint8_t> z = { 0x78, 0xda };  // 32 KB window, best compression
+  const std::vector<uint8_t> raw = rawDeflate();
+  z.insert(z.end(), raw.begin(), raw.end());
+  for (int i = 3; i >= 0; i--) z.push_back((uint8_t)(adler >> (8 * i)));
+  return z;
+}
+
+// Stored blocks of at most 1000 bytes (the last one flagged final).
+static std::vector<uint8_t> storedDeflate() {
+  const std::string p = payload();
+  std::vector<uint8_t> out;
+  for (size_t off = 0; off < p.size(); off += 1000) {
+    const uint16_t len = (uint16_t)std::min<size_t>(1000, p.size() - off);
+    out.push_back(off + len == p.size() ? 1 : 0);
+    out.push_back((uint8_t)len);
+    out.push_back((uint8_t)(len >> 8));
+    out.push_back((uint8_t)~len);
+    out.push_back((uint8_t)(~len >> 8));
+    out.insert(out.end(), p.begin() + off, p.begin() + off + len);
+  }
+  return out;
+}
+
+// ==================== Source =====================
+
+struct Feed {
+  const uint8_t* data;
+  size_t         len;
+  size_t         pos;
+  size_t         step;  // bytes per callback, so blocks straddle refills
+};
+
+static size_t feedSource(void* ctx, uint8_t* buf, size_t len) {
+  Feed* f = static_cast<Feed*>(ctx);
+  size_t n = f->len - f->pos;
+  if (n > len) n = len;
+  if (n > f->step) n = f->step;
+  memcpy(buf, f->data + f->pos, n);
+  f->pos += n;
+  return n;
+}
+
+static uint8_t s_window[NET_INFLATE_WINDOW_BYTES];
+
+static std::string inflateAll(NetInflate& inf, const uint8_t* data, size_t len, NetInflateFormat format,
+                              size_t step = 7, size_t readLen = 100) {
+  Feed f = { data, len, 0, step };
+  inf.begin(feedSource, &f, format);
+  std::string out;
+  char buf[128];
+  size_t n;
+  while ((n = inf.readBytes(buf, readLen)) > 0) out.append(buf, n);
+  return out;
+}
+
+void setUp() {}
+void tearDown() {}
+
+// ==================== Formats =====================
+
+static void test_gzip() {
+  NetInflate inf(s_window, sizeof(s_window));
+  const std::string out = inflateAll(inf, kGzip, sizeof(kGzip), NET_INFLATE_GZIP);
+  TEST_ASSERT_TRUE(out == payload());
+  TEST_ASSERT_TRUE(inf.finished());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_OK, inf.error());
+  TEST_ASSERT_EQUAL_size_t(sizeof(kGzip), inf.inBytes());
+  TEST_ASSERT_EQUAL_size_t(payload().size(), inf.outBytes());
+}
+
+static void test_zlib_wrapped_deflate() {
+  const std::vector<uint8_t> z = zlibWrapped();
+  NetInflate inf(s_window, sizeof(s_window));
+  TEST_ASSERT_TRUE(inflateAll(inf, z.data(), z.size(), NET_INFLATE_DEFLATE) == payload());
+  TEST_ASSERT_TRUE(inf.finished());
+}
+
+static void test_raw_deflate() {
+  const std::vector<uint8_t> raw = rawDeflate();
+  NetInflate inf(s_window, sizeof(s_window));
+  TEST_ASSERT_TRUE(inflateAll(inf, raw.data(), raw.size(), NET_INFLATE_DEFLATE) == payload());
+  TEST_ASSERT_TRUE(inf.finished());
+}
+
+static void test_fixed_huffman() {
+  NetInflate inf(s_window, sizeof(s_window));
+  TEST_ASSERT_TRUE(inflateAll(inf, kFixed, sizeof(kFixed), NET_INFLATE_DEFLATE) == payload());
+  TEST_ASSERT_TRUE(inf.finished());
+}
+
+static void test_stored_blocks() {
+  const std::vector<uint8_t> st = storedDeflate();
+  NetInflate inf(s_window, sizeof(s_window));
+  TEST_ASSERT_TRUE(inflateAll(inf, st.data(), st.size(), NET_INFLATE_DEFLATE) == payload());
+  TEST_ASSERT_TRUE(inf.finished());
+}
+
+static void test_byte_at_a_time() {
+  NetInflate inf(s_window, sizeof(s_window));
+  Feed f = { kGzip, sizeof(kGzip), 0, 1 };
+  inf.begin(feedSource, &f, NET_INFLATE_GZIP);
+  std::string out;
+  int c;
+  while ((c = inf.read()) >= 0) out += (char)c;
+  TEST_ASSERT_TRUE(out == payload());
+  TEST_ASSERT_TRUE(inf.finished());
+}
+
+static void test_window_reused_across_streams() {
+  NetInflate inf(s_window, sizeof(s_window));
+  const std::vector<uint8_t> raw = rawDeflate();
+  TEST_ASSERT_TRUE(inflateAll(inf, kFixed, sizeof(kFixed), NET_INFLATE_DEFLATE) == payload());
+  TEST_ASSERT_TRUE(inflateAll(inf, raw.data(), raw.size(), NET_INFLATE_DEFLATE, 64, 1) == payload());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_OK, inf.error());
+}
+
+// ==================== Errors =====================
+
+static void test_truncated_stream() {
+  NetInflate inf(s_window, sizeof(s_window));
+  const std::string out = inflateAll(inf, kGzip, sizeof(kGzip) / 2, NET_INFLATE_GZIP);
+  TEST_ASSERT_LESS_THAN(payload().size(), out.size());
+  TEST_ASSERT_FALSE(inf.finished());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_INPUT, inf.error());
+}
+
+static void test_reference_beyond_small_window() {
+  static uint8_t small[1024];
+  NetInflate inf(small, sizeof(small));
+  inflateAll(inf, kGzip, sizeof(kGzip), NET_INFLATE_GZIP);
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_WINDOW, inf.error());
+
+  // A zlib header announcing a 32 KB window is refused up front.
+  const std::vector<uint8_t> z = zlibWrapped();
+  TEST_ASSERT_EQUAL_size_t(0, inflateAll(inf, z.data(), z.size(), NET_INFLATE_DEFLATE).size());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_WINDOW, inf.error());
+}
+
+static void test_no_window() {
+  NetInflate inf;
+  TEST_ASSERT_EQUAL_size_t(0, inflateAll(inf, kGzip, sizeof(kGzip), NET_INFLATE_GZIP).size());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_WINDOW, inf.error());
+
+  // A window borrowed for one stream, then given back.
+  inf.setWindow(s_window, sizeof(s_window));
+  TEST_ASSERT_TRUE(inflateAll(inf, kGzip, sizeof(kGzip), NET_INFLATE_GZIP) == payload());
+  inf.setWindow(nullptr, 0);
+  inflateAll(inf, kGzip, sizeof(kGzip), NET_INFLATE_GZIP);
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_WINDOW, inf.error());
+}
+
+static void test_bad_gzip_magic() {
+  uint8_t bad[sizeof(kGzip)];
+  memcpy(bad, kGzip, sizeof(bad));
+  bad[1] = 0x8c;
+  NetInflate inf(s_window, sizeof(s_window));
+  TEST_ASSERT_EQUAL_size_t(0, inflateAll(inf, bad, sizeof(bad), NET_INFLATE_GZIP).size());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_DATA, inf.error());
+}
+
+static void test_wrong_length_in_trailer() {
+  uint8_t bad[sizeof(kGzip)];
+  memcpy(bad, kGzip, sizeof(bad));
+  bad[sizeof(bad) - 4] ^= 0x01;  // ISIZE
+  NetInflate inf(s_window, sizeof(s_window));
+  inflateAll(inf, bad, sizeof(bad), NET_INFLATE_GZIP);
+  TEST_ASSERT_FALSE(inf.finished());
+  TEST_ASSERT_EQUAL_INT(NET_INFLATE_ERR_DATA, inf.error());
+}
+
+static void test_corrupt_blocks_terminate() {
+  // Flipped bits anywhere in the data must end the stream, never hang or overrun.
+  for (size_t at = kGzipHeader; at < sizeof(kGzip) - kGzipTrailer; at += 37) {
+    uint8_t bad[sizeof(kGzip)];
+    memcpy(bad, kGzip, sizeof(bad));
+    bad[at] ^= 0x5a;
+    NetInflate inf(s_window, sizeof(s_window));
+    const std::string out = inflateAll(inf, bad, sizeof(bad), NET_INFLATE_GZIP, 64);
+    TEST_ASSERT_TRUE(inf.finished() || inf.error() != NET_INFLATE_OK);
+    TEST_ASSERT_EQUAL_size_t(out.size(), inf.outBytes());
+  }
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_gzip);
+  RUN_TEST(test_zlib_wrapped_deflate);
+  RUN_TEST(test_raw_deflate);
+  RUN_TEST(test_fixed_huffman);
+  RUN_TEST(test_stored_blocks);
+  RUN_TEST(test_byte_at_a_time);
+  RUN_TEST(test_window_reused_across_streams);
+  RUN_TEST(test_truncated_stream);
+  RUN_TEST(test_reference_beyond_small_window);
+  RUN_TEST(test_no_window);
+  RUN_TEST(test_bad_gzip_magic);
+  RUN_TEST(test_wrong_length_in_trailer);
+  RUN_TEST(test_corrupt_blocks_terminate);
+  return UNITY_END();
+}
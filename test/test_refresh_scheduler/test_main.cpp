@@ -0,0 +1,149 @@
+// CryptoBar V0.99s (Unit tests)
+// test_refresh_scheduler - Ghosting budgets per refresh mode, safety cap and quiet-time cleanup
+#include <unity.h>
+
+#include "app_state.h"
+#include "epd_display.h"
+#include "refresh_scheduler.h"
+
+// Screen area (rotation 1) that covers whole diff tiles: toggling it adds one
+// transition per pixel, i.e. 1.0 ghost load, to each of those tiles.
+static const int16_t kBlockX = 0, kBlockY = 0, kBlockW = 96, kBlockH = 64;
+
+static bool s_blockBlack = false;
+static bool s_dotBlack   = false;
+
+// One frame on the simulated panel, refreshed partially or fully.
+static void drawFrame(bool full) {
+  if (full) display.setFullWindow();
+  else      display.setPartialWindow(0, 0, display.width(), display.height());
+  display.firstPage();
+  do {
+    display.fillScreen(GxEPD_WHITE);
+    if (s_blockBlack) display.fillRect(kBlockX, kBlockY, kBlockW, kBlockH, GxEPD_BLACK);
+    if (s_dotBlack) display.drawPixel(200, 100, GxEPD_BLACK);
+  } while (display.nextPage());
+}
+
+static void toggleBlock(bool full = false) {
+  s_blockBlack = !s_blockBlack;
+  drawFrame(full);
+}
+
+static void toggleDot() {
+  s_dotBlack = !s_dotBlack;
+  drawFrame(false);
+}
+
+// Frame the scheduler asked for, as the render task would draw it.
+static bool nextIsFull(time_t cycleStartUtc = 0) {
+  return refreshSchedulerWantFull(false, cycleStartUtc);
+}
+
+void setUp() {
+  g_refreshMode = 0;
+  s_blockBlack = false;
+  s_dotBlack   = false;
+  drawFrame(true);  // clean panel, ghost load 0
+}
+
+void tearDown() {}
+
+// ==================== Budgets =====================
+
+static void test_forced_full_always_wins() {
+  TEST_ASSERT_TRUE(refreshSchedulerWantFull(true, 0));
+}
+
+static void test_partial_mode_budget() {
+  for (int i = 0; i < 3; i++) {
+    toggleBlock();
+    TEST_ASSERT_FALSE(nextIsFull());
+  }
+  TEST_ASSERT_EQUAL_UINT16(75, refreshSchedulerGhostPercent());
+  toggleBlock();  // 4.0 transitions per pixel
+  TEST_ASSERT_EQUAL_UINT16(100, refreshSchedulerGhostPercent());
+  TEST_ASSERT_TRUE(nextIsFull());
+
+  toggleBlock(true);
+  TEST_ASSERT_EQUAL_UINT16(0, refreshSchedulerGhostPercent());
+  TEST_ASSERT_FALSE(nextIsFull());
+}
+
+static void test_full_mode_budget_is_stricter() {
+  g_refreshMode = 1;
+  toggleBlock();
+  TEST_ASSERT_TRUE(nextIsFull());  // 1.0 is the whole Full-mode budget
+  toggleBlock(true);
+  TEST_ASSERT_FALSE(nextIsFull());
+}
+
+static void test_full_mode_no_flash_for_small_changes() {
+  // A clock-sized change does not trigger a full refresh even in Full mode.
+  g_refreshMode = 1;
+  for (int i = 0; i < 20; i++) {
+    toggleDot();
+    TEST_ASSERT_FALSE(nextIsFull());
+  }
+}
+
+// ==================== Safety cap =====================
+
+static void test_cap_bounds_partials() {
+  int partials = 0;
+  while (!nextIsFull()) {
+    toggleDot();
+    partials++;
+    TEST_ASSERT_LESS_OR_EQUAL(PARTIAL_REFRESH_LIMIT, partials);
+  }
+  TEST_ASSERT_EQUAL_INT(PARTIAL_REFRESH_LIMIT, partials);
+  TEST_ASSERT_EQUAL_UINT16(PARTIAL_REFRESH_LIMIT, g_partialRefreshCount);
+}
+
+// ==================== Quiet time =====================
+
+static void test_quiet_cleanup_needs_some_ghosting() {
+  const time_t day1 = 1760914800, day2 = day1 + 86400, day3 = day2 + 86400;
+  TEST_ASSERT_FALSE(nextIsFull(day1));  // first cycle seen: nothing to close
+
+  toggleDot();
+  TEST_ASSERT_FALSE(nextIsFull(day2));  // rollover, but load < 25 % of the budget
+
+  toggleBlock();  // 1.0 of 4.0 = 25 %
+  TEST_ASSERT_FALSE(nextIsFull(day2));
+  TEST_ASSERT_TRUE(nextIsFull(day3));
+}
+
+// ==================== Metrics =====================
+
+static void test_full_refreshes_counted_by_reason() {
+  RefreshDayStats before, after, y;
+  refreshSchedulerGetStats(before, y);
+
+  for (int i = 0; i < 4; i++) toggleBlock();
+  TEST_ASSERT_TRUE(nextIsFull());
+  toggleBlock(true);
+
+  refreshSchedulerGetStats(after, y);
+  TEST_ASSERT_EQUAL_UINT32(before.partialCount + 4, after.partialCount);
+  TEST_ASSERT_EQUAL_UINT32(before.fullCount + 1, after.fullCount);
+  TEST_ASSERT_EQUAL_UINT32(before.fullByReason[REFRESH_FULL_BUDGET] + 1, after.fullByReason[REFRESH_FULL_BUDGET]);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  display.init(115200);
+  display.setRotation(1);
+  refreshSchedulerBegin();
+
+  UNITY_BEGIN();
+  RUN_TEST(test_forced_full_always_wins);
+  RUN_TEST(test_partial_mode_budget);
+  RUN_TEST(test_full_mode_budget_is_stricter);
+  RUN_TEST(test_full_mode_no_flash_for_small_changes);
+  RUN_TEST(test_cap_bounds_partials);
+  RUN_TEST(test_quiet_cleanup_needs_some_ghosting);
+  RUN_TEST(test_full_refreshes_counted_by_reason);
+  return UNITY_END();
+}
@@ -0,0 +1,189 @@
+// CryptoBar V0.99s (Unit tests)
+// test_warm_restart - Snapshot round trip, CRC / layout version / firmware checks, max age, discard
+#include <unity.h>
+
+#include <Preferences.h>
+#include <string.h>
+
+#include "host_hal.h"
+#include "app_state.h"
+#include "coins.h"
+#include "day_avg.h"
+#include "retained_state.h"
+#include "warm_restart.h"
+
+static const time_t kSaveUtc = 1760850000;  // a valid clock (2025-10-19)
+
+// WarmSnapshot starts with magic, version, reserved, size, savedUtc, firmware[16].
+static const size_t kVersionOffset  = 4;
+static const size_t kFirmwareOffset = 16;
+
+static void resetState() {
+  g_lastPriceUsd     = 0.0;
+  g_lastChange24h    = 0.0;
+  g_chartSampleCount = 0;
+  g_cycleInit        = false;
+  dayAvgRollingReset();
+}
+
+// A running device on XRP with a few chart and mean samples, saved at kSaveUtc.
+static void saveRunningState() {
+  hostClockSetUtc(kSaveUtc);
+  g_currentCoinIndex = coinIndexFromTicker("XRP");
+  g_lastPriceUsd     = 2.4375;
+  g_lastChange24h    = -1.25;
+  g_cycleInit        = true;
+  g_cycleStartUtc    = kSaveUtc - 3600;
+  g_cycleEndUtc      = kSaveUtc + 82800;
+  g_chartSampleCount = 3;
+  for (int i = 0; i < 3; i++) {
+    g_chartSamples[i].pos   = 0.25f * i;
+    g_chartSamples[i].price = 2.0 + 0.25 * i;
+  }
+  dayAvgRollingReset();
+  dayAvgRollingAdd(kSaveUtc - 1800, 2.25);
+  dayAvgRollingAdd(kSaveUtc - 600, 2.5);
+  warmRestartSave();
+  resetState();
+}
+
+// Re-seal the snapshot after editing it, so only the edited field differs.
+static void reseal(uint8_t* raw, size_t crcOffset) {
+  uint32_t crc = retainedCrc(raw, crcOffset);
+  memcpy(raw + crcOffset, &crc, sizeof(crc));
+}
+
+void setUp() {
+  hostPrefsClear();
+  warmRestartDiscard();
+  resetState();
+}
+
+void tearDown() {}
+
+// ==================== Round trip =====================
+
+static void test_no_snapshot() {
+  TEST_ASSERT_FALSE(warmRestartRestore());
+}
+
+static void test_round_trip() {
+  saveRunningState();
+  hostClockSetUtc(kSaveUtc + 20);
+  TEST_ASSERT_TRUE(warmRestartRestore());
+  TEST_ASSERT_TRUE(warmRestartRestored());
+
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 2.4375);
+  TEST_ASSERT_TRUE(g_lastChange24h == -1.25);
+  TEST_ASSERT_TRUE(g_cycleInit);
+  TEST_ASSERT_TRUE(g_cycleStartUtc == kSaveUtc - 3600);
+  TEST_ASSERT_EQUAL_INT(3, g_chartSampleCount);
+  TEST_ASSERT_TRUE(g_chartSamples[2].pos == 0.5f);
+  TEST_ASSERT_TRUE(g_chartSamples[2].price == 2.5);
+  TEST_ASSERT_EQUAL_INT(2, dayAvgRollingCount());
+
+  TEST_ASSERT_TRUE(warmRestartChartFresh(kSaveUtc + 20));
+  TEST_ASSERT_FALSE(warmRestartChartFresh(kSaveUtc + WARM_RESTART_HISTORY_MAX_AGE_SEC + 1));
+}
+
+static void test_restore_consumes_snapshot() {
+  saveRunningState();
+  TEST_ASSERT_TRUE(warmRestartRestore());
+  resetState();
+  TEST_ASSERT_FALSE(warmRestartRestore());  // a later crash does not replay it
+}
+
+static void test_discard() {
+  saveRunningState();
+  warmRestartDiscard();
+  TEST_ASSERT_FALSE(warmRestartRestore());
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 0.0);
+}
+
+// ==================== Integrity =====================
+
+static void test_crc_mismatch_rejected() {
+  saveRunningState();
+  size_t crcOffset;
+  uint8_t* raw = warmRestartSnapshotRaw(crcOffset);
+  raw[crcOffset - 8] ^= 0x40;  // a bit in the samples, CRC left as saved
+  TEST_ASSERT_FALSE(warmRestartRestore());
+  TEST_ASSERT_EQUAL_INT(0, g_chartSampleCount);
+}
+
+static void test_layout_version_mismatch_rejected() {
+  saveRunningState();
+  size_t crcOffset;
+  uint8_t* raw = warmRestartSnapshotRaw(crcOffset);
+  uint16_t version;
+  memcpy(&version, raw + kVersionOffset, sizeof(version));
+  version++;
+  memcpy(raw + kVersionOffset, &version, sizeof(version));
+  reseal(raw, crcOffset);
+  TEST_ASSERT_FALSE(warmRestartRestore());
+}
+
+static void test_firmware_mismatch_rejected() {
+  saveRunningState();
+  size_t crcOffset;
+  uint8_t* raw = warmRestartSnapshotRaw(crcOffset);
+  char* firmware = (char*)raw + kFirmwareOffset;
+  TEST_ASSERT_EQUAL_STRING(CRYPTOBAR_VERSION, firmware);
+  strcpy(firmware, "V0.00");
+  reseal(raw, crcOffset);
+  TEST_ASSERT_FALSE(warmRestartRestore());
+}
+
+// ==================== Age and coin =====================
+
+static void test_max_age() {
+  saveRunningState();
+  hostClockSetUtc(kSaveUtc + WARM_RESTART_MAX_AGE_SEC);
+  TEST_ASSERT_TRUE(warmRestartRestore());
+
+  resetState();
+  saveRunningState();
+  hostClockSetUtc(kSaveUtc + WARM_RESTART_MAX_AGE_SEC + 1);
+  TEST_ASSERT_FALSE(warmRestartRestore());
+}
+
+static void test_clock_lost_rejected() {
+  saveRunningState();
+  hostClockSetUtc(1000);  // RTC not valid after the restart
+  TEST_ASSERT_FALSE(warmRestartRestore());
+}
+
+static void test_saved_without_clock_kept() {
+  hostClockSetUtc(1000);
+  g_currentCoinIndex = coinIndexFromTicker("XRP");
+  g_lastPriceUsd     = 2.0;
+  warmRestartSave();
+  resetState();
+  TEST_ASSERT_TRUE(warmRestartRestore());
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 2.0);
+}
+
+static void test_other_coin_rejected() {
+  saveRunningState();
+  g_currentCoinIndex = coinIndexFromTicker("BTC");
+  TEST_ASSERT_FALSE(warmRestartRestore());
+  TEST_ASSERT_TRUE(g_lastPriceUsd == 0.0);
+}
+
+int main(int argc, char** argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_no_snapshot);
+  RUN_TEST(test_round_trip);
+  RUN_TEST(test_restore_consumes_snapshot);
+  RUN_TEST(test_discard);
+  RUN_TEST(test_crc_mismatch_rejected);
+  RUN_TEST(test_layout_version_mismatch_rejected);
+  RUN_TEST(test_firmware_mismatch_rejected);
+  RUN_TEST(test_max_age);
+  RUN_TEST(test_clock_lost_rejected);
+  RUN_TEST(test_saved_without_clock_kept);
+  RUN_TEST(test_other_coin_rejected);
+  return UNITY_END();
+}